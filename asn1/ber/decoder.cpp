@@ -1,4 +1,5 @@
 #include "asn1/ber/decoder.h"
+#include "asn1/ber/framer.h"
 
 asn1::ber::decoder::result asn1::ber::decoder::next(value& val)
 {
@@ -26,7 +27,7 @@ asn1::ber::decoder::result asn1::ber::decoder::next(value& val)
 
         // Decode length.
         bool definite_length;
-        const result res = decode_length(0, val._M_length, definite_length);
+        const result res = decode_length(val._M_length, definite_length);
 
         // If the length could be decoded...
         if (res == result::no_error) {
@@ -159,9 +160,7 @@ asn1::ber::decoder::decode_tag_number(uint32_t& tag_number)
 }
 
 asn1::ber::decoder::result
-asn1::ber::decoder::decode_length(size_t depth,
-                                  size_t& length,
-                                  bool& definite_length)
+asn1::ber::decoder::decode_length(size_t& length, bool& definite_length)
 {
   // If not at the end of the data...
   if (_M_offset < _M_length) {
@@ -201,31 +200,21 @@ asn1::ber::decoder::decode_length(size_t depth,
       } else if (!_M_primitive) {
         // Indefinite length.
 
-        // If the maximum number of nested end-of-contents has not been
-        // reached...
-        if (depth < max_nested_eoc) {
-          // Save current offset (it will be modified in find_eoc()).
-          const size_t offset = _M_offset;
+        // Find end-of-contents (iteratively, up to
+        // `framer::max_nested_eoc` nested indefinite-length values).
+        size_t eoc = _M_offset;
+        const result res = framer::find_eoc(_M_data, _M_length, eoc);
 
-          // Find end-of-contents.
-          const result res = find_eoc(depth + 1);
-
-          // If not error...
-          if (res == result::no_error) {
-            // Compute length (`_M_offset` points to end-of-contents).
-            length = _M_offset - offset;
-
-            // Restore offset.
-            _M_offset = offset;
+        // If not error...
+        if (res == result::no_error) {
+          // Compute length (`eoc` points to end-of-contents).
+          length = eoc - _M_offset;
 
-            definite_length = false;
+          definite_length = false;
 
-            return result::no_error;
-          } else {
-            return res;
-          }
+          return result::no_error;
         } else {
-          return result::max_nested_eoc_exceeded;
+          return res;
         }
       }
     }
@@ -236,67 +225,17 @@ asn1::ber::decoder::decode_length(size_t depth,
   }
 }
 
-asn1::ber::decoder::result asn1::ber::decoder::find_eoc(size_t depth)
+const char* asn1::ber::to_string(decoder::result res)
 {
-  // Save `_M_primitive`.
-  const bool primitive = _M_primitive;
-
-  // While the end of the data has not been reached...
-  while (_M_offset < _M_length) {
-    // Save identifier octet.
-    const uint8_t idoctet = _M_data[_M_offset];
-
-    // Decode tag number.
-    uint32_t tag_number;
-    const result res = decode_tag_number(tag_number);
-
-    // If the tag number could be decoded...
-    if (res == result::no_error) {
-      // Save whether the encoding is primitive or constructed.
-      _M_primitive = (idoctet & 0x20u) == 0;
-
-      // Decode length.
-      size_t len;
-      bool definite_length;
-      const result res = decode_length(depth, len, definite_length);
-
-      // If the length could be decoded...
-      if (res == result::no_error) {
-        // If the contents octets fit in the buffer...
-        if (_M_offset + len <= _M_length) {
-          // If not the end-of-contents...
-          if (idoctet != 0) {
-            // Definite length?
-            if (definite_length) {
-              // Skip contents octets.
-              _M_offset += len;
-            } else {
-              // Skip contents octets and end-of-contents.
-              _M_offset += (len + 2);
-            }
-          } else {
-            if (len == 0) {
-              // Restore `_M_primitive`.
-              _M_primitive = primitive;
-
-              // Make `_M_offset` point to end-of-contents.
-              _M_offset -= 2;
-
-              return result::no_error;
-            } else {
-              return result::invalid_length;
-            }
-          }
-        } else {
-          return result::unexpected_eof;
-        }
-      } else {
-        return res;
-      }
-    } else {
-      return res;
-    }
+  switch (res) {
+    case decoder::result::no_error:                return "no_error";
+    case decoder::result::eof:                     return "eof";
+    case decoder::result::unexpected_eof:          return "unexpected_eof";
+    case decoder::result::invalid_tag_number:      return "invalid_tag_number";
+    case decoder::result::invalid_length:          return "invalid_length";
+    case decoder::result::max_depth_exceeded:      return "max_depth_exceeded";
+    case decoder::result::max_nested_eoc_exceeded:
+      return "max_nested_eoc_exceeded";
+    default:                                       return "(unknown-result)";
   }
-
-  return result::unexpected_eof;
 }
@@ -29,6 +29,10 @@ namespace asn1 {
           max_nested_eoc_exceeded
         };
 
+        // Number of results.
+        static constexpr const size_t number_results =
+          static_cast<size_t>(result::max_nested_eoc_exceeded) + 1;
+
         result next(value& val);
 
         // Enter constructed.
@@ -41,9 +45,6 @@ namespace asn1 {
         // Maximum depth.
         static constexpr const size_t max_depth = 128;
 
-        // Maximum number of nested end-of-contents.
-        static constexpr const size_t max_nested_eoc = 128;
-
         // Pointer to the data.
         const uint8_t* _M_data;
 
@@ -80,14 +81,11 @@ namespace asn1 {
         result decode_tag_number(uint32_t& tag_number);
 
         // Decode length.
-        result decode_length(size_t depth,
-                             size_t& length,
-                             bool& definite_length);
-
-        // Find end-of-contents.
-        result find_eoc(size_t depth);
+        result decode_length(size_t& length, bool& definite_length);
     };
 
+    const char* to_string(decoder::result res);
+
     inline decoder::decoder(const void* data, size_t length)
       : _M_data(static_cast<const uint8_t*>(data)),
         _M_length(length)
@@ -5,6 +5,7 @@
 #include <unistd.h>
 #include <time.h>
 #include <errno.h>
+#include <limits.h>
 #include "asn1/ber/encoder.h"
 
 #if !defined(_WIN32)
@@ -13,44 +14,42 @@
 
 bool asn1::ber::encoder::add_boolean(tag_class tc, uint32_t tn, bool val)
 {
-  // If there are not too many values...
-  if (_M_nvalues < max_values) {
-    value* const v = &_M_values[_M_nvalues];
-
+  // If the value could be allocated...
+  value* const v = new_value();
+  if (v) {
     // Encode boolean.
     v->encode_boolean(tc, tn, val);
 
     // Set value's parent.
     v->parent(_M_parent);
 
-    // Increment number of values.
-    _M_nvalues++;
+    // Add length to the parent's.
+    add_length(v->total_length());
 
     return true;
   }
 
-  return true;
+  return false;
 }
 
 bool asn1::ber::encoder::add_integer(tag_class tc, uint32_t tn, int64_t val)
 {
-  // If there are not too many values...
-  if (_M_nvalues < max_values) {
-    value* const v = &_M_values[_M_nvalues];
-
+  // If the value could be allocated...
+  value* const v = new_value();
+  if (v) {
     // Encode integer.
     v->encode_integer(tc, tn, val);
 
     // Set value's parent.
     v->parent(_M_parent);
 
-    // Increment number of values.
-    _M_nvalues++;
+    // Add length to the parent's.
+    add_length(v->total_length());
 
     return true;
   }
 
-  return true;
+  return false;
 }
 
 bool asn1::ber::encoder::add_data(tag_class tc,
@@ -59,85 +58,101 @@ bool asn1::ber::encoder::add_data(tag_class tc,
                                   size_t len,
                                   copy cp)
 {
-  // If there are not too many values...
-  if (_M_nvalues < max_values) {
-    value* const v = &_M_values[_M_nvalues];
+  // Deep copy?
+  if (cp == copy::deep) {
+    // Copy data to the data arena.
+    size_t offset;
+    if (copy_data(val, len, offset)) {
+      // If the value could be allocated...
+      value* const v = new_value();
+      if (v) {
+        // Encode data.
+        v->encode_copied_data(tc, tn, offset, len);
+
+        // Set value's parent.
+        v->parent(_M_parent);
+
+        // Add length to the parent's.
+        add_length(v->total_length());
+
+        return true;
+      }
+
+      // Release the copy.
+      _M_data_used = offset;
+    }
+  } else {
+    // If the value could be allocated...
+    value* const v = new_value();
+    if (v) {
+      // Encode data.
+      v->encode_data(tc, tn, val, len);
 
-    // Encode data.
-    if (v->encode_data(tc, tn, val, len, cp)) {
       // Set value's parent.
       v->parent(_M_parent);
 
-      // Increment number of values.
-      _M_nvalues++;
+      // Add length to the parent's.
+      add_length(v->total_length());
 
       return true;
     }
   }
 
-  return true;
+  return false;
 }
 
 bool asn1::ber::encoder::add_null(tag_class tc, uint32_t tn)
 {
-  // If there are not too many values...
-  if (_M_nvalues < max_values) {
-    value* const v = &_M_values[_M_nvalues];
-
+  // If the value could be allocated...
+  value* const v = new_value();
+  if (v) {
     // Encode null.
     v->encode_null(tc, tn);
 
     // Set value's parent.
     v->parent(_M_parent);
 
-    // Increment number of values.
-    _M_nvalues++;
+    // Add length to the parent's.
+    add_length(v->total_length());
 
     return true;
   }
 
-  return true;
+  return false;
 }
 
 bool asn1::ber::encoder::start_constructed(tag_class tc, uint32_t tn)
 {
-  // If there are not too many values...
-  if (_M_nvalues < max_values) {
-    value* const v = &_M_values[_M_nvalues];
-
+  // If the value could be allocated...
+  value* const v = new_value();
+  if (v) {
     // Encode constructed.
     v->encode_constructed(tc, tn);
 
     // Set value's parent.
     v->parent(_M_parent);
 
-    _M_parent = _M_nvalues;
-
-    // Increment number of values.
-    _M_nvalues++;
+    _M_parent = _M_nvalues - 1;
 
     return true;
   }
 
-  return true;
+  return false;
 }
 
 bool asn1::ber::encoder::end_constructed()
 {
   if (_M_parent != -1) {
-    // Compute the length of the constructed value.
-    size_t valuelen = 0;
-    for (size_t i = _M_parent + 1; i < _M_nvalues; i++) {
-      // If the value is a child value of the current parent...
-      if (_M_values[i].parent() == _M_parent) {
-        valuelen += _M_values[i].total_length();
-      }
-    }
+    value* const v = &_M_values[_M_parent];
+
+    // Encode the length of the constructed value (the sum of the lengths of
+    // its child values, accumulated as they were added).
+    v->value_length(v->value_length());
 
-    // Set value length.
-    _M_values[_M_parent].value_length(valuelen);
+    _M_parent = v->parent();
 
-    _M_parent = _M_values[_M_parent].parent();
+    // Add length to the parent's.
+    add_length(v->total_length());
 
     return true;
   }
@@ -149,23 +164,22 @@ bool asn1::ber::encoder::add_generalized_time(tag_class tc,
                                               uint32_t tn,
                                               const struct timeval& tv)
 {
-  // If there are not too many values...
-  if (_M_nvalues < max_values) {
-    value* const v = &_M_values[_M_nvalues];
-
+  // If the value could be allocated...
+  value* const v = new_value();
+  if (v) {
     // Encode generalized time.
     v->encode_generalized_time(tc, tn, tv);
 
     // Set value's parent.
     v->parent(_M_parent);
 
-    // Increment number of values.
-    _M_nvalues++;
+    // Add length to the parent's.
+    add_length(v->total_length());
 
     return true;
   }
 
-  return true;
+  return false;
 }
 
 bool asn1::ber::encoder::add_generalized_time(tag_class tc, uint32_t tn)
@@ -183,7 +197,7 @@ bool asn1::ber::encoder::serialize(string::buffer& buf) const
     // For each value...
     for (size_t i = 0; i < _M_nvalues; i++) {
       // Serialize value.
-      if (!_M_values[i].serialize(buf)) {
+      if (!_M_values[i].serialize(buf, _M_data)) {
         return false;
       }
     }
@@ -196,6 +210,23 @@ bool asn1::ber::encoder::serialize(string::buffer& buf) const
 
 bool asn1::ber::encoder::serialize(const char* filename) const
 {
+#if !defined(_WIN32)
+  // Open file for writing.
+  const int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+  // If the file could be opened...
+  if (fd != -1) {
+    // Serialize to the file.
+    if (serialize(fd)) {
+      return (close(fd) == 0);
+    }
+
+    close(fd);
+    unlink(filename);
+  }
+
+  return false;
+#else
   // Serialize to buffer.
   string::buffer buf;
   if (serialize(buf)) {
@@ -236,13 +267,189 @@ bool asn1::ber::encoder::serialize(const char* filename) const
   }
 
   return false;
+#endif // !defined(_WIN32)
 }
 
-asn1::ber::encoder::value::~value()
+#if !defined(_WIN32)
+bool asn1::ber::encoder::serialize(const struct iovec*& iov,
+                                   size_t& iovcnt) const
 {
-  if (_M_type == type::pointer) {
-    free(_M_value.data);
+  if (_M_parent == -1) {
+    _M_headers.clear();
+
+    size_t n = 0;
+
+    // Offset of the octets of the buffer not referenced yet.
+    size_t chunk = 0;
+
+    // For each value...
+    for (size_t i = 0; i < _M_nvalues; i++) {
+      const value& v = _M_values[i];
+
+      // Make room for two more entries.
+      if (n + 2 > _M_iov_size) {
+        const size_t size = (_M_iov_size == 0) ? initial_values :
+                                                 _M_iov_size * 2;
+
+        struct iovec* const vec = static_cast<struct iovec*>(
+                                    realloc(_M_iov, size * sizeof(struct iovec))
+                                  );
+
+        if (!vec) {
+          return false;
+        }
+
+        _M_iov = vec;
+        _M_iov_size = size;
+      }
+
+      // Serialize identifier and length octets.
+      if (!v.serialize_header(_M_headers)) {
+        return false;
+      }
+
+      // Primitive?
+      if (!v.constructed()) {
+        const void* const contents = v.contents(_M_data);
+        const size_t len = v.value_length();
+
+        // If the data is short...
+        if (len < min_reference_length) {
+          // Copy data.
+          if (!_M_headers.append(contents, len)) {
+            return false;
+          }
+        } else {
+          // Reference the octets of the buffer (the base is set once the
+          // buffer is complete).
+          _M_iov[n].iov_base = nullptr;
+          _M_iov[n++].iov_len = _M_headers.length() - chunk;
+
+          // Reference data in place.
+          _M_iov[n].iov_base = const_cast<void*>(contents);
+          _M_iov[n++].iov_len = len;
+
+          chunk = _M_headers.length();
+        }
+      }
+    }
+
+    // If there are octets of the buffer not referenced yet...
+    if (_M_headers.length() > chunk) {
+      // If the I/O vector is full...
+      if (n == _M_iov_size) {
+        const size_t size = (_M_iov_size == 0) ? 1 : _M_iov_size + 1;
+
+        struct iovec* const vec = static_cast<struct iovec*>(
+                                    realloc(_M_iov, size * sizeof(struct iovec))
+                                  );
+
+        if (!vec) {
+          return false;
+        }
+
+        _M_iov = vec;
+        _M_iov_size = size;
+      }
+
+      _M_iov[n].iov_base = nullptr;
+      _M_iov[n++].iov_len = _M_headers.length() - chunk;
+    }
+
+    // Set the base of the entries which reference the buffer.
+    uint8_t* const headers = static_cast<uint8_t*>(
+                               const_cast<void*>(_M_headers.data())
+                             );
+
+    size_t offset = 0;
+    for (size_t i = 0; i < n; i++) {
+      if (!_M_iov[i].iov_base) {
+        _M_iov[i].iov_base = headers + offset;
+        offset += _M_iov[i].iov_len;
+      }
+    }
+
+    iov = _M_iov;
+    iovcnt = n;
+
+    return true;
   }
+
+  return false;
+}
+
+bool asn1::ber::encoder::serialize(int fd) const
+{
+  const struct iovec* vec;
+  size_t iovcnt;
+  if (serialize(vec, iovcnt)) {
+    // The entries are updated after partial writes.
+    struct iovec* iov = _M_iov;
+
+    // While there is data to be written...
+    while (iovcnt > 0) {
+      // Write data.
+      const ssize_t ret = writev(fd,
+                                 iov,
+                                 (iovcnt <= IOV_MAX) ? iovcnt : IOV_MAX);
+
+      // If we have written some data...
+      if (ret > 0) {
+        size_t written = static_cast<size_t>(ret);
+
+        // Skip the entries which have been completely written.
+        while ((iovcnt > 0) && (written >= iov->iov_len)) {
+          written -= iov->iov_len;
+
+          iov++;
+          iovcnt--;
+        }
+
+        // If an entry has been partially written...
+        if (written > 0) {
+          iov->iov_base = static_cast<uint8_t*>(iov->iov_base) + written;
+          iov->iov_len -= written;
+        }
+      } else if ((ret < 0) && (errno != EINTR)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  return false;
+}
+#endif // !defined(_WIN32)
+
+bool asn1::ber::encoder::copy_data(const void* data,
+                                   size_t len,
+                                   size_t& offset)
+{
+  // If the data doesn't fit in the arena...
+  if (len > _M_data_size - _M_data_used) {
+    size_t size = (_M_data_size == 0) ? initial_data_size : _M_data_size * 2;
+    while (len > size - _M_data_used) {
+      size *= 2;
+    }
+
+    uint8_t* const d = static_cast<uint8_t*>(realloc(_M_data, size));
+    if (!d) {
+      return false;
+    }
+
+    _M_data = d;
+    _M_data_size = size;
+  }
+
+  if (len > 0) {
+    memcpy(_M_data + _M_data_used, data, len);
+  }
+
+  offset = _M_data_used;
+  _M_data_used += len;
+
+  return true;
 }
 
 size_t asn1::ber::encoder::value::total_length() const
@@ -260,12 +467,41 @@ void asn1::ber::encoder::value::parent(ssize_t p)
   _M_parent = p;
 }
 
+bool asn1::ber::encoder::value::constructed() const
+{
+  return (_M_type == type::constructed);
+}
+
+const void* asn1::ber::encoder::value::contents(const uint8_t* data) const
+{
+  switch (_M_type) {
+    case type::value:
+      return _M_value.v;
+    case type::const_pointer:
+      return _M_value.cdata;
+    case type::copied:
+      return data + _M_value.offset;
+    default:
+      return nullptr;
+  }
+}
+
+size_t asn1::ber::encoder::value::value_length() const
+{
+  return _M_valuelen;
+}
+
 void asn1::ber::encoder::value::value_length(size_t valuelen)
 {
   // Encode length.
   encode_length(valuelen);
 }
 
+void asn1::ber::encoder::value::add_value_length(size_t len)
+{
+  _M_valuelen += len;
+}
+
 void asn1::ber::encoder::value::encode_boolean(tag_class tc,
                                                uint32_t tn,
                                                bool val)
@@ -273,6 +509,11 @@ void asn1::ber::encoder::value::encode_boolean(tag_class tc,
   // Encode identifier octets.
   encode_identifier_octets(tc, true, tn);
 
+  encode_boolean(val);
+}
+
+void asn1::ber::encoder::value::encode_boolean(bool val)
+{
   // Encode length.
   _M_len[0] = 1;
   _M_lenlen = 1;
@@ -291,6 +532,11 @@ void asn1::ber::encoder::value::encode_integer(tag_class tc,
   // Encode identifier octets.
   encode_identifier_octets(tc, true, tn);
 
+  encode_integer(val);
+}
+
+void asn1::ber::encoder::value::encode_integer(int64_t val)
+{
   _M_type = type::value;
 
   if ((val < 0x80ll) && (val >= -0x80ll)) {
@@ -395,31 +641,46 @@ void asn1::ber::encoder::value::encode_integer(tag_class tc,
   }
 }
 
-bool asn1::ber::encoder::value::encode_data(tag_class tc,
+void asn1::ber::encoder::value::encode_data(tag_class tc,
                                             uint32_t tn,
                                             const void* data,
-                                            size_t len,
-                                            copy cp)
+                                            size_t len)
 {
-  if (cp == copy::deep) {
-    if ((_M_value.data = malloc(len)) != nullptr) {
-      memcpy(_M_value.data, data, len);
-      _M_type = type::pointer;
-    } else {
-      return false;
-    }
-  } else {
-    _M_value.cdata = data;
-    _M_type = type::const_pointer;
-  }
+  // Encode identifier octets.
+  encode_identifier_octets(tc, true, tn);
+
+  encode_data(data, len);
+}
 
+void asn1::ber::encoder::value::encode_data(const void* data, size_t len)
+{
+  // Encode length.
+  encode_length(len);
+
+  _M_type = type::const_pointer;
+
+  _M_value.cdata = data;
+}
+
+void asn1::ber::encoder::value::encode_copied_data(tag_class tc,
+                                                   uint32_t tn,
+                                                   size_t offset,
+                                                   size_t len)
+{
   // Encode identifier octets.
   encode_identifier_octets(tc, true, tn);
 
+  encode_copied_data(offset, len);
+}
+
+void asn1::ber::encoder::value::encode_copied_data(size_t offset, size_t len)
+{
   // Encode length.
   encode_length(len);
 
-  return true;
+  _M_type = type::copied;
+
+  _M_value.offset = offset;
 }
 
 void asn1::ber::encoder::value::encode_null(tag_class tc, uint32_t tn)
@@ -427,8 +688,14 @@ void asn1::ber::encoder::value::encode_null(tag_class tc, uint32_t tn)
   // Encode identifier octets.
   encode_identifier_octets(tc, true, tn);
 
+  encode_null();
+}
+
+void asn1::ber::encoder::value::encode_null()
+{
   // Encode length.
-  _M_lenlen = 0;
+  _M_len[0] = 0;
+  _M_lenlen = 1;
 
   _M_type = type::value;
 
@@ -440,6 +707,11 @@ void asn1::ber::encoder::value::encode_constructed(tag_class tc, uint32_t tn)
   // Encode identifier octets.
   encode_identifier_octets(tc, false, tn);
 
+  encode_constructed();
+}
+
+void asn1::ber::encoder::value::encode_constructed()
+{
   _M_lenlen = 0;
   _M_valuelen = 0;
 
@@ -454,6 +726,12 @@ asn1::ber::encoder::value::encode_generalized_time(tag_class tc,
   // Encode identifier octets.
   encode_identifier_octets(tc, true, tn);
 
+  encode_generalized_time(tv);
+}
+
+void
+asn1::ber::encoder::value::encode_generalized_time(const struct timeval& tv)
+{
   struct tm tm;
 
 #if !defined(_WIN32)
@@ -505,7 +783,14 @@ asn1::ber::encoder::value::encode_generalized_time(tag_class tc,
   _M_type = type::value;
 }
 
-bool asn1::ber::encoder::value::serialize(string::buffer& buf) const
+bool asn1::ber::encoder::value::serialize_header(string::buffer& buf) const
+{
+  // Serialize tag and length.
+  return ((buf.append(_M_tag, _M_taglen)) && (buf.append(_M_len, _M_lenlen)));
+}
+
+bool asn1::ber::encoder::value::serialize(string::buffer& buf,
+                                          const uint8_t* data) const
 {
   // Serialize tag and length.
   if ((buf.append(_M_tag, _M_taglen)) && (buf.append(_M_len, _M_lenlen))) {
@@ -514,8 +799,8 @@ bool asn1::ber::encoder::value::serialize(string::buffer& buf) const
         return buf.append(_M_value.v, _M_valuelen);
       case type::const_pointer:
         return buf.append(_M_value.cdata, _M_valuelen);
-      case type::pointer:
-        return buf.append(_M_value.data, _M_valuelen);
+      case type::copied:
+        return buf.append(data + _M_value.offset, _M_valuelen);
       case type::constructed:
         return true;
     }
@@ -1,14 +1,28 @@
 #ifndef ASN1_BER_ENCODER_H
 #define ASN1_BER_ENCODER_H
 
+#include <stdlib.h>
+#include <string.h>
 #include <sys/time.h>
+
+#if !defined(_WIN32)
+  #include <sys/uio.h>
+#endif
+
 #include "asn1/ber/tag.h"
 #include "string/buffer.h"
 
 namespace asn1 {
   namespace ber {
     // ASN.1 BER encoder.
+    //
+    // The values are kept in a growable array and the deep copies of the
+    // data in a growable arena, both kept by `reset()` for the next record.
+    // The `add_*()` methods and `start_constructed()` return false if the
+    // memory couldn't be allocated (the value is not added).
     class encoder {
+      friend class stream_encoder;
+
       public:
         // Copy.
         enum class copy {
@@ -20,7 +34,10 @@ namespace asn1 {
         encoder() = default;
 
         // Destructor.
-        ~encoder() = default;
+        ~encoder();
+
+        // Reset (the memory is kept for the next record).
+        void reset();
 
         // Add boolean.
         bool add_boolean(tag_class tc, uint32_t tn, bool val);
@@ -52,22 +69,90 @@ namespace asn1 {
         // Add generalized time using current time.
         bool add_generalized_time(tag_class tc, uint32_t tn);
 
+        // Add values whose tag is known at compile time (the identifier
+        // octets are encoded at compile time).
+        template<tag_class TC, uint32_t TN>
+        bool add_boolean(bool val);
+
+        template<tag_class TC, uint32_t TN>
+        bool add_integer(int64_t val);
+
+        template<tag_class TC, uint32_t TN>
+        bool add_data(const void* val, size_t len, copy cp = copy::deep);
+
+        template<tag_class TC, uint32_t TN>
+        bool add_null();
+
+        template<tag_class TC, uint32_t TN>
+        bool start_constructed();
+
+        template<tag_class TC, uint32_t TN>
+        bool add_generalized_time(const struct timeval& tv);
+
         // Serialize.
         bool serialize(string::buffer& buf) const;
         bool serialize(const char* filename) const;
 
+#if !defined(_WIN32)
+        // Serialize into an I/O vector (valid until the encoder is modified):
+        // the identifier and length octets and the short values are copied
+        // into a buffer owned by the encoder, the data of the values of at
+        // least `min_reference_length` bytes is referenced in place (data
+        // added with `copy::shallow` must still be valid).
+        bool serialize(const struct iovec*& iov, size_t& iovcnt) const;
+
+        // Serialize to a file descriptor (file or blocking socket) with
+        // writev().
+        bool serialize(int fd) const;
+#endif // !defined(_WIN32)
+
       private:
-        // Maximum number of values.
-        static constexpr const size_t max_values = 256;
+        // Minimum length of the data referenced in place by the I/O vector.
+        static constexpr const size_t min_reference_length = 64;
+
+        // Initial number of values.
+        static constexpr const size_t initial_values = 32;
+
+        // Initial size of the data arena.
+        static constexpr const size_t initial_data_size = 1024;
+
+        // Maximum length of the identifier octets.
+        static constexpr const size_t max_identifier_length = 6;
+
+        // Compute the identifier octet `n` of a tag whose identifier octets
+        // are `len` octets long.
+        static constexpr uint8_t identifier_octet(tag_class tc,
+                                                  bool primitive,
+                                                  uint32_t tn,
+                                                  size_t len,
+                                                  size_t n);
+
+        // Identifier octets encoded at compile time.
+        template<tag_class TC, bool Primitive, uint32_t TN>
+        struct identifier {
+          // Length of the identifier octets.
+          static constexpr const size_t length = (TN < 31) ? 1 :
+                                                 (TN < 0x80u) ? 2 :
+                                                 (TN < 0x4000u) ? 3 :
+                                                 (TN < 0x200000u) ? 4 :
+                                                 (TN < 0x10000000u) ? 5 :
+                                                 6;
+
+          // Identifier octets.
+          static constexpr const uint8_t octets[max_identifier_length] = {
+            identifier_octet(TC, Primitive, TN, length, 0),
+            identifier_octet(TC, Primitive, TN, length, 1),
+            identifier_octet(TC, Primitive, TN, length, 2),
+            identifier_octet(TC, Primitive, TN, length, 3),
+            identifier_octet(TC, Primitive, TN, length, 4),
+            identifier_octet(TC, Primitive, TN, length, 5)
+          };
+        };
 
-        // Value.
+        // Value (trivially copyable: the array of values is moved by
+        // realloc()).
         class value {
           public:
-            // Constructor.
-            value() = default;
-
-            // Destructor.
-            ~value();
 
             // Get total length.
             size_t total_length() const;
@@ -75,43 +160,73 @@ namespace asn1 {
             // Get parent.
             ssize_t parent() const;
 
+            // Is constructed?
+            bool constructed() const;
+
+            // Get pointer to the contents octets (nullptr if constructed;
+            // `data` is the data arena).
+            const void* contents(const uint8_t* data) const;
+
             // Set parent.
             void parent(ssize_t p);
 
+            // Get value length.
+            size_t value_length() const;
+
             // Set value length.
             void value_length(size_t valuelen);
 
+            // Add the length of a child value (constructed).
+            void add_value_length(size_t len);
+
+            // Set the identifier octets (encoded at compile time).
+            void identifier(const uint8_t* tag, size_t taglen);
+
             // Encode boolean.
             void encode_boolean(tag_class tc, uint32_t tn, bool val);
+            void encode_boolean(bool val);
 
             // Encode integer.
             void encode_integer(tag_class tc, uint32_t tn, int64_t val);
+            void encode_integer(int64_t val);
 
             // Encode data.
-            bool encode_data(tag_class tc,
+            void encode_data(tag_class tc,
                              uint32_t tn,
                              const void* val,
-                             size_t len,
-                             copy cp);
+                             size_t len);
+            void encode_data(const void* val, size_t len);
+
+            // Encode data copied to the data arena at `offset`.
+            void encode_copied_data(tag_class tc,
+                                    uint32_t tn,
+                                    size_t offset,
+                                    size_t len);
+            void encode_copied_data(size_t offset, size_t len);
 
             // Encode null.
             void encode_null(tag_class tc, uint32_t tn);
+            void encode_null();
 
             // Encode constructed.
             void encode_constructed(tag_class tc, uint32_t tn);
-
+            void encode_constructed();
 
             // Encode generalized time.
             void encode_generalized_time(tag_class tc,
                                          uint32_t tn,
                                          const struct timeval& tv);
+            void encode_generalized_time(const struct timeval& tv);
 
-            // Serialize.
-            bool serialize(string::buffer& buf) const;
+            // Serialize (`data` is the data arena).
+            bool serialize(string::buffer& buf, const uint8_t* data) const;
+
+            // Serialize identifier and length octets.
+            bool serialize_header(string::buffer& buf) const;
 
           private:
             // Encoded tag.
-            uint8_t _M_tag[6];
+            uint8_t _M_tag[max_identifier_length];
 
             // Length of the encoded tag.
             size_t _M_taglen;
@@ -129,11 +244,11 @@ namespace asn1 {
             enum class type {
               value,
               const_pointer,
-              pointer,
+              copied,
               constructed
             };
 
-            type _M_type = type::value;
+            type _M_type;
 
             // Value.
             union {
@@ -141,7 +256,9 @@ namespace asn1 {
               uint8_t v[23];
 
               const void* cdata;
-              void* data;
+
+              // Offset in the data arena.
+              size_t offset;
             } _M_value;
 
             // Length of the value.
@@ -160,23 +277,287 @@ namespace asn1 {
 
             // Encode length.
             void encode_length(size_t len);
-
-            // Disable copy constructor and assignment operator.
-            value(const value&) = delete;
-            value& operator=(const value&) = delete;
         };
 
         // Values.
-        value _M_values[max_values];
+        value* _M_values = nullptr;
+        size_t _M_size = 0;
         size_t _M_nvalues = 0;
 
+        // Data arena (deep copies).
+        uint8_t* _M_data = nullptr;
+        size_t _M_data_size = 0;
+        size_t _M_data_used = 0;
+
         // Parent.
         ssize_t _M_parent = -1;
 
+#if !defined(_WIN32)
+        // Identifier and length octets and short values (I/O vector).
+        mutable string::buffer _M_headers;
+
+        // I/O vector.
+        mutable struct iovec* _M_iov = nullptr;
+        mutable size_t _M_iov_size = 0;
+#endif // !defined(_WIN32)
+
+        // Get a new value (nullptr if the array of values couldn't be
+        // grown).
+        value* new_value();
+
+        // Get a new value with the identifier octets of a tag known at
+        // compile time.
+        template<tag_class TC, bool Primitive, uint32_t TN>
+        value* new_value();
+
+        // Add the length of a complete value to its parent's.
+        void add_length(size_t len);
+
+        // Copy data to the data arena.
+        bool copy_data(const void* data, size_t len, size_t& offset);
+
         // Disable copy constructor and assignment operator.
         encoder(const encoder&) = delete;
         encoder& operator=(const encoder&) = delete;
     };
+
+    inline encoder::~encoder()
+    {
+      free(_M_values);
+      free(_M_data);
+
+#if !defined(_WIN32)
+      free(_M_iov);
+#endif
+    }
+
+    inline void encoder::reset()
+    {
+      _M_nvalues = 0;
+      _M_data_used = 0;
+      _M_parent = -1;
+    }
+
+    inline encoder::value* encoder::new_value()
+    {
+      // If the array of values is full...
+      if (_M_nvalues == _M_size) {
+        const size_t size = (_M_size == 0) ? initial_values : _M_size * 2;
+
+        value* const values = static_cast<value*>(
+                                realloc(_M_values, size * sizeof(value))
+                              );
+
+        if (!values) {
+          return nullptr;
+        }
+
+        _M_values = values;
+        _M_size = size;
+      }
+
+      return &_M_values[_M_nvalues++];
+    }
+
+    template<tag_class TC, bool Primitive, uint32_t TN>
+    inline encoder::value* encoder::new_value()
+    {
+      // If the value could be allocated...
+      value* const v = new_value();
+      if (v) {
+        v->identifier(identifier<TC, Primitive, TN>::octets,
+                      identifier<TC, Primitive, TN>::length);
+      }
+
+      return v;
+    }
+
+    template<tag_class TC, uint32_t TN>
+    inline bool encoder::add_boolean(bool val)
+    {
+      // If the value could be allocated...
+      value* const v = new_value<TC, true, TN>();
+      if (v) {
+        // Encode boolean.
+        v->encode_boolean(val);
+
+        // Set value's parent.
+        v->parent(_M_parent);
+
+        // Add length to the parent's.
+        add_length(v->total_length());
+
+        return true;
+      }
+
+      return false;
+    }
+
+    template<tag_class TC, uint32_t TN>
+    inline bool encoder::add_integer(int64_t val)
+    {
+      // If the value could be allocated...
+      value* const v = new_value<TC, true, TN>();
+      if (v) {
+        // Encode integer.
+        v->encode_integer(val);
+
+        // Set value's parent.
+        v->parent(_M_parent);
+
+        // Add length to the parent's.
+        add_length(v->total_length());
+
+        return true;
+      }
+
+      return false;
+    }
+
+    template<tag_class TC, uint32_t TN>
+    inline bool encoder::add_data(const void* val, size_t len, copy cp)
+    {
+      // Deep copy?
+      if (cp == copy::deep) {
+        // Copy data to the data arena.
+        size_t offset;
+        if (copy_data(val, len, offset)) {
+          // If the value could be allocated...
+          value* const v = new_value<TC, true, TN>();
+          if (v) {
+            // Encode data.
+            v->encode_copied_data(offset, len);
+
+            // Set value's parent.
+            v->parent(_M_parent);
+
+            // Add length to the parent's.
+            add_length(v->total_length());
+
+            return true;
+          }
+
+          // Release the copy.
+          _M_data_used = offset;
+        }
+      } else {
+        // If the value could be allocated...
+        value* const v = new_value<TC, true, TN>();
+        if (v) {
+          // Encode data.
+          v->encode_data(val, len);
+
+          // Set value's parent.
+          v->parent(_M_parent);
+
+          // Add length to the parent's.
+          add_length(v->total_length());
+
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    template<tag_class TC, uint32_t TN>
+    inline bool encoder::add_null()
+    {
+      // If the value could be allocated...
+      value* const v = new_value<TC, true, TN>();
+      if (v) {
+        // Encode null.
+        v->encode_null();
+
+        // Set value's parent.
+        v->parent(_M_parent);
+
+        // Add length to the parent's.
+        add_length(v->total_length());
+
+        return true;
+      }
+
+      return false;
+    }
+
+    template<tag_class TC, uint32_t TN>
+    inline bool encoder::start_constructed()
+    {
+      // If the value could be allocated...
+      value* const v = new_value<TC, false, TN>();
+      if (v) {
+        // Encode constructed.
+        v->encode_constructed();
+
+        // Set value's parent.
+        v->parent(_M_parent);
+
+        _M_parent = _M_nvalues - 1;
+
+        return true;
+      }
+
+      return false;
+    }
+
+    template<tag_class TC, uint32_t TN>
+    inline bool encoder::add_generalized_time(const struct timeval& tv)
+    {
+      // If the value could be allocated...
+      value* const v = new_value<TC, true, TN>();
+      if (v) {
+        // Encode generalized time.
+        v->encode_generalized_time(tv);
+
+        // Set value's parent.
+        v->parent(_M_parent);
+
+        // Add length to the parent's.
+        add_length(v->total_length());
+
+        return true;
+      }
+
+      return false;
+    }
+
+    inline constexpr uint8_t encoder::identifier_octet(tag_class tc,
+                                                       bool primitive,
+                                                       uint32_t tn,
+                                                       size_t len,
+                                                       size_t n)
+    {
+      // The first octet contains the tag class, the primitive/constructed
+      // bit and either the tag number or 0x1f; the following octets contain
+      // the tag number (7 bits per octet, the most significant first).
+      return (n == 0) ?
+               static_cast<uint8_t>((static_cast<uint8_t>(tc) << 6) |
+                                    (primitive ? 0x00 : 0x20) |
+                                    ((tn < 31) ? tn : 0x1f)) :
+             (n < len) ?
+               static_cast<uint8_t>(((n == len - 1) ? 0x00 : 0x80) |
+                                    ((tn >> (7 * (len - 1 - n))) & 0x7f)) :
+               0;
+    }
+
+    template<tag_class TC, bool Primitive, uint32_t TN>
+    constexpr const uint8_t
+    encoder::identifier<TC, Primitive, TN>::octets[max_identifier_length];
+
+    inline void encoder::value::identifier(const uint8_t* tag, size_t taglen)
+    {
+      memcpy(_M_tag, tag, taglen);
+      _M_taglen = taglen;
+    }
+
+    inline void encoder::add_length(size_t len)
+    {
+      // If the value has a parent...
+      if (_M_parent != -1) {
+        _M_values[_M_parent].add_value_length(len);
+      }
+    }
   }
 }
 
@@ -0,0 +1,121 @@
+#include "asn1/ber/framer.h"
+#include "asn1/ber/header.h"
+
+asn1::ber::decoder::result asn1::ber::framer::next(size_t& length)
+{
+  // If not at the end of the data...
+  if (_M_offset < _M_length) {
+    size_t offset = _M_offset;
+
+    // Decode identifier and length octets.
+    header hdr;
+    decoder::result res = hdr.decode(_M_data, _M_length, offset);
+
+    // If the header could be decoded...
+    if (res == decoder::result::no_error) {
+      // Definite length?
+      if (hdr.definite_length) {
+        // If the contents octets fit in the buffer...
+        if (hdr.length <= _M_length - offset) {
+          offset += hdr.length;
+        } else {
+          return decoder::result::unexpected_eof;
+        }
+      } else {
+        // Find end-of-contents.
+        if ((res = find_eoc(_M_data, _M_length, offset)) ==
+            decoder::result::no_error) {
+          // Skip end-of-contents.
+          offset += 2;
+        } else {
+          return res;
+        }
+      }
+
+      length = offset - _M_offset;
+
+      _M_offset = offset;
+
+      return decoder::result::no_error;
+    }
+
+    return res;
+  } else {
+    return decoder::result::eof;
+  }
+}
+
+asn1::ber::decoder::result asn1::ber::framer::find_eoc(const uint8_t* data,
+                                                      size_t length,
+                                                      size_t& offset)
+{
+  // Number of open indefinite-length values.
+  size_t nested = 1;
+
+  size_t off = offset;
+
+  // While the end of the data has not been reached...
+  while (off < length) {
+    // Save identifier octet.
+    const uint8_t idoctet = data[off];
+
+    size_t len;
+    bool definite_length;
+
+    // If the tag number fits in the identifier octet and the length is
+    // either short or indefinite (most common case)...
+    uint8_t lenoctet;
+    if (((idoctet & 0x1fu) != 0x1fu) &&
+        (off + 1 < length) &&
+        (((lenoctet = data[off + 1]) < 0x80u) ||
+         ((lenoctet == 0x80u) && ((idoctet & 0x20u) != 0)))) {
+      len = lenoctet & 0x7fu;
+      definite_length = (lenoctet != 0x80u);
+
+      off += 2;
+    } else {
+      // Decode identifier and length octets.
+      header hdr;
+      const decoder::result res = hdr.decode(data, length, off);
+
+      // If the header couldn't be decoded...
+      if (res != decoder::result::no_error) {
+        return res;
+      }
+
+      len = hdr.length;
+      definite_length = hdr.definite_length;
+    }
+
+    // Definite length?
+    if (definite_length) {
+      // If the contents octets fit in the buffer...
+      if (len <= length - off) {
+        // If not the end-of-contents...
+        if (idoctet != 0) {
+          // Skip contents octets.
+          off += len;
+        } else if (len == 0) {
+          // If this is the end-of-contents of the outermost value...
+          if (--nested == 0) {
+            // Make `offset` point to end-of-contents.
+            offset = off - 2;
+
+            return decoder::result::no_error;
+          }
+        } else {
+          return decoder::result::invalid_length;
+        }
+      } else {
+        return decoder::result::unexpected_eof;
+      }
+    } else if (nested < max_nested_eoc) {
+      // Enter nested indefinite-length value.
+      nested++;
+    } else {
+      return decoder::result::max_nested_eoc_exceeded;
+    }
+  }
+
+  return decoder::result::unexpected_eof;
+}
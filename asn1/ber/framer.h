@@ -0,0 +1,66 @@
+#ifndef ASN1_BER_FRAMER_H
+#define ASN1_BER_FRAMER_H
+
+#include "asn1/ber/decoder.h"
+
+namespace asn1 {
+  namespace ber {
+    // ASN.1 BER framer.
+    //
+    // Finds the boundaries of the top-level values (records) without decoding
+    // them: only the outer identifier and length octets are decoded and, for
+    // indefinite-length values, the contents are scanned (without recursion)
+    // for the matching end-of-contents. It returns the same results as
+    // `decoder::next()`, with a footprint of a few words.
+    class framer {
+      public:
+        // Maximum number of nested end-of-contents.
+        static constexpr const size_t max_nested_eoc = 128;
+
+        // Constructor.
+        framer(const void* data, size_t length);
+        framer(const framer&) = default;
+
+        // Destructor.
+        ~framer() = default;
+
+        // Assignment operator.
+        framer& operator=(const framer&) = default;
+
+        // Get length of the next record.
+        decoder::result next(size_t& length);
+
+        // Get offset (end of the last record).
+        size_t offset() const;
+
+        // Find end-of-contents (`offset` points to the contents octets of an
+        // indefinite-length value and is made point to its end-of-contents).
+        static decoder::result find_eoc(const uint8_t* data,
+                                        size_t length,
+                                        size_t& offset);
+
+      private:
+        // Pointer to the data.
+        const uint8_t* _M_data;
+
+        // Length.
+        size_t _M_length;
+
+        // Offset.
+        size_t _M_offset = 0;
+    };
+
+    inline framer::framer(const void* data, size_t length)
+      : _M_data(static_cast<const uint8_t*>(data)),
+        _M_length(length)
+    {
+    }
+
+    inline size_t framer::offset() const
+    {
+      return _M_offset;
+    }
+  }
+}
+
+#endif // ASN1_BER_FRAMER_H
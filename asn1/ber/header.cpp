@@ -0,0 +1,81 @@
+#include "asn1/ber/header.h"
+
+asn1::ber::decoder::result asn1::ber::header::decode(const uint8_t* data,
+                                                    size_t len,
+                                                    size_t& offset)
+{
+  const uint8_t idoctet = data[offset++];
+
+  tag_class = static_cast<enum tag_class>((idoctet >> 6) & 0x03u);
+  constructed = ((idoctet & 0x20u) != 0);
+
+  // Extract tag number.
+  uint32_t tn = idoctet & 0x1fu;
+
+  // If the tag number doesn't fit in the identifier octet...
+  if (tn == 0x1fu) {
+    tn = 0;
+
+    do {
+      // If at the end of the data...
+      if (offset == len) {
+        return decoder::result::unexpected_eof;
+      }
+
+      // If the tag number is too big...
+      if (((tn >> (32 - 7)) & 0x7fu) != 0) {
+        return decoder::result::invalid_tag_number;
+      }
+
+      tn = (tn << 7) | (data[offset] & 0x7fu);
+    } while ((data[offset++] & 0x80u) != 0);
+  }
+
+  tag_number = tn;
+
+  // If at the end of the data...
+  if (offset == len) {
+    return decoder::result::unexpected_eof;
+  }
+
+  // If the length fits in seven bits...
+  if ((data[offset] & 0x80u) == 0) {
+    length = data[offset++];
+    definite_length = true;
+
+    return decoder::result::no_error;
+  }
+
+  // Get the number of subsequent octets.
+  const size_t noctets = data[offset++] & 0x7fu;
+
+  // If the number of octets is not too big...
+  if (noctets < 5) {
+    // If not the indefinite length...
+    if (noctets > 0) {
+      // If the whole length is in the buffer...
+      if (noctets <= len - offset) {
+        size_t l = 0;
+
+        for (size_t i = noctets; i > 0; i--) {
+          l = (l << 8) | data[offset++];
+        }
+
+        length = l;
+        definite_length = true;
+
+        return decoder::result::no_error;
+      } else {
+        return decoder::result::unexpected_eof;
+      }
+    } else if (constructed) {
+      // Indefinite length (only allowed for constructed values).
+      length = 0;
+      definite_length = false;
+
+      return decoder::result::no_error;
+    }
+  }
+
+  return decoder::result::invalid_length;
+}
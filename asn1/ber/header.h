@@ -0,0 +1,34 @@
+#ifndef ASN1_BER_HEADER_H
+#define ASN1_BER_HEADER_H
+
+#include "asn1/ber/decoder.h"
+
+namespace asn1 {
+  namespace ber {
+    // Identifier and length octets of a data value.
+    struct header {
+      // Tag class.
+      enum tag_class tag_class;
+
+      // Constructed?
+      bool constructed;
+
+      // Tag number.
+      uint32_t tag_number;
+
+      // Length of the contents octets (0 if indefinite).
+      size_t length;
+
+      // Definite length?
+      bool definite_length;
+
+      // Decode identifier and length octets at `data + offset` (`offset` is
+      // made point to the contents octets).
+      decoder::result decode(const uint8_t* data,
+                             size_t length,
+                             size_t& offset);
+    };
+  }
+}
+
+#endif // ASN1_BER_HEADER_H
@@ -0,0 +1,545 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include "asn1/ber/json_printer.h"
+
+// Hexadecimal digits.
+static const char hex_digits[] = "0123456789abcdef";
+
+// Length of the UTF-8 sequence starting with the non-ASCII octet `data[0]`
+// (0 if it is not a well-formed sequence: unexpected continuation octet,
+// truncated sequence, overlong form, surrogate or value above U+10FFFF).
+static size_t utf8_sequence_length(const uint8_t* data, size_t len);
+
+bool asn1::ber::json_printer::print(size_t offset,
+                                    decoder& decoder,
+                                    size_t& len)
+{
+  const size_t start = _M_out->length();
+
+  // Print data value.
+  const bool ret = print_value(offset, decoder, len);
+
+  // If the data value couldn't be printed...
+  if (!ret) {
+    // Discard the output of the data value.
+    _M_out->resize(start);
+  }
+
+  // If the output for the standard output has to be written...
+  if ((_M_out == &_M_buf) && ((!ret) || (_M_buf.length() >= flush_size))) {
+    flush();
+  }
+
+  return ret;
+}
+
+bool asn1::ber::json_printer::flush()
+{
+  // If there is pending output...
+  if (!_M_buf.empty()) {
+    const size_t len = _M_buf.length();
+    const bool ret = (fwrite(_M_buf.data(), 1, len, stdout) == len);
+
+    _M_buf.clear();
+
+    return ret;
+  }
+
+  return true;
+}
+
+bool asn1::ber::json_printer::print_value(size_t offset,
+                                          decoder& decoder,
+                                          size_t& len)
+{
+  _M_ntags = 0;
+
+  // Get data value.
+  value val;
+  switch (decoder.next(val)) {
+    case decoder::result::no_error:
+      if (_M_separator) {
+        write(",\n");
+      }
+
+      write("{\"offset\":");
+      write_unsigned(offset);
+      write(",");
+
+      // Print data value.
+      if ((print_key(val, 0)) && (print(decoder, val))) {
+        write(_M_array ? "}" : "}\n");
+
+        _M_separator = _M_array;
+
+        // Save total length of the data value.
+        len = val.total_length();
+
+        return true;
+      }
+
+      break;
+    case decoder::result::eof:
+      _M_eof = true;
+      break;
+    default:
+      break;
+  }
+
+  return false;
+}
+
+bool asn1::ber::json_printer::print(decoder& decoder, const value& val)
+{
+  // Primitive?
+  if (val.primitive()) {
+    return print_primitive(val);
+  }
+
+  // Enter constructed.
+  if (!decoder.enter_constructed()) {
+    return false;
+  }
+
+  write("{");
+
+  // Index of the first tag seen among the child data values.
+  const size_t first = _M_ntags;
+
+  do {
+    // Get next data value.
+    value child;
+    switch (decoder.next(child)) {
+      case decoder::result::no_error:
+        // If it is not the first child data value...
+        if (_M_ntags > first) {
+          write(",");
+        }
+
+        // Print child data value.
+        if ((!print_key(child, first)) || (!print(decoder, child))) {
+          return false;
+        }
+
+        break;
+      case decoder::result::eof:
+        _M_ntags = first;
+
+        // Leave constructed.
+        decoder.leave_constructed();
+
+        write("}");
+
+        return true;
+      default:
+        return false;
+    }
+  } while (true);
+}
+
+bool asn1::ber::json_printer::print_primitive(const value& val)
+{
+  // If not universal...
+  if (val.tag_class() != tag_class::Universal) {
+    print_hexadecimal(val);
+    return true;
+  }
+
+  switch (val.tag_number()) {
+    case static_cast<uint32_t>(type::Boolean):
+      {
+        // Decode boolean.
+        bool b;
+        if (val.decode_boolean(b)) {
+          write(b ? "true" : "false");
+          return true;
+        }
+      }
+
+      break;
+    case static_cast<uint32_t>(type::Integer):
+      {
+        // Decode integer.
+        int64_t n;
+        if (val.decode_integer(n)) {
+          write_signed(n);
+          return true;
+        }
+      }
+
+      break;
+    case static_cast<uint32_t>(type::Null):
+      // Decode null.
+      if (val.decode_null()) {
+        write("null");
+        return true;
+      }
+
+      break;
+    case static_cast<uint32_t>(type::ObjectIdentifier):
+      {
+        // Decode OID.
+        uint32_t components[value::max_oid_components];
+        size_t ncomponents;
+        if (val.decode_oid(components, ncomponents)) {
+          write("\"");
+
+          for (size_t i = 0; i < ncomponents; i++) {
+            if (i > 0) {
+              write(".");
+            }
+
+            write_unsigned(components[i]);
+          }
+
+          write("\"");
+
+          return true;
+        }
+      }
+
+      break;
+    case static_cast<uint32_t>(type::Enumerated):
+      {
+        // Decode enumerated.
+        int64_t n;
+        if (val.decode_enumerated(n)) {
+          write_signed(n);
+          return true;
+        }
+      }
+
+      break;
+    case static_cast<uint32_t>(type::UTCTime):
+      {
+        // Decode UTCTime.
+        time_t t;
+        if (val.decode_utc_time(t)) {
+          print_utc_time(t);
+          return true;
+        }
+      }
+
+      break;
+    case static_cast<uint32_t>(type::GeneralizedTime):
+      {
+        // Decode GeneralizedTime.
+        struct timeval tv;
+        if (val.decode_generalized_time(tv)) {
+          print_generalized_time(tv);
+          return true;
+        }
+      }
+
+      break;
+    case static_cast<uint32_t>(type::UTF8String):
+      print_string(val, true);
+      return true;
+    case static_cast<uint32_t>(type::ObjectDescriptor):
+    case static_cast<uint32_t>(type::NumericString):
+    case static_cast<uint32_t>(type::PrintableString):
+    case static_cast<uint32_t>(type::TeletexString):
+    case static_cast<uint32_t>(type::VideotexString):
+    case static_cast<uint32_t>(type::IA5String):
+    case static_cast<uint32_t>(type::GraphicString):
+    case static_cast<uint32_t>(type::VisibleString):
+    case static_cast<uint32_t>(type::GeneralString):
+      print_string(val, false);
+      return true;
+    default:
+      print_hexadecimal(val);
+      return true;
+  }
+
+  fprintf(stderr,
+          "Error decoding '%s'.\n",
+          to_string(static_cast<type>(val.tag_number())));
+
+  return false;
+}
+
+bool asn1::ber::json_printer::print_key(const value& val, size_t first)
+{
+  // Search the tag among the tags of the siblings.
+  size_t count = 0;
+  size_t i;
+  for (i = first; i < _M_ntags; i++) {
+    if ((_M_tags[i].tag_number == val.tag_number()) &&
+        (_M_tags[i].tag_class == val.tag_class())) {
+      count = ++_M_tags[i].count;
+      break;
+    }
+  }
+
+  // If the tag has not been seen yet...
+  if (i == _M_ntags) {
+    // If the array of tags is full...
+    if (_M_ntags == _M_size) {
+      const size_t size = (_M_size == 0) ? initial_tags : _M_size * 2;
+
+      tag* const tags = static_cast<tag*>(realloc(_M_tags, size * sizeof(tag)));
+
+      if (!tags) {
+        fprintf(stderr, "Error allocating memory.\n");
+        return false;
+      }
+
+      _M_tags = tags;
+      _M_size = size;
+    }
+
+    _M_tags[_M_ntags].tag_class = val.tag_class();
+    _M_tags[_M_ntags].tag_number = val.tag_number();
+    _M_tags[_M_ntags].count = 0;
+
+    _M_ntags++;
+  }
+
+  switch (val.tag_class()) {
+    case tag_class::Universal:
+      write("\"[UNIVERSAL ");
+      break;
+    case tag_class::Application:
+      write("\"[APPLICATION ");
+      break;
+    case tag_class::Private:
+      write("\"[PRIVATE ");
+      break;
+    default:
+      write("\"[");
+      break;
+  }
+
+  write_unsigned(val.tag_number());
+
+  // If the tag is repeated...
+  if (count > 0) {
+    write("]#");
+    write_unsigned(count);
+    write("\":");
+  } else {
+    write("]\":");
+  }
+
+  return true;
+}
+
+void asn1::ber::json_printer::print_utc_time(time_t val)
+{
+#if !defined(_WIN32)
+  struct tm tm;
+  gmtime_r(&val, &tm);
+  const struct tm* const tmp = &tm;
+#else
+  const struct tm* const tmp = gmtime(&val);
+#endif
+
+  write_time(*tmp);
+  write("Z\"");
+}
+
+void asn1::ber::json_printer::print_generalized_time(const struct timeval& val)
+{
+#if !defined(_WIN32)
+  struct tm tm;
+  gmtime_r(&val.tv_sec, &tm);
+  const struct tm* const tmp = &tm;
+#else
+  const time_t t = val.tv_sec;
+  const struct tm* const tmp = gmtime(&t);
+#endif
+
+  write_time(*tmp);
+
+  if (val.tv_usec != 0) {
+    write(".");
+    write_unsigned(static_cast<unsigned>(val.tv_usec), 6);
+  }
+
+  write("Z\"");
+}
+
+void asn1::ber::json_printer::print_string(const value& val, bool utf8)
+{
+  write("\"");
+
+  const uint8_t* const data = static_cast<const uint8_t*>(val.data());
+  const size_t len = val.length();
+
+  // Beginning of the characters which don't have to be escaped.
+  size_t start = 0;
+
+  for (size_t i = 0; i < len; i++) {
+    const uint8_t c = data[i];
+
+    // If the character doesn't have to be escaped...
+    if ((c >= 0x20) && (c < 0x7f) && (c != '"') && (c != '\\')) {
+      continue;
+    }
+
+    // If the character is a well-formed UTF-8 sequence...
+    if ((c >= 0x80) && (utf8)) {
+      const size_t n = utf8_sequence_length(data + i, len - i);
+      if (n > 0) {
+        i += n - 1;
+        continue;
+      }
+    }
+
+    write(reinterpret_cast<const char*>(data) + start, i - start);
+    start = i + 1;
+
+    switch (c) {
+      case '"':
+        write("\\\"");
+        break;
+      case '\\':
+        write("\\\\");
+        break;
+      case '\n':
+        write("\\n");
+        break;
+      case '\r':
+        write("\\r");
+        break;
+      case '\t':
+        write("\\t");
+        break;
+      default:
+        {
+          const char escape[] = {
+            '\\', 'u', '0', '0', hex_digits[c >> 4], hex_digits[c & 0x0f]
+          };
+
+          write(escape, sizeof(escape));
+        }
+
+        break;
+    }
+  }
+
+  write(reinterpret_cast<const char*>(data) + start, len - start);
+
+  write("\"");
+}
+
+void asn1::ber::json_printer::print_hexadecimal(const value& val)
+{
+  write("\"");
+
+  const uint8_t* data = static_cast<const uint8_t*>(val.data());
+  size_t left = val.length();
+
+  while (left > 0) {
+    char hex[64];
+    const size_t n = (left < sizeof(hex) / 2) ? left : sizeof(hex) / 2;
+
+    for (size_t i = 0; i < n; i++) {
+      hex[i * 2] = hex_digits[data[i] >> 4];
+      hex[(i * 2) + 1] = hex_digits[data[i] & 0x0f];
+    }
+
+    write(hex, n * 2);
+
+    data += n;
+    left -= n;
+  }
+
+  write("\"");
+}
+
+void asn1::ber::json_printer::write_unsigned(uint64_t n, size_t width)
+{
+  // Convert to decimal (from the last digit).
+  char digits[max_digits];
+  char* const end = digits + max_digits;
+  char* p = end;
+
+  do {
+    *--p = static_cast<char>('0' + (n % 10));
+    n /= 10;
+  } while (n > 0);
+
+  // Pad with zeros.
+  const size_t len = end - p;
+  if (len < width) {
+    _M_out->append(width - len, '0');
+  }
+
+  write(p, len);
+}
+
+void asn1::ber::json_printer::write_signed(int64_t n)
+{
+  if (n >= 0) {
+    write_unsigned(static_cast<uint64_t>(n));
+  } else {
+    write("-");
+    write_unsigned(0 - static_cast<uint64_t>(n));
+  }
+}
+
+void asn1::ber::json_printer::write_time(const struct tm& tm)
+{
+  write("\"");
+  write_unsigned(static_cast<unsigned>(1900 + tm.tm_year), 4);
+  write("-");
+  write_unsigned(static_cast<unsigned>(1 + tm.tm_mon), 2);
+  write("-");
+  write_unsigned(static_cast<unsigned>(tm.tm_mday), 2);
+  write("T");
+  write_unsigned(static_cast<unsigned>(tm.tm_hour), 2);
+  write(":");
+  write_unsigned(static_cast<unsigned>(tm.tm_min), 2);
+  write(":");
+  write_unsigned(static_cast<unsigned>(tm.tm_sec), 2);
+}
+
+size_t utf8_sequence_length(const uint8_t* data, size_t len)
+{
+  // Length of the sequence and range of the second octet (which excludes the
+  // overlong forms, the surrogates and the values above U+10FFFF).
+  size_t n;
+  uint8_t min = 0x80;
+  uint8_t max = 0xbf;
+
+  if ((data[0] >= 0xc2) && (data[0] <= 0xdf)) {
+    n = 2;
+  } else if ((data[0] >= 0xe0) && (data[0] <= 0xef)) {
+    n = 3;
+
+    if (data[0] == 0xe0) {
+      min = 0xa0;
+    } else if (data[0] == 0xed) {
+      max = 0x9f;
+    }
+  } else if ((data[0] >= 0xf0) && (data[0] <= 0xf4)) {
+    n = 4;
+
+    if (data[0] == 0xf0) {
+      min = 0x90;
+    } else if (data[0] == 0xf4) {
+      max = 0x8f;
+    }
+  } else {
+    return 0;
+  }
+
+  // If the sequence is truncated...
+  if (len < n) {
+    return 0;
+  }
+
+  if ((data[1] < min) || (data[1] > max)) {
+    return 0;
+  }
+
+  // Check the remaining continuation octets.
+  for (size_t i = 2; i < n; i++) {
+    if ((data[i] & 0xc0) != 0x80) {
+      return 0;
+    }
+  }
+
+  return n;
+}
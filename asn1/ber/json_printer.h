@@ -0,0 +1,210 @@
+#ifndef ASN1_BER_JSON_PRINTER_H
+#define ASN1_BER_JSON_PRINTER_H
+
+#include <stdlib.h>
+#include "asn1/ber/decoder.h"
+#include "string/buffer.h"
+
+namespace asn1 {
+  namespace ber {
+    // ASN.1 BER printer for JSON.
+    //
+    // Each record is printed as one JSON object: the offset of the record and
+    // the top-level value keyed by its tag. The contents of a constructed
+    // value are an object with a member per child value, keyed by its tag in
+    // the syntax of the path queries ("[UNIVERSAL 16]", "[APPLICATION 1]",
+    // "[PRIVATE 2]", "[3]" for context-specific); the n-th (0-based, n > 0)
+    // repetition of a tag among its siblings is keyed "<tag>#<n>".
+    //
+    // Primitive values are typed: booleans, integers and enumerated values
+    // are JSON booleans and numbers, NULL is null, object identifiers and
+    // times are strings ("1.2.840.113549", "2024-05-17T08:30:00Z"),
+    // character strings are JSON strings and the other values are strings
+    // of hexadecimal digits.
+    //
+    // Example:
+    // {"offset":0,"[APPLICATION 1]":{"[0]":5,"[1]":"abc","[1]#1":"def"}}
+    //
+    // With `array` set, the records are printed as a JSON array (`begin()`,
+    // records separated by commas and new lines, `end()`); otherwise, the
+    // records are printed as newline-delimited JSON (NDJSON).
+    //
+    // Like `printer`, the output is printed to the standard output (in blocks)
+    // or to an output buffer.
+    class json_printer {
+      public:
+        // Constructor.
+        json_printer(bool array = false);
+
+        // Destructor.
+        ~json_printer();
+
+        // Set output buffer (nullptr: standard output).
+        void output(string::buffer* out);
+
+        // Print the beginning of the array (array only).
+        void begin();
+
+        // Print the end of the array (array only).
+        void end();
+
+        // Print a separator before the first record (array only; for output
+        // which continues the output of another printer).
+        void separator(bool sep);
+
+        // Print (on error, the output of the record is discarded).
+        bool print(size_t offset, const void* data, size_t& len);
+        bool print(size_t offset, decoder& decoder, size_t& len);
+
+        // Write the pending output to the standard output.
+        bool flush();
+
+        // End of file?
+        bool eof() const;
+
+      private:
+        // Size of the blocks written to the standard output.
+        static constexpr const size_t flush_size = 64 * 1024;
+
+        // Maximum number of digits of a 64-bit integer.
+        static constexpr const size_t max_digits = 20;
+
+        // Initial number of tags.
+        static constexpr const size_t initial_tags = 64;
+
+        // Print records as a JSON array?
+        const bool _M_array;
+
+        // Print separator before the next record?
+        bool _M_separator = false;
+
+        // End of file?
+        bool _M_eof = false;
+
+        // Buffer for the standard output.
+        string::buffer _M_buf;
+
+        // Output buffer (`_M_buf` for the standard output).
+        string::buffer* _M_out;
+
+        // Tag seen among the siblings of the current constructed values.
+        struct tag {
+          enum tag_class tag_class;
+          uint32_t tag_number;
+
+          // Number of repetitions.
+          size_t count;
+        };
+
+        tag* _M_tags = nullptr;
+        size_t _M_size = 0;
+        size_t _M_ntags = 0;
+
+        // Print data value.
+        bool print_value(size_t offset, decoder& decoder, size_t& len);
+
+        // Print the contents of a data value.
+        bool print(decoder& decoder, const value& val);
+
+        // Print primitive.
+        bool print_primitive(const value& val);
+
+        // Print key of a data value (`first`: index of the first tag seen
+        // among its siblings).
+        bool print_key(const value& val, size_t first);
+
+        void print_utc_time(time_t val);
+        void print_generalized_time(const struct timeval& val);
+
+        // Print string (`utf8`: copy the well-formed non-ASCII UTF-8
+        // sequences as they are; otherwise, and for the octets which are not
+        // part of a well-formed sequence, the octets are printed as Latin-1
+        // characters).
+        void print_string(const value& val, bool utf8);
+
+        // Print in hexadecimal.
+        void print_hexadecimal(const value& val);
+
+        // Write string.
+        void write(const char* s);
+        void write(const char* s, size_t len);
+
+        // Write unsigned integer (padded with zeros to `width` digits).
+        void write_unsigned(uint64_t n, size_t width = 1);
+
+        // Write signed integer.
+        void write_signed(int64_t n);
+
+        // Write date and time.
+        void write_time(const struct tm& tm);
+
+        // Disable copy constructor and assignment operator.
+        json_printer(const json_printer&) = delete;
+        json_printer& operator=(const json_printer&) = delete;
+    };
+
+    inline json_printer::json_printer(bool array)
+      : _M_array(array),
+        _M_out(&_M_buf)
+    {
+    }
+
+    inline json_printer::~json_printer()
+    {
+      flush();
+      free(_M_tags);
+    }
+
+    inline void json_printer::output(string::buffer* out)
+    {
+      // Write the pending output to the standard output (if any).
+      flush();
+
+      _M_out = out ? out : &_M_buf;
+    }
+
+    inline void json_printer::begin()
+    {
+      if (_M_array) {
+        write("[");
+      }
+    }
+
+    inline void json_printer::end()
+    {
+      if (_M_array) {
+        write("]\n");
+      }
+    }
+
+    inline void json_printer::separator(bool sep)
+    {
+      _M_separator = (_M_array) && (sep);
+    }
+
+    inline bool json_printer::print(size_t offset,
+                                    const void* data,
+                                    size_t& len)
+    {
+      decoder decoder(data, len);
+      return print(offset, decoder, len);
+    }
+
+    inline bool json_printer::eof() const
+    {
+      return _M_eof;
+    }
+
+    inline void json_printer::write(const char* s)
+    {
+      _M_out->append(s, strlen(s));
+    }
+
+    inline void json_printer::write(const char* s, size_t len)
+    {
+      _M_out->append(s, len);
+    }
+  }
+}
+
+#endif // ASN1_BER_JSON_PRINTER_H
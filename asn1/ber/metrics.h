@@ -0,0 +1,41 @@
+#ifndef ASN1_BER_METRICS_H
+#define ASN1_BER_METRICS_H
+
+#include "asn1/ber/decoder.h"
+#include "util/counter.h"
+#include "util/histogram.h"
+
+namespace asn1 {
+  namespace ber {
+    // Metrics of a worker thread (only updated by the worker thread itself;
+    // aligned to a cache line to avoid false sharing between workers).
+    struct alignas(64) metrics {
+      // Number of connections accepted.
+      util::counter connections_accepted;
+
+      // Number of connections closed.
+      util::counter connections_closed;
+
+      // Number of bytes read.
+      util::counter bytes_read;
+
+      // Number of framing results (indexed by `decoder::result`).
+      util::counter records[decoder::number_results];
+
+      // Number of bytes framed.
+      util::counter bytes_framed;
+
+      // Highest number of bytes buffered by a connection.
+      util::counter buffer_high_water_mark;
+
+      // Number of batches which couldn't be created.
+      util::counter batch_errors;
+
+      // Latencies between the reception of the records and their framing
+      // (microseconds).
+      util::histogram latencies;
+    };
+  }
+}
+
+#endif // ASN1_BER_METRICS_H
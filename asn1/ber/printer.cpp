@@ -1,9 +1,11 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <ctype.h>
-#include <inttypes.h>
 #include "asn1/ber/printer.h"
 
+// Hexadecimal digits.
+static const char hex_digits[] = "0123456789abcdef";
+
 bool asn1::ber::printer::print(size_t offset, const void* data, size_t& len)
 {
   decoder decoder(data, len);
@@ -11,6 +13,36 @@ bool asn1::ber::printer::print(size_t offset, const void* data, size_t& len)
 }
 
 bool asn1::ber::printer::print(size_t offset, decoder& decoder, size_t& len)
+{
+  // Print data value.
+  const bool ret = print_value(offset, decoder, len);
+
+  // If the output for the standard output has to be written...
+  if ((_M_out == &_M_buf) && ((!ret) || (_M_buf.length() >= flush_size))) {
+    flush();
+  }
+
+  return ret;
+}
+
+bool asn1::ber::printer::flush()
+{
+  // If there is pending output...
+  if (!_M_buf.empty()) {
+    const size_t len = _M_buf.length();
+    const bool ret = (fwrite(_M_buf.data(), 1, len, stdout) == len);
+
+    _M_buf.clear();
+
+    return ret;
+  }
+
+  return true;
+}
+
+bool asn1::ber::printer::print_value(size_t offset,
+                                     decoder& decoder,
+                                     size_t& len)
 {
   // Get data value.
   value val;
@@ -70,7 +102,7 @@ void asn1::ber::printer::enter_constructed(decoder& decoder, size_t depth) const
   decoder.enter_constructed();
 
   indent(depth);
-  printf("{\n");
+  write("{\n");
 }
 
 void asn1::ber::printer::leave_constructed(decoder& decoder, size_t depth) const
@@ -79,7 +111,7 @@ void asn1::ber::printer::leave_constructed(decoder& decoder, size_t depth) const
   decoder.leave_constructed();
 
   indent(depth);
-  printf("}\n");
+  write("}\n");
 }
 
 bool asn1::ber::printer::print(decoder& decoder, size_t depth) const
@@ -126,12 +158,15 @@ bool asn1::ber::printer::print_primitive(const value& value, size_t depth) const
 
   // Universal?
   if (value.tag_class() == tag_class::Universal) {
-    printf("[Primitive] Tag class: %s, tag: %s, length: %zu, total length: "
-           "%zu\n",
-           to_string(value.tag_class()),
-           to_string(static_cast<type>(value.tag_number())),
-           value.length(),
-           value.total_length());
+    write("[Primitive] Tag class: ");
+    write(to_string(value.tag_class()));
+    write(", tag: ");
+    write(to_string(static_cast<type>(value.tag_number())));
+    write(", length: ");
+    write_unsigned(value.length());
+    write(", total length: ");
+    write_unsigned(value.total_length());
+    write("\n");
 
     switch (value.tag_number()) {
       case static_cast<uint32_t>(type::Boolean):
@@ -247,12 +282,15 @@ bool asn1::ber::printer::print_primitive(const value& value, size_t depth) const
         break;
     }
   } else {
-    printf("[Primitive] Tag class: %s, tag number: %u, length: %zu, total "
-           "length: %zu\n",
-           to_string(value.tag_class()),
-           value.tag_number(),
-           value.length(),
-           value.total_length());
+    write("[Primitive] Tag class: ");
+    write(to_string(value.tag_class()));
+    write(", tag number: ");
+    write_unsigned(value.tag_number());
+    write(", length: ");
+    write_unsigned(value.length());
+    write(", total length: ");
+    write_unsigned(value.total_length());
+    write("\n");
 
     print_ascii(value, depth);
   }
@@ -267,78 +305,105 @@ void asn1::ber::printer::print_constructed(const value& value,
 {
   indent(depth);
 
+  write(to_string(value.tag_class()));
+  write(": ");
+
   if (value.tag_class() == tag_class::Universal) {
-    printf("%s: %s, length: %zu, total length: %zu\n",
-           to_string(value.tag_class()),
-           to_string(static_cast<type>(value.tag_number())),
-           value.length(),
-           value.total_length());
+    write(to_string(static_cast<type>(value.tag_number())));
   } else {
-    printf("%s: %u, length: %zu, total length: %zu\n",
-           to_string(value.tag_class()),
-           value.tag_number(),
-           value.length(),
-           value.total_length());
+    write_unsigned(value.tag_number());
   }
+
+  write(", length: ");
+  write_unsigned(value.length());
+  write(", total length: ");
+  write_unsigned(value.total_length());
+  write("\n");
 }
 
 void asn1::ber::printer::print_ascii(const value& value, size_t depth) const
 {
   indent(depth);
-  printf("  Value:");
+  write("  Value:");
+
+  const uint8_t* data = static_cast<const uint8_t*>(value.data());
+  size_t left = value.length();
 
-  const uint8_t* const data = static_cast<const uint8_t*>(value.data());
+  while (left > 0) {
+    const size_t n = (left < number_ascii_chars_per_line) ?
+                       left :
+                       number_ascii_chars_per_line;
 
-  for (size_t i = 0; i < value.length(); i++) {
-    if ((i % number_ascii_chars_per_line) == 0) {
-      printf("\n");
-      indent(depth);
-      printf("    ");
+    // Build line.
+    char line[number_ascii_chars_per_line];
+    for (size_t i = 0; i < n; i++) {
+      line[i] = isprint(data[i]) ? static_cast<char>(data[i]) : '.';
     }
 
-    printf("%c", isprint(data[i]) ? static_cast<char>(data[i]) : '.');
+    write("\n");
+    indent(depth);
+    write("    ");
+    write(line, n);
+
+    data += n;
+    left -= n;
   }
 
-  printf("\n\n");
+  write("\n\n");
 }
 
 void asn1::ber::printer::print_hexadecimal(const value& value,
                                            size_t depth) const
 {
   indent(depth);
-  printf("  Hexadecimal:");
-
-  const uint8_t* const data = static_cast<const uint8_t*>(value.data());
-
-  for (size_t i = 0; i < value.length(); i++) {
-    if ((i % number_hex_chars_per_line) == 0) {
-      printf("\n");
-      indent(depth);
-      printf("   ");
+  write("  Hexadecimal:");
+
+  const uint8_t* data = static_cast<const uint8_t*>(value.data());
+  size_t left = value.length();
+
+  while (left > 0) {
+    const size_t n = (left < number_hex_chars_per_line) ?
+                       left :
+                       number_hex_chars_per_line;
+
+    // Build line.
+    char line[number_hex_chars_per_line * 3];
+    for (size_t i = 0; i < n; i++) {
+      line[i * 3] = ' ';
+      line[(i * 3) + 1] = hex_digits[data[i] >> 4];
+      line[(i * 3) + 2] = hex_digits[data[i] & 0x0f];
     }
 
-    printf(" %02x", data[i]);
+    write("\n");
+    indent(depth);
+    write("   ");
+    write(line, n * 3);
+
+    data += n;
+    left -= n;
   }
 
-  printf("\n");
+  write("\n");
 }
 
 void asn1::ber::printer::print_boolean(bool val, size_t depth) const
 {
   indent(depth);
-  printf("  Value:\n");
+  write("  Value:\n");
 
   indent(depth);
-  printf("    %s\n\n", val ? "true" : "false");
+  write(val ? "    true\n\n" : "    false\n\n");
 }
 
 void asn1::ber::printer::print_integer(int64_t val, size_t depth) const
 {
   indent(depth);
-  printf("  Value:\n");
+  write("  Value:\n");
 
   indent(depth);
-  printf("    %" PRId64 "\n\n", val);
+  write("    ");
+  write_signed(val);
+  write("\n\n");
 }
 
 void asn1::ber::printer::print_oid(const uint32_t* val,
@@ -346,22 +411,26 @@ void asn1::ber::printer::print_oid(const uint32_t* val,
                                    size_t depth) const
 {
   indent(depth);
-  printf("  Value:\n");
+  write("  Value:\n");
 
   indent(depth);
-  printf("    ");
+  write("    ");
 
   for (size_t i = 0; i < ncomponents; i++) {
-    printf("%s%u", (i > 0) ? "." : "", val[i]);
+    if (i > 0) {
+      write(".");
+    }
+
+    write_unsigned(val[i]);
   }
 
-  printf("\n\n");
+  write("\n\n");
 }
 
 void asn1::ber::printer::print_utc_time(time_t val, size_t depth) const
 {
   indent(depth);
-  printf("  Value:\n");
+  write("  Value:\n");
 
   indent(depth);
 
@@ -373,20 +442,15 @@ void asn1::ber::printer::print_utc_time(time_t val, size_t depth) const
   const struct tm* const tmp = gmtime(&val);
 #endif
 
-  printf("    %04u/%02u/%02u %02u:%02u:%02u (UTC)\n\n",
-         1900 + tmp->tm_year,
-         1 + tmp->tm_mon,
-         tmp->tm_mday,
-         tmp->tm_hour,
-         tmp->tm_min,
-         tmp->tm_sec);
+  write_time(*tmp);
+  write(" (UTC)\n\n");
 }
 
 void asn1::ber::printer::print_generalized_time(const struct timeval& val,
                                                 size_t depth) const
 {
   indent(depth);
-  printf("  Value:\n");
+  write("  Value:\n");
 
   indent(depth);
 
@@ -399,42 +463,74 @@ void asn1::ber::printer::print_generalized_time(const struct timeval& val,
   const struct tm* const tmp = gmtime(&t);
 #endif
 
+  write_time(*tmp);
+
   if (val.tv_usec != 0) {
-    printf("    %04u/%02u/%02u %02u:%02u:%02u.%06u (UTC)\n\n",
-           1900 + tmp->tm_year,
-           1 + tmp->tm_mon,
-           tmp->tm_mday,
-           tmp->tm_hour,
-           tmp->tm_min,
-           tmp->tm_sec,
-           static_cast<unsigned>(val.tv_usec));
-  } else {
-    printf("    %04u/%02u/%02u %02u:%02u:%02u (UTC)\n\n",
-           1900 + tmp->tm_year,
-           1 + tmp->tm_mon,
-           tmp->tm_mday,
-           tmp->tm_hour,
-           tmp->tm_min,
-           tmp->tm_sec);
+    write(".");
+    write_unsigned(static_cast<unsigned>(val.tv_usec), 6);
   }
+
+  write(" (UTC)\n\n");
 }
 
-void asn1::ber::printer::indent(size_t depth) const
+void asn1::ber::printer::write_time(const struct tm& tm) const
 {
-  for (size_t i = depth * _M_tab_size; i > 0; i--) {
-    printf(" ");
-  }
+  write("    ");
+  write_unsigned(static_cast<unsigned>(1900 + tm.tm_year), 4);
+  write("/");
+  write_unsigned(static_cast<unsigned>(1 + tm.tm_mon), 2);
+  write("/");
+  write_unsigned(static_cast<unsigned>(tm.tm_mday), 2);
+  write(" ");
+  write_unsigned(static_cast<unsigned>(tm.tm_hour), 2);
+  write(":");
+  write_unsigned(static_cast<unsigned>(tm.tm_min), 2);
+  write(":");
+  write_unsigned(static_cast<unsigned>(tm.tm_sec), 2);
+}
+
+void asn1::ber::printer::print_header(size_t offset) const
+{
+  write("Offset: ");
+  write_unsigned(offset);
+  write("\n");
+  write("---------------------------------------------------------------------"
+        "-----------\n");
 }
 
-void asn1::ber::printer::print_header(size_t offset)
+void asn1::ber::printer::print_footer() const
 {
-  printf("Offset: %zu\n", offset);
-  printf("---------------------------------------------------------------------"
-         "-----------\n");
+  write("====================================================================="
+        "===========\n");
+}
+
+void asn1::ber::printer::write_unsigned(uint64_t n, size_t width) const
+{
+  // Convert to decimal (from the last digit).
+  char digits[max_digits];
+  char* const end = digits + max_digits;
+  char* p = end;
+
+  do {
+    *--p = static_cast<char>('0' + (n % 10));
+    n /= 10;
+  } while (n > 0);
+
+  // Pad with zeros.
+  const size_t len = end - p;
+  if (len < width) {
+    _M_out->append(width - len, '0');
+  }
+
+  write(p, len);
 }
 
-void asn1::ber::printer::print_footer()
+void asn1::ber::printer::write_signed(int64_t n) const
 {
-  printf("====================================================================="
-         "===========\n");
+  if (n >= 0) {
+    write_unsigned(static_cast<uint64_t>(n));
+  } else {
+    write("-");
+    write_unsigned(0 - static_cast<uint64_t>(n));
+  }
 }
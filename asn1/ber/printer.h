@@ -2,26 +2,37 @@
 #define ASN1_BER_PRINTER_H
 
 #include "asn1/ber/decoder.h"
+#include "string/buffer.h"
 
 namespace asn1 {
   namespace ber {
     // ASN.1 BER printer.
+    //
+    // Prints to the standard output or, if an output buffer has been set, to
+    // the output buffer (the error messages are printed to the standard
+    // error).
+    //
+    // The output is always rendered into a buffer; the output for the standard
+    // output is written in blocks of at least `flush_size` bytes (and when the
+    // printer is flushed or destroyed).
     class printer {
       public:
         // Constructor.
         printer(size_t tab_size = default_tab_size);
-        printer(const printer&) = default;
 
         // Destructor.
-        ~printer() = default;
+        ~printer();
 
-        // Assignment operator.
-        printer& operator=(const printer&) = default;
+        // Set output buffer (nullptr: standard output).
+        void output(string::buffer* out);
 
         // Print.
         bool print(size_t offset, const void* data, size_t& len);
         bool print(size_t offset, decoder& decoder, size_t& len);
 
+        // Write the pending output to the standard output.
+        bool flush();
+
         // End of file?
         bool eof() const;
 
@@ -36,12 +47,27 @@ namespace asn1 {
         static constexpr const size_t
           number_ascii_chars_per_line = (number_hex_chars_per_line * 3) - 1;
 
+        // Size of the blocks written to the standard output.
+        static constexpr const size_t flush_size = 64 * 1024;
+
+        // Maximum number of digits of a 64-bit integer.
+        static constexpr const size_t max_digits = 20;
+
         // Tab size.
         const size_t _M_tab_size;
 
         // End of file?
         bool _M_eof = false;
 
+        // Buffer for the standard output.
+        string::buffer _M_buf;
+
+        // Output buffer (`_M_buf` for the standard output).
+        string::buffer* _M_out;
+
+        // Print data value.
+        bool print_value(size_t offset, decoder& decoder, size_t& len);
+
         // Enter constructed.
         void enter_constructed(decoder& decoder, size_t depth) const;
 
@@ -75,22 +101,68 @@ namespace asn1 {
 
         void indent(size_t depth) const;
 
+        // Write date and time.
+        void write_time(const struct tm& tm) const;
+
         // Print header.
-        static void print_header(size_t offset);
+        void print_header(size_t offset) const;
 
         // Print footer.
-        static void print_footer();
+        void print_footer() const;
+
+        // Write string.
+        void write(const char* s) const;
+        void write(const char* s, size_t len) const;
+
+        // Write unsigned integer (padded with zeros to `width` digits).
+        void write_unsigned(uint64_t n, size_t width = 1) const;
+
+        // Write signed integer.
+        void write_signed(int64_t n) const;
+
+        // Disable copy constructor and assignment operator.
+        printer(const printer&) = delete;
+        printer& operator=(const printer&) = delete;
     };
 
     inline printer::printer(size_t tab_size)
-      : _M_tab_size(tab_size)
+      : _M_tab_size(tab_size),
+        _M_out(&_M_buf)
+    {
+    }
+
+    inline printer::~printer()
     {
+      flush();
+    }
+
+    inline void printer::output(string::buffer* out)
+    {
+      // Write the pending output to the standard output (if any).
+      flush();
+
+      _M_out = out ? out : &_M_buf;
     }
 
     inline bool printer::eof() const
     {
       return _M_eof;
     }
+
+    inline void printer::indent(size_t depth) const
+    {
+      _M_out->append(depth * _M_tab_size, ' ');
+    }
+
+    inline void printer::write(const char* s) const
+    {
+      _M_out->append(s, strlen(s));
+    }
+
+    inline void printer::write(const char* s, size_t len) const
+    {
+      _M_out->append(s, len);
+    }
   }
 }
 
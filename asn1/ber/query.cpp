@@ -0,0 +1,359 @@
+#include <string.h>
+#include "asn1/ber/query.h"
+#include "asn1/ber/header.h"
+#include "asn1/ber/framer.h"
+
+bool asn1::ber::query::compile(const char* path)
+{
+  _M_nsteps = 0;
+
+  const char* p = path;
+
+  do {
+    // Search end of the step.
+    const char* end = strchr(p, '/');
+    if (!end) {
+      end = p + strlen(p);
+    }
+
+    // If there are too many steps...
+    if (_M_nsteps == max_steps) {
+      return false;
+    }
+
+    step* const s = &_M_steps[_M_nsteps];
+
+    // Parse step.
+    if (!parse_step(p, end, *s)) {
+      return false;
+    }
+
+    // Consecutive '**' are not allowed.
+    if ((s->descendants) &&
+        (_M_nsteps > 0) &&
+        (_M_steps[_M_nsteps - 1].descendants)) {
+      return false;
+    }
+
+    _M_nsteps++;
+
+    // If this is the last step...
+    if (!*end) {
+      return true;
+    }
+
+    p = end + 1;
+  } while (true);
+}
+
+bool asn1::ber::query::run(const void* data,
+                           size_t length,
+                           callback_t callback,
+                           void* user,
+                           decoder::result* error) const
+{
+  // If the query has been compiled...
+  if (_M_nsteps > 0) {
+    context ctx;
+    ctx.begin = static_cast<const uint8_t*>(data);
+    ctx.callback = callback;
+    ctx.user = user;
+    ctx.stopped = false;
+    ctx.error = decoder::result::no_error;
+
+    const bool ret = match(ctx.begin, length, 1, 0, ctx);
+
+    if (error) {
+      *error = ctx.error;
+    }
+
+    return ret;
+  }
+
+  return false;
+}
+
+bool asn1::ber::query::match(const uint8_t* data,
+                             size_t length,
+                             steps_t steps,
+                             size_t depth,
+                             context& ctx) const
+{
+  // If the values are nested too deeply...
+  if (depth > max_depth) {
+    ctx.error = decoder::result::max_depth_exceeded;
+    return false;
+  }
+
+  // A '**' step also matches no levels: add the steps following the '**'
+  // steps (consecutive '**' are not allowed).
+  for (size_t i = 0; i < _M_nsteps; i++) {
+    if ((steps & (static_cast<steps_t>(1) << i)) && (_M_steps[i].descendants)) {
+      steps |= static_cast<steps_t>(1) << (i + 1);
+    }
+  }
+
+  // Number of siblings which matched the selector of each step.
+  size_t occurrences[max_steps];
+  memset(occurrences, 0, _M_nsteps * sizeof(size_t));
+
+  size_t offset = 0;
+
+  do {
+    // Save offset of the value.
+    const size_t begin = offset;
+
+    // Get next value (the contents are skipped).
+    value val;
+    const decoder::result res = next(data, length, offset, val);
+    switch (res) {
+      case decoder::result::no_error:
+        {
+          // Does the value match the path ('**' as last step)?
+          bool matched = ((steps & (static_cast<steps_t>(1) << _M_nsteps)) !=
+                          0);
+
+          // Steps the child values have to be matched against.
+          steps_t children = 0;
+
+          // Apply the active steps.
+          for (size_t i = 0; i < _M_nsteps; i++) {
+            if (steps & (static_cast<steps_t>(1) << i)) {
+              apply(val, i, occurrences[i], matched, children);
+            }
+          }
+
+          // If the value matches the path...
+          if (matched) {
+            if (!ctx.callback(val, data + begin - ctx.begin, ctx.user)) {
+              ctx.stopped = true;
+              return true;
+            }
+          }
+
+          // If the child values have to be matched...
+          if ((children != 0) && (val.constructed())) {
+            if (!match(static_cast<const uint8_t*>(val.data()),
+                       val.length(),
+                       children,
+                       depth + 1,
+                       ctx)) {
+              return false;
+            }
+
+            // If the query has been stopped...
+            if (ctx.stopped) {
+              return true;
+            }
+          }
+        }
+
+        break;
+      case decoder::result::eof:
+        return true;
+      default:
+        ctx.error = res;
+        return false;
+    }
+  } while (true);
+}
+
+void asn1::ber::query::apply(const value& val,
+                             size_t nstep,
+                             size_t& occurrences,
+                             bool& matched,
+                             steps_t& children) const
+{
+  const step* const s = &_M_steps[nstep];
+
+  // Any number of levels?
+  if (s->descendants) {
+    // The child values are matched against the same step.
+    children |= static_cast<steps_t>(1) << nstep;
+    return;
+  }
+
+  // If the value matches the selector...
+  if ((s->any) ||
+      ((val.tag_number() == s->tag_number) &&
+       (val.tag_class() == s->tag_class))) {
+    // If the occurrence is selected...
+    if ((s->occurrence == any_occurrence) ||
+        (occurrences++ == s->occurrence)) {
+      // If this is the last step...
+      if (nstep + 1 == _M_nsteps) {
+        matched = true;
+      } else {
+        // The child values are matched against the next step.
+        children |= static_cast<steps_t>(1) << (nstep + 1);
+      }
+    }
+  }
+}
+
+asn1::ber::decoder::result asn1::ber::query::next(const uint8_t* data,
+                                                 size_t length,
+                                                 size_t& offset,
+                                                 value& val)
+{
+  // If not at the end of the data...
+  if (offset < length) {
+    const size_t begin = offset;
+
+    // Decode identifier and length octets.
+    header hdr;
+    decoder::result res = hdr.decode(data, length, offset);
+
+    // If the header could be decoded...
+    if (res == decoder::result::no_error) {
+      size_t end;
+
+      // Definite length?
+      if (hdr.definite_length) {
+        // If the contents octets don't fit in the buffer...
+        if (hdr.length > length - offset) {
+          return decoder::result::unexpected_eof;
+        }
+
+        end = offset + hdr.length;
+
+        val._M_length = hdr.length;
+        val._M_total_length = end - begin;
+      } else {
+        // Find end-of-contents.
+        size_t eoc = offset;
+        if ((res = framer::find_eoc(data, length, eoc)) !=
+            decoder::result::no_error) {
+          return res;
+        }
+
+        end = eoc + 2;
+
+        val._M_length = eoc - offset;
+        val._M_total_length = end - begin;
+      }
+
+      val._M_tag_class = hdr.tag_class;
+      val._M_primitive = !hdr.constructed;
+      val._M_tag_number = hdr.tag_number;
+      val._M_data = data + offset;
+
+      // Skip value.
+      offset = end;
+
+      return decoder::result::no_error;
+    }
+
+    return res;
+  } else {
+    return decoder::result::eof;
+  }
+}
+
+bool asn1::ber::query::parse_step(const char* begin,
+                                  const char* end,
+                                  step& step)
+{
+  step.any = false;
+  step.descendants = false;
+  step.tag_class = tag_class::ContextSpecific;
+  step.tag_number = 0;
+  step.occurrence = any_occurrence;
+
+  // Any number of levels?
+  if ((end - begin == 2) && (begin[0] == '*') && (begin[1] == '*')) {
+    step.any = true;
+    step.descendants = true;
+
+    return true;
+  }
+
+  const char* p = begin;
+
+  // If the step is not empty...
+  if (p < end) {
+    // Any value?
+    if (*p == '*') {
+      step.any = true;
+      p++;
+    } else if (*p == '[') {
+      p++;
+
+      static const struct {
+        const char* name;
+        size_t len;
+        enum tag_class tag_class;
+      } classes[] = {
+        {"UNIVERSAL ", 10, tag_class::Universal},
+        {"APPLICATION ", 12, tag_class::Application},
+        {"CONTEXT ", 8, tag_class::ContextSpecific},
+        {"PRIVATE ", 8, tag_class::Private}
+      };
+
+      // Parse tag class (optional).
+      for (size_t i = 0; i < sizeof(classes) / sizeof(classes[0]); i++) {
+        if ((static_cast<size_t>(end - p) > classes[i].len) &&
+            (memcmp(p, classes[i].name, classes[i].len) == 0)) {
+          step.tag_class = classes[i].tag_class;
+          p += classes[i].len;
+
+          break;
+        }
+      }
+
+      // Parse tag number.
+      uint64_t tn = 0;
+      const char* const digits = p;
+
+      while ((p < end) && (*p >= '0') && (*p <= '9')) {
+        // If the tag number is too big...
+        if ((tn = (tn * 10) + (*p - '0')) > 0xffffffffu) {
+          return false;
+        }
+
+        p++;
+      }
+
+      // If there are no digits or the closing bracket is missing...
+      if ((p == digits) || (p == end) || (*p != ']')) {
+        return false;
+      }
+
+      step.tag_number = static_cast<uint32_t>(tn);
+
+      p++;
+    } else {
+      return false;
+    }
+
+    // If the occurrence has been specified...
+    if ((p < end) && (*p == '#')) {
+      p++;
+
+      size_t n = 0;
+      const char* const digits = p;
+
+      while ((p < end) && (*p >= '0') && (*p <= '9')) {
+        // If the occurrence is too big...
+        if (n > (any_occurrence - 10) / 10) {
+          return false;
+        }
+
+        n = (n * 10) + (*p - '0');
+
+        p++;
+      }
+
+      // If there are no digits...
+      if (p == digits) {
+        return false;
+      }
+
+      step.occurrence = n;
+    }
+
+    return (p == end);
+  }
+
+  return false;
+}
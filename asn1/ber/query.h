@@ -0,0 +1,144 @@
+#ifndef ASN1_BER_QUERY_H
+#define ASN1_BER_QUERY_H
+
+#include "asn1/ber/decoder.h"
+
+namespace asn1 {
+  namespace ber {
+    // ASN.1 BER path query.
+    //
+    // A path is compiled once and then matched against records. The values
+    // which don't match a step are skipped using their lengths (their
+    // contents are not decoded), so the cost of a query is roughly the cost
+    // of decoding the headers of the values along the path and their
+    // siblings.
+    //
+    // <path> ::= <step> ['/' <step>]*
+    // <step> ::= <selector> ['#' <occurrence>] | '**'
+    // <selector> ::= '[' [<class> ' '] <tag-number> ']' | '*'
+    // <class> ::= UNIVERSAL | APPLICATION | CONTEXT | PRIVATE
+    //
+    // The default class is context-specific. '*' matches any value, '**'
+    // matches any number of levels (including none) and '#<occurrence>'
+    // selects the n-th (0-based) sibling matching the selector. The
+    // top-level values (records) are matched against the first step.
+    //
+    // The values of a level are matched against the set of the steps which
+    // are active at that level (several with '**'), so a value is reported
+    // at most once, even if it matches the path in several ways.
+    //
+    // As with the decoder, values nested more than `max_depth` levels deep
+    // make the query fail (`decoder::result::max_depth_exceeded`).
+    //
+    // Example: "[APPLICATION 1]/[0]/[5]", "[APPLICATION 1]/**/[UNIVERSAL 6]".
+    class query {
+      public:
+        // Maximum number of steps.
+        static constexpr const size_t max_steps = 32;
+
+        // Callback invoked for each match (`offset` is the offset of the
+        // identifier octets of the value from the beginning of the data;
+        // returns false to stop the query).
+        typedef bool (*callback_t)(const value& val,
+                                   size_t offset,
+                                   void* user);
+
+        // Constructor.
+        query() = default;
+
+        // Destructor.
+        ~query() = default;
+
+        // Compile path.
+        bool compile(const char* path);
+
+        // Run query (returns false if the data couldn't be decoded; if
+        // `error` is not null, the reason is saved in `*error`).
+        bool run(const void* data,
+                 size_t length,
+                 callback_t callback,
+                 void* user = nullptr,
+                 decoder::result* error = nullptr) const;
+
+      private:
+        // Maximum depth (as the decoder's).
+        static constexpr const size_t max_depth = 128;
+
+        // Any occurrence.
+        static constexpr const size_t any_occurrence = static_cast<size_t>(-1);
+
+        // Step.
+        struct step {
+          // Match any value ('*')?
+          bool any;
+
+          // Match any number of levels ('**')?
+          bool descendants;
+
+          // Tag class.
+          enum tag_class tag_class;
+
+          // Tag number.
+          uint32_t tag_number;
+
+          // Occurrence (`any_occurrence` for all).
+          size_t occurrence;
+        };
+
+        step _M_steps[max_steps];
+        size_t _M_nsteps = 0;
+
+        // Set of steps (bit `n`: step `n`; bit `_M_nsteps`: the path has been
+        // matched).
+        typedef uint64_t steps_t;
+
+        // Query context.
+        struct context {
+          // Beginning of the data.
+          const uint8_t* begin;
+
+          // Callback.
+          callback_t callback;
+
+          // Pointer to user data.
+          void* user;
+
+          // Has the query been stopped?
+          bool stopped;
+
+          // Error.
+          decoder::result error;
+        };
+
+        // Match the values in `data` (at depth `depth`) against the set of
+        // steps `steps`.
+        bool match(const uint8_t* data,
+                   size_t length,
+                   steps_t steps,
+                   size_t depth,
+                   context& ctx) const;
+
+        // Apply the step `nstep` to the value `val`: set `matched` if the
+        // value matches the path and add to `children` the steps its child
+        // values have to be matched against.
+        void apply(const value& val,
+                   size_t nstep,
+                   size_t& occurrences,
+                   bool& matched,
+                   steps_t& children) const;
+
+        // Get next value.
+        static decoder::result next(const uint8_t* data,
+                                    size_t length,
+                                    size_t& offset,
+                                    value& val);
+
+        // Parse step.
+        static bool parse_step(const char* begin,
+                               const char* end,
+                               step& step);
+    };
+  }
+}
+
+#endif // ASN1_BER_QUERY_H
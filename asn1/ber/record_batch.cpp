@@ -0,0 +1,60 @@
+#include "asn1/ber/record_batch.h"
+
+bool asn1::ber::record_batch::reserve(size_t len, size_t nrecords)
+{
+  // If the array of offsets is too small...
+  if (nrecords > _M_size - _M_count) {
+    size_t size = (_M_size == 0) ? initial_records : _M_size * 2;
+    while (nrecords > size - _M_count) {
+      size *= 2;
+    }
+
+    size_t* const offsets = static_cast<size_t*>(
+                              realloc(_M_offsets, size * sizeof(size_t))
+                            );
+
+    if (!offsets) {
+      return false;
+    }
+
+    _M_offsets = offsets;
+    _M_size = size;
+  }
+
+  return _M_buf.reserve(len);
+}
+
+bool asn1::ber::record_batch::add(const encoder& enc)
+{
+  // If there is room for one more record...
+  if (allocate()) {
+    const size_t offset = _M_buf.length();
+
+    // Serialize the record at the end of the buffer.
+    if (enc.serialize(_M_buf)) {
+      _M_offsets[_M_count++] = offset;
+      return true;
+    }
+
+    // Discard the partially serialized record.
+    _M_buf.resize(offset);
+  }
+
+  return false;
+}
+
+bool asn1::ber::record_batch::add(const void* record, size_t len)
+{
+  // If there is room for one more record...
+  if (allocate()) {
+    const size_t offset = _M_buf.length();
+
+    // Append record.
+    if (_M_buf.append(record, len)) {
+      _M_offsets[_M_count++] = offset;
+      return true;
+    }
+  }
+
+  return false;
+}
@@ -0,0 +1,147 @@
+#ifndef ASN1_BER_RECORD_BATCH_H
+#define ASN1_BER_RECORD_BATCH_H
+
+#include <stdlib.h>
+#include "asn1/ber/encoder.h"
+#include "string/buffer.h"
+
+namespace asn1 {
+  namespace ber {
+    // Batch of ASN.1 BER records.
+    //
+    // The records are encoded back to back into one buffer and the offset of
+    // each record is kept. `clear()` keeps the memory, so a batch which is
+    // reused (together with an encoder which is reset for each record)
+    // doesn't allocate memory once it has reached its working size.
+    class record_batch {
+      public:
+        // Constructor.
+        record_batch() = default;
+
+        // Destructor.
+        ~record_batch();
+
+        // Clear (the memory is kept for the next batch).
+        void clear();
+
+        // Reserve memory for `len` more bytes and `nrecords` more records.
+        bool reserve(size_t len, size_t nrecords);
+
+        // Add the record encoded by `enc` (on error, the batch is left
+        // unchanged).
+        bool add(const encoder& enc);
+
+        // Add a record which is already encoded.
+        bool add(const void* record, size_t len);
+
+        // Get data.
+        const void* data() const;
+
+        // Get length of the data.
+        size_t length() const;
+
+        // Empty?
+        bool empty() const;
+
+        // Get number of records.
+        size_t count() const;
+
+        // Get offset of the record `n` (`length()` if `n` is `count()`).
+        size_t offset(size_t n) const;
+
+        // Get length of the record `n`.
+        size_t length(size_t n) const;
+
+        // Get record `n`.
+        const void* record(size_t n) const;
+
+      private:
+        // Initial number of records.
+        static constexpr const size_t initial_records = 256;
+
+        // Data.
+        string::buffer _M_buf;
+
+        // Offset of each record.
+        size_t* _M_offsets = nullptr;
+        size_t _M_size = 0;
+        size_t _M_count = 0;
+
+        // Make room for one more record.
+        bool allocate();
+
+        // Disable copy constructor and assignment operator.
+        record_batch(const record_batch&) = delete;
+        record_batch& operator=(const record_batch&) = delete;
+    };
+
+    inline record_batch::~record_batch()
+    {
+      free(_M_offsets);
+    }
+
+    inline void record_batch::clear()
+    {
+      _M_buf.clear();
+      _M_count = 0;
+    }
+
+    inline const void* record_batch::data() const
+    {
+      return _M_buf.data();
+    }
+
+    inline size_t record_batch::length() const
+    {
+      return _M_buf.length();
+    }
+
+    inline bool record_batch::empty() const
+    {
+      return (_M_count == 0);
+    }
+
+    inline size_t record_batch::count() const
+    {
+      return _M_count;
+    }
+
+    inline size_t record_batch::offset(size_t n) const
+    {
+      return (n < _M_count) ? _M_offsets[n] : _M_buf.length();
+    }
+
+    inline size_t record_batch::length(size_t n) const
+    {
+      return offset(n + 1) - _M_offsets[n];
+    }
+
+    inline const void* record_batch::record(size_t n) const
+    {
+      return static_cast<const uint8_t*>(_M_buf.data()) + _M_offsets[n];
+    }
+
+    inline bool record_batch::allocate()
+    {
+      // If the array of offsets is full...
+      if (_M_count == _M_size) {
+        const size_t size = (_M_size == 0) ? initial_records : _M_size * 2;
+
+        size_t* const offsets = static_cast<size_t*>(
+                                  realloc(_M_offsets, size * sizeof(size_t))
+                                );
+
+        if (!offsets) {
+          return false;
+        }
+
+        _M_offsets = offsets;
+        _M_size = size;
+      }
+
+      return true;
+    }
+  }
+}
+
+#endif // ASN1_BER_RECORD_BATCH_H
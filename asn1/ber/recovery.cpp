@@ -0,0 +1,288 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "asn1/ber/recovery.h"
+#include "asn1/ber/framer.h"
+
+bool asn1::ber::recovery::run()
+{
+  // Scan temporary directory.
+  if (scan()) {
+    // If there are files to be recovered...
+    if (_M_used > 0) {
+      const size_t nthreads = (_M_nthreads < _M_used) ? _M_nthreads : _M_used;
+
+      pthread_t threads[max_threads];
+      size_t nrunning = 0;
+
+      // Start threads.
+      for (; nrunning < nthreads; nrunning++) {
+        if (pthread_create(&threads[nrunning], nullptr, run, this) != 0) {
+          break;
+        }
+      }
+
+      // If no thread could be started, recover the files in this thread.
+      if (nrunning == 0) {
+        work();
+      }
+
+      // Wait for the threads to finish.
+      for (size_t i = 0; i < nrunning; i++) {
+        pthread_join(threads[i], nullptr);
+      }
+    }
+
+    return (failed() == 0);
+  }
+
+  return false;
+}
+
+bool asn1::ber::recovery::scan()
+{
+  // Open temporary directory.
+  DIR* const dir = opendir(_M_tempdir);
+
+  // If the directory could be opened...
+  if (dir) {
+    static constexpr const char* const extension = ".asn1";
+    static constexpr const size_t extensionlen = 5;
+
+    const struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+      const size_t len = strlen(entry->d_name);
+
+      // If the file has the extension of the ASN.1 files...
+      if ((len > extensionlen) &&
+          (memcmp(entry->d_name + len - extensionlen,
+                  extension,
+                  extensionlen) == 0)) {
+        // Add file name.
+        if (!add(entry->d_name, len)) {
+          closedir(dir);
+          return false;
+        }
+      }
+    }
+
+    closedir(dir);
+
+    return true;
+  }
+
+  return false;
+}
+
+bool asn1::ber::recovery::add(const char* name, size_t len)
+{
+  if (allocate()) {
+    const size_t offset = _M_names.length();
+
+    // Append file name (including the null-terminator).
+    if (_M_names.append(name, len + 1)) {
+      _M_offsets[_M_used++] = offset;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void* asn1::ber::recovery::run(void* arg)
+{
+  static_cast<recovery*>(arg)->work();
+  return nullptr;
+}
+
+void asn1::ber::recovery::work()
+{
+  const char* const names = static_cast<const char*>(_M_names.data());
+
+  size_t idx;
+  while ((idx = _M_next.fetch_add(1, std::memory_order_relaxed)) < _M_used) {
+    // Recover file.
+    if (!recover(names + _M_offsets[idx])) {
+      _M_failed.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+bool asn1::ber::recovery::recover(const char* name)
+{
+  // Compose pathname.
+  char pathname[PATH_MAX];
+  if (snprintf(pathname,
+               sizeof(pathname),
+               "%s/%s",
+               _M_tempdir,
+               name) >= static_cast<int>(sizeof(pathname))) {
+    return false;
+  }
+
+  // Open file.
+  const int fd = open(pathname, O_RDWR);
+
+  // If the file could be opened...
+  if (fd != -1) {
+    struct stat sbuf;
+    if ((fstat(fd, &sbuf) == 0) && (S_ISREG(sbuf.st_mode))) {
+      const size_t size = static_cast<size_t>(sbuf.st_size);
+
+      // Offset after the last complete record.
+      size_t offset = 0;
+
+      // If the file is not empty...
+      if (size > 0) {
+        // Map file into memory.
+        void* const base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+
+        // If the file could be mapped into memory...
+        if (base != MAP_FAILED) {
+          framer framer(base, size);
+
+          // Skip complete records.
+          size_t len;
+          while (framer.next(len) == decoder::result::no_error) {
+            offset += len;
+          }
+
+          munmap(base, size);
+        } else {
+          close(fd);
+          return false;
+        }
+      }
+
+      // If there are no complete records...
+      if (offset == 0) {
+        close(fd);
+
+        // Remove file.
+        if (unlink(pathname) == 0) {
+          _M_removed.fetch_add(1, std::memory_order_relaxed);
+          return true;
+        }
+
+        return false;
+      }
+
+      // If the last record is incomplete...
+      if (offset < size) {
+        // Truncate file after the last complete record.
+        if (ftruncate(fd, static_cast<off_t>(offset)) == 0) {
+          _M_truncated.fetch_add(1, std::memory_order_relaxed);
+        } else {
+          close(fd);
+          return false;
+        }
+      }
+
+      close(fd);
+
+      // Move file to the final directory.
+      if (move(name)) {
+        _M_recovered.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+
+      return false;
+    }
+
+    close(fd);
+  }
+
+  return false;
+}
+
+bool asn1::ber::recovery::move(const char* name) const
+{
+  // Maximum number of attempts to find a free name.
+  static constexpr const unsigned max_attempts = 1000;
+
+  // Compose pathname in the temporary directory.
+  char oldpath[PATH_MAX];
+  snprintf(oldpath, sizeof(oldpath), "%s/%s", _M_tempdir, name);
+
+  // Name without extension.
+  const int len = static_cast<int>(strlen(name)) - 5;
+
+  for (unsigned i = 0; i < max_attempts; i++) {
+    // Compose pathname in the final directory (if there is already a file
+    // with the same name, add a suffix).
+    char newpath[PATH_MAX];
+    if (i == 0) {
+      snprintf(newpath, sizeof(newpath), "%s/%s", _M_finaldir, name);
+    } else {
+      snprintf(newpath,
+               sizeof(newpath),
+               "%s/%.*s-r%u.asn1",
+               _M_finaldir,
+               len,
+               name,
+               i);
+    }
+
+    // Move file (unless there is already a file with the same name).
+    if (rename(oldpath, newpath)) {
+      return true;
+    } else if (errno != EEXIST) {
+      return false;
+    }
+  }
+
+  return false;
+}
+
+bool asn1::ber::recovery::rename(const char* oldpath, const char* newpath)
+{
+  // Rename file (fail if `newpath` already exists).
+  if (renameat2(AT_FDCWD, oldpath, AT_FDCWD, newpath, RENAME_NOREPLACE) == 0) {
+    return true;
+  }
+
+  // If the file system doesn't support RENAME_NOREPLACE...
+  if ((errno == EINVAL) || (errno == ENOSYS)) {
+    // Create new link (fail if `newpath` already exists).
+    if (link(oldpath, newpath) == 0) {
+      // Remove old link.
+      if (unlink(oldpath) == 0) {
+        return true;
+      }
+
+      // Remove new link (the file is left in place).
+      const int error = errno;
+      unlink(newpath);
+      errno = error;
+    }
+  }
+
+  return false;
+}
+
+bool asn1::ber::recovery::allocate()
+{
+  if (_M_used < _M_size) {
+    return true;
+  } else {
+    const size_t size = (_M_size > 0) ? _M_size * 2 : allocation;
+
+    size_t* offsets = static_cast<size_t*>(
+                        realloc(_M_offsets, size * sizeof(size_t))
+                      );
+
+    if (offsets) {
+      _M_offsets = offsets;
+      _M_size = size;
+
+      return true;
+    } else {
+      return false;
+    }
+  }
+}
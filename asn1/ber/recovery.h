@@ -0,0 +1,147 @@
+#ifndef ASN1_BER_RECOVERY_H
+#define ASN1_BER_RECOVERY_H
+
+#include <pthread.h>
+#include <limits.h>
+#include <atomic>
+#include "string/buffer.h"
+
+namespace asn1 {
+  namespace ber {
+    // Recovery of the ASN.1 files left in the temporary directory (e.g. after
+    // a crash).
+    //
+    // Each file is truncated after its last complete record and moved to the
+    // final directory (empty files are removed). The files are processed in
+    // parallel.
+    class recovery {
+      public:
+        // Default number of threads.
+        static constexpr const size_t default_threads = 8;
+
+        // Maximum number of threads.
+        static constexpr const size_t max_threads = 64;
+
+        // Constructor.
+        recovery(const char* tempdir,
+                 const char* finaldir,
+                 size_t nthreads = default_threads);
+
+        // Destructor.
+        ~recovery();
+
+        // Run.
+        bool run();
+
+        // Get number of files moved to the final directory.
+        size_t recovered() const;
+
+        // Get number of files which had to be truncated.
+        size_t truncated() const;
+
+        // Get number of files removed (no complete records).
+        size_t removed() const;
+
+        // Get number of files which couldn't be recovered.
+        size_t failed() const;
+
+        // Rename file without overwriting `newpath` (fails with errno set
+        // to EEXIST if it already exists).
+        static bool rename(const char* oldpath, const char* newpath);
+
+      private:
+        // Allocation.
+        static constexpr const size_t allocation = 256;
+
+        // Temporary directory.
+        const char* _M_tempdir;
+
+        // Final directory.
+        const char* _M_finaldir;
+
+        // Number of threads.
+        size_t _M_nthreads;
+
+        // File names.
+        string::buffer _M_names;
+
+        // Offsets of the file names in `_M_names`.
+        size_t* _M_offsets = nullptr;
+        size_t _M_size = 0;
+        size_t _M_used = 0;
+
+        // Next file to be processed.
+        std::atomic<size_t> _M_next{0};
+
+        // Counters.
+        std::atomic<size_t> _M_recovered{0};
+        std::atomic<size_t> _M_truncated{0};
+        std::atomic<size_t> _M_removed{0};
+        std::atomic<size_t> _M_failed{0};
+
+        // Scan temporary directory.
+        bool scan();
+
+        // Add file name.
+        bool add(const char* name, size_t len);
+
+        // Thread.
+        static void* run(void* arg);
+        void work();
+
+        // Recover file.
+        bool recover(const char* name);
+
+        // Move file to the final directory (without overwriting existing
+        // files).
+        bool move(const char* name) const;
+
+        // Allocate.
+        bool allocate();
+
+        // Disable copy constructor and assignment operator.
+        recovery(const recovery&) = delete;
+        recovery& operator=(const recovery&) = delete;
+    };
+
+    inline recovery::recovery(const char* tempdir,
+                              const char* finaldir,
+                              size_t nthreads)
+      : _M_tempdir(tempdir),
+        _M_finaldir(finaldir),
+        _M_nthreads(nthreads == 0 ? 1 :
+                                    nthreads > max_threads ? max_threads :
+                                                             nthreads)
+    {
+    }
+
+    inline recovery::~recovery()
+    {
+      if (_M_offsets) {
+        free(_M_offsets);
+      }
+    }
+
+    inline size_t recovery::recovered() const
+    {
+      return _M_recovered.load(std::memory_order_relaxed);
+    }
+
+    inline size_t recovery::truncated() const
+    {
+      return _M_truncated.load(std::memory_order_relaxed);
+    }
+
+    inline size_t recovery::removed() const
+    {
+      return _M_removed.load(std::memory_order_relaxed);
+    }
+
+    inline size_t recovery::failed() const
+    {
+      return _M_failed.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+#endif // ASN1_BER_RECOVERY_H
@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <time.h>
+#include "asn1/ber/schema/runtime.h"
+
+bool asn1::ber::schema::unwrap(const value& val, value& inner)
+{
+  // If the value is constructed...
+  if (val.constructed()) {
+    decoder decoder(val.data(), val.length());
+
+    // The explicitly tagged value must contain exactly one value.
+    value v;
+    return ((decoder.next(inner) == decoder::result::no_error) &&
+            (decoder.next(v) == decoder::result::eof));
+  }
+
+  return false;
+}
+
+bool asn1::ber::schema::encode_oid(encoder& enc,
+                                   tag_class tc,
+                                   uint32_t tn,
+                                   const oid& v)
+{
+  // If there are at least two components and the first two components are
+  // valid...
+  if ((v.ncomponents >= 2) &&
+      (v.ncomponents <= value::max_oid_components) &&
+      (v.components[0] <= 2) &&
+      ((v.components[0] == 2) || (v.components[1] < 40))) {
+    // Each subidentifier takes up to 5 octets.
+    uint8_t buf[value::max_oid_components * 5];
+    size_t len = 0;
+
+    // For each subidentifier (the first two components are combined)...
+    for (size_t i = 1; i < v.ncomponents; i++) {
+      const uint64_t n = (i == 1) ?
+                           static_cast<uint64_t>(v.components[0]) * 40 +
+                           v.components[1] :
+                           v.components[i];
+
+      // The decoder only accepts subidentifiers which fit in 32 bits.
+      if (n <= 0xffffffffull) {
+        // Count the number of octets.
+        size_t noctets = 1;
+        while ((n >> (7 * noctets)) != 0) {
+          noctets++;
+        }
+
+        for (size_t j = noctets; j > 1; j--) {
+          buf[len++] = 0x80 |
+                       static_cast<uint8_t>((n >> (7 * (j - 1))) & 0x7f);
+        }
+
+        buf[len++] = static_cast<uint8_t>(n & 0x7f);
+      } else {
+        return false;
+      }
+    }
+
+    return enc.add_data(tc, tn, buf, len, encoder::copy::deep);
+  }
+
+  return false;
+}
+
+bool asn1::ber::schema::encode_utc_time(encoder& enc,
+                                        tag_class tc,
+                                        uint32_t tn,
+                                        time_t v)
+{
+  struct tm tm;
+
+#if !defined(_WIN32)
+  gmtime_r(&v, &tm);
+#else
+  gmtime_s(&tm, &v);
+#endif
+
+  // UTC time can only represent the years 1950 - 2049.
+  if ((tm.tm_year >= 50) && (tm.tm_year < 150)) {
+    char buf[16];
+    const int len = snprintf(buf,
+                             sizeof(buf),
+                             "%02u%02u%02u%02u%02u%02uZ",
+                             tm.tm_year % 100,
+                             1 + tm.tm_mon,
+                             tm.tm_mday,
+                             tm.tm_hour,
+                             tm.tm_min,
+                             tm.tm_sec);
+
+    return enc.add_data(tc, tn, buf, len, encoder::copy::deep);
+  }
+
+  return false;
+}
@@ -0,0 +1,487 @@
+#ifndef ASN1_BER_SCHEMA_RUNTIME_H
+#define ASN1_BER_SCHEMA_RUNTIME_H
+
+#include <stdlib.h>
+#include <new>
+#include <utility>
+#include "asn1/ber/decoder.h"
+#include "asn1/ber/encoder.h"
+
+namespace asn1 {
+  namespace ber {
+    // Support for the code generated by `asn1_ber_compiler`.
+    namespace schema {
+      // Tag.
+      struct tag {
+        enum tag_class tag_class;
+        uint32_t tag_number;
+      };
+
+      // Does the value have the tag?
+      bool match(const value& val, tag_class tc, uint32_t tn);
+      bool match(const value& val, const tag& t);
+
+      // Does the value have one of the tags?
+      template<size_t N>
+      bool match(const value& val, const tag (&tags)[N]);
+
+      // Null.
+      struct null {
+      };
+
+      // Octets (OCTET STRING, BIT STRING and character strings).
+      //
+      // The octets are not copied: when decoding, `data` points to the
+      // contents octets in the decoded buffer; when encoding, the octets
+      // must remain valid until the encoder has been serialized.
+      struct octets {
+        const void* data = nullptr;
+        size_t length = 0;
+      };
+
+      // Object identifier.
+      struct oid {
+        uint32_t components[value::max_oid_components];
+        size_t ncomponents = 0;
+      };
+
+      // Array (SEQUENCE OF and SET OF).
+      template<typename T>
+      class array {
+        public:
+          // Constructor.
+          array() = default;
+
+          // Move constructor.
+          array(array&& other);
+
+          // Destructor.
+          ~array();
+
+          // Move assignment operator.
+          array& operator=(array&& other);
+
+          // Clear.
+          void clear();
+
+          // Get number of elements.
+          size_t size() const;
+
+          // Empty?
+          bool empty() const;
+
+          // Get element.
+          T& operator[](size_t idx);
+          const T& operator[](size_t idx) const;
+
+          // Iterators.
+          T* begin();
+          T* end();
+          const T* begin() const;
+          const T* end() const;
+
+          // Add value-initialized element (returns nullptr if the element
+          // couldn't be allocated).
+          T* add();
+
+        private:
+          // Allocation.
+          static constexpr const size_t allocation = 8;
+
+          // Elements.
+          T* _M_elements = nullptr;
+          size_t _M_size = 0;
+          size_t _M_used = 0;
+
+          // Allocate.
+          bool allocate();
+
+          // Disable copy constructor and assignment operator.
+          array(const array&) = delete;
+          array& operator=(const array&) = delete;
+      };
+
+      // Reader of the values contained in a constructed value.
+      class reader {
+        public:
+          // Constructor.
+          reader(const value& val);
+
+          // At the end of the contents (or error)?
+          bool end() const;
+
+          // Get current value.
+          const value& get() const;
+
+          // Move to the next value (returns false on error).
+          bool next();
+
+          // Error?
+          bool error() const;
+
+        private:
+          // Decoder.
+          decoder _M_decoder;
+
+          // Current value.
+          value _M_value;
+
+          // Result of the last call to `decoder::next()`.
+          decoder::result _M_result;
+
+          // Disable copy constructor and assignment operator.
+          reader(const reader&) = delete;
+          reader& operator=(const reader&) = delete;
+      };
+
+      // Get the value contained in an explicitly tagged value.
+      bool unwrap(const value& val, value& inner);
+
+      // Decode.
+      bool decode_boolean(const value& val, bool& v);
+      bool decode_integer(const value& val, int64_t& v);
+      bool decode_null(const value& val, null& v);
+      bool decode_octets(const value& val, octets& v);
+      bool decode_oid(const value& val, oid& v);
+      bool decode_utc_time(const value& val, time_t& v);
+      bool decode_generalized_time(const value& val, struct timeval& v);
+
+      // Encode.
+      bool encode_boolean(encoder& enc, tag_class tc, uint32_t tn, bool v);
+      bool encode_integer(encoder& enc, tag_class tc, uint32_t tn, int64_t v);
+      bool encode_null(encoder& enc, tag_class tc, uint32_t tn, const null& v);
+      bool encode_octets(encoder& enc,
+                         tag_class tc,
+                         uint32_t tn,
+                         const octets& v);
+
+      bool encode_oid(encoder& enc, tag_class tc, uint32_t tn, const oid& v);
+      bool encode_utc_time(encoder& enc, tag_class tc, uint32_t tn, time_t v);
+      bool encode_generalized_time(encoder& enc,
+                                   tag_class tc,
+                                   uint32_t tn,
+                                   const struct timeval& v);
+
+      // Encode with a tag known at compile time.
+      template<tag_class TC, uint32_t TN>
+      bool encode_boolean(encoder& enc, bool v);
+
+      template<tag_class TC, uint32_t TN>
+      bool encode_integer(encoder& enc, int64_t v);
+
+      template<tag_class TC, uint32_t TN>
+      bool encode_null(encoder& enc, const null& v);
+
+      template<tag_class TC, uint32_t TN>
+      bool encode_octets(encoder& enc, const octets& v);
+
+      template<tag_class TC, uint32_t TN>
+      bool encode_generalized_time(encoder& enc, const struct timeval& v);
+
+      inline bool match(const value& val, tag_class tc, uint32_t tn)
+      {
+        return ((val.tag_number() == tn) && (val.tag_class() == tc));
+      }
+
+      inline bool match(const value& val, const tag& t)
+      {
+        return match(val, t.tag_class, t.tag_number);
+      }
+
+      template<size_t N>
+      inline bool match(const value& val, const tag (&tags)[N])
+      {
+        for (size_t i = 0; i < N; i++) {
+          if (match(val, tags[i])) {
+            return true;
+          }
+        }
+
+        return false;
+      }
+
+      template<typename T>
+      inline array<T>::array(array&& other)
+        : _M_elements(other._M_elements),
+          _M_size(other._M_size),
+          _M_used(other._M_used)
+      {
+        other._M_elements = nullptr;
+        other._M_size = 0;
+        other._M_used = 0;
+      }
+
+      template<typename T>
+      inline array<T>::~array()
+      {
+        if (_M_elements) {
+          clear();
+          free(_M_elements);
+        }
+      }
+
+      template<typename T>
+      inline array<T>& array<T>::operator=(array&& other)
+      {
+        if (this != &other) {
+          if (_M_elements) {
+            clear();
+            free(_M_elements);
+          }
+
+          _M_elements = other._M_elements;
+          _M_size = other._M_size;
+          _M_used = other._M_used;
+
+          other._M_elements = nullptr;
+          other._M_size = 0;
+          other._M_used = 0;
+        }
+
+        return *this;
+      }
+
+      template<typename T>
+      inline void array<T>::clear()
+      {
+        for (size_t i = 0; i < _M_used; i++) {
+          _M_elements[i].~T();
+        }
+
+        _M_used = 0;
+      }
+
+      template<typename T>
+      inline size_t array<T>::size() const
+      {
+        return _M_used;
+      }
+
+      template<typename T>
+      inline bool array<T>::empty() const
+      {
+        return (_M_used == 0);
+      }
+
+      template<typename T>
+      inline T& array<T>::operator[](size_t idx)
+      {
+        return _M_elements[idx];
+      }
+
+      template<typename T>
+      inline const T& array<T>::operator[](size_t idx) const
+      {
+        return _M_elements[idx];
+      }
+
+      template<typename T>
+      inline T* array<T>::begin()
+      {
+        return _M_elements;
+      }
+
+      template<typename T>
+      inline T* array<T>::end()
+      {
+        return _M_elements + _M_used;
+      }
+
+      template<typename T>
+      inline const T* array<T>::begin() const
+      {
+        return _M_elements;
+      }
+
+      template<typename T>
+      inline const T* array<T>::end() const
+      {
+        return _M_elements + _M_used;
+      }
+
+      template<typename T>
+      inline T* array<T>::add()
+      {
+        if (allocate()) {
+          return new (&_M_elements[_M_used++]) T();
+        }
+
+        return nullptr;
+      }
+
+      template<typename T>
+      bool array<T>::allocate()
+      {
+        if (_M_used < _M_size) {
+          return true;
+        } else {
+          const size_t size = (_M_size > 0) ? _M_size * 2 : allocation;
+
+          T* elements = static_cast<T*>(malloc(size * sizeof(T)));
+
+          if (elements) {
+            // Move the elements to the new storage (the elements might not
+            // be trivially copyable).
+            for (size_t i = 0; i < _M_used; i++) {
+              new (&elements[i]) T(std::move(_M_elements[i]));
+              _M_elements[i].~T();
+            }
+
+            if (_M_elements) {
+              free(_M_elements);
+            }
+
+            _M_elements = elements;
+            _M_size = size;
+
+            return true;
+          } else {
+            return false;
+          }
+        }
+      }
+
+      inline reader::reader(const value& val)
+        : _M_decoder(val.data(), val.length()),
+          _M_result(_M_decoder.next(_M_value))
+      {
+      }
+
+      inline bool reader::end() const
+      {
+        return (_M_result != decoder::result::no_error);
+      }
+
+      inline const value& reader::get() const
+      {
+        return _M_value;
+      }
+
+      inline bool reader::next()
+      {
+        _M_result = _M_decoder.next(_M_value);
+
+        return ((_M_result == decoder::result::no_error) ||
+                (_M_result == decoder::result::eof));
+      }
+
+      inline bool reader::error() const
+      {
+        return ((_M_result != decoder::result::no_error) &&
+                (_M_result != decoder::result::eof));
+      }
+
+      inline bool decode_boolean(const value& val, bool& v)
+      {
+        return val.decode_boolean(v);
+      }
+
+      inline bool decode_integer(const value& val, int64_t& v)
+      {
+        return val.decode_integer(v);
+      }
+
+      inline bool decode_null(const value& val, null&)
+      {
+        return val.decode_null();
+      }
+
+      inline bool decode_octets(const value& val, octets& v)
+      {
+        if (val.primitive()) {
+          v.data = val.data();
+          v.length = val.length();
+
+          return true;
+        }
+
+        return false;
+      }
+
+      inline bool decode_oid(const value& val, oid& v)
+      {
+        return val.decode_oid(v.components, v.ncomponents);
+      }
+
+      inline bool decode_utc_time(const value& val, time_t& v)
+      {
+        return val.decode_utc_time(v);
+      }
+
+      inline bool decode_generalized_time(const value& val, struct timeval& v)
+      {
+        return val.decode_generalized_time(v);
+      }
+
+      inline bool encode_boolean(encoder& enc, tag_class tc, uint32_t tn, bool v)
+      {
+        return enc.add_boolean(tc, tn, v);
+      }
+
+      inline bool encode_integer(encoder& enc,
+                                 tag_class tc,
+                                 uint32_t tn,
+                                 int64_t v)
+      {
+        return enc.add_integer(tc, tn, v);
+      }
+
+      inline bool encode_null(encoder& enc,
+                              tag_class tc,
+                              uint32_t tn,
+                              const null&)
+      {
+        return enc.add_null(tc, tn);
+      }
+
+      inline bool encode_octets(encoder& enc,
+                                tag_class tc,
+                                uint32_t tn,
+                                const octets& v)
+      {
+        return enc.add_data(tc, tn, v.data, v.length, encoder::copy::shallow);
+      }
+
+      inline bool encode_generalized_time(encoder& enc,
+                                          tag_class tc,
+                                          uint32_t tn,
+                                          const struct timeval& v)
+      {
+        return enc.add_generalized_time(tc, tn, v);
+      }
+
+      template<tag_class TC, uint32_t TN>
+      inline bool encode_boolean(encoder& enc, bool v)
+      {
+        return enc.add_boolean<TC, TN>(v);
+      }
+
+      template<tag_class TC, uint32_t TN>
+      inline bool encode_integer(encoder& enc, int64_t v)
+      {
+        return enc.add_integer<TC, TN>(v);
+      }
+
+      template<tag_class TC, uint32_t TN>
+      inline bool encode_null(encoder& enc, const null&)
+      {
+        return enc.add_null<TC, TN>();
+      }
+
+      template<tag_class TC, uint32_t TN>
+      inline bool encode_octets(encoder& enc, const octets& v)
+      {
+        return enc.add_data<TC, TN>(v.data, v.length, encoder::copy::shallow);
+      }
+
+      template<tag_class TC, uint32_t TN>
+      inline bool encode_generalized_time(encoder& enc,
+                                          const struct timeval& v)
+      {
+        return enc.add_generalized_time<TC, TN>(v);
+      }
+    }
+  }
+}
+
+#endif // ASN1_BER_SCHEMA_RUNTIME_H
@@ -0,0 +1,323 @@
+#include <string.h>
+#include "asn1/ber/segmented_decoder.h"
+#include "asn1/ber/framer.h"
+
+asn1::ber::segmented_decoder::segmented_decoder(const struct iovec* iov,
+                                                size_t iovcnt)
+  : _M_iov(iov),
+    _M_iovcnt(iovcnt)
+{
+  // Compute total length.
+  for (size_t i = 0; i < iovcnt; i++) {
+    _M_length += iov[i].iov_len;
+  }
+}
+
+asn1::ber::decoder::result asn1::ber::segmented_decoder::next(value& val)
+{
+  // If not at the end of the data...
+  if (_M_offset < _M_length) {
+    // Save initial offset.
+    const size_t offset = _M_offset;
+
+    // Primitive or the maximum depth has not been reached?
+    size_t available;
+    if (((*seek(_M_offset, available) & 0x20u) == 0) ||
+        (_M_depth < max_depth)) {
+      // Decode identifier and length octets.
+      uint8_t idoctet;
+      header hdr;
+      decoder::result res = decode_header(_M_offset, _M_length, idoctet, hdr);
+
+      // If the header could be decoded...
+      if (res == decoder::result::no_error) {
+        // Indefinite length?
+        if (!hdr.definite_length) {
+          // Find end-of-contents.
+          size_t eoc = _M_offset;
+          if ((res = find_eoc(_M_length, eoc)) != decoder::result::no_error) {
+            _M_offset = offset;
+            return res;
+          }
+
+          hdr.length = eoc - _M_offset;
+        }
+
+        // If the contents octets fit in the buffer...
+        if (hdr.length <= _M_length - _M_offset) {
+          val._M_tag_class = hdr.tag_class;
+          val._M_primitive = !hdr.constructed;
+          val._M_tag_number = hdr.tag_number;
+          val._M_length = hdr.length;
+
+          _M_primitive = val._M_primitive;
+
+          // Primitive?
+          if (_M_primitive) {
+            // Get contents octets (copy them if they straddle a boundary).
+            val._M_data = contents(_M_offset, hdr.length);
+          } else {
+            available = 0;
+            const uint8_t* const data = (hdr.length > 0) ?
+                                          seek(_M_offset, available) :
+                                          nullptr;
+
+            // The contents octets are only available if they are in one
+            // segment.
+            val._M_data = (hdr.length <= available) ? data : nullptr;
+
+            _M_constructed[_M_depth].length = _M_length;
+
+            _M_constructed[_M_depth].definite_length = hdr.definite_length;
+
+            _M_constructed[_M_depth].contents_offset = _M_offset;
+            _M_constructed[_M_depth].contents_length = hdr.length;
+          }
+
+          // Definite length?
+          if (hdr.definite_length) {
+            // Skip contents octets.
+            _M_offset += hdr.length;
+          } else {
+            // Skip contents octets and end-of-contents.
+            _M_offset += (hdr.length + 2);
+          }
+
+          // Save total length of the value (header + contents octets +
+          // end-of-contents octets [optional]).
+          val._M_total_length = _M_offset - offset;
+
+          return decoder::result::no_error;
+        } else {
+          res = decoder::result::unexpected_eof;
+        }
+      }
+
+      _M_offset = offset;
+
+      return res;
+    } else {
+      return decoder::result::max_depth_exceeded;
+    }
+  } else {
+    return decoder::result::eof;
+  }
+}
+
+bool asn1::ber::segmented_decoder::enter_constructed()
+{
+  // Constructed?
+  if (!_M_primitive) {
+    const constructed* const constructed = &_M_constructed[_M_depth++];
+
+    _M_offset = constructed->contents_offset;
+    _M_length = constructed->contents_offset + constructed->contents_length;
+
+    // The next value (if any) is the first child.
+    _M_primitive = true;
+
+    return true;
+  }
+
+  return false;
+}
+
+bool asn1::ber::segmented_decoder::leave_constructed()
+{
+  if (_M_depth > 0) {
+    const constructed* const constructed = &_M_constructed[--_M_depth];
+
+    _M_length = constructed->length;
+
+    // Definite length?
+    if (constructed->definite_length) {
+      // Skip contents octets.
+      _M_offset = constructed->contents_offset + constructed->contents_length;
+    } else {
+      // Skip contents octets and end-of-contents.
+      _M_offset = constructed->contents_offset +
+                  constructed->contents_length +
+                  2;
+    }
+
+    _M_primitive = true;
+
+    return true;
+  }
+
+  return false;
+}
+
+const uint8_t* asn1::ber::segmented_decoder::seek(size_t offset,
+                                                  size_t& available)
+{
+  // Move backwards.
+  while (offset < _M_segment_offset) {
+    _M_segment_offset -= _M_iov[--_M_segment].iov_len;
+  }
+
+  // Move forward (skipping empty segments).
+  while (offset - _M_segment_offset >= _M_iov[_M_segment].iov_len) {
+    _M_segment_offset += _M_iov[_M_segment++].iov_len;
+  }
+
+  const size_t off = offset - _M_segment_offset;
+
+  available = _M_iov[_M_segment].iov_len - off;
+
+  return static_cast<const uint8_t*>(_M_iov[_M_segment].iov_base) + off;
+}
+
+asn1::ber::decoder::result
+asn1::ber::segmented_decoder::decode_header(size_t& offset,
+                                            size_t end,
+                                            uint8_t& idoctet,
+                                            header& hdr)
+{
+  size_t available;
+  const uint8_t* data = seek(offset, available);
+
+  // Maximum number of octets of the header.
+  size_t len = end - offset;
+  if (len > max_header_length) {
+    len = max_header_length;
+  }
+
+  uint8_t buf[max_header_length];
+
+  // If the header might straddle a boundary...
+  if (available < len) {
+    // Copy the octets which might belong to the header.
+    size_t copied = 0;
+
+    do {
+      memcpy(buf + copied, data, available);
+      copied += available;
+
+      if (copied < len) {
+        data = seek(offset + copied, available);
+
+        if (available > len - copied) {
+          available = len - copied;
+        }
+      } else {
+        break;
+      }
+    } while (true);
+
+    data = buf;
+  }
+
+  idoctet = data[0];
+
+  size_t off = 0;
+  const decoder::result res = hdr.decode(data, len, off);
+
+  // If the header could be decoded...
+  if (res == decoder::result::no_error) {
+    offset += off;
+  }
+
+  return res;
+}
+
+asn1::ber::decoder::result
+asn1::ber::segmented_decoder::find_eoc(size_t end, size_t& offset)
+{
+  // Number of open indefinite-length values.
+  size_t nested = 1;
+
+  size_t off = offset;
+
+  // While the end of the data has not been reached...
+  while (off < end) {
+    // Decode identifier and length octets.
+    uint8_t idoctet;
+    header hdr;
+    const decoder::result res = decode_header(off, end, idoctet, hdr);
+
+    // If the header couldn't be decoded...
+    if (res != decoder::result::no_error) {
+      return res;
+    }
+
+    // Definite length?
+    if (hdr.definite_length) {
+      // If the contents octets fit in the buffer...
+      if (hdr.length <= end - off) {
+        // If not the end-of-contents...
+        if (idoctet != 0) {
+          // Skip contents octets.
+          off += hdr.length;
+        } else if (hdr.length == 0) {
+          // If this is the end-of-contents of the outermost value...
+          if (--nested == 0) {
+            // Make `offset` point to end-of-contents.
+            offset = off - 2;
+
+            return decoder::result::no_error;
+          }
+        } else {
+          return decoder::result::invalid_length;
+        }
+      } else {
+        return decoder::result::unexpected_eof;
+      }
+    } else if (nested < framer::max_nested_eoc) {
+      // Enter nested indefinite-length value.
+      nested++;
+    } else {
+      return decoder::result::max_nested_eoc_exceeded;
+    }
+  }
+
+  return decoder::result::unexpected_eof;
+}
+
+const uint8_t* asn1::ber::segmented_decoder::contents(size_t offset,
+                                                      size_t length)
+{
+  // Empty contents?
+  if (length == 0) {
+    return nullptr;
+  }
+
+  size_t available;
+  const uint8_t* data = seek(offset, available);
+
+  // If the contents octets are in one segment...
+  if (length <= available) {
+    return data;
+  }
+
+  // If the scratch buffer is too small...
+  if (length > _M_scratch_size) {
+    // Free the old buffer (its contents are not needed).
+    free(_M_scratch);
+
+    if ((_M_scratch = static_cast<uint8_t*>(malloc(length))) != nullptr) {
+      _M_scratch_size = length;
+    } else {
+      _M_scratch_size = 0;
+      return nullptr;
+    }
+  }
+
+  // Copy the contents octets.
+  size_t copied = 0;
+
+  do {
+    memcpy(_M_scratch + copied, data, available);
+    copied += available;
+
+    if (copied < length) {
+      data = seek(offset + copied, available);
+
+      if (available > length - copied) {
+        available = length - copied;
+      }
+    } else {
+      return _M_scratch;
+    }
+  } while (true);
+}
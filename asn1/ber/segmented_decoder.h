@@ -0,0 +1,121 @@
+#ifndef ASN1_BER_SEGMENTED_DECODER_H
+#define ASN1_BER_SEGMENTED_DECODER_H
+
+#include <stdlib.h>
+#include <sys/uio.h>
+#include "asn1/ber/header.h"
+
+namespace asn1 {
+  namespace ber {
+    // ASN.1 BER decoder of a chain of buffer segments.
+    //
+    // Same interface and results as `decoder`, but the input is a sequence of
+    // segments (e.g. the fixed-size chunks filled by readv()) and the values
+    // can cross the segment boundaries. The contents of a primitive value
+    // point into its segment; only when the contents straddle a boundary are
+    // they copied into a scratch buffer owned by the decoder, which is reused
+    // by the next straddling value. The contents of a constructed value are
+    // only available if they are contained in one segment (otherwise
+    // `value::data()` returns nullptr: use `enter_constructed()`); the same
+    // applies to a straddling primitive value whose contents couldn't be
+    // copied (out of memory). The segments must outlive the decoder.
+    class segmented_decoder {
+      public:
+        // Constructor.
+        segmented_decoder(const struct iovec* iov, size_t iovcnt);
+
+        // Destructor.
+        ~segmented_decoder();
+
+        // Get next object.
+        decoder::result next(value& val);
+
+        // Enter constructed.
+        bool enter_constructed();
+
+        // Leave constructed.
+        bool leave_constructed();
+
+      private:
+        // Maximum depth.
+        static constexpr const size_t max_depth = 128;
+
+        // Maximum length of the identifier and length octets.
+        static constexpr const size_t max_header_length = 16;
+
+        // Segments.
+        const struct iovec* _M_iov;
+        size_t _M_iovcnt;
+
+        // Current segment (the offsets are relative to the beginning of the
+        // first segment).
+        size_t _M_segment = 0;
+
+        // Offset of the current segment.
+        size_t _M_segment_offset = 0;
+
+        // End of the current level.
+        size_t _M_length = 0;
+
+        // Offset.
+        size_t _M_offset = 0;
+
+        // Was the last value a primitive value?
+        bool _M_primitive = true;
+
+        // Constructed.
+        struct constructed {
+          // End of the enclosing level.
+          size_t length;
+
+          // Definite length?
+          bool definite_length;
+
+          // Contents offset.
+          size_t contents_offset;
+
+          // Contents length.
+          size_t contents_length;
+        };
+
+        constructed _M_constructed[max_depth];
+
+        // Depth.
+        size_t _M_depth = 0;
+
+        // Scratch buffer (contents straddling a boundary).
+        uint8_t* _M_scratch = nullptr;
+        size_t _M_scratch_size = 0;
+
+        // Get pointer to the octet at `offset` (`offset` must be smaller than
+        // the total length) and number of contiguous octets.
+        const uint8_t* seek(size_t offset, size_t& available);
+
+        // Decode identifier and length octets at `offset` (`offset` is made
+        // point to the contents octets).
+        decoder::result decode_header(size_t& offset,
+                                      size_t end,
+                                      uint8_t& idoctet,
+                                      header& hdr);
+
+        // Find end-of-contents (`offset` points to the contents octets of an
+        // indefinite-length value and is made point to its end-of-contents).
+        decoder::result find_eoc(size_t end, size_t& offset);
+
+        // Get pointer to the contents octets (copied into the scratch buffer
+        // if they straddle a boundary).
+        const uint8_t* contents(size_t offset, size_t length);
+
+        // Disable copy constructor and assignment operator.
+        segmented_decoder(const segmented_decoder&) = delete;
+        segmented_decoder& operator=(const segmented_decoder&) = delete;
+    };
+
+    inline segmented_decoder::~segmented_decoder()
+    {
+      free(_M_scratch);
+    }
+  }
+}
+
+#endif // ASN1_BER_SEGMENTED_DECODER_H
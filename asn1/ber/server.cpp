@@ -1,63 +1,62 @@
-#include <stdlib.h>
 #include <string.h>
-#include <sys/stat.h>
+#include <inttypes.h>
+#include <new>
 #include "asn1/ber/server.h"
-#include "asn1/ber/decoder.h"
+#include "asn1/ber/sinks/file.h"
+#include "asn1/ber/framer.h"
+#include "util/clock.h"
 
 asn1::ber::server::~server()
 {
-  // Stop receiver (if running).
-  _M_receiver.stop();
+  // Stop receiver and sinks (if running).
+  stop();
 
-  if (_M_files) {
-    for (size_t i = _M_receiver.number_workers(); i > 0; i--) {
-      if (_M_files[i - 1].f) {
-        move(_M_files[i - 1]);
-      }
-    }
+  for (size_t i = _M_nsinks; i > 0; i--) {
+    delete _M_sinks[i - 1];
+  }
 
-    free(_M_files);
+  if (_M_batches) {
+    delete [] _M_batches;
   }
 }
 
-bool asn1::ber::server::start(const char* tempdir,
-                              const char* finaldir,
-                              size_t maxfilesize,
-                              time_t maxfileage)
+bool asn1::ber::server::add_sink(sinks::sink* sink, bool lossy)
 {
-  const size_t tempdirlen = strlen(tempdir);
-  const size_t finaldirlen = strlen(finaldir);
-
-  struct stat sbuf;
-  if ((tempdirlen < sizeof(_M_tempdir)) &&
-      (finaldirlen < sizeof(_M_finaldir)) &&
-      (maxfilesize >= min_file_size) &&
-      (maxfilesize <= max_file_size) &&
-      (maxfileage >= min_file_age) &&
-      (maxfileage <= max_file_age) &&
-      (stat(tempdir, &sbuf) == 0) &&
-      (S_ISDIR(sbuf.st_mode)) &&
-      (stat(finaldir, &sbuf) == 0) &&
-      (S_ISDIR(sbuf.st_mode))) {
-    _M_files = static_cast<file*>(
-                 malloc(_M_receiver.number_workers() * sizeof(file))
-               );
-
-    if (_M_files) {
-      for (size_t i = _M_receiver.number_workers(); i > 0; i--) {
-        _M_files[i - 1].f = nullptr;
-        _M_files[i - 1].count = 0;
-        _M_files[i - 1].timestamp_last_file = 0;
-      }
+  // If there are not too many sinks...
+  if (_M_nsinks < max_sinks) {
+    // Create sink queue.
+    if ((_M_sinks[_M_nsinks] = new (std::nothrow) sinks::queue(sink, lossy)) !=
+        nullptr) {
+      _M_nsinks++;
+      return true;
+    }
+  }
 
-      memcpy(_M_tempdir, tempdir, tempdirlen);
-      _M_tempdir[tempdirlen] = 0;
+  delete sink;
 
-      memcpy(_M_finaldir, finaldir, finaldirlen);
-      _M_finaldir[finaldirlen] = 0;
+  return false;
+}
 
-      _M_maxfilesize = maxfilesize;
-      _M_maxfileage = maxfileage;
+bool asn1::ber::server::start()
+{
+  // If at least one sink has been added...
+  if (_M_nsinks > 0) {
+    // If there is only one sink, its batches are never dropped (the records
+    // would be lost).
+    if (_M_nsinks == 1) {
+      _M_sinks[0]->lossy(false);
+    }
+    // Create pools of batches.
+    _M_batches = new (std::nothrow)
+                 sinks::batches[_M_receiver.number_workers()];
+
+    if (_M_batches) {
+      // Start sinks.
+      for (size_t i = 0; i < _M_nsinks; i++) {
+        if (!_M_sinks[i]->start(_M_receiver.number_workers())) {
+          return false;
+        }
+      }
 
       net::tcp::connection::callbacks callbacks(new_connection,
                                                 data_received,
@@ -65,16 +64,44 @@ bool asn1::ber::server::start(const char* tempdir,
                                                 this);
 
       // Start TCP receiver.
-      return _M_receiver.start(callbacks, idle, this);
+      return _M_receiver.start(callbacks, nullptr, this);
     }
   }
 
   return false;
 }
 
+bool asn1::ber::server::start(const char* tempdir,
+                              const char* finaldir,
+                              size_t maxfilesize,
+                              time_t maxfileage)
+{
+  return ((add_sink(new (std::nothrow) sinks::file(tempdir,
+                                                   finaldir,
+                                                   maxfilesize,
+                                                   maxfileage))) &&
+          (start()));
+}
+
+void asn1::ber::server::stop()
+{
+  // Stop metrics endpoint (if running).
+  _M_endpoint.stop();
+
+  // Stop receiver (if running).
+  _M_receiver.stop();
+
+  // Stop sinks (the pending records are processed).
+  for (size_t i = 0; i < _M_nsinks; i++) {
+    _M_sinks[i]->stop();
+  }
+}
+
 bool asn1::ber::server::new_connection(net::tcp::connection* conn,
                                        size_t nworker)
 {
+  _M_metrics[nworker].connections_accepted.add();
+
   return true;
 }
 
@@ -83,41 +110,84 @@ bool asn1::ber::server::data_received(const void* data,
                                       net::tcp::connection* conn,
                                       size_t nworker)
 {
-  // Get current time.
-  const time_t now = time(nullptr);
+  // Get current time (cached by the worker).
+  const time_t now = _M_receiver.clock(nworker).now();
+
+  metrics& metrics = _M_metrics[nworker];
+
+  metrics.bytes_read.add(len);
 
   string::buffer& buf = conn->buffer();
 
+  metrics.buffer_high_water_mark.max(buf.length());
+
   const uint8_t* const begin = static_cast<const uint8_t*>(buf.data());
 
   const uint8_t* p = begin;
   len = buf.length();
 
+  sinks::batch* batch = nullptr;
+
+  framer framer(begin, len);
+
   do {
-    decoder decoder(p, len);
+    // Get length of the next record.
+    size_t reclen;
+    const decoder::result res = framer.next(reclen);
 
-    value val;
+    metrics.records[static_cast<size_t>(res)].add();
 
-    switch (decoder.next(val)) {
+    switch (res) {
       case decoder::result::no_error:
-        // Write record.
-        if (write(nworker, p, val.total_length(), now)) {
+        // If the batch has not been created yet...
+        if (!batch) {
+          // Get batch.
+          if ((batch = _M_batches[nworker].pop()) == nullptr) {
+            metrics.batch_errors.add();
+            return false;
+          }
+        }
+
+        // Add record to the batch.
+        if (batch->add(p, reclen)) {
+          metrics.bytes_framed.add(reclen);
+
           // Skip record.
-          p += val.total_length();
-          len -= val.total_length();
+          p += reclen;
         } else {
+          metrics.batch_errors.add();
+
+          // If records have been added to the batch...
+          if (batch->count() > 0) {
+            // Dispatch the records preceding the one which couldn't be added.
+            dispatch(batch, nworker, now, conn->timestamp());
+          } else {
+            // Return batch to the pool.
+            _M_batches[nworker].push(batch);
+          }
+
           return false;
         }
 
         break;
+      case decoder::result::eof:
       case decoder::result::unexpected_eof:
         if (p != begin) {
-          // Remove the first `p - begin` bytes.
-          buf.erase(0, p - begin);
+          // Dispatch batch.
+          dispatch(batch, nworker, now, conn->timestamp());
+
+          // Remove the first `p - begin` bytes (the partial record left, if
+          // any, is timestamped with the time of the last read).
+          conn->consume(p - begin);
         }
 
         return true;
       default:
+        // Dispatch the records preceding the invalid one.
+        if (batch) {
+          dispatch(batch, nworker, now, conn->timestamp());
+        }
+
         return false;
     }
   } while (true);
@@ -126,99 +196,355 @@ bool asn1::ber::server::data_received(const void* data,
 void asn1::ber::server::connection_closed(net::tcp::connection* conn,
                                           size_t nworker)
 {
+  _M_metrics[nworker].connections_closed.add();
 }
 
-void asn1::ber::server::idle(size_t nworker)
+void asn1::ber::server::dispatch(sinks::batch* batch,
+                                 size_t nworker,
+                                 time_t now,
+                                 uint64_t received)
 {
-  // If the file is open and has not been updated for a while...
-  if ((_M_files[nworker].f) &&
-      (time(nullptr) - _M_files[nworker].timestamp_last_write >
-       _M_maxfileage)) {
-    // Close file and move it to the final directory.
-    move(_M_files[nworker]);
+  const uint64_t framed = util::clock::monotonic();
+
+  _M_metrics[nworker].latencies.record(
+    (framed > received) ? framed - received : 0,
+    batch->count()
+  );
+
+  batch->nworker(nworker);
+  batch->timestamp(now);
+  batch->framed(framed);
+
+  // The batch is shared by all the sinks.
+  batch->references(_M_nsinks);
+
+  // For each sink...
+  for (size_t i = 0; i < _M_nsinks; i++) {
+    // Push batch (if the sink's queue is full, waits for room or, if the
+    // sink is lossy, the batch is dropped for this sink).
+    if (!_M_sinks[i]->push(batch)) {
+      batch->release();
+    }
   }
 }
 
-bool asn1::ber::server::open(size_t nworker, time_t now)
+bool asn1::ber::server::render_metrics(string::buffer& buf) const
 {
-  struct tm tm;
-  localtime_r(&now, &tm);
-
-  file* const file = &_M_files[nworker];
-
-  file->count = (now != file->timestamp_last_file) ? 0 : file->count + 1;
-
-  // Compose filename.
-  snprintf(file->name,
-           sizeof(file->name),
-           "%04u%02u%02u-%02u%02u%02u-%03zu-%06zu.asn1",
-           1900 + tm.tm_year,
-           1 + tm.tm_mon,
-           tm.tm_mday,
-           tm.tm_hour,
-           tm.tm_min,
-           tm.tm_sec,
-           nworker,
-           file->count);
-
-  // Compose pathname.
-  char pathname[PATH_MAX];
-  snprintf(pathname, sizeof(pathname), "%s/%s", _M_tempdir, file->name);
-
-  // Open file.
-  file->f = fopen(pathname, "w");
-
-  // If the file could be opened...
-  if (file->f) {
-    file->size = 0;
-    file->timestamp_last_file = now;
-
-    return true;
-  } else {
+  const size_t nworkers = _M_receiver.number_workers();
+
+  // Per-worker counters.
+  static const struct {
+    const char* name;
+    const char* type;
+    const char* help;
+    const util::counter metrics::* counter;
+  } counters[] = {
+    {
+      "asn1_ber_connections_accepted_total",
+      "counter",
+      "Number of connections accepted.",
+      &metrics::connections_accepted
+    },
+    {
+      "asn1_ber_connections_closed_total",
+      "counter",
+      "Number of connections closed.",
+      &metrics::connections_closed
+    },
+    {
+      "asn1_ber_bytes_read_total",
+      "counter",
+      "Number of bytes read.",
+      &metrics::bytes_read
+    },
+    {
+      "asn1_ber_bytes_framed_total",
+      "counter",
+      "Number of bytes of complete records.",
+      &metrics::bytes_framed
+    },
+    {
+      "asn1_ber_buffer_high_water_mark_bytes",
+      "gauge",
+      "Highest number of bytes buffered by a connection.",
+      &metrics::buffer_high_water_mark
+    },
+    {
+      "asn1_ber_batch_errors_total",
+      "counter",
+      "Number of batches which couldn't be created.",
+      &metrics::batch_errors
+    }
+  };
+
+  for (size_t i = 0; i < sizeof(counters) / sizeof(counters[0]); i++) {
+    if (!buf.format("# HELP %s %s\n# TYPE %s %s\n",
+                    counters[i].name,
+                    counters[i].help,
+                    counters[i].name,
+                    counters[i].type)) {
+      return false;
+    }
+
+    // For each worker...
+    for (size_t j = 0; j < nworkers; j++) {
+      if (!buf.format("%s{worker=\"%zu\"} %" PRIu64 "\n",
+                      counters[i].name,
+                      j,
+                      (_M_metrics[j].*counters[i].counter).get())) {
+        return false;
+      }
+    }
+  }
+
+  // Active connections.
+  if (!buf.format("# HELP asn1_ber_connections_active "
+                  "Number of open connections.\n"
+                  "# TYPE asn1_ber_connections_active gauge\n")) {
     return false;
   }
-}
 
-bool asn1::ber::server::move(file& file) const
-{
-  // Close file.
-  fclose(file.f);
-  file.f = nullptr;
+  for (size_t i = 0; i < nworkers; i++) {
+    const uint64_t closed = _M_metrics[i].connections_closed.get();
+    const uint64_t accepted = _M_metrics[i].connections_accepted.get();
+
+    if (!buf.format("asn1_ber_connections_active{worker=\"%zu\"} %" PRIu64
+                    "\n",
+                    i,
+                    (accepted > closed) ? accepted - closed : 0)) {
+      return false;
+    }
+  }
+
+  // Framing results.
+  if (!buf.format("# HELP asn1_ber_framing_results_total "
+                  "Number of framing results.\n"
+                  "# TYPE asn1_ber_framing_results_total counter\n")) {
+    return false;
+  }
+
+  for (size_t i = 0; i < nworkers; i++) {
+    for (size_t j = 0; j < decoder::number_results; j++) {
+      if (!buf.format("asn1_ber_framing_results_total"
+                      "{worker=\"%zu\",result=\"%s\"} %" PRIu64 "\n",
+                      i,
+                      to_string(static_cast<decoder::result>(j)),
+                      _M_metrics[i].records[j].get())) {
+        return false;
+      }
+    }
+  }
+
+  // Per-sink counters.
+  static const struct {
+    const char* name;
+    const char* help;
+    uint64_t (sinks::queue::*counter)() const;
+  } sinkcounters[] = {
+    {
+      "asn1_ber_sink_records_total",
+      "Number of records written by the sink.",
+      &sinks::queue::records
+    },
+    {
+      "asn1_ber_sink_bytes_total",
+      "Number of bytes written by the sink.",
+      &sinks::queue::bytes
+    },
+    {
+      "asn1_ber_sink_dropped_batches_total",
+      "Number of batches dropped (sink's queue full).",
+      &sinks::queue::dropped
+    },
+    {
+      "asn1_ber_sink_queue_waits_total",
+      "Number of batches which waited for room in the sink's queue.",
+      &sinks::queue::waits
+    },
+    {
+      "asn1_ber_sink_errors_total",
+      "Number of write errors.",
+      &sinks::queue::errors
+    }
+  };
+
+  for (size_t i = 0; i < sizeof(sinkcounters) / sizeof(sinkcounters[0]); i++) {
+    if (!buf.format("# HELP %s %s\n# TYPE %s counter\n",
+                    sinkcounters[i].name,
+                    sinkcounters[i].help,
+                    sinkcounters[i].name)) {
+      return false;
+    }
+
+    // For each sink...
+    for (size_t j = 0; j < _M_nsinks; j++) {
+      if (!buf.format("%s{sink=\"%s\",index=\"%zu\"} %" PRIu64 "\n",
+                      sinkcounters[i].name,
+                      _M_sinks[j]->get()->name(),
+                      j,
+                      (_M_sinks[j]->*sinkcounters[i].counter)())) {
+        return false;
+      }
+    }
+  }
+
+  // Rotations.
+  if (!buf.format("# HELP asn1_ber_sink_rotations_total "
+                  "Number of output rotations.\n"
+                  "# TYPE asn1_ber_sink_rotations_total counter\n")) {
+    return false;
+  }
+
+  for (size_t i = 0; i < _M_nsinks; i++) {
+    if (!buf.format("asn1_ber_sink_rotations_total"
+                    "{sink=\"%s\",index=\"%zu\"} %" PRIu64 "\n",
+                    _M_sinks[i]->get()->name(),
+                    i,
+                    _M_sinks[i]->get()->rotations())) {
+      return false;
+    }
+  }
+
+  // Latencies between the reception of the records and their framing
+  // (merged from all the workers).
+  if (!buf.format("# HELP asn1_ber_framing_latency_seconds "
+                  "Time between the reception and the framing of the "
+                  "records.\n"
+                  "# TYPE asn1_ber_framing_latency_seconds summary\n")) {
+    return false;
+  }
+
+  util::histogram* const latencies = new (std::nothrow) util::histogram();
+  if (!latencies) {
+    return false;
+  }
 
-  // Compose pathname in the temporary directory.
-  char oldpath[PATH_MAX];
-  snprintf(oldpath, sizeof(oldpath), "%s/%s", _M_tempdir, file.name);
+  for (size_t i = 0; i < nworkers; i++) {
+    latencies->add(_M_metrics[i].latencies);
+  }
+
+  const bool rendered = render_latencies(buf,
+                                         "asn1_ber_framing_latency_seconds",
+                                         nullptr,
+                                         *latencies);
+
+  delete latencies;
+
+  if (!rendered) {
+    return false;
+  }
+
+  // Latencies between the framing of the records and their write.
+  if (!buf.format("# HELP asn1_ber_sink_write_latency_seconds "
+                  "Time between the framing and the write of the records.\n"
+                  "# TYPE asn1_ber_sink_write_latency_seconds summary\n")) {
+    return false;
+  }
+
+  for (size_t i = 0; i < _M_nsinks; i++) {
+    char labels[64];
+    snprintf(labels,
+             sizeof(labels),
+             "sink=\"%s\",index=\"%zu\"",
+             _M_sinks[i]->get()->name(),
+             i);
+
+    if (!render_latencies(buf,
+                          "asn1_ber_sink_write_latency_seconds",
+                          labels,
+                          _M_sinks[i]->latencies())) {
+      return false;
+    }
+  }
+
+  // Latencies between the write of the oldest record of an output and its
+  // rotation.
+  if (!buf.format("# HELP asn1_ber_sink_rotation_latency_seconds "
+                  "Time between the write of the first record of an output "
+                  "and its rotation.\n"
+                  "# TYPE asn1_ber_sink_rotation_latency_seconds summary\n")) {
+    return false;
+  }
 
-  // Compose pathname in the final directory.
-  char newpath[PATH_MAX];
-  snprintf(newpath, sizeof(newpath), "%s/%s", _M_finaldir, file.name);
+  for (size_t i = 0; i < _M_nsinks; i++) {
+    const util::histogram* const
+      histogram = _M_sinks[i]->get()->rotation_latencies();
+
+    // If the sink rotates its output...
+    if (histogram) {
+      char labels[64];
+      snprintf(labels,
+               sizeof(labels),
+               "sink=\"%s\",index=\"%zu\"",
+               _M_sinks[i]->get()->name(),
+               i);
+
+      if (!render_latencies(buf,
+                            "asn1_ber_sink_rotation_latency_seconds",
+                            labels,
+                            *histogram)) {
+        return false;
+      }
+    }
+  }
 
-  // Move file.
-  return (rename(oldpath, newpath) == 0);
+  return true;
 }
 
-bool asn1::ber::server::write(size_t nworker,
-                              const void* buf,
-                              size_t len,
-                              time_t now)
+bool asn1::ber::server::render_latencies(string::buffer& buf,
+                                         const char* name,
+                                         const char* labels,
+                                         const util::histogram& histogram)
 {
-  file* const file = &_M_files[nworker];
+  static constexpr const char* const quantiles[] = {
+    "0.5", "0.9", "0.99", "0.999", "1"
+  };
+
+  static constexpr const double values[] = {0.5, 0.9, 0.99, 0.999, 1.0};
+
+  const char* const separator = labels ? "," : "";
+  if (!labels) {
+    labels = "";
+  }
 
-  // If the file has not been opened yet...
-  if (!file->f) {
-    // Open file.
-    if (!open(nworker, now)) {
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    if (!buf.format("%s{%s%squantile=\"%s\"} %.6f\n",
+                    name,
+                    labels,
+                    separator,
+                    quantiles[i],
+                    histogram.quantile(values[i]) / 1e6)) {
       return false;
     }
   }
 
-  // Write to the file.
-  if (fwrite(buf, 1, len, file->f) == len) {
-    file->size += len;
-    file->timestamp_last_write = now;
-
-    return (file->size < _M_maxfilesize) ? true : move(*file);
+  // If there are labels...
+  if (*labels) {
+    return buf.format("%s_sum{%s} %.6f\n%s_count{%s} %" PRIu64 "\n",
+                      name,
+                      labels,
+                      histogram.sum() / 1e6,
+                      name,
+                      labels,
+                      histogram.count());
   } else {
-    return false;
+    return buf.format("%s_sum %.6f\n%s_count %" PRIu64 "\n",
+                      name,
+                      histogram.sum() / 1e6,
+                      name,
+                      histogram.count());
+  }
+}
+
+bool asn1::ber::server::metrics_handler(const char* path,
+                                        size_t pathlen,
+                                        string::buffer& body,
+                                        void* user)
+{
+  // If the path is "/metrics"...
+  if ((pathlen == 8) && (memcmp(path, "/metrics", 8) == 0)) {
+    return static_cast<const server*>(user)->render_metrics(body);
   }
+
+  return false;
 }
@@ -1,26 +1,19 @@
 #ifndef ASN1_BER_SERVER_H
 #define ASN1_BER_SERVER_H
 
-#include <stdio.h>
 #include <time.h>
 #include "net/tcp/receiver.h"
+#include "net/http/endpoint.h"
+#include "asn1/ber/sinks/queue.h"
+#include "asn1/ber/metrics.h"
 
 namespace asn1 {
   namespace ber {
     // ASN.1 BER server.
     class server {
       public:
-        // Minimum file size.
-        static constexpr const size_t min_file_size = 1;
-
-        // Maximum file size.
-        static constexpr const size_t max_file_size = 4 * 1024 * 1024;
-
-        // Minimum file age (seconds).
-        static constexpr const time_t min_file_age = 1;
-
-        // Maximum file age (seconds).
-        static constexpr const time_t max_file_age = 3600;
+        // Maximum number of sinks.
+        static constexpr const size_t max_sinks = 8;
 
         // Constructor.
         server(size_t nworkers = net::tcp::receiver::default_workers);
@@ -34,7 +27,16 @@ namespace asn1 {
         bool listen(const char* address, in_port_t minport, in_port_t maxport);
         bool listen(const struct sockaddr& addr, socklen_t addrlen);
 
+        // Add sink (the server takes ownership of the sink, also if it
+        // cannot be added). When the queue of a sink is full, the workers
+        // wait (backpressure) unless the sink is `lossy`, whose batches are
+        // dropped instead; a single sink is never lossy.
+        bool add_sink(sinks::sink* sink, bool lossy = false);
+
         // Start.
+        bool start();
+
+        // Start with a file sink.
         bool start(const char* tempdir,
                    const char* finaldir,
                    size_t maxfilesize,
@@ -43,44 +45,35 @@ namespace asn1 {
         // Stop.
         void stop();
 
+        // Serve metrics (Prometheus text format) under the path "/metrics".
+        // <address> ::= unix:<path> | <ip-address>:<port>
+        bool serve_metrics(const char* address);
+
+        // Render metrics.
+        bool render_metrics(string::buffer& buf) const;
+
       private:
         // TCP receiver.
         net::tcp::receiver _M_receiver;
 
-        // Temporary directory where to store the ASN.1 files.
-        char _M_tempdir[PATH_MAX];
-
-        // Final directory where to store the ASN.1 files.
-        char _M_finaldir[PATH_MAX];
-
-        // Files for the ASN.1 records (one per worker thread).
-        struct file {
-          // File name.
-          char name[PATH_MAX];
+        // Sinks.
+        sinks::queue* _M_sinks[max_sinks];
+        size_t _M_nsinks = 0;
 
-          // File pointer.
-          FILE* f;
+        // Pools of batches (one per worker thread).
+        sinks::batches* _M_batches = nullptr;
 
-          // File size.
-          size_t size;
+        // Metrics (one per worker thread).
+        metrics _M_metrics[net::tcp::receiver::max_workers];
 
-          // Number of files in the same second.
-          size_t count;
+        // Metrics endpoint.
+        net::http::endpoint _M_endpoint;
 
-          // Timestamp of the last file.
-          time_t timestamp_last_file;
-
-          // Timestamp of the last write.
-          time_t timestamp_last_write;
-        };
-
-        file* _M_files = nullptr;
-
-        // Maximum file size.
-        size_t _M_maxfilesize;
-
-        // Maximum file age.
-        time_t _M_maxfileage;
+        // Metrics handler.
+        static bool metrics_handler(const char* path,
+                                    size_t pathlen,
+                                    string::buffer& body,
+                                    void* user);
 
         // New connection callback.
         static bool new_connection(net::tcp::connection* conn,
@@ -108,21 +101,18 @@ namespace asn1 {
 
         void connection_closed(net::tcp::connection* conn, size_t nworker);
 
-        // Idle callback.
-        static void idle(size_t nworker, void* user);
-        void idle(size_t nworker);
-
-        // Open file.
-        bool open(size_t nworker, time_t now);
+        // Dispatch batch to the sinks (`received` is the time when the oldest
+        // record of the batch was received).
+        void dispatch(sinks::batch* batch,
+                      size_t nworker,
+                      time_t now,
+                      uint64_t received);
 
-        // Close and move file to the final directory.
-        bool move(file& file) const;
-
-        // Write record.
-        bool write(size_t nworker,
-                   const void* buf,
-                   size_t len,
-                   time_t now);
+        // Render latencies (Prometheus summary).
+        static bool render_latencies(string::buffer& buf,
+                                     const char* name,
+                                     const char* labels,
+                                     const util::histogram& histogram);
 
         // Disable copy constructor and assignment operator.
         server(const server&) = delete;
@@ -156,9 +146,9 @@ namespace asn1 {
       return _M_receiver.listen(addr, addrlen);
     }
 
-    inline void server::stop()
+    inline bool server::serve_metrics(const char* address)
     {
-      _M_receiver.stop();
+      return _M_endpoint.start(address, metrics_handler, this);
     }
 
     inline bool server::new_connection(net::tcp::connection* conn,
@@ -186,11 +176,6 @@ namespace asn1 {
     {
       static_cast<server*>(user)->connection_closed(conn, nworker);
     }
-
-    inline void server::idle(size_t nworker, void* user)
-    {
-      static_cast<server*>(user)->idle(nworker);
-    }
   }
 }
 
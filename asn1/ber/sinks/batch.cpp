@@ -0,0 +1,93 @@
+#include <new>
+#include "asn1/ber/sinks/batch.h"
+
+bool asn1::ber::sinks::batch::add(const void* record, size_t len)
+{
+  if ((allocate()) && (_M_data.append(record, len))) {
+    _M_offsets[_M_used++] = _M_data.length();
+    return true;
+  }
+
+  return false;
+}
+
+void asn1::ber::sinks::batch::release()
+{
+  // If this is the last reference...
+  if (_M_references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    // Return batch to the pool.
+    _M_pool->push(this);
+  }
+}
+
+bool asn1::ber::sinks::batch::allocate()
+{
+  if (_M_used < _M_size) {
+    return true;
+  } else {
+    const size_t size = (_M_size > 0) ? _M_size * 2 : allocation;
+
+    size_t* offsets = static_cast<size_t*>(
+                        realloc(_M_offsets, size * sizeof(size_t))
+                      );
+
+    if (offsets) {
+      _M_offsets = offsets;
+      _M_size = size;
+
+      return true;
+    } else {
+      return false;
+    }
+  }
+}
+
+asn1::ber::sinks::batches::~batches()
+{
+  while (_M_free) {
+    batch* const next = _M_free->_M_next;
+
+    delete _M_free;
+
+    _M_free = next;
+  }
+
+  pthread_mutex_destroy(&_M_mutex);
+}
+
+asn1::ber::sinks::batch* asn1::ber::sinks::batches::pop()
+{
+  pthread_mutex_lock(&_M_mutex);
+
+  batch* b = _M_free;
+
+  // If there are free batches...
+  if (b) {
+    _M_free = b->_M_next;
+
+    pthread_mutex_unlock(&_M_mutex);
+  } else {
+    pthread_mutex_unlock(&_M_mutex);
+
+    // Create new batch.
+    if ((b = new (std::nothrow) batch()) == nullptr) {
+      return nullptr;
+    }
+
+    b->_M_pool = this;
+  }
+
+  b->clear();
+
+  return b;
+}
+
+void asn1::ber::sinks::batches::push(batch* b)
+{
+  pthread_mutex_lock(&_M_mutex);
+
+  b->_M_next = _M_free;
+  _M_free = b;
+
+  pthread_mutex_unlock(&_M_mutex);
+}
@@ -0,0 +1,197 @@
+#ifndef ASN1_BER_SINKS_BATCH_H
+#define ASN1_BER_SINKS_BATCH_H
+
+#include <time.h>
+#include <pthread.h>
+#include <atomic>
+#include "string/buffer.h"
+
+namespace asn1 {
+  namespace ber {
+    namespace sinks {
+      // Forward declaration.
+      class batches;
+
+      // Batch of ASN.1 records.
+      //
+      // A batch is shared by all the sink queues it has been pushed to and is
+      // returned to its pool when the last of them releases it.
+      class batch {
+        friend class batches;
+
+        public:
+          // Constructor.
+          batch() = default;
+
+          // Destructor.
+          ~batch();
+
+          // Clear batch.
+          void clear();
+
+          // Add record.
+          bool add(const void* record, size_t len);
+
+          // Get number of records.
+          size_t count() const;
+
+          // Get record.
+          const void* record(size_t idx, size_t& len) const;
+
+          // Get/set worker number.
+          size_t nworker() const;
+          void nworker(size_t n);
+
+          // Get/set timestamp.
+          time_t timestamp() const;
+          void timestamp(time_t t);
+
+          // Get/set time when the records were framed (monotonic time in
+          // microseconds).
+          uint64_t framed() const;
+          void framed(uint64_t t);
+
+          // Set number of references.
+          void references(size_t n);
+
+          // Release reference (the batch is returned to its pool when the
+          // last reference is released).
+          void release();
+
+        private:
+          // Allocation.
+          static constexpr const size_t allocation = 64;
+
+          // Records.
+          string::buffer _M_data;
+
+          // Offsets of the records (`_M_offsets[i]` is the end of the record
+          // `i`).
+          size_t* _M_offsets = nullptr;
+          size_t _M_size = 0;
+          size_t _M_used = 0;
+
+          // Worker number.
+          size_t _M_nworker = 0;
+
+          // Timestamp.
+          time_t _M_timestamp = 0;
+
+          // Time when the records were framed.
+          uint64_t _M_framed = 0;
+
+          // Number of references.
+          std::atomic<size_t> _M_references{0};
+
+          // Pool.
+          batches* _M_pool = nullptr;
+
+          // Next batch (in the pool).
+          batch* _M_next = nullptr;
+
+          // Allocate.
+          bool allocate();
+
+          // Disable copy constructor and assignment operator.
+          batch(const batch&) = delete;
+          batch& operator=(const batch&) = delete;
+      };
+
+      // Pool of batches.
+      class batches {
+        public:
+          // Constructor.
+          batches();
+
+          // Destructor.
+          ~batches();
+
+          // Get batch.
+          batch* pop();
+
+          // Return batch.
+          void push(batch* b);
+
+        private:
+          // Free batches.
+          batch* _M_free = nullptr;
+
+          // Mutex.
+          pthread_mutex_t _M_mutex;
+
+          // Disable copy constructor and assignment operator.
+          batches(const batches&) = delete;
+          batches& operator=(const batches&) = delete;
+      };
+
+      inline batch::~batch()
+      {
+        if (_M_offsets) {
+          free(_M_offsets);
+        }
+      }
+
+      inline void batch::clear()
+      {
+        _M_data.clear();
+        _M_used = 0;
+      }
+
+      inline size_t batch::count() const
+      {
+        return _M_used;
+      }
+
+      inline const void* batch::record(size_t idx, size_t& len) const
+      {
+        const size_t begin = (idx > 0) ? _M_offsets[idx - 1] : 0;
+
+        len = _M_offsets[idx] - begin;
+
+        return static_cast<const uint8_t*>(_M_data.data()) + begin;
+      }
+
+      inline size_t batch::nworker() const
+      {
+        return _M_nworker;
+      }
+
+      inline void batch::nworker(size_t n)
+      {
+        _M_nworker = n;
+      }
+
+      inline time_t batch::timestamp() const
+      {
+        return _M_timestamp;
+      }
+
+      inline void batch::timestamp(time_t t)
+      {
+        _M_timestamp = t;
+      }
+
+      inline uint64_t batch::framed() const
+      {
+        return _M_framed;
+      }
+
+      inline void batch::framed(uint64_t t)
+      {
+        _M_framed = t;
+      }
+
+      inline void batch::references(size_t n)
+      {
+        _M_references.store(n, std::memory_order_relaxed);
+      }
+
+      inline batches::batches()
+      {
+        pthread_mutex_init(&_M_mutex, nullptr);
+      }
+    }
+  }
+}
+
+#endif // ASN1_BER_SINKS_BATCH_H
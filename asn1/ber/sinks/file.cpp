@@ -0,0 +1,257 @@
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include "asn1/ber/sinks/file.h"
+#include "asn1/ber/recovery.h"
+
+static char* format_number(char* buf, size_t n, size_t width);
+
+asn1::ber::sinks::file::file(const char* tempdir,
+                             const char* finaldir,
+                             size_t maxfilesize,
+                             time_t maxfileage,
+                             bool recover)
+  : _M_maxfilesize(maxfilesize),
+    _M_maxfileage(maxfileage),
+    _M_recover(recover)
+{
+  // If a directory name is too long, it is left empty and open() fails.
+  const size_t tempdirlen = strlen(tempdir);
+  if (tempdirlen < sizeof(_M_tempdir)) {
+    memcpy(_M_tempdir, tempdir, tempdirlen + 1);
+  } else {
+    *_M_tempdir = 0;
+  }
+
+  const size_t finaldirlen = strlen(finaldir);
+  if (finaldirlen < sizeof(_M_finaldir)) {
+    memcpy(_M_finaldir, finaldir, finaldirlen + 1);
+  } else {
+    *_M_finaldir = 0;
+  }
+}
+
+bool asn1::ber::sinks::file::open(size_t nworkers)
+{
+  struct stat sbuf;
+  if ((*_M_tempdir) &&
+      (*_M_finaldir) &&
+      (_M_maxfilesize >= min_file_size) &&
+      (_M_maxfilesize <= max_file_size) &&
+      (_M_maxfileage >= min_file_age) &&
+      (_M_maxfileage <= max_file_age) &&
+      (stat(_M_tempdir, &sbuf) == 0) &&
+      (S_ISDIR(sbuf.st_mode)) &&
+      (stat(_M_finaldir, &sbuf) == 0) &&
+      (S_ISDIR(sbuf.st_mode))) {
+    // Recover the files left in the temporary directory by a previous run
+    // (before any new file is created).
+    if (_M_recover) {
+      recovery recovery(_M_tempdir, _M_finaldir);
+      if (!recovery.run()) {
+        fprintf(stderr,
+                "Error recovering files in '%s' (%zu file(s) not recovered).\n",
+                _M_tempdir,
+                recovery.failed());
+      }
+    }
+
+    _M_outputs = static_cast<output*>(malloc(nworkers * sizeof(output)));
+
+    if (_M_outputs) {
+      for (size_t i = nworkers; i > 0; i--) {
+        _M_outputs[i - 1].f = nullptr;
+        _M_outputs[i - 1].count = 0;
+        _M_outputs[i - 1].timestamp_last_file = 0;
+      }
+
+      _M_nworkers = nworkers;
+
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool asn1::ber::sinks::file::begin(size_t nworker, time_t now)
+{
+  _M_outputs[nworker].now = now;
+  return true;
+}
+
+bool asn1::ber::sinks::file::append(size_t nworker,
+                                    const void* buf,
+                                    size_t len)
+{
+  output* const output = &_M_outputs[nworker];
+
+  // If the file has not been opened yet...
+  if (!output->f) {
+    // Open file.
+    if (!open(nworker, output->now)) {
+      return false;
+    }
+  }
+
+  // Write to the file.
+  if (fwrite(buf, 1, len, output->f) == len) {
+    output->size += len;
+    output->timestamp_last_write = output->now;
+
+    return (output->size < _M_maxfilesize) ? true : move(*output);
+  } else {
+    return false;
+  }
+}
+
+bool asn1::ber::sinks::file::flush(size_t nworker)
+{
+  return true;
+}
+
+bool asn1::ber::sinks::file::rotate(size_t nworker, time_t now)
+{
+  output* const output = &_M_outputs[nworker];
+
+  // If the file is open and has not been updated for a while...
+  if ((output->f) && (now - output->timestamp_last_write > _M_maxfileage)) {
+    // Close file and move it to the final directory.
+    return move(*output);
+  }
+
+  return true;
+}
+
+void asn1::ber::sinks::file::close()
+{
+  if (_M_outputs) {
+    for (size_t i = _M_nworkers; i > 0; i--) {
+      if (_M_outputs[i - 1].f) {
+        move(_M_outputs[i - 1]);
+      }
+    }
+
+    free(_M_outputs);
+    _M_outputs = nullptr;
+  }
+}
+
+bool asn1::ber::sinks::file::open(size_t nworker, time_t now)
+{
+  // Maximum number of attempts to find a free name.
+  static constexpr const size_t max_attempts = 1000;
+
+  output* const output = &_M_outputs[nworker];
+
+  output->count = (now != output->timestamp_last_file) ? 0 :
+                                                         output->count + 1;
+
+  for (size_t i = max_attempts; i > 0; i--) {
+    // Compose filename.
+    _M_clock.set(now);
+    compose_name(*output, nworker);
+
+    // Compose pathname.
+    char pathname[PATH_MAX];
+    snprintf(pathname, sizeof(pathname), "%s/%s", _M_tempdir, output->name);
+
+    // Open file (fail if it already exists).
+    output->f = fopen(pathname, "wx");
+
+    // If the file could be opened...
+    if (output->f) {
+      output->size = 0;
+      output->timestamp_last_file = now;
+      output->opened = util::clock::monotonic();
+
+      return true;
+    } else if (errno == EEXIST) {
+      // Try with the next number.
+      output->count++;
+    } else {
+      return false;
+    }
+  }
+
+  return false;
+}
+
+void asn1::ber::sinks::file::compose_name(output& output, size_t nworker)
+{
+  // "YYYYMMDD-HHMMSS-WWW-CCCCCC.asn1" (WWW: worker number, CCCCCC: number of
+  // the file in the same second).
+  char* name = output.name;
+
+  memcpy(name, _M_clock.prefix(), util::clock::prefix_length);
+  name += util::clock::prefix_length;
+
+  *name++ = '-';
+  name = format_number(name, nworker, 3);
+
+  *name++ = '-';
+  name = format_number(name, output.count, 6);
+
+  memcpy(name, ".asn1", 6);
+}
+
+bool asn1::ber::sinks::file::move(output& output)
+{
+  // Maximum number of attempts to find a free name.
+  static constexpr const size_t max_attempts = 1000;
+
+  // Close file.
+  fclose(output.f);
+  output.f = nullptr;
+
+  // Compose pathname in the temporary directory.
+  char oldpath[PATH_MAX];
+  snprintf(oldpath, sizeof(oldpath), "%s/%s", _M_tempdir, output.name);
+
+  for (size_t i = max_attempts; i > 0; i--) {
+    // Compose pathname in the final directory.
+    char newpath[PATH_MAX];
+    snprintf(newpath, sizeof(newpath), "%s/%s", _M_finaldir, output.name);
+
+    // Move file (unless there is already a file with the same name, e.g.
+    // moved by a previous run in the same second).
+    if (recovery::rename(oldpath, newpath)) {
+      _M_rotations.add();
+      _M_rotation_latencies.record(util::clock::monotonic() - output.opened);
+
+      return true;
+    } else if (errno == EEXIST) {
+      // Try with the next number ("...-CCCCCC.asn1").
+      char* const count = strrchr(output.name, '-') + 1;
+      memcpy(format_number(count, ++output.count, 6), ".asn1", 6);
+    } else {
+      return false;
+    }
+  }
+
+  return false;
+}
+
+char* format_number(char* buf, size_t n, size_t width)
+{
+  // Format number backwards.
+  char tmp[32];
+  char* end = tmp + sizeof(tmp);
+  char* p = end;
+
+  do {
+    *--p = '0' + (n % 10);
+    n /= 10;
+  } while (n > 0);
+
+  // Pad with zeros.
+  while (static_cast<size_t>(end - p) < width) {
+    *--p = '0';
+  }
+
+  const size_t len = end - p;
+  memcpy(buf, p, len);
+
+  return buf + len;
+}
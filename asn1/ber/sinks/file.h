@@ -0,0 +1,168 @@
+#ifndef ASN1_BER_SINKS_FILE_H
+#define ASN1_BER_SINKS_FILE_H
+
+#include <stdio.h>
+#include <limits.h>
+#include "asn1/ber/sinks/sink.h"
+#include "util/clock.h"
+#include "util/counter.h"
+
+namespace asn1 {
+  namespace ber {
+    namespace sinks {
+      // File sink.
+      //
+      // Writes the records of each worker to its own file in the temporary
+      // directory and moves the file to the final directory when it is too big
+      // or has not been updated for a while. The files left in the temporary
+      // directory by a previous run are recovered when the sink is opened.
+      class file : public sink {
+        public:
+          // Minimum file size.
+          static constexpr const size_t min_file_size = 1;
+
+          // Maximum file size.
+          static constexpr const size_t max_file_size = 4 * 1024 * 1024;
+
+          // Minimum file age (seconds).
+          static constexpr const time_t min_file_age = 1;
+
+          // Maximum file age (seconds).
+          static constexpr const time_t max_file_age = 3600;
+
+          // Constructor (if `recover` is true, the files left in the
+          // temporary directory are recovered when the sink is opened).
+          file(const char* tempdir,
+               const char* finaldir,
+               size_t maxfilesize,
+               time_t maxfileage,
+               bool recover = true);
+
+          // Destructor.
+          ~file();
+
+          // Get name.
+          const char* name() const;
+
+          // Open.
+          bool open(size_t nworkers);
+
+          // Begin batch.
+          bool begin(size_t nworker, time_t now);
+
+          // Append record.
+          bool append(size_t nworker, const void* buf, size_t len);
+
+          // Flush.
+          bool flush(size_t nworker);
+
+          // Rotate.
+          bool rotate(size_t nworker, time_t now);
+
+          // Close.
+          void close();
+
+          // Get number of rotations.
+          uint64_t rotations() const;
+
+          // Get latencies between the write of the first record of a file
+          // and its move to the final directory (microseconds).
+          const util::histogram* rotation_latencies() const;
+
+        private:
+          // Temporary directory where to store the ASN.1 files.
+          char _M_tempdir[PATH_MAX];
+
+          // Final directory where to store the ASN.1 files.
+          char _M_finaldir[PATH_MAX];
+
+          // Files for the ASN.1 records (one per worker thread).
+          struct output {
+            // File name.
+            char name[PATH_MAX];
+
+            // File pointer.
+            FILE* f;
+
+            // File size.
+            size_t size;
+
+            // Number of files in the same second.
+            size_t count;
+
+            // Timestamp of the last file.
+            time_t timestamp_last_file;
+
+            // Timestamp of the last write.
+            time_t timestamp_last_write;
+
+            // Timestamp of the current batch.
+            time_t now;
+
+            // Time when the file was opened (monotonic time in
+            // microseconds).
+            uint64_t opened;
+          };
+
+          output* _M_outputs = nullptr;
+
+          // Number of worker threads.
+          size_t _M_nworkers = 0;
+
+          // Maximum file size.
+          size_t _M_maxfilesize;
+
+          // Maximum file age.
+          time_t _M_maxfileage;
+
+          // Recover the files left in the temporary directory?
+          bool _M_recover;
+
+          // Clock (caches the prefix of the file names).
+          util::clock _M_clock;
+
+          // Number of rotations (files moved to the final directory).
+          util::counter _M_rotations;
+
+          // Latencies between the write of the first record of a file and
+          // its move to the final directory.
+          util::histogram _M_rotation_latencies;
+
+          // Open file.
+          bool open(size_t nworker, time_t now);
+
+          // Compose file name.
+          void compose_name(output& output, size_t nworker);
+
+          // Close and move file to the final directory.
+          bool move(output& output);
+
+          // Disable copy constructor and assignment operator.
+          file(const file&) = delete;
+          file& operator=(const file&) = delete;
+      };
+
+      inline file::~file()
+      {
+        close();
+      }
+
+      inline const char* file::name() const
+      {
+        return "file";
+      }
+
+      inline uint64_t file::rotations() const
+      {
+        return _M_rotations.get();
+      }
+
+      inline const util::histogram* file::rotation_latencies() const
+      {
+        return &_M_rotation_latencies;
+      }
+    }
+  }
+}
+
+#endif // ASN1_BER_SINKS_FILE_H
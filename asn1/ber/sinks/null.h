@@ -0,0 +1,82 @@
+#ifndef ASN1_BER_SINKS_NULL_H
+#define ASN1_BER_SINKS_NULL_H
+
+#include "asn1/ber/sinks/sink.h"
+
+namespace asn1 {
+  namespace ber {
+    namespace sinks {
+      // Null sink (discards the records, for benchmarking).
+      class null : public sink {
+        public:
+          // Constructor.
+          null() = default;
+
+          // Destructor.
+          ~null() = default;
+
+          // Get name.
+          const char* name() const;
+
+          // Open.
+          bool open(size_t nworkers);
+
+          // Begin batch.
+          bool begin(size_t nworker, time_t now);
+
+          // Append record.
+          bool append(size_t nworker, const void* buf, size_t len);
+
+          // Flush.
+          bool flush(size_t nworker);
+
+          // Rotate.
+          bool rotate(size_t nworker, time_t now);
+
+          // Close.
+          void close();
+
+        private:
+          // Disable copy constructor and assignment operator.
+          null(const null&) = delete;
+          null& operator=(const null&) = delete;
+      };
+
+      inline const char* null::name() const
+      {
+        return "null";
+      }
+
+      inline bool null::open(size_t nworkers)
+      {
+        return true;
+      }
+
+      inline bool null::begin(size_t nworker, time_t now)
+      {
+        return true;
+      }
+
+      inline bool null::append(size_t nworker, const void* buf, size_t len)
+      {
+        return true;
+      }
+
+      inline bool null::flush(size_t nworker)
+      {
+        return true;
+      }
+
+      inline bool null::rotate(size_t nworker, time_t now)
+      {
+        return true;
+      }
+
+      inline void null::close()
+      {
+      }
+    }
+  }
+}
+
+#endif // ASN1_BER_SINKS_NULL_H
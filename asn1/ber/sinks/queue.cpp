@@ -0,0 +1,242 @@
+#include <stdlib.h>
+#include "asn1/ber/sinks/queue.h"
+#include "util/clock.h"
+
+asn1::ber::sinks::queue::queue(sink* s, bool lossy, size_t size)
+  : _M_sink(s),
+    _M_lossy(lossy),
+    _M_size((size > 0) ? size : 1)
+{
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+
+  pthread_mutex_init(&_M_mutex, nullptr);
+  pthread_cond_init(&_M_cond, &attr);
+  pthread_cond_init(&_M_not_full, nullptr);
+
+  pthread_condattr_destroy(&attr);
+}
+
+asn1::ber::sinks::queue::~queue()
+{
+  // Stop queue (if running).
+  stop();
+
+  if (_M_batches) {
+    free(_M_batches);
+  }
+
+  delete _M_sink;
+
+  pthread_cond_destroy(&_M_not_full);
+  pthread_cond_destroy(&_M_cond);
+  pthread_mutex_destroy(&_M_mutex);
+}
+
+bool asn1::ber::sinks::queue::start(size_t nworkers)
+{
+  _M_batches = static_cast<batch**>(malloc(_M_size * sizeof(batch*)));
+
+  // If the circular buffer could be allocated...
+  if (_M_batches) {
+    // Open sink.
+    if (_M_sink->open(nworkers)) {
+      _M_nworkers = nworkers;
+
+      _M_running = true;
+
+      // Start thread.
+      if (pthread_create(&_M_thread, nullptr, run, this) == 0) {
+        return true;
+      }
+
+      _M_running = false;
+
+      _M_sink->close();
+    }
+  }
+
+  return false;
+}
+
+void asn1::ber::sinks::queue::stop()
+{
+  pthread_mutex_lock(&_M_mutex);
+
+  // If the thread is running...
+  if (_M_running) {
+    _M_running = false;
+
+    pthread_cond_signal(&_M_cond);
+
+    // Wake up the workers waiting for room in the queue.
+    pthread_cond_broadcast(&_M_not_full);
+
+    pthread_mutex_unlock(&_M_mutex);
+
+    pthread_join(_M_thread, nullptr);
+
+    // Close sink.
+    _M_sink->close();
+  } else {
+    pthread_mutex_unlock(&_M_mutex);
+  }
+}
+
+bool asn1::ber::sinks::queue::push(batch* b)
+{
+  pthread_mutex_lock(&_M_mutex);
+
+  // If the queue is full and the batch cannot be dropped...
+  if ((!_M_lossy) && (_M_running) && (_M_count == _M_size)) {
+    _M_waits.fetch_add(1, std::memory_order_relaxed);
+
+    // Wait until there is room in the queue.
+    do {
+      pthread_cond_wait(&_M_not_full, &_M_mutex);
+    } while ((_M_running) && (_M_count == _M_size));
+  }
+
+  // If the queue is not full...
+  if ((_M_running) && (_M_count < _M_size)) {
+    _M_batches[(_M_head + _M_count++) % _M_size] = b;
+
+    pthread_cond_signal(&_M_cond);
+    pthread_mutex_unlock(&_M_mutex);
+
+    return true;
+  }
+
+  pthread_mutex_unlock(&_M_mutex);
+
+  _M_dropped.fetch_add(1, std::memory_order_relaxed);
+
+  return false;
+}
+
+void* asn1::ber::sinks::queue::run(void* arg)
+{
+  static_cast<queue*>(arg)->run();
+  return nullptr;
+}
+
+void asn1::ber::sinks::queue::run()
+{
+  // Maximum number of batches to be taken from the queue at once.
+  static constexpr const size_t max_batches = 64;
+
+  struct timespec last_rotation;
+  clock_gettime(CLOCK_MONOTONIC, &last_rotation);
+
+  pthread_mutex_lock(&_M_mutex);
+
+  do {
+    // If the queue is empty...
+    if (_M_count == 0) {
+      // If the queue has been stopped...
+      if (!_M_running) {
+        break;
+      }
+
+      // Wait for batches to arrive.
+      struct timespec ts;
+      clock_gettime(CLOCK_MONOTONIC, &ts);
+
+      ts.tv_nsec += rotation_interval * 1000000l;
+      if (ts.tv_nsec >= 1000000000l) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000l;
+      }
+
+      pthread_cond_timedwait(&_M_cond, &_M_mutex, &ts);
+    }
+
+    // Take batches from the queue.
+    batch* batches[max_batches];
+    size_t nbatches = 0;
+
+    while ((_M_count > 0) && (nbatches < max_batches)) {
+      batches[nbatches++] = _M_batches[_M_head];
+
+      _M_head = (_M_head + 1) % _M_size;
+      _M_count--;
+    }
+
+    // If batches have been taken, wake up the workers waiting for room in
+    // the queue.
+    if ((nbatches > 0) && (!_M_lossy)) {
+      pthread_cond_broadcast(&_M_not_full);
+    }
+
+    pthread_mutex_unlock(&_M_mutex);
+
+    // Process batches.
+    for (size_t i = 0; i < nbatches; i++) {
+      process(batches[i]);
+    }
+
+    // If it is time to check whether the outputs have to be rotated...
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    if ((now.tv_sec - last_rotation.tv_sec) * 1000l +
+        (now.tv_nsec - last_rotation.tv_nsec) / 1000000l >=
+        static_cast<long>(rotation_interval)) {
+      rotate();
+
+      last_rotation = now;
+    }
+
+    pthread_mutex_lock(&_M_mutex);
+  } while (true);
+
+  pthread_mutex_unlock(&_M_mutex);
+}
+
+void asn1::ber::sinks::queue::process(batch* b)
+{
+  const size_t nworker = b->nworker();
+
+  if (_M_sink->begin(nworker, b->timestamp())) {
+    // For each record...
+    for (size_t i = 0; i < b->count(); i++) {
+      // Append record.
+      size_t len;
+      const void* const record = b->record(i, len);
+
+      if (_M_sink->append(nworker, record, len)) {
+        _M_records.add();
+        _M_bytes.add(len);
+      } else {
+        _M_errors.add();
+      }
+    }
+
+    if (_M_sink->flush(nworker)) {
+      const uint64_t now = util::clock::monotonic();
+
+      _M_latencies.record((now > b->framed()) ? now - b->framed() : 0,
+                          b->count());
+    } else {
+      _M_errors.add();
+    }
+  } else {
+    _M_errors.add();
+  }
+
+  // Release batch.
+  b->release();
+}
+
+void asn1::ber::sinks::queue::rotate()
+{
+  const time_t now = time(nullptr);
+
+  // For each worker...
+  for (size_t i = 0; i < _M_nworkers; i++) {
+    if (!_M_sink->rotate(i, now)) {
+      _M_errors.add();
+    }
+  }
+}
@@ -0,0 +1,186 @@
+#ifndef ASN1_BER_SINKS_QUEUE_H
+#define ASN1_BER_SINKS_QUEUE_H
+
+#include <pthread.h>
+#include <atomic>
+#include "util/counter.h"
+#include "util/histogram.h"
+#include "asn1/ber/sinks/sink.h"
+#include "asn1/ber/sinks/batch.h"
+
+namespace asn1 {
+  namespace ber {
+    namespace sinks {
+      // Sink queue.
+      //
+      // Runs a sink on its own thread. The worker threads push batches of
+      // records to the queue; if the queue is full (the sink cannot keep up),
+      // the worker waits until there is room (backpressure: the worker stops
+      // reading from its connections), so no records are lost. For a lossy
+      // sink (e.g. a mirror), the batch is dropped for this sink only
+      // instead, so a slow lossy sink doesn't stall the workers nor the other
+      // sinks.
+      class queue {
+        public:
+          // Default queue size (number of batches).
+          static constexpr const size_t default_size = 1024;
+
+          // Constructor (the queue takes ownership of the sink).
+          queue(sink* s, bool lossy = false, size_t size = default_size);
+
+          // Destructor.
+          ~queue();
+
+          // Start.
+          bool start(size_t nworkers);
+
+          // Stop (the pending batches are processed before the sink is
+          // closed).
+          void stop();
+
+          // Push batch (waits until the queue is not full; if the sink is
+          // lossy, returns false if the queue is full).
+          bool push(batch* b);
+
+          // Get sink.
+          const sink* get() const;
+
+          // Is the sink lossy?
+          bool lossy() const;
+
+          // Set whether the sink is lossy (before starting).
+          void lossy(bool l);
+
+          // Get number of records written.
+          uint64_t records() const;
+
+          // Get number of bytes written.
+          uint64_t bytes() const;
+
+          // Get number of dropped batches.
+          uint64_t dropped() const;
+
+          // Get number of batches which had to wait for room in the queue.
+          uint64_t waits() const;
+
+          // Get number of errors.
+          uint64_t errors() const;
+
+          // Get latencies between the framing of the records and their write
+          // (microseconds).
+          const util::histogram& latencies() const;
+
+        private:
+          // Rotation check interval (milliseconds).
+          static constexpr const unsigned rotation_interval = 250;
+
+          // Sink.
+          sink* _M_sink;
+
+          // Drop the batches when the queue is full?
+          bool _M_lossy;
+
+          // Batches (circular buffer).
+          batch** _M_batches = nullptr;
+          size_t _M_size;
+          size_t _M_head = 0;
+          size_t _M_count = 0;
+
+          // Number of worker threads.
+          size_t _M_nworkers = 0;
+
+          // Mutex and condition variables (batches available, room
+          // available).
+          pthread_mutex_t _M_mutex;
+          pthread_cond_t _M_cond;
+          pthread_cond_t _M_not_full;
+
+          // Thread id.
+          pthread_t _M_thread;
+
+          // Running?
+          bool _M_running = false;
+
+          // Number of dropped batches (updated by the worker threads).
+          std::atomic<uint64_t> _M_dropped{0};
+
+          // Number of batches which had to wait for room in the queue
+          // (updated by the worker threads).
+          std::atomic<uint64_t> _M_waits{0};
+
+          // Number of records written.
+          util::counter _M_records;
+
+          // Number of bytes written.
+          util::counter _M_bytes;
+
+          // Number of errors.
+          util::counter _M_errors;
+
+          // Latencies between the framing of the records and their write.
+          util::histogram _M_latencies;
+
+          // Run.
+          static void* run(void* arg);
+          void run();
+
+          // Process batch.
+          void process(batch* b);
+
+          // Rotate.
+          void rotate();
+
+          // Disable copy constructor and assignment operator.
+          queue(const queue&) = delete;
+          queue& operator=(const queue&) = delete;
+      };
+
+      inline const sink* queue::get() const
+      {
+        return _M_sink;
+      }
+
+      inline bool queue::lossy() const
+      {
+        return _M_lossy;
+      }
+
+      inline void queue::lossy(bool l)
+      {
+        _M_lossy = l;
+      }
+
+      inline uint64_t queue::records() const
+      {
+        return _M_records.get();
+      }
+
+      inline uint64_t queue::bytes() const
+      {
+        return _M_bytes.get();
+      }
+
+      inline uint64_t queue::dropped() const
+      {
+        return _M_dropped.load(std::memory_order_relaxed);
+      }
+
+      inline uint64_t queue::waits() const
+      {
+        return _M_waits.load(std::memory_order_relaxed);
+      }
+
+      inline uint64_t queue::errors() const
+      {
+        return _M_errors.get();
+      }
+
+      inline const util::histogram& queue::latencies() const
+      {
+        return _M_latencies;
+      }
+    }
+  }
+}
+
+#endif // ASN1_BER_SINKS_QUEUE_H
@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include "asn1/ber/sinks/shm.h"
+
+asn1::ber::sinks::shm::shm(const char* name, size_t capacity)
+  : _M_capacity(capacity & ~static_cast<size_t>(7))
+{
+  // The name of the shared memory object has to start with '/'.
+  snprintf(_M_name, sizeof(_M_name), "%s%s", (*name == '/') ? "" : "/", name);
+}
+
+bool asn1::ber::sinks::shm::open(size_t nworkers)
+{
+  // If the capacity is valid...
+  if ((_M_capacity >= min_capacity) && (_M_capacity <= max_capacity)) {
+    // Open shared memory object.
+    const int fd = shm_open(_M_name, O_CREAT | O_RDWR, 0600);
+
+    // If the shared memory object could be opened...
+    if (fd != -1) {
+      const size_t size = sizeof(header) + _M_capacity;
+
+      // Set size and map shared memory object into memory.
+      void* base;
+      if ((ftruncate(fd, size) == 0) &&
+          ((base = mmap(nullptr,
+                        size,
+                        PROT_READ | PROT_WRITE,
+                        MAP_SHARED,
+                        fd,
+                        0)) != MAP_FAILED)) {
+        ::close(fd);
+
+        _M_header = static_cast<header*>(base);
+        _M_ring = static_cast<uint8_t*>(base) + sizeof(header);
+
+        // If the ring has not been initialized yet or has a different
+        // capacity...
+        if ((_M_header->magic != magic) ||
+            (_M_header->capacity != _M_capacity)) {
+          _M_header->capacity = _M_capacity;
+          _M_header->head.store(0, std::memory_order_relaxed);
+          _M_header->magic = magic;
+        }
+
+        _M_head = _M_header->head.load(std::memory_order_relaxed);
+
+        return true;
+      }
+
+      ::close(fd);
+    }
+  }
+
+  return false;
+}
+
+bool asn1::ber::sinks::shm::begin(size_t nworker, time_t now)
+{
+  return true;
+}
+
+bool asn1::ber::sinks::shm::append(size_t nworker,
+                                   const void* buf,
+                                   size_t len)
+{
+  // Compute space needed (length + record, padded to 8 bytes).
+  const size_t needed = (sizeof(uint32_t) + len + 7) & ~static_cast<size_t>(7);
+
+  // If the record fits in the ring...
+  if ((len < wrap) && (needed < _M_capacity)) {
+    size_t pos = _M_head % _M_capacity;
+
+    // If the record doesn't fit before the end of the ring...
+    if (pos + needed > _M_capacity) {
+      // Write wrap marker.
+      const uint32_t marker = wrap;
+      memcpy(_M_ring + pos, &marker, sizeof(uint32_t));
+
+      _M_head += (_M_capacity - pos);
+
+      pos = 0;
+    }
+
+    // Write length and record.
+    const uint32_t l = static_cast<uint32_t>(len);
+    memcpy(_M_ring + pos, &l, sizeof(uint32_t));
+    memcpy(_M_ring + pos + sizeof(uint32_t), buf, len);
+
+    _M_head += needed;
+
+    return true;
+  }
+
+  return false;
+}
+
+bool asn1::ber::sinks::shm::flush(size_t nworker)
+{
+  // Publish records.
+  _M_header->head.store(_M_head, std::memory_order_release);
+
+  return true;
+}
+
+bool asn1::ber::sinks::shm::rotate(size_t nworker, time_t now)
+{
+  return true;
+}
+
+void asn1::ber::sinks::shm::close()
+{
+  if (_M_header) {
+    munmap(_M_header, sizeof(header) + _M_capacity);
+    _M_header = nullptr;
+  }
+}
@@ -0,0 +1,111 @@
+#ifndef ASN1_BER_SINKS_SHM_H
+#define ASN1_BER_SINKS_SHM_H
+
+#include <limits.h>
+#include <atomic>
+#include "asn1/ber/sinks/sink.h"
+
+namespace asn1 {
+  namespace ber {
+    namespace sinks {
+      // Shared memory ring sink.
+      //
+      // The records are written to a ring buffer in a POSIX shared memory
+      // object. Each record is preceded by its length (32 bits, host byte
+      // order) and padded to a multiple of 8 bytes; a length of `wrap` means
+      // that the writer has continued at the beginning of the ring.
+      //
+      // `head` is the total number of bytes written since the ring was
+      // created and is published (with release semantics) at the end of each
+      // batch. A reader keeps its own position and has been overrun if
+      // `head - position > capacity`.
+      class shm : public sink {
+        public:
+          // Ring header.
+          struct header {
+            // Magic number.
+            uint64_t magic;
+
+            // Capacity of the ring (bytes).
+            uint64_t capacity;
+
+            // Total number of bytes written.
+            std::atomic<uint64_t> head;
+
+            uint64_t reserved[5];
+          };
+
+          // Magic number ("ASN1RING").
+          static constexpr const uint64_t magic = 0x474e4952314e5341ull;
+
+          // Wrap marker.
+          static constexpr const uint32_t wrap = 0xffffffffu;
+
+          // Minimum capacity.
+          static constexpr const size_t min_capacity = 64 * 1024;
+
+          // Maximum capacity.
+          static constexpr const size_t max_capacity = 1ull << 34;
+
+          // Constructor.
+          shm(const char* name, size_t capacity);
+
+          // Destructor.
+          ~shm();
+
+          // Get name.
+          const char* name() const;
+
+          // Open.
+          bool open(size_t nworkers);
+
+          // Begin batch.
+          bool begin(size_t nworker, time_t now);
+
+          // Append record.
+          bool append(size_t nworker, const void* buf, size_t len);
+
+          // Flush.
+          bool flush(size_t nworker);
+
+          // Rotate.
+          bool rotate(size_t nworker, time_t now);
+
+          // Close.
+          void close();
+
+        private:
+          // Name of the shared memory object.
+          char _M_name[NAME_MAX];
+
+          // Capacity.
+          size_t _M_capacity;
+
+          // Header.
+          header* _M_header = nullptr;
+
+          // Ring.
+          uint8_t* _M_ring;
+
+          // Position of the next record (not published yet).
+          uint64_t _M_head;
+
+          // Disable copy constructor and assignment operator.
+          shm(const shm&) = delete;
+          shm& operator=(const shm&) = delete;
+      };
+
+      inline shm::~shm()
+      {
+        close();
+      }
+
+      inline const char* shm::name() const
+      {
+        return "shm";
+      }
+    }
+  }
+}
+
+#endif // ASN1_BER_SINKS_SHM_H
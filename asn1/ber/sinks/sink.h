@@ -0,0 +1,67 @@
+#ifndef ASN1_BER_SINKS_SINK_H
+#define ASN1_BER_SINKS_SINK_H
+
+#include <stdint.h>
+#include <time.h>
+#include <sys/types.h>
+#include "util/histogram.h"
+
+namespace asn1 {
+  namespace ber {
+    namespace sinks {
+      // Sink interface.
+      //
+      // A sink receives the ASN.1 records framed by the server's worker
+      // threads. All the methods are invoked from the sink's own thread (see
+      // `queue`), so implementations don't need any synchronization.
+      class sink {
+        public:
+          // Destructor.
+          virtual ~sink() = default;
+
+          // Get name.
+          virtual const char* name() const = 0;
+
+          // Open (`nworkers` is the number of worker threads producing
+          // records).
+          virtual bool open(size_t nworkers) = 0;
+
+          // Begin batch of records received by the worker `nworker` at `now`.
+          virtual bool begin(size_t nworker, time_t now) = 0;
+
+          // Append record.
+          virtual bool append(size_t nworker, const void* buf, size_t len) = 0;
+
+          // Flush (end of batch).
+          virtual bool flush(size_t nworker) = 0;
+
+          // Rotate the output of the worker `nworker` if due (invoked
+          // periodically).
+          virtual bool rotate(size_t nworker, time_t now) = 0;
+
+          // Close.
+          virtual void close() = 0;
+
+          // Get number of rotations (for sinks which rotate their output).
+          virtual uint64_t rotations() const;
+
+          // Get latencies between the write of the oldest record of an
+          // output and its rotation (nullptr if the sink doesn't rotate its
+          // output).
+          virtual const util::histogram* rotation_latencies() const;
+      };
+
+      inline uint64_t sink::rotations() const
+      {
+        return 0;
+      }
+
+      inline const util::histogram* sink::rotation_latencies() const
+      {
+        return nullptr;
+      }
+    }
+  }
+}
+
+#endif // ASN1_BER_SINKS_SINK_H
@@ -0,0 +1,102 @@
+#include <unistd.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include "asn1/ber/sinks/tcp.h"
+
+bool asn1::ber::sinks::tcp::open(size_t nworkers)
+{
+  // Connect (if the server is not available yet, the connection will be
+  // retried later).
+  connect();
+
+  return true;
+}
+
+bool asn1::ber::sinks::tcp::begin(size_t nworker, time_t now)
+{
+  _M_buf.clear();
+  return true;
+}
+
+bool asn1::ber::sinks::tcp::append(size_t nworker,
+                                   const void* buf,
+                                   size_t len)
+{
+  // If connected...
+  if (_M_fd != -1) {
+    return _M_buf.append(buf, len);
+  }
+
+  return false;
+}
+
+bool asn1::ber::sinks::tcp::flush(size_t nworker)
+{
+  // If connected...
+  if (_M_fd != -1) {
+    const uint8_t* data = static_cast<const uint8_t*>(_M_buf.data());
+    size_t left = _M_buf.length();
+
+    // While there is data to be sent...
+    while (left > 0) {
+      // Send.
+      const ssize_t ret = send(_M_fd, data, left, MSG_NOSIGNAL);
+
+      // If we have sent some data...
+      if (ret > 0) {
+        data += ret;
+        left -= ret;
+      } else if ((ret < 0) && (errno != EINTR)) {
+        disconnect();
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  return _M_buf.empty();
+}
+
+bool asn1::ber::sinks::tcp::rotate(size_t nworker, time_t now)
+{
+  // If not connected, try to reconnect (once per rotation check).
+  if ((nworker == 0) && (_M_fd == -1)) {
+    connect();
+  }
+
+  return true;
+}
+
+void asn1::ber::sinks::tcp::close()
+{
+  disconnect();
+}
+
+bool asn1::ber::sinks::tcp::connect()
+{
+  const struct sockaddr& addr = _M_addr;
+
+  // Create socket.
+  _M_fd = ::socket(addr.sa_family, SOCK_STREAM, 0);
+
+  // If the socket could be created...
+  if (_M_fd != -1) {
+    // Connect.
+    if (::connect(_M_fd, &addr, _M_addr.length()) == 0) {
+      return true;
+    }
+
+    disconnect();
+  }
+
+  return false;
+}
+
+void asn1::ber::sinks::tcp::disconnect()
+{
+  if (_M_fd != -1) {
+    ::close(_M_fd);
+    _M_fd = -1;
+  }
+}
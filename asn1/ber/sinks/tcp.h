@@ -0,0 +1,83 @@
+#ifndef ASN1_BER_SINKS_TCP_H
+#define ASN1_BER_SINKS_TCP_H
+
+#include "asn1/ber/sinks/sink.h"
+#include "net/socket/address.h"
+#include "string/buffer.h"
+
+namespace asn1 {
+  namespace ber {
+    namespace sinks {
+      // TCP sink (forwards the records to a TCP server).
+      //
+      // If the connection fails, the records are dropped until the connection
+      // is reestablished (at most one attempt per rotation check).
+      class tcp : public sink {
+        public:
+          // Constructor.
+          tcp(const net::socket::address& addr);
+
+          // Destructor.
+          ~tcp();
+
+          // Get name.
+          const char* name() const;
+
+          // Open.
+          bool open(size_t nworkers);
+
+          // Begin batch.
+          bool begin(size_t nworker, time_t now);
+
+          // Append record.
+          bool append(size_t nworker, const void* buf, size_t len);
+
+          // Flush.
+          bool flush(size_t nworker);
+
+          // Rotate.
+          bool rotate(size_t nworker, time_t now);
+
+          // Close.
+          void close();
+
+        private:
+          // Address of the TCP server.
+          net::socket::address _M_addr;
+
+          // Socket descriptor.
+          int _M_fd = -1;
+
+          // Buffer.
+          string::buffer _M_buf;
+
+          // Connect.
+          bool connect();
+
+          // Disconnect.
+          void disconnect();
+
+          // Disable copy constructor and assignment operator.
+          tcp(const tcp&) = delete;
+          tcp& operator=(const tcp&) = delete;
+      };
+
+      inline tcp::tcp(const net::socket::address& addr)
+        : _M_addr(addr)
+      {
+      }
+
+      inline tcp::~tcp()
+      {
+        close();
+      }
+
+      inline const char* tcp::name() const
+      {
+        return "tcp";
+      }
+    }
+  }
+}
+
+#endif // ASN1_BER_SINKS_TCP_H
@@ -0,0 +1,158 @@
+#include <unistd.h>
+#include <errno.h>
+#include "asn1/ber/stream_encoder.h"
+
+bool asn1::ber::stream_encoder::add_boolean(tag_class tc,
+                                            uint32_t tn,
+                                            bool val)
+{
+  // Encode boolean.
+  encoder::value v;
+  v.encode_boolean(tc, tn, val);
+
+  return add(v);
+}
+
+bool asn1::ber::stream_encoder::add_integer(tag_class tc,
+                                            uint32_t tn,
+                                            int64_t val)
+{
+  // Encode integer.
+  encoder::value v;
+  v.encode_integer(tc, tn, val);
+
+  return add(v);
+}
+
+bool asn1::ber::stream_encoder::add_data(tag_class tc,
+                                         uint32_t tn,
+                                         const void* val,
+                                         size_t len)
+{
+  // Encode data.
+  encoder::value v;
+  v.encode_data(tc, tn, val, len);
+
+  // If the value fits in the buffer...
+  if (v.total_length() <= _M_buffer_size - _M_buf.length()) {
+    return add(v);
+  }
+
+  // Serialize identifier and length octets and write the buffer.
+  if ((v.serialize_header(_M_buf)) && (flush())) {
+    // If the data fits in the buffer...
+    if (len < _M_buffer_size) {
+      return _M_buf.append(val, len);
+    } else {
+      // Write the data directly.
+      return write(val, len);
+    }
+  }
+
+  return false;
+}
+
+bool asn1::ber::stream_encoder::add_null(tag_class tc, uint32_t tn)
+{
+  // Encode null.
+  encoder::value v;
+  v.encode_null(tc, tn);
+
+  return add(v);
+}
+
+bool asn1::ber::stream_encoder::start_constructed(tag_class tc, uint32_t tn)
+{
+  // Encode constructed.
+  encoder::value v;
+  v.encode_constructed(tc, tn);
+
+  // Serialize identifier octets and indefinite length.
+  if ((v.serialize_header(_M_buf)) && (_M_buf.push_back(0x80))) {
+    _M_depth++;
+
+    return (_M_buf.length() < _M_buffer_size) || (flush());
+  }
+
+  return false;
+}
+
+bool asn1::ber::stream_encoder::end_constructed()
+{
+  if (_M_depth > 0) {
+    // Serialize end-of-contents.
+    if (_M_buf.append(2, 0)) {
+      _M_depth--;
+
+      return (_M_buf.length() < _M_buffer_size) || (flush());
+    }
+  }
+
+  return false;
+}
+
+bool asn1::ber::stream_encoder::add_generalized_time(tag_class tc,
+                                                     uint32_t tn,
+                                                     const struct timeval& tv)
+{
+  // Encode generalized time.
+  encoder::value v;
+  v.encode_generalized_time(tc, tn, tv);
+
+  return add(v);
+}
+
+bool asn1::ber::stream_encoder::add_generalized_time(tag_class tc,
+                                                     uint32_t tn)
+{
+  // Get current time.
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+
+  return add_generalized_time(tc, tn, tv);
+}
+
+bool asn1::ber::stream_encoder::flush()
+{
+  // If there are buffered values...
+  if (!_M_buf.empty()) {
+    if (write(_M_buf.data(), _M_buf.length())) {
+      _M_buf.clear();
+      return true;
+    }
+
+    return false;
+  }
+
+  return true;
+}
+
+bool asn1::ber::stream_encoder::add(const encoder::value& v)
+{
+  // Serialize value (write the buffer if it is full).
+  return (v.serialize(_M_buf, nullptr)) &&
+         ((_M_buf.length() < _M_buffer_size) || (flush()));
+}
+
+bool asn1::ber::stream_encoder::write(const void* data, size_t len)
+{
+  const uint8_t* d = static_cast<const uint8_t*>(data);
+
+  // While there is data to be written...
+  while (len > 0) {
+    // Write data.
+    const ssize_t ret = ::write(_M_fd, d, len);
+
+    // If we have written some data...
+    if (ret > 0) {
+      d += ret;
+      len -= ret;
+
+      _M_written += ret;
+    } else if ((ret < 0) && (errno != EINTR)) {
+      return false;
+    }
+  }
+
+  return true;
+}
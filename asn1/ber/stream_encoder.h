@@ -0,0 +1,118 @@
+#ifndef ASN1_BER_STREAM_ENCODER_H
+#define ASN1_BER_STREAM_ENCODER_H
+
+#include "asn1/ber/encoder.h"
+
+namespace asn1 {
+  namespace ber {
+    // Streaming ASN.1 BER encoder.
+    //
+    // Unlike `encoder`, which keeps the whole record to compute the definite
+    // lengths of the constructed values, the stream encoder writes the values
+    // as they are added: the constructed values are encoded with indefinite
+    // length (their end-of-contents octets are written by
+    // `end_constructed()`), so the memory used doesn't depend on the size of
+    // the record.
+    //
+    // The encoded values are collected in a buffer of `buffer_size` bytes,
+    // which is written to the file descriptor when it is full; data which
+    // doesn't fit in the buffer is written directly. `flush()` has to be
+    // called once the last value has been added.
+    class stream_encoder {
+      public:
+        // Minimum buffer size.
+        static constexpr const size_t min_buffer_size = 64;
+
+        // Default buffer size.
+        static constexpr const size_t default_buffer_size = 64 * 1024;
+
+        // Constructor (the file descriptor is not closed by the stream
+        // encoder).
+        stream_encoder(int fd, size_t buffersize = default_buffer_size);
+
+        // Destructor.
+        ~stream_encoder() = default;
+
+        // Add boolean.
+        bool add_boolean(tag_class tc, uint32_t tn, bool val);
+
+        // Add integer.
+        bool add_integer(tag_class tc, uint32_t tn, int64_t val);
+
+        // Add data.
+        bool add_data(tag_class tc, uint32_t tn, const void* val, size_t len);
+
+        // Add null.
+        bool add_null(tag_class tc, uint32_t tn);
+
+        // Start constructed.
+        bool start_constructed(tag_class tc, uint32_t tn);
+
+        // End constructed.
+        bool end_constructed();
+
+        // Add generalized time.
+        bool add_generalized_time(tag_class tc,
+                                  uint32_t tn,
+                                  const struct timeval& tv);
+
+        // Add generalized time using current time.
+        bool add_generalized_time(tag_class tc, uint32_t tn);
+
+        // Write the buffered values.
+        bool flush();
+
+        // Get number of open constructed values.
+        size_t depth() const;
+
+        // Get number of bytes written to the file descriptor.
+        uint64_t written() const;
+
+      private:
+        // File descriptor.
+        int _M_fd;
+
+        // Buffer size.
+        size_t _M_buffer_size;
+
+        // Buffer.
+        string::buffer _M_buf;
+
+        // Number of open constructed values.
+        size_t _M_depth = 0;
+
+        // Number of bytes written to the file descriptor.
+        uint64_t _M_written = 0;
+
+        // Add primitive value.
+        bool add(const encoder::value& v);
+
+        // Write data to the file descriptor.
+        bool write(const void* data, size_t len);
+
+        // Disable copy constructor and assignment operator.
+        stream_encoder(const stream_encoder&) = delete;
+        stream_encoder& operator=(const stream_encoder&) = delete;
+    };
+
+    inline stream_encoder::stream_encoder(int fd, size_t buffersize)
+      : _M_fd(fd),
+        _M_buffer_size((buffersize >= min_buffer_size) ?
+                         buffersize :
+                         min_buffer_size)
+    {
+    }
+
+    inline size_t stream_encoder::depth() const
+    {
+      return _M_depth;
+    }
+
+    inline uint64_t stream_encoder::written() const
+    {
+      return _M_written;
+    }
+  }
+}
+
+#endif // ASN1_BER_STREAM_ENCODER_H
@@ -0,0 +1,212 @@
+#include "asn1/ber/tape.h"
+#include "asn1/ber/header.h"
+
+bool asn1::ber::tape::decode(const void* data, size_t length)
+{
+  _M_data = static_cast<const uint8_t*>(data);
+  _M_total_length = 0;
+  _M_used = 0;
+
+  // If the data is empty...
+  if (length == 0) {
+    _M_error = decoder::result::eof;
+    return false;
+  }
+
+  // Records longer than `max_length` cannot be decoded.
+  if (length > max_length) {
+    length = max_length;
+  }
+
+  // Indices of the open constructed values and their limits (end of the
+  // contents octets for definite-length values; for indefinite-length
+  // values, the limit of the enclosing value).
+  size_t open[max_depth];
+  size_t limits[max_depth];
+  size_t depth = 0;
+
+  size_t pos = 0;
+
+  do {
+    // Close the constructed values which end at the current position.
+    while (depth > 0) {
+      const size_t idx = open[depth - 1];
+
+      // Definite length?
+      if ((_M_flags[idx] & flag_definite_length) != 0) {
+        // If not at the end of the contents octets...
+        if (pos < limits[depth - 1]) {
+          break;
+        }
+      } else {
+        // If not at the end-of-contents...
+        if ((pos + 1 >= limits[depth - 1]) ||
+            (_M_data[pos] != 0) ||
+            (_M_data[pos + 1] != 0)) {
+          break;
+        }
+
+        // Save length of the contents octets.
+        _M_lengths[idx] = static_cast<uint32_t>(
+                            pos - _M_offsets[idx] - _M_header_lengths[idx]
+                          );
+
+        // Skip end-of-contents.
+        pos += 2;
+      }
+
+      _M_next[idx] = static_cast<uint32_t>(_M_used);
+
+      depth--;
+    }
+
+    // If the whole record has been decoded...
+    if ((depth == 0) && (_M_used > 0)) {
+      _M_total_length = pos;
+      _M_error = decoder::result::no_error;
+
+      return true;
+    }
+
+    // The value cannot go beyond the end of the enclosing definite-length
+    // value.
+    const size_t limit = (depth > 0) ? limits[depth - 1] : length;
+
+    // If at the end of the data...
+    if (pos >= limit) {
+      _M_error = decoder::result::unexpected_eof;
+      return false;
+    }
+
+    // Allocate.
+    if (!allocate()) {
+      _M_error = decoder::result::no_error;
+      return false;
+    }
+
+    // Save identifier octet.
+    const uint8_t idoctet = _M_data[pos];
+
+    // Decode identifier and length octets.
+    size_t off = pos;
+    header hdr;
+    const decoder::result res = hdr.decode(_M_data, limit, off);
+
+    // If the header couldn't be decoded...
+    if (res != decoder::result::no_error) {
+      _M_error = res;
+      return false;
+    }
+
+    // Definite length?
+    if (hdr.definite_length) {
+      // If the contents octets don't fit in the enclosing value...
+      if (hdr.length > limit - off) {
+        _M_error = decoder::result::unexpected_eof;
+        return false;
+      }
+
+      // If an indefinite-length value contains a value with tag 0 which is
+      // not the end-of-contents...
+      if ((idoctet == 0) &&
+          (depth > 0) &&
+          ((_M_flags[open[depth - 1]] & flag_definite_length) == 0)) {
+        _M_error = decoder::result::invalid_length;
+        return false;
+      }
+    }
+
+    // If the maximum depth has been reached...
+    if ((hdr.constructed) && (depth == max_depth)) {
+      _M_error = decoder::result::max_depth_exceeded;
+      return false;
+    }
+
+    // Add value.
+    const size_t idx = _M_used++;
+
+    _M_offsets[idx] = static_cast<uint32_t>(pos);
+    _M_header_lengths[idx] = static_cast<uint32_t>(off - pos);
+    _M_tag_numbers[idx] = hdr.tag_number;
+    _M_flags[idx] = (idoctet & 0xe0u) |
+                    (hdr.definite_length ? flag_definite_length : 0);
+
+    _M_lengths[idx] = static_cast<uint32_t>(hdr.length);
+    _M_depths[idx] = static_cast<uint8_t>(depth);
+    _M_next[idx] = static_cast<uint32_t>(_M_used);
+
+    // Constructed?
+    if (hdr.constructed) {
+      // The children start at the contents octets.
+      open[depth] = idx;
+      limits[depth++] = hdr.definite_length ? off + hdr.length : limit;
+
+      pos = off;
+    } else {
+      // Skip contents octets.
+      pos = off + hdr.length;
+    }
+  } while (true);
+}
+
+size_t asn1::ber::tape::find(size_t idx,
+                             enum tag_class tc,
+                             uint32_t tn) const
+{
+  // For each child...
+  for (size_t i = idx + 1; i < _M_next[idx]; i = _M_next[i]) {
+    if ((_M_tag_numbers[i] == tn) && (tag_class(i) == tc)) {
+      return i;
+    }
+  }
+
+  return npos;
+}
+
+void asn1::ber::tape::get(size_t idx, value& val) const
+{
+  val._M_total_length = _M_header_lengths[idx] +
+                        _M_lengths[idx] +
+                        (definite_length(idx) ? 0 : 2);
+
+  val._M_tag_class = tag_class(idx);
+  val._M_primitive = !constructed(idx);
+  val._M_tag_number = _M_tag_numbers[idx];
+  val._M_data = static_cast<const uint8_t*>(data(idx));
+  val._M_length = _M_lengths[idx];
+}
+
+bool asn1::ber::tape::allocate()
+{
+  if (_M_used < _M_size) {
+    return true;
+  } else {
+    const size_t size = (_M_size > 0) ? _M_size * 2 : allocation;
+
+    if ((grow(_M_offsets, size)) &&
+        (grow(_M_header_lengths, size)) &&
+        (grow(_M_tag_numbers, size)) &&
+        (grow(_M_flags, size)) &&
+        (grow(_M_lengths, size)) &&
+        (grow(_M_depths, size)) &&
+        (grow(_M_next, size))) {
+      _M_size = size;
+      return true;
+    }
+
+    return false;
+  }
+}
+
+template<typename T>
+bool asn1::ber::tape::grow(T*& array, size_t size)
+{
+  T* const a = static_cast<T*>(realloc(array, size * sizeof(T)));
+
+  if (a) {
+    array = a;
+    return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,217 @@
+#ifndef ASN1_BER_TAPE_H
+#define ASN1_BER_TAPE_H
+
+#include <stdlib.h>
+#include "asn1/ber/decoder.h"
+
+namespace asn1 {
+  namespace ber {
+    // ASN.1 BER tape.
+    //
+    // Decodes a whole record in a single pass into flat arrays (one entry per
+    // data value, in document order): offset, tag number, flags (tag class,
+    // constructed, definite length), contents length, depth and index of the
+    // next sibling. The children of the value `idx` are the values
+    // `idx + 1 .. next_sibling(idx) - 1`, so lookups and walks are array
+    // scans. The arrays are kept between records (no allocations once they
+    // are big enough). The tape points to the data, which must outlive it.
+    class tape {
+      public:
+        // Maximum depth.
+        static constexpr const size_t max_depth = 128;
+
+        // Maximum length of a record.
+        static constexpr const size_t max_length = 0xffffffffu;
+
+        // Invalid index.
+        static constexpr const size_t npos = static_cast<size_t>(-1);
+
+        // Constructor.
+        tape() = default;
+
+        // Destructor.
+        ~tape();
+
+        // Decode the record at the beginning of `data` (returns false if the
+        // record couldn't be decoded, see `error()`, or if memory couldn't be
+        // allocated).
+        bool decode(const void* data, size_t length);
+
+        // Get decoding error of the last call to decode().
+        decoder::result error() const;
+
+        // Get total length of the record.
+        size_t total_length() const;
+
+        // Get number of data values.
+        size_t size() const;
+
+        // Get offset of the identifier octets.
+        size_t offset(size_t idx) const;
+
+        // Get tag class.
+        enum tag_class tag_class(size_t idx) const;
+
+        // Get tag number.
+        uint32_t tag_number(size_t idx) const;
+
+        // Is constructed?
+        bool constructed(size_t idx) const;
+
+        // Definite length?
+        bool definite_length(size_t idx) const;
+
+        // Get contents octets.
+        const void* data(size_t idx) const;
+
+        // Get length of the contents octets.
+        size_t length(size_t idx) const;
+
+        // Get depth (the record has depth 0).
+        size_t depth(size_t idx) const;
+
+        // Get index of the next sibling (`size()` if it is the last value of
+        // the record).
+        size_t next_sibling(size_t idx) const;
+
+        // Get index of the first child (npos if none).
+        size_t first_child(size_t idx) const;
+
+        // Find child by tag (npos if not found).
+        size_t find(size_t idx, enum tag_class tc, uint32_t tn) const;
+
+        // Get value.
+        void get(size_t idx, value& val) const;
+
+      private:
+        // Allocation.
+        static constexpr const size_t allocation = 256;
+
+        // Flags.
+        static constexpr const uint8_t flag_constructed = 0x20u;
+        static constexpr const uint8_t flag_definite_length = 0x01u;
+
+        // Pointer to the data.
+        const uint8_t* _M_data = nullptr;
+
+        // Total length of the record.
+        size_t _M_total_length = 0;
+
+        // Decoding error.
+        decoder::result _M_error = decoder::result::no_error;
+
+        // Offsets of the identifier octets.
+        uint32_t* _M_offsets = nullptr;
+
+        // Lengths of the identifier and length octets.
+        uint32_t* _M_header_lengths = nullptr;
+
+        // Tag numbers.
+        uint32_t* _M_tag_numbers = nullptr;
+
+        // Flags (tag class in the bits 6-7).
+        uint8_t* _M_flags = nullptr;
+
+        // Lengths of the contents octets.
+        uint32_t* _M_lengths = nullptr;
+
+        // Depths.
+        uint8_t* _M_depths = nullptr;
+
+        // Indices of the next siblings.
+        uint32_t* _M_next = nullptr;
+
+        size_t _M_size = 0;
+        size_t _M_used = 0;
+
+        // Allocate.
+        bool allocate();
+
+        // Grow array.
+        template<typename T>
+        static bool grow(T*& array, size_t size);
+
+        // Disable copy constructor and assignment operator.
+        tape(const tape&) = delete;
+        tape& operator=(const tape&) = delete;
+    };
+
+    inline tape::~tape()
+    {
+      free(_M_offsets);
+      free(_M_header_lengths);
+      free(_M_tag_numbers);
+      free(_M_flags);
+      free(_M_lengths);
+      free(_M_depths);
+      free(_M_next);
+    }
+
+    inline decoder::result tape::error() const
+    {
+      return _M_error;
+    }
+
+    inline size_t tape::total_length() const
+    {
+      return _M_total_length;
+    }
+
+    inline size_t tape::size() const
+    {
+      return _M_used;
+    }
+
+    inline size_t tape::offset(size_t idx) const
+    {
+      return _M_offsets[idx];
+    }
+
+    inline enum tag_class tape::tag_class(size_t idx) const
+    {
+      return static_cast<enum tag_class>(_M_flags[idx] >> 6);
+    }
+
+    inline uint32_t tape::tag_number(size_t idx) const
+    {
+      return _M_tag_numbers[idx];
+    }
+
+    inline bool tape::constructed(size_t idx) const
+    {
+      return ((_M_flags[idx] & flag_constructed) != 0);
+    }
+
+    inline bool tape::definite_length(size_t idx) const
+    {
+      return ((_M_flags[idx] & flag_definite_length) != 0);
+    }
+
+    inline const void* tape::data(size_t idx) const
+    {
+      return _M_data + _M_offsets[idx] + _M_header_lengths[idx];
+    }
+
+    inline size_t tape::length(size_t idx) const
+    {
+      return _M_lengths[idx];
+    }
+
+    inline size_t tape::depth(size_t idx) const
+    {
+      return _M_depths[idx];
+    }
+
+    inline size_t tape::next_sibling(size_t idx) const
+    {
+      return _M_next[idx];
+    }
+
+    inline size_t tape::first_child(size_t idx) const
+    {
+      return (_M_next[idx] > idx + 1) ? idx + 1 : npos;
+    }
+  }
+}
+
+#endif // ASN1_BER_TAPE_H
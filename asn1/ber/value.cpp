@@ -1,10 +1,28 @@
+#include <string.h>
 #include "asn1/ber/value.h"
 
-#define IS_DIGIT(x) (((x) >= '0') && ((x) <= '9'))
+// Are the octets decimal digits (all the octets are checked at once)?
+static bool are_digits(const uint8_t* s, size_t n);
 
-#if defined(_WIN32)
-  #define timegm _mkgmtime
-#endif
+// Get value of two decimal digits.
+static unsigned two_digits(const uint8_t* s);
+
+// Number of days since 1970-01-01 of a date of the proleptic Gregorian
+// calendar (the day of the month can overflow into the next months, as with
+// `timegm()`).
+static int64_t days_from_civil(int64_t year, unsigned month, unsigned mday);
+
+// Convert local time to UTC.
+static time_t local_to_utc(int64_t t, const struct tm& tm);
+
+// Convert big-endian two's complement integer (1 to 8 octets).
+static int64_t to_integer(const uint8_t* data, size_t len);
+
+// Convert object identifier (at least 1 octet).
+static bool to_oid(const uint8_t* data,
+                   size_t len,
+                   uint32_t* components,
+                   size_t& ncomponents);
 
 bool asn1::ber::value::decode_boolean(bool& val) const
 {
@@ -19,21 +37,7 @@ bool asn1::ber::value::decode_boolean(bool& val) const
 bool asn1::ber::value::decode_integer(int64_t& val) const
 {
   if ((_M_primitive) && (_M_length >= 1) && (_M_length <= 8)) {
-    uint64_t n = 0;
-    for (size_t i = 0; i < _M_length; i++) {
-      n = (n << 8) | _M_data[i];
-    }
-
-    // If the number is positive...
-    if ((_M_data[0] & 0x80u) == 0) {
-      val = static_cast<int64_t>(n);
-    } else {
-      // `n` is in two's complement.
-      n |= (~static_cast<uint64_t>(0) << (_M_length << 3));
-
-      val = -static_cast<int64_t>(~n + 1);
-    }
-
+    val = to_integer(_M_data, _M_length);
     return true;
   }
 
@@ -49,39 +53,120 @@ bool asn1::ber::value::decode_oid(uint32_t* components,
                                   size_t& ncomponents) const
 {
   if ((_M_primitive) && (_M_length > 0)) {
-    components[0] = _M_data[0] / 40;
-    components[1] = _M_data[0] % 40;
-
-    size_t count = 2;
-    uint32_t component = 0;
-
-    for (size_t i = 1; i < _M_length; i++) {
-      // If the component is not too big...
-      if (((component >> (32 - 7)) & 0x7fu) == 0) {
-        component = (component << 7) | (_M_data[i] & 0x7fu);
-
-        // If this is the last octet...
-        if ((_M_data[i] & 0x80u) == 0) {
-          // Add component.
-          components[count++] = component;
-
-          // If the OID is not too long...
-          if (count < max_oid_components) {
-            component = 0;
-          } else if (i + 1 == _M_length) {
-            ncomponents = count;
-            return true;
-          } else {
-            return false;
+    return to_oid(_M_data, _M_length, components, ncomponents);
+  }
+
+  return false;
+}
+
+bool asn1::ber::value::decode_utc_time(time_t& val) const
+{
+  // If the format is YYMMDDhhmmssZ...
+  if ((_M_primitive) &&
+      (_M_length == 13) &&
+      (are_digits(_M_data, 12)) &&
+      (_M_data[12] == 'Z')) {
+    const unsigned year = two_digits(_M_data);
+    const unsigned month = two_digits(_M_data + 2);
+    const unsigned mday = two_digits(_M_data + 4);
+    const unsigned hour = two_digits(_M_data + 6);
+    const unsigned minute = two_digits(_M_data + 8);
+    const unsigned second = two_digits(_M_data + 10);
+
+    // If the fields are in range (checked without branches)...
+    if ((month - 1 < 12) &
+        (mday - 1 < 31) &
+        (hour < 24) &
+        (minute < 60) &
+        (second < 60)) {
+      const int64_t days = days_from_civil((year >= 70) ? 1900 + year :
+                                                          2000 + year,
+                                           month,
+                                           mday);
+
+      val = static_cast<time_t>((days * 86400) +
+                                (hour * 3600) +
+                                (minute * 60) +
+                                second);
+
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool asn1::ber::value::decode_generalized_time(struct timeval& val) const
+{
+  // If the format is YYYYMMDDhhmmss[.f{1,6}][Z]...
+  if ((_M_primitive) &&
+      (_M_length >= 14) &&
+      (_M_length <= 22) &&
+      (are_digits(_M_data, 14))) {
+    const unsigned year = (two_digits(_M_data) * 100) + two_digits(_M_data + 2);
+    const unsigned month = two_digits(_M_data + 4);
+    const unsigned mday = two_digits(_M_data + 6);
+    const unsigned hour = two_digits(_M_data + 8);
+    const unsigned minute = two_digits(_M_data + 10);
+    const unsigned second = two_digits(_M_data + 12);
+
+    // If the fields are in range (checked without branches)...
+    if ((year >= 1900) &
+        (month - 1 < 12) &
+        (mday - 1 < 31) &
+        (hour < 24) &
+        (minute < 60) &
+        (second < 60)) {
+      const bool utc = (_M_data[_M_length - 1] == 'Z');
+
+      unsigned microsecond = 0;
+
+      // Length of the fraction of second (with the decimal point).
+      const size_t len = _M_length - 14 - (utc ? 1 : 0);
+
+      if (len > 0) {
+        // If the fraction of second has between 1 and 6 digits...
+        if ((len >= 2) &&
+            (len <= 7) &&
+            (_M_data[14] == '.') &&
+            (are_digits(_M_data + 15, len - 1))) {
+          static const unsigned scale[] = {
+            100000, 10000, 1000, 100, 10, 1
+          };
+
+          for (size_t i = 15; i < 14 + len; i++) {
+            microsecond = (microsecond * 10) + (_M_data[i] - '0');
           }
+
+          microsecond *= scale[len - 2];
+        } else {
+          return false;
         }
+      }
+
+      const int64_t t = (days_from_civil(year, month, mday) * 86400) +
+                        (hour * 3600) +
+                        (minute * 60) +
+                        second;
+
+      // UTC?
+      if (utc) {
+        val.tv_sec = static_cast<time_t>(t);
       } else {
-        return false;
+        struct tm tm;
+        tm.tm_year = year - 1900;
+        tm.tm_mon = month - 1;
+        tm.tm_mday = mday;
+        tm.tm_hour = hour;
+        tm.tm_min = minute;
+        tm.tm_sec = second;
+        tm.tm_isdst = -1;
+
+        val.tv_sec = local_to_utc(t, tm);
       }
-    }
 
-    if ((_M_length == 1) || ((_M_data[_M_length - 1] & 0x80u) == 0)) {
-      ncomponents = count;
+      val.tv_usec = microsecond;
+
       return true;
     }
   }
@@ -89,165 +174,271 @@ bool asn1::ber::value::decode_oid(uint32_t* components,
   return false;
 }
 
-bool asn1::ber::value::decode_utc_time(time_t& val) const
+size_t asn1::ber::value::decode_booleans(const value* vals,
+                                        size_t n,
+                                        bool* out,
+                                        bool* valid)
 {
-  if ((_M_primitive) &&
-      (_M_length == 13) &&
-      (IS_DIGIT(_M_data[0])) &&
-      (IS_DIGIT(_M_data[1])) &&
-      (IS_DIGIT(_M_data[2])) &&
-      (IS_DIGIT(_M_data[3])) &&
-      (IS_DIGIT(_M_data[4])) &&
-      (IS_DIGIT(_M_data[5])) &&
-      (IS_DIGIT(_M_data[6])) &&
-      (IS_DIGIT(_M_data[7])) &&
-      (IS_DIGIT(_M_data[8])) &&
-      (IS_DIGIT(_M_data[9])) &&
-      (IS_DIGIT(_M_data[10])) &&
-      (IS_DIGIT(_M_data[11])) &&
-      (_M_data[12] == 'Z')) {
-    const unsigned year = ((_M_data[0] - '0') * 10) + (_M_data[1] - '0');
+  size_t count = 0;
 
-    const unsigned month = ((_M_data[2] - '0') * 10) + (_M_data[3] - '0');
+  for (size_t i = 0; i < n; i++) {
+    const value& val = vals[i];
 
-    if ((month >= 1) && (month <= 12)) {
-      const unsigned mday = ((_M_data[4] - '0') * 10) + (_M_data[5] - '0');
+    const bool ok = ((val._M_primitive) & (val._M_length == 1));
 
-      if ((mday >= 1) && (mday <= 31)) {
-        const unsigned hour = ((_M_data[6] - '0') * 10) + (_M_data[7] - '0');
+    out[i] = ((ok) && (*val._M_data != 0));
+    valid[i] = ok;
 
-        if (hour <= 23) {
-          const unsigned minute = ((_M_data[8] - '0') * 10) +
-                                  (_M_data[9] - '0');
+    count += ok;
+  }
 
-          if (minute <= 59) {
-            const unsigned second = ((_M_data[10] - '0') * 10) +
-                                    (_M_data[11] - '0');
+  return count;
+}
 
-            if (second <= 59) {
-              struct tm tm;
-              tm.tm_year = (year >= 70) ? year : 100 + year;
-              tm.tm_mon = month - 1;
-              tm.tm_mday = mday;
-              tm.tm_hour = hour;
-              tm.tm_min = minute;
-              tm.tm_sec = second;
-              tm.tm_isdst = -1;
+size_t asn1::ber::value::decode_integers(const value* vals,
+                                        size_t n,
+                                        int64_t* out,
+                                        bool* valid)
+{
+  size_t count = 0;
 
-              val = timegm(&tm);
+  for (size_t i = 0; i < n; i++) {
+    const value& val = vals[i];
 
-              return true;
-            }
-          }
-        }
-      }
+    const bool ok = ((val._M_primitive) & (val._M_length - 1 < 8));
+
+    out[i] = ok ? to_integer(val._M_data, val._M_length) : 0;
+    valid[i] = ok;
+
+    count += ok;
+  }
+
+  return count;
+}
+
+size_t asn1::ber::value::decode_oids(const value* vals,
+                                    size_t n,
+                                    uint32_t* components,
+                                    size_t size,
+                                    size_t* offsets,
+                                    bool* valid)
+{
+  size_t used = 0;
+
+  offsets[0] = 0;
+
+  for (size_t i = 0; i < n; i++) {
+    const value& val = vals[i];
+
+    // Maximum number of components of the value.
+    const size_t max = (val._M_length < max_oid_components) ?
+                         val._M_length + 1 :
+                         max_oid_components;
+
+    // If the components might not fit...
+    if (max > size - used) {
+      return i;
     }
+
+    size_t ncomponents;
+    if ((val._M_primitive) &&
+        (val._M_length > 0) &&
+        (to_oid(val._M_data, val._M_length, components + used, ncomponents))) {
+      used += ncomponents;
+      valid[i] = true;
+    } else {
+      valid[i] = false;
+    }
+
+    offsets[i + 1] = used;
   }
 
-  return false;
+  return n;
 }
 
-bool asn1::ber::value::decode_generalized_time(struct timeval& val) const
+bool are_digits(const uint8_t* s, size_t n)
 {
-  if ((_M_primitive) &&
-      (_M_length >= 14) &&
-      (_M_length <= 22) &&
-      (IS_DIGIT(_M_data[0])) &&
-      (IS_DIGIT(_M_data[1])) &&
-      (IS_DIGIT(_M_data[2])) &&
-      (IS_DIGIT(_M_data[3])) &&
-      (IS_DIGIT(_M_data[4])) &&
-      (IS_DIGIT(_M_data[5])) &&
-      (IS_DIGIT(_M_data[6])) &&
-      (IS_DIGIT(_M_data[7])) &&
-      (IS_DIGIT(_M_data[8])) &&
-      (IS_DIGIT(_M_data[9])) &&
-      (IS_DIGIT(_M_data[10])) &&
-      (IS_DIGIT(_M_data[11])) &&
-      (IS_DIGIT(_M_data[12])) &&
-      (IS_DIGIT(_M_data[13])) &&
-      ((_M_data[_M_length - 1] == 'Z') || (IS_DIGIT(_M_data[_M_length - 1])))) {
-    const unsigned year = ((_M_data[0] - '0') * 1000) +
-                          ((_M_data[1] - '0') * 100) +
-                          ((_M_data[2] - '0') * 10) +
-                          (_M_data[3] - '0');
-
-    if (year >= 1900) {
-      const unsigned month = ((_M_data[4] - '0') * 10) + (_M_data[5] - '0');
-
-      if ((month >= 1) && (month <= 12)) {
-        const unsigned mday = ((_M_data[6] - '0') * 10) + (_M_data[7] - '0');
-
-        if ((mday >= 1) && (mday <= 31)) {
-          const unsigned hour = ((_M_data[8] - '0') * 10) + (_M_data[9] - '0');
-
-          if (hour <= 23) {
-            const unsigned minute = ((_M_data[10] - '0') * 10) +
-                                    (_M_data[11] - '0');
-
-            if (minute <= 59) {
-              const unsigned second = ((_M_data[12] - '0') * 10) +
-                                      (_M_data[13] - '0');
-
-              if (second <= 59) {
-                unsigned microsecond = 0;
-
-                if (_M_length == 15) {
-                  if (_M_data[14] != 'Z') {
-                    return false;
-                  }
-                } else if (_M_length > 15) {
-                  if (_M_data[14] == '.') {
-                    const size_t ndigits = (_M_data[_M_length - 1] == 'Z') ?
-                                             _M_length - 1 - 15 :
-                                             _M_length - 15;
-
-                    if ((ndigits >= 1) && (ndigits <= 6)) {
-                      unsigned n = 1000000;
-
-                      const size_t max = (_M_data[_M_length - 1] == 'Z') ?
-                                           _M_length - 1 :
-                                           _M_length;
-
-                      for (size_t i = 15; i < max; i++) {
-                        if (IS_DIGIT(_M_data[i])) {
-                          microsecond = (microsecond * 10) + (_M_data[i] - '0');
-                          n /= 10;
-                        } else {
-                          return false;
-                        }
-                      }
-
-                      microsecond *= n;
-                    } else {
-                      return false;
-                    }
-                  } else {
-                    return false;
-                  }
-                }
-
-                struct tm tm;
-                tm.tm_year = year - 1900;
-                tm.tm_mon = month - 1;
-                tm.tm_mday = mday;
-                tm.tm_hour = hour;
-                tm.tm_min = minute;
-                tm.tm_sec = second;
-                tm.tm_isdst = -1;
-
-                val.tv_sec = (_M_data[_M_length - 1] == 'Z') ? timegm(&tm) :
-                                                               mktime(&tm);
-
-                val.tv_usec = microsecond;
-
-                return true;
-              }
-            }
-          }
+  static constexpr const uint64_t high = 0xf0f0f0f0f0f0f0f0ull;
+  static constexpr const uint64_t zeros = 0x3030303030303030ull;
+  static constexpr const uint64_t sixes = 0x0606060606060606ull;
+
+  uint64_t acc = 0;
+
+  // Check eight octets at a time: each octet must be 0x3X and, after adding
+  // 6, still 0x3X (X <= 9).
+  for (; n >= 8; s += 8, n -= 8) {
+    uint64_t v;
+    memcpy(&v, s, 8);
+
+    acc |= ((v & high) ^ zeros) | (((v + sixes) & high) ^ zeros);
+  }
+
+  // Remaining octets.
+  if (n > 0) {
+    uint64_t v = zeros;
+    memcpy(&v, s, n);
+
+    acc |= ((v & high) ^ zeros) | (((v + sixes) & high) ^ zeros);
+  }
+
+  return (acc == 0);
+}
+
+unsigned two_digits(const uint8_t* s)
+{
+  return ((s[0] - '0') * 10) + (s[1] - '0');
+}
+
+int64_t days_from_civil(int64_t year, unsigned month, unsigned mday)
+{
+  // The year starts in March (the leap day is the last day of the year).
+  year -= (month <= 2);
+
+  // 400-year era.
+  const int64_t era = ((year >= 0) ? year : year - 399) / 400;
+
+  // Year of the era [0, 399].
+  const unsigned yoe = static_cast<unsigned>(year - (era * 400));
+
+  // Day of the year [0, 365] (for valid days of the month).
+  const unsigned doy = (((153 * ((month > 2) ? month - 3 : month + 9)) + 2) /
+                        5) +
+                       mday -
+                       1;
+
+  // Day of the era [0, 146096].
+  const unsigned doe = (yoe * 365) + (yoe / 4) - (yoe / 100) + doy;
+
+  return (era * 146097) + static_cast<int64_t>(doe) - 719468;
+}
+
+time_t local_to_utc(int64_t t, const struct tm& tm)
+{
+  // Number of cached UTC offsets.
+  static constexpr const size_t noffsets = 64;
+
+  // UTC offsets by local hour (cached per thread, `mktime()` is slow and
+  // takes a global lock).
+  struct utc_offset {
+    int64_t hour;
+    int64_t offset;
+    bool valid;
+  };
+
+  static thread_local utc_offset offsets[noffsets];
+
+  // Local hour.
+  const int64_t hour = ((t >= 0) ? t : t - 3599) / 3600;
+
+  utc_offset* const entry = &offsets[static_cast<uint64_t>(hour) %
+                                     noffsets];
+
+  // If the UTC offset is not in the cache...
+  if ((!entry->valid) || (entry->hour != hour)) {
+    struct tm tmp = tm;
+    const time_t utc = mktime(&tmp);
+
+    if (utc == static_cast<time_t>(-1)) {
+      return utc;
+    }
+
+    entry->hour = hour;
+    entry->offset = t - static_cast<int64_t>(utc);
+    entry->valid = true;
+  }
+
+  return static_cast<time_t>(t - entry->offset);
+}
+
+int64_t to_integer(const uint8_t* data, size_t len)
+{
+  uint64_t n = 0;
+
+  // Load the octets (big-endian).
+  switch (len) {
+    case 8: n = (n << 8) | *data++; // Fall through.
+    case 7: n = (n << 8) | *data++; // Fall through.
+    case 6: n = (n << 8) | *data++; // Fall through.
+    case 5: n = (n << 8) | *data++; // Fall through.
+    case 4: n = (n << 8) | *data++; // Fall through.
+    case 3: n = (n << 8) | *data++; // Fall through.
+    case 2: n = (n << 8) | *data++; // Fall through.
+    default: n = (n << 8) | *data;
+  }
+
+  // Move the sign bit to the most significant bit and sign-extend
+  // (arithmetic shift).
+  const unsigned shift = (8 - len) << 3;
+
+  return static_cast<int64_t>(n << shift) >> shift;
+}
+
+bool to_oid(const uint8_t* data,
+            size_t len,
+            uint32_t* components,
+            size_t& ncomponents)
+{
+  static constexpr const size_t max_oid_components =
+    asn1::ber::value::max_oid_components;
+
+  components[0] = data[0] / 40;
+  components[1] = data[0] % 40;
+
+  size_t count = 2;
+  uint32_t component = 0;
+
+  size_t i = 1;
+
+  while (i < len) {
+    // If a component starts here, the next 8 octets are single-octet
+    // components and there is room for them (most common case)...
+    if (((i == 1) || ((data[i - 1] & 0x80u) == 0)) &&
+        (len - i >= 8) &&
+        (count + 8 < max_oid_components)) {
+      uint64_t v;
+      memcpy(&v, data + i, 8);
+
+      if ((v & 0x8080808080808080ull) == 0) {
+        for (size_t j = 0; j < 8; j++) {
+          components[count + j] = data[i + j];
         }
+
+        count += 8;
+        i += 8;
+
+        continue;
       }
     }
+
+    // If the component is not too big...
+    if (((component >> (32 - 7)) & 0x7fu) == 0) {
+      component = (component << 7) | (data[i] & 0x7fu);
+
+      // If this is the last octet...
+      if ((data[i] & 0x80u) == 0) {
+        // Add component.
+        components[count++] = component;
+
+        // If the OID is not too long...
+        if (count < max_oid_components) {
+          component = 0;
+        } else if (i + 1 == len) {
+          ncomponents = count;
+          return true;
+        } else {
+          return false;
+        }
+      }
+    } else {
+      return false;
+    }
+
+    i++;
+  }
+
+  if ((len == 1) || ((data[len - 1] & 0x80u) == 0)) {
+    ncomponents = count;
+    return true;
   }
 
   return false;
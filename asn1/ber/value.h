@@ -11,6 +11,9 @@ namespace asn1 {
     // ASN.1 data value.
     class value {
       friend class decoder;
+      friend class tape;
+      friend class query;
+      friend class segmented_decoder;
 
       public:
         // Maximum number of object identifier components.
@@ -68,6 +71,35 @@ namespace asn1 {
         // Decode generalized time.
         bool decode_generalized_time(struct timeval& val) const;
 
+        // Decode booleans (batch): `out[i]` receives the value of `vals[i]`
+        // and `valid[i]` whether it could be decoded (if not, `out[i]` is
+        // false). Returns the number of valid values.
+        static size_t decode_booleans(const value* vals,
+                                      size_t n,
+                                      bool* out,
+                                      bool* valid);
+
+        // Decode integers (batch): `out[i]` receives the value of `vals[i]`
+        // and `valid[i]` whether it could be decoded (if not, `out[i]` is 0).
+        // Returns the number of valid values.
+        static size_t decode_integers(const value* vals,
+                                      size_t n,
+                                      int64_t* out,
+                                      bool* valid);
+
+        // Decode object identifiers (batch): the components of `vals[i]` are
+        // written to `components[offsets[i] .. offsets[i + 1] - 1]`
+        // (`offsets` has `n + 1` entries and `size` is the capacity of
+        // `components`) and `valid[i]` receives whether it could be decoded
+        // (if not, it has no components). Returns the number of values
+        // processed (smaller than `n` if `components` is full).
+        static size_t decode_oids(const value* vals,
+                                  size_t n,
+                                  uint32_t* components,
+                                  size_t size,
+                                  size_t* offsets,
+                                  bool* valid);
+
       private:
         // Total length of the value (header + contents).
         size_t _M_total_length;
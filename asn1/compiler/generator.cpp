@@ -0,0 +1,1730 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "asn1/compiler/generator.h"
+
+// C++ keywords (the ASN.1 identifiers which are C++ keywords get a trailing
+// underscore).
+static const char* const keywords[] = {
+  "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor",
+  "bool", "break", "case", "catch", "char", "char16_t", "char32_t", "class",
+  "compl", "const", "const_cast", "constexpr", "continue", "decltype",
+  "default", "delete", "do", "double", "dynamic_cast", "else", "enum",
+  "explicit", "export", "extern", "false", "float", "for", "friend", "goto",
+  "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept",
+  "not", "not_eq", "nullptr", "operator", "or", "or_eq", "private",
+  "protected", "public", "register", "reinterpret_cast", "return", "short",
+  "signed", "sizeof", "static", "static_assert", "static_cast", "struct",
+  "switch", "template", "this", "thread_local", "throw", "true", "try",
+  "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual",
+  "void", "volatile", "wchar_t", "while", "xor", "xor_eq"
+};
+
+// Skip the tagged types.
+static const asn1::compiler::type* untag(const asn1::compiler::type* t);
+
+// Format integer as a C++ literal.
+static void format_integer(int64_t n, char* out, size_t size);
+
+bool asn1::compiler::generator::generate(string::buffer& header,
+                                         string::buffer& source,
+                                         string::buffer& error)
+{
+  _M_error = &error;
+
+  // Assign C++ names and emit C++ types.
+  if ((!name_types()) || (!check_names()) || (!emit_types())) {
+    return false;
+  }
+
+  // Emit functions.
+  emit_functions();
+
+  if (!_M_ok) {
+    return false;
+  }
+
+  // Compose the name of the include guard.
+  const char* name = strrchr(_M_header, '/');
+  name = name ? name + 1 : _M_header;
+
+  char guard[max_name + 1];
+  size_t len = 0;
+  for (; (name[len]) && (len < max_name); len++) {
+    const char c = name[len];
+
+    if ((c >= 'a') && (c <= 'z')) {
+      guard[len] = c - 'a' + 'A';
+    } else if (((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9'))) {
+      guard[len] = c;
+    } else {
+      guard[len] = '_';
+    }
+  }
+
+  guard[len] = 0;
+
+  // Header.
+  emit(header,
+       0,
+       "// Generated by asn1_ber_compiler from the ASN.1 module %s.",
+       _M_module.name());
+
+  emit(header, 0, "// Do not edit.");
+  emit(header, 0, "");
+  emit(header, 0, "#ifndef %s", guard);
+  emit(header, 0, "#define %s", guard);
+  emit(header, 0, "");
+  emit(header, 0, "#include \"asn1/ber/schema/runtime.h\"");
+  emit(header, 0, "");
+  emit(header, 0, "namespace %s {", _M_namespace);
+
+  if (!header.append(_M_types)) {
+    _M_ok = false;
+  }
+
+  // For each type assignment...
+  for (size_t i = 0; i < _M_aliases.size(); i++) {
+    const char* const cname = _M_aliases[i].cname;
+
+    emit(header, 2, "// Decode %s.", cname);
+    emit(header,
+         2,
+         "bool decode_%s(const asn1::ber::value& val, %s& v);",
+         cname,
+         cname);
+
+    emit(header, 0, "");
+
+    emit(header, 2, "// Encode %s.", cname);
+    emit(header,
+         2,
+         "bool encode_%s(asn1::ber::encoder& enc, const %s& v);",
+         cname,
+         cname);
+
+    if (i + 1 < _M_aliases.size()) {
+      emit(header, 0, "");
+    }
+  }
+
+  emit(header, 0, "}");
+  emit(header, 0, "");
+  emit(header, 0, "#endif // %s", guard);
+
+  // Source.
+  emit(source,
+       0,
+       "// Generated by asn1_ber_compiler from the ASN.1 module %s.",
+       _M_module.name());
+
+  emit(source, 0, "// Do not edit.");
+  emit(source, 0, "");
+  emit(source, 0, "#include \"%s\"", name);
+  emit(source, 0, "");
+  emit(source, 0, "namespace %s {", _M_namespace);
+
+  if ((!source.append(_M_tables)) ||
+      (!source.append(_M_prototypes)) ||
+      (!source.append(_M_code))) {
+    _M_ok = false;
+  }
+
+  emit(source, 0, "}");
+
+  if (!_M_ok) {
+    if (error.empty()) {
+      error.format("out of memory.");
+    }
+
+    return false;
+  }
+
+  return true;
+}
+
+bool asn1::compiler::generator::name_types()
+{
+  // For each type assignment...
+  for (size_t i = 0; i < _M_module.size(); i++) {
+    const assignment& a = _M_module.get(i);
+
+    alias* const al = _M_aliases.add();
+    if (al) {
+      sanitize(a.name, al->cname, sizeof(al->cname));
+
+      // The C++ type of a SEQUENCE, SET, CHOICE or ENUMERATED is named after
+      // the type assignment; for the other types, a typedef is generated.
+      switch (untag(a.type)->kind) {
+        case type::kind::sequence:
+        case type::kind::set:
+        case type::kind::choice:
+        case type::kind::enumerated:
+          al->is_typedef = false;
+          break;
+        default:
+          al->is_typedef = true;
+      }
+
+      al->state = state::pending;
+
+      if (!name_type(a.type, al->cname, a.line)) {
+        return false;
+      }
+    } else {
+      _M_error->format("out of memory.");
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool asn1::compiler::generator::name_type(type* t,
+                                          const char* name,
+                                          unsigned line)
+{
+  char child[max_name + 1];
+
+  switch (t->kind) {
+    case type::kind::tagged:
+      return name_type(t->inner, name, line);
+    case type::kind::sequence:
+    case type::kind::set:
+    case type::kind::choice:
+    case type::kind::enumerated:
+      {
+        snprintf(t->cname, sizeof(t->cname), "%s", name);
+
+        composite* const c = _M_composites.add();
+        if (!c) {
+          _M_error->format("out of memory.");
+          return false;
+        }
+
+        c->type = t;
+        c->state = state::pending;
+
+        // For each component...
+        for (size_t i = 0; i < t->components.size(); i++) {
+          const component& comp = t->components[i];
+
+          // The inner types are named after the type and the component.
+          char member[lexer::max_identifier + 2];
+          sanitize(comp.name, member, sizeof(member));
+
+          if (snprintf(child,
+                       sizeof(child),
+                       "%s_%s",
+                       name,
+                       member) >= static_cast<int>(sizeof(child))) {
+            _M_error->format("line %u: name too long.", comp.line);
+            return false;
+          }
+
+          if (!name_type(comp.type, child, comp.line)) {
+            return false;
+          }
+        }
+      }
+
+      return true;
+    case type::kind::sequence_of:
+    case type::kind::set_of:
+      if (snprintf(child,
+                   sizeof(child),
+                   "%s_element",
+                   name) >= static_cast<int>(sizeof(child))) {
+        _M_error->format("line %u: name too long.", line);
+        return false;
+      }
+
+      return name_type(t->inner, child, line);
+    default:
+      return true;
+  }
+}
+
+bool asn1::compiler::generator::check_names()
+{
+  // For each composite type...
+  for (size_t i = 0; i < _M_composites.size(); i++) {
+    const type* const t = _M_composites[i].type;
+
+    // If there is another composite type with the same name...
+    for (size_t j = 0; j < i; j++) {
+      if (strcmp(t->cname, _M_composites[j].type->cname) == 0) {
+        _M_error->format("line %u: duplicate C++ type '%s'.",
+                         t->line,
+                         t->cname);
+
+        return false;
+      }
+    }
+
+    // If there is a typedef with the same name...
+    for (size_t j = 0; j < _M_aliases.size(); j++) {
+      if ((_M_aliases[j].is_typedef) &&
+          (strcmp(t->cname, _M_aliases[j].cname) == 0)) {
+        _M_error->format("line %u: duplicate C++ type '%s'.",
+                         t->line,
+                         t->cname);
+
+        return false;
+      }
+    }
+  }
+
+  // For each type assignment...
+  for (size_t i = 0; i < _M_aliases.size(); i++) {
+    for (size_t j = 0; j < i; j++) {
+      if (strcmp(_M_aliases[i].cname, _M_aliases[j].cname) == 0) {
+        _M_error->format("line %u: duplicate C++ type '%s'.",
+                         _M_module.get(i).line,
+                         _M_aliases[i].cname);
+
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool asn1::compiler::generator::emit_types()
+{
+  // Forward declarations.
+  bool empty = true;
+  for (size_t i = 0; i < _M_composites.size(); i++) {
+    const type* const t = _M_composites[i].type;
+
+    if (t->kind != type::kind::enumerated) {
+      if (empty) {
+        emit(_M_types, 2, "// Forward declarations.");
+        empty = false;
+      }
+
+      emit(_M_types, 2, "struct %s;", t->cname);
+    }
+  }
+
+  if (!empty) {
+    emit(_M_types, 0, "");
+  }
+
+  // Enumerations.
+  for (size_t i = 0; i < _M_composites.size(); i++) {
+    const type* const t = _M_composites[i].type;
+
+    if (t->kind == type::kind::enumerated) {
+      emit(_M_types, 2, "// %s.", t->cname);
+      emit(_M_types, 2, "enum class %s : int64_t {", t->cname);
+
+      for (size_t j = 0; j < t->enumerators.size(); j++) {
+        char name[lexer::max_identifier + 2];
+        sanitize(t->enumerators[j].name, name, sizeof(name));
+
+        char value[32];
+        format_integer(t->enumerators[j].value, value, sizeof(value));
+
+        emit(_M_types,
+             4,
+             "%s = %s%s",
+             name,
+             value,
+             (j + 1 < t->enumerators.size()) ? "," : "");
+      }
+
+      emit(_M_types, 2, "};");
+      emit(_M_types, 0, "");
+
+      _M_composites[i].state = state::done;
+    }
+  }
+
+  // Typedefs and structs (in dependency order).
+  for (size_t i = 0; i < _M_aliases.size(); i++) {
+    if (!visit_alias(i)) {
+      return false;
+    }
+  }
+
+  for (size_t i = 0; i < _M_composites.size(); i++) {
+    if (!visit_composite(i)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool asn1::compiler::generator::visit_composite(size_t idx)
+{
+  switch (_M_composites[idx].state) {
+    case state::done:
+      return true;
+    case state::visiting:
+      _M_error->format("line %u: type '%s' contains itself (recursive types "
+                       "require a SEQUENCE OF or a SET OF).",
+                       _M_composites[idx].type->line,
+                       _M_composites[idx].type->cname);
+
+      return false;
+    default:
+      ;
+  }
+
+  const type* const t = _M_composites[idx].type;
+
+  _M_composites[idx].state = state::visiting;
+
+  // The types of the members must be complete.
+  for (size_t i = 0; i < t->components.size(); i++) {
+    if (!visit_dependencies(t->components[i].type, true)) {
+      return false;
+    }
+  }
+
+  emit_struct(t);
+
+  _M_composites[idx].state = state::done;
+
+  return true;
+}
+
+bool asn1::compiler::generator::visit_alias(size_t idx)
+{
+  alias& al = _M_aliases[idx];
+
+  // If the type assignment doesn't generate a typedef...
+  if (!al.is_typedef) {
+    return true;
+  }
+
+  switch (al.state) {
+    case state::done:
+      return true;
+    case state::visiting:
+      _M_error->format("line %u: type '%s' is defined in terms of itself.",
+                       _M_module.get(idx).line,
+                       al.cname);
+
+      return false;
+    default:
+      ;
+  }
+
+  al.state = state::visiting;
+
+  const type* const t = _M_module.get(idx).type;
+
+  // The types named by the typedef must be declared.
+  if (!visit_dependencies(t, false)) {
+    return false;
+  }
+
+  char ct[max_ctype];
+  if (ctype(t, ct, sizeof(ct))) {
+    emit(_M_types, 2, "// %s.", al.cname);
+    emit(_M_types, 2, "typedef %s %s;", ct, al.cname);
+    emit(_M_types, 0, "");
+  }
+
+  al.state = state::done;
+
+  return true;
+}
+
+bool asn1::compiler::generator::visit_dependencies(const type* t,
+                                                   bool by_value)
+{
+  switch (t->kind) {
+    case type::kind::tagged:
+      return visit_dependencies(t->inner, by_value);
+    case type::kind::reference:
+      {
+        const size_t idx = t->target - &_M_module.get(0);
+
+        if (_M_aliases[idx].is_typedef) {
+          // The typedef must be emitted before its use and, if the type is
+          // used by value, the type named by the typedef must be complete.
+          return ((visit_alias(idx)) &&
+                  ((!by_value) || (visit_dependencies(t->target->type, true))));
+        } else {
+          return ((!by_value) ||
+                  (visit_composite(find(untag(t->target->type)))));
+        }
+      }
+    case type::kind::sequence:
+    case type::kind::set:
+    case type::kind::choice:
+      return ((!by_value) || (visit_composite(find(t))));
+    case type::kind::sequence_of:
+    case type::kind::set_of:
+      // The elements of an array can be incomplete types.
+      return visit_dependencies(t->inner, false);
+    default:
+      return true;
+  }
+}
+
+void asn1::compiler::generator::emit_struct(const type* t)
+{
+  emit(_M_types, 2, "// %s.", t->cname);
+  emit(_M_types, 2, "struct %s {", t->cname);
+
+  const bool choice = (t->kind == type::kind::choice);
+
+  // If the type is a CHOICE...
+  if (choice) {
+    emit(_M_types, 4, "// Alternatives.");
+    emit(_M_types, 4, "enum class alternative {");
+    emit(_M_types, 6, "none%s", t->components.empty() ? "" : ",");
+
+    for (size_t i = 0; i < t->components.size(); i++) {
+      char name[lexer::max_identifier + 2];
+      sanitize(t->components[i].name, name, sizeof(name));
+
+      emit(_M_types,
+           6,
+           "%s%s",
+           name,
+           (i + 1 < t->components.size()) ? "," : "");
+    }
+
+    emit(_M_types, 4, "};");
+    emit(_M_types, 0, "");
+    emit(_M_types, 4, "// Present alternative.");
+    emit(_M_types, 4, "alternative present = alternative::none;");
+
+    if (!t->components.empty()) {
+      emit(_M_types, 0, "");
+    }
+  }
+
+  // For each component...
+  for (size_t i = 0; i < t->components.size(); i++) {
+    emit_member(t->components[i], choice);
+
+    if (i + 1 < t->components.size()) {
+      emit(_M_types, 0, "");
+    }
+  }
+
+  emit(_M_types, 2, "};");
+  emit(_M_types, 0, "");
+}
+
+void asn1::compiler::generator::emit_member(const component& c, bool choice)
+{
+  char name[lexer::max_identifier + 2];
+  sanitize(c.name, name, sizeof(name));
+
+  char ct[max_ctype];
+  char init[max_ctype];
+  if ((ctype(c.type, ct, sizeof(ct))) &&
+      (initializer(c, init, sizeof(init)))) {
+    if (c.optional) {
+      emit(_M_types, 4, "// %s (optional).", c.name);
+      emit(_M_types, 4, "bool has_%s = false;", name);
+    } else if (c.has_default) {
+      emit(_M_types, 4, "// %s (default: %s).", c.name, init);
+    } else {
+      emit(_M_types, 4, "// %s.", c.name);
+    }
+
+    if (init[0]) {
+      emit(_M_types, 4, "%s %s = %s;", ct, name, init);
+    } else {
+      emit(_M_types, 4, "%s %s;", ct, name);
+    }
+  }
+}
+
+void asn1::compiler::generator::emit_functions()
+{
+  // For each composite type...
+  for (size_t i = 0; i < _M_composites.size(); i++) {
+    const type* const t = _M_composites[i].type;
+
+    switch (t->kind) {
+      case type::kind::sequence:
+        emit_sequence(t);
+        break;
+      case type::kind::set:
+        emit_set(t);
+        break;
+      case type::kind::choice:
+        emit_choice(t);
+        break;
+      case type::kind::enumerated:
+        emit_enumerated(t);
+        break;
+      default:
+        ;
+    }
+  }
+
+  // For each type assignment...
+  for (size_t i = 0; i < _M_aliases.size(); i++) {
+    const char* const cname = _M_aliases[i].cname;
+    const type* const t = _M_module.get(i).type;
+
+    emit_table(t, cname);
+
+    emit(_M_code,
+         2,
+         "bool decode_%s(const asn1::ber::value& val, %s& v)",
+         cname,
+         cname);
+
+    emit(_M_code, 2, "{");
+    emit(_M_code, 4, "if (!asn1::ber::schema::match(val, tags_%s)) {", cname);
+    emit(_M_code, 6, "return false;");
+    emit(_M_code, 4, "}");
+    emit(_M_code, 0, "");
+    emit_decode(_M_code, 4, t, "val", "v", cname);
+    emit(_M_code, 0, "");
+    emit(_M_code, 4, "return true;");
+    emit(_M_code, 2, "}");
+    emit(_M_code, 0, "");
+
+    emit(_M_code,
+         2,
+         "bool encode_%s(asn1::ber::encoder& enc, const %s& v)",
+         cname,
+         cname);
+
+    emit(_M_code, 2, "{");
+    emit_encode(_M_code, 4, t, "v");
+    emit(_M_code, 0, "");
+    emit(_M_code, 4, "return true;");
+    emit(_M_code, 2, "}");
+
+    if (i + 1 < _M_aliases.size()) {
+      emit(_M_code, 0, "");
+    }
+  }
+}
+
+void asn1::compiler::generator::emit_sequence(const type* t)
+{
+  const char* const cname = t->cname;
+  const int width = static_cast<int>(strlen(cname)) + 26;
+
+  // Prototypes.
+  emit(_M_prototypes,
+       2,
+       "static bool decode_%s_value(const asn1::ber::value& val, %s& v);",
+       cname,
+       cname);
+
+  emit(_M_prototypes,
+       2,
+       "static bool encode_%s_value(asn1::ber::encoder& enc,",
+       cname);
+
+  emit(_M_prototypes, 2, "%*sasn1::ber::tag_class tc,", width, "");
+  emit(_M_prototypes, 2, "%*suint32_t tn,", width, "");
+  emit(_M_prototypes, 2, "%*sconst %s& v);", width, "", cname);
+  emit(_M_prototypes, 0, "");
+
+  // Decoder.
+  emit(_M_code,
+       2,
+       "static bool decode_%s_value(const asn1::ber::value& val, %s& v)",
+       cname,
+       cname);
+
+  emit(_M_code, 2, "{");
+  emit(_M_code, 4, "if (!val.constructed()) {");
+  emit(_M_code, 6, "return false;");
+  emit(_M_code, 4, "}");
+  emit(_M_code, 0, "");
+  emit(_M_code, 4, "asn1::ber::schema::reader r(val);");
+  emit(_M_code, 0, "");
+
+  // For each component...
+  for (size_t i = 0; i < t->components.size(); i++) {
+    const component& c = t->components[i];
+
+    char name[lexer::max_identifier + 2];
+    sanitize(c.name, name, sizeof(name));
+
+    char site[max_name + 1];
+    snprintf(site, sizeof(site), "%s_%s", cname, name);
+
+    char target[max_name + 1];
+    snprintf(target, sizeof(target), "v.%s", name);
+
+    emit_table(c.type, site);
+
+    emit(_M_code, 4, "// %s.", c.name);
+    emit(_M_code,
+         4,
+         "if ((!r.end()) && (asn1::ber::schema::match(r.get(), tags_%s))) {",
+         site);
+
+    emit_decode(_M_code, 6, c.type, "r.get()", target, site);
+
+    if (c.optional) {
+      emit(_M_code, 6, "v.has_%s = true;", name);
+    }
+
+    emit(_M_code, 0, "");
+    emit(_M_code, 6, "if (!r.next()) {");
+    emit(_M_code, 8, "return false;");
+    emit(_M_code, 6, "}");
+    emit(_M_code, 4, "} else {");
+
+    if (c.optional) {
+      emit(_M_code, 6, "v.has_%s = false;", name);
+    } else if (c.has_default) {
+      char init[max_ctype];
+      if (initializer(c, init, sizeof(init))) {
+        emit(_M_code, 6, "v.%s = %s;", name, init);
+      }
+    } else {
+      emit(_M_code, 6, "return false;");
+    }
+
+    emit(_M_code, 4, "}");
+    emit(_M_code, 0, "");
+  }
+
+  // If the type is extensible...
+  if (t->extensible) {
+    emit(_M_code, 4, "// Skip extensions.");
+    emit(_M_code, 4, "while (!r.end()) {");
+    emit(_M_code, 6, "if (!r.next()) {");
+    emit(_M_code, 8, "return false;");
+    emit(_M_code, 6, "}");
+    emit(_M_code, 4, "}");
+    emit(_M_code, 0, "");
+  }
+
+  emit(_M_code, 4, "return ((r.end()) && (!r.error()));");
+  emit(_M_code, 2, "}");
+  emit(_M_code, 0, "");
+
+  // Encoder.
+  emit(_M_code,
+       2,
+       "static bool encode_%s_value(asn1::ber::encoder& enc,",
+       cname);
+
+  emit(_M_code, 2, "%*sasn1::ber::tag_class tc,", width, "");
+  emit(_M_code, 2, "%*suint32_t tn,", width, "");
+  emit(_M_code, 2, "%*sconst %s& v)", width, "", cname);
+  emit(_M_code, 2, "{");
+  emit(_M_code, 4, "if (!enc.start_constructed(tc, tn)) {");
+  emit(_M_code, 6, "return false;");
+  emit(_M_code, 4, "}");
+  emit(_M_code, 0, "");
+
+  // For each component...
+  for (size_t i = 0; i < t->components.size(); i++) {
+    const component& c = t->components[i];
+
+    char name[lexer::max_identifier + 2];
+    sanitize(c.name, name, sizeof(name));
+
+    char source[max_name + 1];
+    snprintf(source, sizeof(source), "v.%s", name);
+
+    emit(_M_code, 4, "// %s.", c.name);
+
+    if (c.optional) {
+      emit(_M_code, 4, "if (v.has_%s) {", name);
+      emit_encode(_M_code, 6, c.type, source);
+      emit(_M_code, 4, "}");
+    } else {
+      emit_encode(_M_code, 4, c.type, source);
+    }
+
+    emit(_M_code, 0, "");
+  }
+
+  emit(_M_code, 4, "return enc.end_constructed();");
+  emit(_M_code, 2, "}");
+  emit(_M_code, 0, "");
+}
+
+void asn1::compiler::generator::emit_set(const type* t)
+{
+  const char* const cname = t->cname;
+  const int width = static_cast<int>(strlen(cname)) + 26;
+
+  // Prototypes.
+  emit(_M_prototypes,
+       2,
+       "static bool decode_%s_value(const asn1::ber::value& val, %s& v);",
+       cname,
+       cname);
+
+  emit(_M_prototypes,
+       2,
+       "static bool encode_%s_value(asn1::ber::encoder& enc,",
+       cname);
+
+  emit(_M_prototypes, 2, "%*sasn1::ber::tag_class tc,", width, "");
+  emit(_M_prototypes, 2, "%*suint32_t tn,", width, "");
+  emit(_M_prototypes, 2, "%*sconst %s& v);", width, "", cname);
+  emit(_M_prototypes, 0, "");
+
+  // Decoder.
+  emit(_M_code,
+       2,
+       "static bool decode_%s_value(const asn1::ber::value& val, %s& v)",
+       cname,
+       cname);
+
+  emit(_M_code, 2, "{");
+  emit(_M_code, 4, "if (!val.constructed()) {");
+  emit(_M_code, 6, "return false;");
+  emit(_M_code, 4, "}");
+  emit(_M_code, 0, "");
+  emit(_M_code, 4, "asn1::ber::schema::reader r(val);");
+  emit(_M_code, 0, "");
+
+  const size_t ncomponents = t->components.size();
+
+  if (ncomponents > 0) {
+    emit(_M_code, 4, "// Components present.");
+    emit(_M_code, 4, "bool present[%zu] = {};", ncomponents);
+    emit(_M_code, 0, "");
+  }
+
+  // The components can appear in any order.
+  emit(_M_code, 4, "while (!r.end()) {");
+
+  // For each component...
+  for (size_t i = 0; i < ncomponents; i++) {
+    const component& c = t->components[i];
+
+    char name[lexer::max_identifier + 2];
+    sanitize(c.name, name, sizeof(name));
+
+    char site[max_name + 1];
+    snprintf(site, sizeof(site), "%s_%s", cname, name);
+
+    char target[max_name + 1];
+    snprintf(target, sizeof(target), "v.%s", name);
+
+    emit_table(c.type, site);
+
+    emit(_M_code, 6, "// %s.", c.name);
+    emit(_M_code,
+         6,
+         "%sif (asn1::ber::schema::match(r.get(), tags_%s)) {",
+         (i > 0) ? "} else " : "",
+         site);
+
+    emit(_M_code, 8, "if (present[%zu]) {", i);
+    emit(_M_code, 10, "return false;");
+    emit(_M_code, 8, "}");
+    emit(_M_code, 0, "");
+
+    emit_decode(_M_code, 8, c.type, "r.get()", target, site);
+
+    emit(_M_code, 0, "");
+    emit(_M_code, 8, "present[%zu] = true;", i);
+  }
+
+  // Unknown components are only allowed if the type is extensible.
+  if (!t->extensible) {
+    if (ncomponents > 0) {
+      emit(_M_code, 6, "} else {");
+      emit(_M_code, 8, "return false;");
+      emit(_M_code, 6, "}");
+    } else {
+      emit(_M_code, 6, "return false;");
+    }
+  } else if (ncomponents > 0) {
+    emit(_M_code, 6, "}");
+  }
+
+  emit(_M_code, 0, "");
+  emit(_M_code, 6, "if (!r.next()) {");
+  emit(_M_code, 8, "return false;");
+  emit(_M_code, 6, "}");
+  emit(_M_code, 4, "}");
+  emit(_M_code, 0, "");
+  emit(_M_code, 4, "if (r.error()) {");
+  emit(_M_code, 6, "return false;");
+  emit(_M_code, 4, "}");
+  emit(_M_code, 0, "");
+
+  // For each component...
+  for (size_t i = 0; i < ncomponents; i++) {
+    const component& c = t->components[i];
+
+    char name[lexer::max_identifier + 2];
+    sanitize(c.name, name, sizeof(name));
+
+    if (c.optional) {
+      emit(_M_code, 4, "v.has_%s = present[%zu];", name, i);
+    } else if (c.has_default) {
+      char init[max_ctype];
+      if (initializer(c, init, sizeof(init))) {
+        emit(_M_code, 4, "if (!present[%zu]) {", i);
+        emit(_M_code, 6, "v.%s = %s;", name, init);
+        emit(_M_code, 4, "}");
+      }
+    } else {
+      emit(_M_code, 4, "if (!present[%zu]) {", i);
+      emit(_M_code, 6, "return false;");
+      emit(_M_code, 4, "}");
+    }
+
+    emit(_M_code, 0, "");
+  }
+
+  emit(_M_code, 4, "return true;");
+  emit(_M_code, 2, "}");
+  emit(_M_code, 0, "");
+
+  // Encoder.
+  emit(_M_code,
+       2,
+       "static bool encode_%s_value(asn1::ber::encoder& enc,",
+       cname);
+
+  emit(_M_code, 2, "%*sasn1::ber::tag_class tc,", width, "");
+  emit(_M_code, 2, "%*suint32_t tn,", width, "");
+  emit(_M_code, 2, "%*sconst %s& v)", width, "", cname);
+  emit(_M_code, 2, "{");
+  emit(_M_code, 4, "if (!enc.start_constructed(tc, tn)) {");
+  emit(_M_code, 6, "return false;");
+  emit(_M_code, 4, "}");
+  emit(_M_code, 0, "");
+
+  // For each component...
+  for (size_t i = 0; i < ncomponents; i++) {
+    const component& c = t->components[i];
+
+    char name[lexer::max_identifier + 2];
+    sanitize(c.name, name, sizeof(name));
+
+    char source[max_name + 1];
+    snprintf(source, sizeof(source), "v.%s", name);
+
+    emit(_M_code, 4, "// %s.", c.name);
+
+    if (c.optional) {
+      emit(_M_code, 4, "if (v.has_%s) {", name);
+      emit_encode(_M_code, 6, c.type, source);
+      emit(_M_code, 4, "}");
+    } else {
+      emit_encode(_M_code, 4, c.type, source);
+    }
+
+    emit(_M_code, 0, "");
+  }
+
+  emit(_M_code, 4, "return enc.end_constructed();");
+  emit(_M_code, 2, "}");
+  emit(_M_code, 0, "");
+}
+
+void asn1::compiler::generator::emit_choice(const type* t)
+{
+  const char* const cname = t->cname;
+
+  // Prototypes.
+  emit(_M_prototypes,
+       2,
+       "static bool decode_%s_value(const asn1::ber::value& val, %s& v);",
+       cname,
+       cname);
+
+  emit(_M_prototypes,
+       2,
+       "static bool encode_%s_value(asn1::ber::encoder& enc, const %s& v);",
+       cname,
+       cname);
+
+  emit(_M_prototypes, 0, "");
+
+  // Decoder.
+  emit(_M_code,
+       2,
+       "static bool decode_%s_value(const asn1::ber::value& val, %s& v)",
+       cname,
+       cname);
+
+  emit(_M_code, 2, "{");
+
+  // For each alternative...
+  for (size_t i = 0; i < t->components.size(); i++) {
+    const component& c = t->components[i];
+
+    char name[lexer::max_identifier + 2];
+    sanitize(c.name, name, sizeof(name));
+
+    char site[max_name + 1];
+    snprintf(site, sizeof(site), "%s_%s", cname, name);
+
+    char target[max_name + 1];
+    snprintf(target, sizeof(target), "v.%s", name);
+
+    emit_table(c.type, site);
+
+    emit(_M_code, 4, "// %s.", c.name);
+    emit(_M_code, 4, "if (asn1::ber::schema::match(val, tags_%s)) {", site);
+    emit(_M_code, 6, "v.present = %s::alternative::%s;", cname, name);
+    emit(_M_code, 0, "");
+
+    emit_decode(_M_code, 6, c.type, "val", target, site);
+
+    emit(_M_code, 0, "");
+    emit(_M_code, 6, "return true;");
+    emit(_M_code, 4, "}");
+    emit(_M_code, 0, "");
+  }
+
+  // If the type is extensible...
+  if (t->extensible) {
+    emit(_M_code, 4, "// Unknown alternative (extension).");
+    emit(_M_code, 4, "v.present = %s::alternative::none;", cname);
+    emit(_M_code, 0, "");
+    emit(_M_code, 4, "return true;");
+  } else {
+    emit(_M_code, 4, "return false;");
+  }
+
+  emit(_M_code, 2, "}");
+  emit(_M_code, 0, "");
+
+  // Encoder.
+  emit(_M_code,
+       2,
+       "static bool encode_%s_value(asn1::ber::encoder& enc, const %s& v)",
+       cname,
+       cname);
+
+  emit(_M_code, 2, "{");
+  emit(_M_code, 4, "switch (v.present) {");
+
+  // For each alternative...
+  for (size_t i = 0; i < t->components.size(); i++) {
+    const component& c = t->components[i];
+
+    char name[lexer::max_identifier + 2];
+    sanitize(c.name, name, sizeof(name));
+
+    char source[max_name + 1];
+    snprintf(source, sizeof(source), "v.%s", name);
+
+    emit(_M_code, 6, "case %s::alternative::%s:", cname, name);
+    emit_encode(_M_code, 8, c.type, source);
+    emit(_M_code, 0, "");
+    emit(_M_code, 8, "return true;");
+  }
+
+  emit(_M_code, 6, "default:");
+  emit(_M_code, 8, "return false;");
+  emit(_M_code, 4, "}");
+  emit(_M_code, 2, "}");
+  emit(_M_code, 0, "");
+}
+
+void asn1::compiler::generator::emit_enumerated(const type* t)
+{
+  const char* const cname = t->cname;
+
+  // Prototype.
+  emit(_M_prototypes,
+       2,
+       "static bool decode_%s_value(const asn1::ber::value& val, %s& v);",
+       cname,
+       cname);
+
+  emit(_M_prototypes, 0, "");
+
+  // Decoder.
+  emit(_M_code,
+       2,
+       "static bool decode_%s_value(const asn1::ber::value& val, %s& v)",
+       cname,
+       cname);
+
+  emit(_M_code, 2, "{");
+  emit(_M_code, 4, "int64_t n;");
+  emit(_M_code, 4, "if (!asn1::ber::schema::decode_integer(val, n)) {");
+  emit(_M_code, 6, "return false;");
+  emit(_M_code, 4, "}");
+  emit(_M_code, 0, "");
+
+  // If the type is extensible...
+  if (t->extensible) {
+    emit(_M_code, 4, "// Unknown values are allowed (extensions).");
+    emit(_M_code, 4, "v = static_cast<%s>(n);", cname);
+    emit(_M_code, 0, "");
+    emit(_M_code, 4, "return true;");
+  } else {
+    emit(_M_code, 4, "switch (n) {");
+
+    // For each enumerator...
+    for (size_t i = 0; i < t->enumerators.size(); i++) {
+      char value[32];
+      format_integer(t->enumerators[i].value, value, sizeof(value));
+
+      emit(_M_code, 6, "case %s:", value);
+    }
+
+    emit(_M_code, 8, "v = static_cast<%s>(n);", cname);
+    emit(_M_code, 8, "return true;");
+    emit(_M_code, 6, "default:");
+    emit(_M_code, 8, "return false;");
+    emit(_M_code, 4, "}");
+  }
+
+  emit(_M_code, 2, "}");
+  emit(_M_code, 0, "");
+}
+
+void asn1::compiler::generator::emit_decode(string::buffer& buf,
+                                            unsigned indent,
+                                            const type* t,
+                                            const char* val,
+                                            const char* target,
+                                            const char* site)
+{
+  wire w;
+  if (!compute(t, w)) {
+    return;
+  }
+
+  const bool choice = (w.base->kind == type::kind::choice);
+
+  // Value being decoded.
+  char cur[32];
+  snprintf(cur, sizeof(cur), "%s", val);
+
+  // Unwrap the explicitly tagged values.
+  const size_t nunwrap = choice ? w.ntags : w.ntags - 1;
+
+  for (size_t i = 0; i < nunwrap; i++) {
+    const unsigned n = _M_var++;
+
+    emit(buf, indent, "asn1::ber::value v%u;", n);
+
+    if (i + 1 < w.ntags) {
+      emit(buf,
+           indent,
+           "if ((!asn1::ber::schema::unwrap(%s, v%u)) ||",
+           cur,
+           n);
+
+      emit(buf,
+           indent,
+           "    (!asn1::ber::schema::match(v%u, %s, %u))) {",
+           n,
+           to_string(w.tags[i + 1].tag_class),
+           w.tags[i + 1].tag_number);
+    } else {
+      emit(buf, indent, "if (!asn1::ber::schema::unwrap(%s, v%u)) {", cur, n);
+    }
+
+    emit(buf, indent + 2, "return false;");
+    emit(buf, indent, "}");
+    emit(buf, 0, "");
+
+    snprintf(cur, sizeof(cur), "v%u", n);
+  }
+
+  const char* function = nullptr;
+
+  switch (w.base->kind) {
+    case type::kind::boolean:
+      function = "asn1::ber::schema::decode_boolean";
+      break;
+    case type::kind::integer:
+      function = "asn1::ber::schema::decode_integer";
+      break;
+    case type::kind::null:
+      function = "asn1::ber::schema::decode_null";
+      break;
+    case type::kind::octets:
+      function = "asn1::ber::schema::decode_octets";
+      break;
+    case type::kind::oid:
+      function = "asn1::ber::schema::decode_oid";
+      break;
+    case type::kind::utc_time:
+      function = "asn1::ber::schema::decode_utc_time";
+      break;
+    case type::kind::generalized_time:
+      function = "asn1::ber::schema::decode_generalized_time";
+      break;
+    case type::kind::enumerated:
+    case type::kind::sequence:
+    case type::kind::set:
+    case type::kind::choice:
+      emit(buf,
+           indent,
+           "if (!decode_%s_value(%s, %s)) {",
+           w.base->cname,
+           cur,
+           target);
+
+      emit(buf, indent + 2, "return false;");
+      emit(buf, indent, "}");
+
+      return;
+    case type::kind::sequence_of:
+    case type::kind::set_of:
+      {
+        const unsigned n = _M_var++;
+
+        char elemsite[max_name + 1];
+        snprintf(elemsite, sizeof(elemsite), "%s_element", site);
+
+        char ct[max_ctype];
+        if (!ctype(w.base->inner, ct, sizeof(ct))) {
+          return;
+        }
+
+        emit_table(w.base->inner, elemsite);
+
+        emit(buf, indent, "if (!%s.constructed()) {", cur);
+        emit(buf, indent + 2, "return false;");
+        emit(buf, indent, "}");
+        emit(buf, 0, "");
+        emit(buf, indent, "%s.clear();", target);
+        emit(buf, 0, "");
+        emit(buf, indent, "asn1::ber::schema::reader r%u(%s);", n, cur);
+        emit(buf, indent, "while (!r%u.end()) {", n);
+        emit(buf,
+             indent + 2,
+             "if (!asn1::ber::schema::match(r%u.get(), tags_%s)) {",
+             n,
+             elemsite);
+
+        emit(buf, indent + 4, "return false;");
+        emit(buf, indent + 2, "}");
+        emit(buf, 0, "");
+        emit(buf, indent + 2, "%s* const p%u = %s.add();", ct, n, target);
+        emit(buf, indent + 2, "if (!p%u) {", n);
+        emit(buf, indent + 4, "return false;");
+        emit(buf, indent + 2, "}");
+        emit(buf, 0, "");
+        emit(buf, indent + 2, "%s& e%u = *p%u;", ct, n, n);
+        emit(buf, 0, "");
+
+        char elemval[32];
+        snprintf(elemval, sizeof(elemval), "r%u.get()", n);
+
+        char elemtarget[32];
+        snprintf(elemtarget, sizeof(elemtarget), "e%u", n);
+
+        emit_decode(buf, indent + 2, w.base->inner, elemval, elemtarget, elemsite);
+
+        emit(buf, 0, "");
+        emit(buf, indent + 2, "if (!r%u.next()) {", n);
+        emit(buf, indent + 4, "return false;");
+        emit(buf, indent + 2, "}");
+        emit(buf, indent, "}");
+        emit(buf, 0, "");
+        emit(buf, indent, "if (r%u.error()) {", n);
+        emit(buf, indent + 2, "return false;");
+        emit(buf, indent, "}");
+      }
+
+      return;
+    default:
+      return;
+  }
+
+  emit(buf, indent, "if (!%s(%s, %s)) {", function, cur, target);
+  emit(buf, indent + 2, "return false;");
+  emit(buf, indent, "}");
+}
+
+void asn1::compiler::generator::emit_encode(string::buffer& buf,
+                                            unsigned indent,
+                                            const type* t,
+                                            const char* source)
+{
+  wire w;
+  if (!compute(t, w)) {
+    return;
+  }
+
+  const bool choice = (w.base->kind == type::kind::choice);
+
+  // Explicit tags.
+  const size_t nwrap = choice ? w.ntags : w.ntags - 1;
+
+  for (size_t i = 0; i < nwrap; i++) {
+    emit(buf,
+         indent,
+         "if (!enc.start_constructed<%s, %u>()) {",
+         to_string(w.tags[i].tag_class),
+         w.tags[i].tag_number);
+
+    emit(buf, indent + 2, "return false;");
+    emit(buf, indent, "}");
+    emit(buf, 0, "");
+  }
+
+  const char* tc = nullptr;
+  uint32_t tn = 0;
+
+  if (!choice) {
+    tc = to_string(w.tags[w.ntags - 1].tag_class);
+    tn = w.tags[w.ntags - 1].tag_number;
+  }
+
+  const char* function = nullptr;
+
+  // The tag is passed as template arguments (if supported by the function).
+  bool templated = true;
+
+  switch (w.base->kind) {
+    case type::kind::boolean:
+      function = "asn1::ber::schema::encode_boolean";
+      break;
+    case type::kind::integer:
+      function = "asn1::ber::schema::encode_integer";
+      break;
+    case type::kind::null:
+      function = "asn1::ber::schema::encode_null";
+      break;
+    case type::kind::octets:
+      function = "asn1::ber::schema::encode_octets";
+      break;
+    case type::kind::oid:
+      function = "asn1::ber::schema::encode_oid";
+      templated = false;
+      break;
+    case type::kind::utc_time:
+      function = "asn1::ber::schema::encode_utc_time";
+      templated = false;
+      break;
+    case type::kind::generalized_time:
+      function = "asn1::ber::schema::encode_generalized_time";
+      break;
+    case type::kind::enumerated:
+      emit(buf,
+           indent,
+           "if (!asn1::ber::schema::encode_integer<%s, %u>(",
+           tc,
+           tn);
+
+      emit(buf, indent, "      enc,");
+      emit(buf, indent, "      static_cast<int64_t>(%s))) {", source);
+
+      emit(buf, indent + 2, "return false;");
+      emit(buf, indent, "}");
+
+      break;
+    case type::kind::sequence:
+    case type::kind::set:
+      emit(buf,
+           indent,
+           "if (!encode_%s_value(enc, %s, %u, %s)) {",
+           w.base->cname,
+           tc,
+           tn,
+           source);
+
+      emit(buf, indent + 2, "return false;");
+      emit(buf, indent, "}");
+
+      break;
+    case type::kind::choice:
+      emit(buf,
+           indent,
+           "if (!encode_%s_value(enc, %s)) {",
+           w.base->cname,
+           source);
+
+      emit(buf, indent + 2, "return false;");
+      emit(buf, indent, "}");
+
+      break;
+    case type::kind::sequence_of:
+    case type::kind::set_of:
+      {
+        const unsigned n = _M_var++;
+
+        emit(buf, indent, "if (!enc.start_constructed<%s, %u>()) {", tc, tn);
+        emit(buf, indent + 2, "return false;");
+        emit(buf, indent, "}");
+        emit(buf, 0, "");
+        emit(buf,
+             indent,
+             "for (size_t i%u = 0; i%u < %s.size(); i%u++) {",
+             n,
+             n,
+             source,
+             n);
+
+        char element[max_line];
+        snprintf(element, sizeof(element), "%s[i%u]", source, n);
+
+        emit_encode(buf, indent + 2, w.base->inner, element);
+
+        emit(buf, indent, "}");
+        emit(buf, 0, "");
+        emit(buf, indent, "if (!enc.end_constructed()) {");
+        emit(buf, indent + 2, "return false;");
+        emit(buf, indent, "}");
+      }
+
+      break;
+    default:
+      ;
+  }
+
+  if (function) {
+    if (templated) {
+      emit(buf,
+           indent,
+           "if (!%s<%s, %u>(enc, %s)) {",
+           function,
+           tc,
+           tn,
+           source);
+    } else {
+      emit(buf,
+           indent,
+           "if (!%s(enc, %s, %u, %s)) {",
+           function,
+           tc,
+           tn,
+           source);
+    }
+
+    emit(buf, indent + 2, "return false;");
+    emit(buf, indent, "}");
+  }
+
+  // Close the explicit tags.
+  for (size_t i = 0; i < nwrap; i++) {
+    emit(buf, 0, "");
+    emit(buf, indent, "if (!enc.end_constructed()) {");
+    emit(buf, indent + 2, "return false;");
+    emit(buf, indent, "}");
+  }
+}
+
+void asn1::compiler::generator::emit_table(const type* t, const char* site)
+{
+  emit(_M_tables,
+       2,
+       "static constexpr const asn1::ber::schema::tag tags_%s[] = {",
+       site);
+
+  bool first = true;
+  add_tags(t, first);
+
+  emit(_M_tables, 0, "");
+  emit(_M_tables, 2, "};");
+  emit(_M_tables, 0, "");
+}
+
+void asn1::compiler::generator::add_tags(const type* t, bool& first)
+{
+  wire w;
+  if (compute(t, w)) {
+    // If the type has a tag...
+    if (w.ntags > 0) {
+      char line[max_line];
+      const int len = snprintf(line,
+                               sizeof(line),
+                               "%s    {%s, %u}",
+                               first ? "" : ",\n",
+                               to_string(w.tags[0].tag_class),
+                               w.tags[0].tag_number);
+
+      if (!_M_tables.append(line, len)) {
+        _M_ok = false;
+      }
+
+      first = false;
+    } else {
+      // Untagged CHOICE: the tags of the alternatives.
+      for (size_t i = 0; i < w.base->components.size(); i++) {
+        add_tags(w.base->components[i].type, first);
+      }
+    }
+  }
+}
+
+void asn1::compiler::generator::emit(string::buffer& buf,
+                                     unsigned indent,
+                                     const char* format,
+                                     ...)
+{
+  char line[max_line];
+
+  va_list ap;
+  va_start(ap, format);
+  const int len = vsnprintf(line, sizeof(line), format, ap);
+  va_end(ap);
+
+  // If the line fits in the buffer...
+  if ((len >= 0) && (static_cast<size_t>(len) < sizeof(line))) {
+    // Empty lines are not indented.
+    if (((len > 0) && (!buf.append(indent, ' '))) ||
+        (!buf.append(line, len)) ||
+        (!buf.push_back('\n'))) {
+      _M_ok = false;
+    }
+  } else {
+    if (_M_ok) {
+      _M_error->format("generated line too long.");
+    }
+
+    _M_ok = false;
+  }
+}
+
+bool asn1::compiler::generator::compute(const type* t, wire& w)
+{
+  w.ntags = 0;
+
+  // Has the tag of the current type been replaced by an implicit tag?
+  bool replaced = false;
+
+  do {
+    switch (t->kind) {
+      case type::kind::tagged:
+        if (!replaced) {
+          if (w.ntags == max_tags) {
+            if (_M_ok) {
+              _M_error->format("line %u: too many tags.", t->line);
+            }
+
+            _M_ok = false;
+
+            return false;
+          }
+
+          w.tags[w.ntags].tag_class = t->tag_class;
+          w.tags[w.ntags].tag_number = t->tag_number;
+          w.ntags++;
+        }
+
+        // If the tag is implicit, the tag of the inner type is replaced.
+        replaced = (t->tagging == tagging::implicit_tagging);
+
+        t = t->inner;
+        break;
+      case type::kind::reference:
+        t = t->target->type;
+        break;
+      default:
+        // If the tag of the built-in type has not been replaced (a CHOICE
+        // has no tag of its own)...
+        if ((!replaced) && (t->kind != type::kind::choice)) {
+          if (w.ntags == max_tags) {
+            if (_M_ok) {
+              _M_error->format("line %u: too many tags.", t->line);
+            }
+
+            _M_ok = false;
+
+            return false;
+          }
+
+          w.tags[w.ntags].tag_class = ber::tag_class::Universal;
+          w.tags[w.ntags].tag_number = t->universal;
+          w.ntags++;
+        }
+
+        w.base = t;
+
+        return true;
+    }
+  } while (true);
+}
+
+bool asn1::compiler::generator::ctype(const type* t,
+                                      char* out,
+                                      size_t size) const
+{
+  int len;
+
+  switch (t->kind) {
+    case type::kind::tagged:
+      return ctype(t->inner, out, size);
+    case type::kind::reference:
+      len = snprintf(out, size, "%s", cname(t->target));
+      break;
+    case type::kind::boolean:
+      len = snprintf(out, size, "bool");
+      break;
+    case type::kind::integer:
+      len = snprintf(out, size, "int64_t");
+      break;
+    case type::kind::null:
+      len = snprintf(out, size, "asn1::ber::schema::null");
+      break;
+    case type::kind::octets:
+      len = snprintf(out, size, "asn1::ber::schema::octets");
+      break;
+    case type::kind::oid:
+      len = snprintf(out, size, "asn1::ber::schema::oid");
+      break;
+    case type::kind::utc_time:
+      len = snprintf(out, size, "time_t");
+      break;
+    case type::kind::generalized_time:
+      len = snprintf(out, size, "struct timeval");
+      break;
+    case type::kind::enumerated:
+    case type::kind::sequence:
+    case type::kind::set:
+    case type::kind::choice:
+      len = snprintf(out, size, "%s", t->cname);
+      break;
+    case type::kind::sequence_of:
+    case type::kind::set_of:
+      {
+        char inner[max_ctype];
+        if (!ctype(t->inner, inner, sizeof(inner))) {
+          return false;
+        }
+
+        len = snprintf(out, size, "asn1::ber::schema::array<%s>", inner);
+      }
+
+      break;
+    default:
+      return false;
+  }
+
+  return ((len >= 0) && (static_cast<size_t>(len) < size));
+}
+
+const char* asn1::compiler::generator::cname(const assignment* a) const
+{
+  return _M_aliases[a - &_M_module.get(0)].cname;
+}
+
+bool asn1::compiler::generator::initializer(const component& c,
+                                            char* out,
+                                            size_t size) const
+{
+  const type* const b = module::base(c.type);
+
+  char value[32];
+
+  switch (b->kind) {
+    case type::kind::boolean:
+      snprintf(out,
+               size,
+               "%s",
+               ((c.has_default) && (c.default_value != 0)) ? "true" : "false");
+
+      return true;
+    case type::kind::integer:
+      format_integer(c.has_default ? c.default_value : 0,
+                     value,
+                     sizeof(value));
+
+      snprintf(out, size, "%s", value);
+
+      return true;
+    case type::kind::enumerated:
+      {
+        char ct[max_ctype];
+        if (!ctype(c.type, ct, sizeof(ct))) {
+          return false;
+        }
+
+        format_integer(c.has_default ?
+                         c.default_value :
+                         b->enumerators[0].value,
+                       value,
+                       sizeof(value));
+
+        const int len = snprintf(out, size, "static_cast<%s>(%s)", ct, value);
+
+        return ((len >= 0) && (static_cast<size_t>(len) < size));
+      }
+    case type::kind::utc_time:
+      snprintf(out, size, "0");
+      return true;
+    case type::kind::generalized_time:
+      snprintf(out, size, "{0, 0}");
+      return true;
+    default:
+      // The other types have a default constructor.
+      *out = 0;
+      return true;
+  }
+}
+
+size_t asn1::compiler::generator::find(const type* t) const
+{
+  for (size_t i = 0; i < _M_composites.size(); i++) {
+    if (_M_composites[i].type == t) {
+      return i;
+    }
+  }
+
+  // Not reached (all the composite types are registered).
+  return 0;
+}
+
+void asn1::compiler::generator::sanitize(const char* name,
+                                         char* out,
+                                         size_t size)
+{
+  size_t len = 0;
+
+  for (; (name[len]) && (len + 2 < size); len++) {
+    out[len] = (name[len] != '-') ? name[len] : '_';
+  }
+
+  out[len] = 0;
+
+  // If the name is a C++ keyword...
+  for (size_t i = 0; i < sizeof(keywords) / sizeof(keywords[0]); i++) {
+    if (strcmp(out, keywords[i]) == 0) {
+      out[len++] = '_';
+      out[len] = 0;
+
+      break;
+    }
+  }
+}
+
+const char* asn1::compiler::generator::to_string(ber::tag_class tc)
+{
+  switch (tc) {
+    case ber::tag_class::Universal:
+      return "asn1::ber::tag_class::Universal";
+    case ber::tag_class::Application:
+      return "asn1::ber::tag_class::Application";
+    case ber::tag_class::ContextSpecific:
+      return "asn1::ber::tag_class::ContextSpecific";
+    case ber::tag_class::Private:
+    default:
+      return "asn1::ber::tag_class::Private";
+  }
+}
+
+const asn1::compiler::type* untag(const asn1::compiler::type* t)
+{
+  while (t->kind == asn1::compiler::type::kind::tagged) {
+    t = t->inner;
+  }
+
+  return t;
+}
+
+void format_integer(int64_t n, char* out, size_t size)
+{
+  // The smallest integer cannot be written as a negated literal.
+  if (n == INT64_MIN) {
+    snprintf(out, size, "(-9223372036854775807ll - 1)");
+  } else {
+    snprintf(out, size, "%lldll", static_cast<long long>(n));
+  }
+}
@@ -0,0 +1,196 @@
+#ifndef ASN1_COMPILER_GENERATOR_H
+#define ASN1_COMPILER_GENERATOR_H
+
+#include "asn1/compiler/module.h"
+#include "string/buffer.h"
+
+namespace asn1 {
+  namespace compiler {
+    // C++ code generator.
+    //
+    // For each type assignment `Foo` of the module, generates a C++ type
+    // (a struct for SEQUENCE, SET and CHOICE, an enum class for ENUMERATED and
+    // a typedef otherwise) and the functions:
+    //   bool decode_Foo(const asn1::ber::value& val, Foo& v);
+    //   bool encode_Foo(asn1::ber::encoder& enc, const Foo& v);
+    //
+    // The tags are resolved at generation time: each component is matched
+    // against a constexpr table of the tags it can start with, and the
+    // decoding of the component is specialized for its type (no dispatch on
+    // the tag number at run time).
+    class generator {
+      public:
+        // Constructor.
+        generator(module& m, const char* ns, const char* header);
+
+        // Destructor.
+        ~generator() = default;
+
+        // Generate header and source (`error` receives the error message on
+        // failure).
+        bool generate(string::buffer& header,
+                      string::buffer& source,
+                      string::buffer& error);
+
+      private:
+        // Maximum number of tags of a type (explicit tags).
+        static constexpr const size_t max_tags = 8;
+
+        // Maximum length of a generated line.
+        static constexpr const size_t max_line = 4096;
+
+        // Maximum length of a C++ type.
+        static constexpr const size_t max_ctype = 1024;
+
+        // Encoding of a type: tags as they appear in the encoding (from the
+        // outermost tag) and built-in type. All the tags but the last one
+        // are explicit tags; for a CHOICE, all the tags are explicit tags.
+        struct wire {
+          ber::schema::tag tags[max_tags];
+          size_t ntags;
+
+          const type* base;
+        };
+
+        // State of a generated C++ type (for emitting the C++ types in
+        // dependency order).
+        enum class state : uint8_t {
+          pending,
+          visiting,
+          done
+        };
+
+        // Composite type (SEQUENCE, SET, CHOICE or ENUMERATED).
+        struct composite {
+          struct type* type;
+          enum state state;
+        };
+
+        // Type assignment.
+        struct alias {
+          // C++ name.
+          char cname[max_name + 1];
+
+          // Is it a typedef (not a composite type)?
+          bool is_typedef;
+
+          enum state state;
+        };
+
+        // Module.
+        module& _M_module;
+
+        // Namespace.
+        const char* _M_namespace;
+
+        // Header file name (for the #include directive).
+        const char* _M_header;
+
+        // Composite types.
+        ber::schema::array<composite> _M_composites;
+
+        // Type assignments.
+        ber::schema::array<alias> _M_aliases;
+
+        // C++ type definitions (header).
+        string::buffer _M_types;
+
+        // Tag tables (source).
+        string::buffer _M_tables;
+
+        // Function prototypes (source).
+        string::buffer _M_prototypes;
+
+        // Function definitions (source).
+        string::buffer _M_code;
+
+        // Error message.
+        string::buffer* _M_error;
+
+        // Counter for the names of the local variables.
+        unsigned _M_var = 0;
+
+        // Could the output be generated?
+        bool _M_ok = true;
+
+        // Assign C++ names.
+        bool name_types();
+        bool name_type(type* t, const char* name, unsigned line);
+
+        // Check that the C++ names are unique.
+        bool check_names();
+
+        // Emit C++ type definitions.
+        bool emit_types();
+        bool visit_composite(size_t idx);
+        bool visit_alias(size_t idx);
+        bool visit_dependencies(const type* t, bool by_value);
+        void emit_struct(const type* t);
+        void emit_member(const component& c, bool choice);
+
+        // Emit functions.
+        void emit_functions();
+        void emit_sequence(const type* t);
+        void emit_set(const type* t);
+        void emit_choice(const type* t);
+        void emit_enumerated(const type* t);
+
+        // Emit decoding of the value `val` of type `t` into `target` (the tag
+        // of the value has been already checked).
+        void emit_decode(string::buffer& buf,
+                         unsigned indent,
+                         const type* t,
+                         const char* val,
+                         const char* target,
+                         const char* site);
+
+        // Emit encoding of `source` of type `t`.
+        void emit_encode(string::buffer& buf,
+                         unsigned indent,
+                         const type* t,
+                         const char* source);
+
+        // Emit table of the tags which can start the encoding of a type.
+        void emit_table(const type* t, const char* site);
+        void add_tags(const type* t, bool& first);
+
+        // Emit line.
+        void emit(string::buffer& buf, unsigned indent, const char* format, ...)
+          __attribute__((format(printf, 4, 5)));
+
+        // Compute the encoding of a type.
+        bool compute(const type* t, wire& w);
+
+        // Get the C++ type of a type.
+        bool ctype(const type* t, char* out, size_t size) const;
+
+        // Get the C++ name of a type assignment.
+        const char* cname(const assignment* a) const;
+
+        // Get the C++ initializer of a member.
+        bool initializer(const component& c, char* out, size_t size) const;
+
+        // Find composite type.
+        size_t find(const type* t) const;
+
+        // Get C++ name of an ASN.1 identifier.
+        static void sanitize(const char* name, char* out, size_t size);
+
+        // Get C++ name of a tag class.
+        static const char* to_string(ber::tag_class tc);
+
+        // Disable copy constructor and assignment operator.
+        generator(const generator&) = delete;
+        generator& operator=(const generator&) = delete;
+    };
+
+    inline generator::generator(module& m, const char* ns, const char* header)
+      : _M_module(m),
+        _M_namespace(ns),
+        _M_header(header)
+    {
+    }
+  }
+}
+
+#endif // ASN1_COMPILER_GENERATOR_H
@@ -0,0 +1,221 @@
+#include "asn1/compiler/lexer.h"
+
+#define IS_DIGIT(x) (((x) >= '0') && ((x) <= '9'))
+#define IS_ALPHA(x) ((((x) >= 'A') && ((x) <= 'Z')) || \
+                     (((x) >= 'a') && ((x) <= 'z')))
+
+bool asn1::compiler::lexer::next(token& tok)
+{
+  // Skip white space and comments.
+  skip();
+
+  tok.line = _M_line;
+
+  // If at the end of the data...
+  if (_M_offset == _M_length) {
+    tok.type = token::type::end;
+    return true;
+  }
+
+  const char c = _M_data[_M_offset];
+
+  // Identifier?
+  if (IS_ALPHA(c)) {
+    size_t len = 0;
+
+    do {
+      // If the identifier is too long...
+      if (len == max_identifier) {
+        return false;
+      }
+
+      tok.text[len++] = _M_data[_M_offset++];
+
+      // If the next character is a hyphen...
+      if ((_M_offset < _M_length) && (_M_data[_M_offset] == '-')) {
+        // An identifier cannot contain two consecutive hyphens (comment)
+        // nor end in a hyphen.
+        if ((_M_offset + 1 < _M_length) &&
+            ((IS_ALPHA(_M_data[_M_offset + 1])) ||
+             (IS_DIGIT(_M_data[_M_offset + 1])))) {
+          if (len == max_identifier) {
+            return false;
+          }
+
+          tok.text[len++] = _M_data[_M_offset++];
+        } else {
+          break;
+        }
+      }
+    } while ((_M_offset < _M_length) &&
+             ((IS_ALPHA(_M_data[_M_offset])) ||
+              (IS_DIGIT(_M_data[_M_offset]))));
+
+    tok.text[len] = 0;
+
+    tok.type = token::type::identifier;
+
+    return true;
+  }
+
+  // Number?
+  if ((IS_DIGIT(c)) ||
+      ((c == '-') &&
+       (_M_offset + 1 < _M_length) &&
+       (IS_DIGIT(_M_data[_M_offset + 1])))) {
+    const bool negative = (c == '-');
+    if (negative) {
+      _M_offset++;
+    }
+
+    uint64_t n = 0;
+
+    do {
+      // If the number is too big...
+      if (n > (static_cast<uint64_t>(INT64_MAX) - 9) / 10) {
+        return false;
+      }
+
+      n = (n * 10) + (_M_data[_M_offset++] - '0');
+    } while ((_M_offset < _M_length) && (IS_DIGIT(_M_data[_M_offset])));
+
+    tok.number = negative ? -static_cast<int64_t>(n) : static_cast<int64_t>(n);
+
+    tok.type = token::type::number;
+
+    return true;
+  }
+
+  // Assignment?
+  if ((c == ':') &&
+      (_M_offset + 2 < _M_length) &&
+      (_M_data[_M_offset + 1] == ':') &&
+      (_M_data[_M_offset + 2] == '=')) {
+    _M_offset += 3;
+
+    tok.type = token::type::assignment;
+
+    return true;
+  }
+
+  // Range or ellipsis?
+  if ((c == '.') &&
+      (_M_offset + 1 < _M_length) &&
+      (_M_data[_M_offset + 1] == '.')) {
+    if ((_M_offset + 2 < _M_length) && (_M_data[_M_offset + 2] == '.')) {
+      _M_offset += 3;
+
+      tok.type = token::type::ellipsis;
+    } else {
+      _M_offset += 2;
+
+      tok.type = token::type::range;
+    }
+
+    return true;
+  }
+
+  switch (c) {
+    case '{':
+    case '}':
+    case '[':
+    case ']':
+    case '(':
+    case ')':
+    case ',':
+    case ';':
+    case '|':
+    case '.':
+    case '<':
+    case '@':
+    case '!':
+    case '^':
+    case ':':
+    case '-':
+      _M_offset++;
+
+      tok.symbol = c;
+      tok.type = token::type::symbol;
+
+      return true;
+    default:
+      return false;
+  }
+}
+
+void asn1::compiler::lexer::skip()
+{
+  while (_M_offset < _M_length) {
+    switch (_M_data[_M_offset]) {
+      case '\n':
+        _M_line++;
+
+        // Fall through.
+      case ' ':
+      case '\t':
+      case '\r':
+      case '\f':
+      case '\v':
+        _M_offset++;
+        break;
+      case '-':
+        // If not the beginning of a comment...
+        if ((_M_offset + 1 == _M_length) || (_M_data[_M_offset + 1] != '-')) {
+          return;
+        }
+
+        // The comment ends at the next "--" or at the end of the line.
+        _M_offset += 2;
+
+        while (_M_offset < _M_length) {
+          if (_M_data[_M_offset] == '\n') {
+            break;
+          } else if ((_M_data[_M_offset] == '-') &&
+                     (_M_offset + 1 < _M_length) &&
+                     (_M_data[_M_offset + 1] == '-')) {
+            _M_offset += 2;
+            break;
+          }
+
+          _M_offset++;
+        }
+
+        break;
+      case '/':
+        // If not the beginning of a comment...
+        if ((_M_offset + 1 == _M_length) || (_M_data[_M_offset + 1] != '*')) {
+          return;
+        }
+
+        {
+          // Comments of this kind can be nested.
+          size_t depth = 1;
+
+          _M_offset += 2;
+
+          while ((_M_offset < _M_length) && (depth > 0)) {
+            if (_M_data[_M_offset] == '\n') {
+              _M_line++;
+              _M_offset++;
+            } else if ((_M_data[_M_offset] == '*') &&
+                       (_M_offset + 1 < _M_length) &&
+                       (_M_data[_M_offset + 1] == '/')) {
+              depth--;
+              _M_offset += 2;
+            } else if ((_M_data[_M_offset] == '/') &&
+                       (_M_offset + 1 < _M_length) &&
+                       (_M_data[_M_offset + 1] == '*')) {
+              depth++;
+              _M_offset += 2;
+            } else {
+              _M_offset++;
+            }
+          }
+        }
+
+        break;
+      default:
+        return;
+    }
+  }
+}
@@ -0,0 +1,86 @@
+#ifndef ASN1_COMPILER_LEXER_H
+#define ASN1_COMPILER_LEXER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace asn1 {
+  namespace compiler {
+    // Lexer of ASN.1 modules.
+    class lexer {
+      public:
+        // Maximum length of an identifier.
+        static constexpr const size_t max_identifier = 127;
+
+        // Token.
+        struct token {
+          enum class type {
+            end,
+            identifier,
+            number,
+            assignment,    // ::=
+            ellipsis,      // ...
+            range,         // ..
+            symbol
+          };
+
+          enum type type;
+
+          // Text of the identifier.
+          char text[max_identifier + 1];
+
+          // Number.
+          int64_t number;
+
+          // Symbol.
+          char symbol;
+
+          // Line.
+          unsigned line;
+        };
+
+        // Constructor.
+        lexer(const char* data, size_t length);
+
+        // Destructor.
+        ~lexer() = default;
+
+        // Get next token (returns false on invalid input).
+        bool next(token& tok);
+
+        // Get current line.
+        unsigned line() const;
+
+      private:
+        // Data.
+        const char* _M_data;
+        size_t _M_length;
+
+        // Offset.
+        size_t _M_offset = 0;
+
+        // Current line.
+        unsigned _M_line = 1;
+
+        // Skip white space and comments.
+        void skip();
+
+        // Disable copy constructor and assignment operator.
+        lexer(const lexer&) = delete;
+        lexer& operator=(const lexer&) = delete;
+    };
+
+    inline lexer::lexer(const char* data, size_t length)
+      : _M_data(data),
+        _M_length(length)
+    {
+    }
+
+    inline unsigned lexer::line() const
+    {
+      return _M_line;
+    }
+  }
+}
+
+#endif // ASN1_COMPILER_LEXER_H
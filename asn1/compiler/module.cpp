@@ -0,0 +1,320 @@
+#include <stdio.h>
+#include <string.h>
+#include "asn1/compiler/module.h"
+
+asn1::compiler::module::~module()
+{
+  for (size_t i = 0; i < _M_types.size(); i++) {
+    delete _M_types[i];
+  }
+}
+
+void asn1::compiler::module::name(const char* n)
+{
+  snprintf(_M_name, sizeof(_M_name), "%s", n);
+}
+
+asn1::compiler::type* asn1::compiler::module::create(enum type::kind k,
+                                                     uint32_t universal)
+{
+  // Create type.
+  type* const t = new (std::nothrow) type(k, universal);
+
+  // If the type could be created...
+  if (t) {
+    type** const slot = _M_types.add();
+
+    // If the type could be added...
+    if (slot) {
+      *slot = t;
+      return t;
+    }
+
+    delete t;
+  }
+
+  return nullptr;
+}
+
+asn1::compiler::assignment* asn1::compiler::module::add(const char* name,
+                                                        type* t,
+                                                        unsigned line)
+{
+  assignment* const a = _M_assignments.add();
+
+  // If the assignment could be added...
+  if (a) {
+    snprintf(a->name, sizeof(a->name), "%s", name);
+    a->type = t;
+    a->line = line;
+  }
+
+  return a;
+}
+
+const asn1::compiler::assignment*
+asn1::compiler::module::find(const char* name) const
+{
+  for (size_t i = 0; i < _M_assignments.size(); i++) {
+    if (strcmp(_M_assignments[i].name, name) == 0) {
+      return &_M_assignments[i];
+    }
+  }
+
+  return nullptr;
+}
+
+bool asn1::compiler::module::resolve(string::buffer& error)
+{
+  // For each type assignment...
+  for (size_t i = 0; i < _M_assignments.size(); i++) {
+    // If the type has been already defined...
+    for (size_t j = 0; j < i; j++) {
+      if (strcmp(_M_assignments[i].name, _M_assignments[j].name) == 0) {
+        error.format("line %u: type '%s' already defined.",
+                     _M_assignments[i].line,
+                     _M_assignments[i].name);
+
+        return false;
+      }
+    }
+  }
+
+  // Resolve references.
+  for (size_t i = 0; i < _M_types.size(); i++) {
+    type* const t = _M_types[i];
+
+    if (t->kind == type::kind::reference) {
+      if ((t->target = find(t->reference)) == nullptr) {
+        error.format("line %u: undefined type '%s'.", t->line, t->reference);
+        return false;
+      }
+    }
+  }
+
+  // Check that there are no circular references (e.g. `A ::= B`,
+  // `B ::= A`): a chain of references cannot be longer than the number of
+  // type assignments.
+  for (size_t i = 0; i < _M_assignments.size(); i++) {
+    const type* t = _M_assignments[i].type;
+
+    for (size_t n = 0; ; n++) {
+      if ((t->kind == type::kind::tagged) ||
+          (t->kind == type::kind::reference)) {
+        if (n < _M_types.size()) {
+          t = (t->kind == type::kind::tagged) ? t->inner : t->target->type;
+        } else {
+          error.format("line %u: circular definition of type '%s'.",
+                       _M_assignments[i].line,
+                       _M_assignments[i].name);
+
+          return false;
+        }
+      } else {
+        break;
+      }
+    }
+  }
+
+  // If automatic tagging has been selected...
+  if (_M_tagging == tagging::automatic_tagging) {
+    // Apply automatic tagging (new types are added to `_M_types`, but none of
+    // them is a SEQUENCE, SET or CHOICE).
+    const size_t ntypes = _M_types.size();
+
+    for (size_t i = 0; i < ntypes; i++) {
+      if (!automatic(_M_types[i])) {
+        error.format("out of memory.");
+        return false;
+      }
+    }
+  }
+
+  // Apply the tagging rules.
+  for (size_t i = 0; i < _M_types.size(); i++) {
+    type* const t = _M_types[i];
+
+    if (t->kind == type::kind::tagged) {
+      // If the tagged type doesn't specify the tagging...
+      if (t->tagging == tagging::none) {
+        t->tagging = (_M_tagging == tagging::explicit_tagging) ?
+                       tagging::explicit_tagging :
+                       tagging::implicit_tagging;
+      }
+
+      // A CHOICE has no tag of its own: it is always explicitly tagged.
+      if ((t->tagging == tagging::implicit_tagging) &&
+          (underlying(t->inner)->kind == type::kind::choice)) {
+        t->tagging = tagging::explicit_tagging;
+      }
+    }
+  }
+
+  // Check types.
+  for (size_t i = 0; i < _M_types.size(); i++) {
+    if (!check(_M_types[i], error)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+const asn1::compiler::type*
+asn1::compiler::module::underlying(const type* t)
+{
+  while (t->kind == type::kind::reference) {
+    t = t->target->type;
+  }
+
+  return t;
+}
+
+const asn1::compiler::type* asn1::compiler::module::base(const type* t)
+{
+  do {
+    if (t->kind == type::kind::reference) {
+      t = t->target->type;
+    } else if (t->kind == type::kind::tagged) {
+      t = t->inner;
+    } else {
+      return t;
+    }
+  } while (true);
+}
+
+bool asn1::compiler::module::check(type* t, string::buffer& error) const
+{
+  switch (t->kind) {
+    case type::kind::choice:
+      if (t->components.empty()) {
+        error.format("line %u: CHOICE without alternatives.", t->line);
+        return false;
+      }
+
+      // Fall through.
+    case type::kind::sequence:
+    case type::kind::set:
+      // For each component...
+      for (size_t i = 0; i < t->components.size(); i++) {
+        component& c = t->components[i];
+
+        // If there is already a component with the same name...
+        for (size_t j = 0; j < i; j++) {
+          if (strcmp(c.name, t->components[j].name) == 0) {
+            error.format("line %u: duplicate component '%s'.", c.line, c.name);
+            return false;
+          }
+        }
+
+        // If the component has a default value...
+        if (c.has_default) {
+          const type* const b = base(c.type);
+
+          switch (b->kind) {
+            case type::kind::integer:
+              if (c.default_name[0] == 0) {
+                continue;
+              }
+
+              break;
+            case type::kind::boolean:
+              if (strcmp(c.default_name, "TRUE") == 0) {
+                c.default_value = 1;
+                continue;
+              } else if (strcmp(c.default_name, "FALSE") == 0) {
+                c.default_value = 0;
+                continue;
+              }
+
+              break;
+            case type::kind::enumerated:
+              {
+                size_t j;
+                for (j = 0; j < b->enumerators.size(); j++) {
+                  if (strcmp(c.default_name, b->enumerators[j].name) == 0) {
+                    c.default_value = b->enumerators[j].value;
+                    break;
+                  }
+                }
+
+                if (j < b->enumerators.size()) {
+                  continue;
+                }
+              }
+
+              break;
+            default:
+              ;
+          }
+
+          error.format("line %u: unsupported default value for '%s'.",
+                       c.line,
+                       c.name);
+
+          return false;
+        }
+      }
+
+      return true;
+    case type::kind::enumerated:
+      if (t->enumerators.empty()) {
+        error.format("line %u: ENUMERATED without enumerators.", t->line);
+        return false;
+      }
+
+      // For each enumerator...
+      for (size_t i = 0; i < t->enumerators.size(); i++) {
+        const enumerator& e = t->enumerators[i];
+
+        for (size_t j = 0; j < i; j++) {
+          if ((strcmp(e.name, t->enumerators[j].name) == 0) ||
+              (e.value == t->enumerators[j].value)) {
+            error.format("line %u: duplicate enumerator '%s'.",
+                         t->line,
+                         e.name);
+
+            return false;
+          }
+        }
+      }
+
+      return true;
+    default:
+      return true;
+  }
+}
+
+bool asn1::compiler::module::automatic(type* t)
+{
+  if ((t->kind == type::kind::sequence) ||
+      (t->kind == type::kind::set) ||
+      (t->kind == type::kind::choice)) {
+    // Automatic tagging is only applied if none of the components is tagged.
+    for (size_t i = 0; i < t->components.size(); i++) {
+      if (t->components[i].type->kind == type::kind::tagged) {
+        return true;
+      }
+    }
+
+    // Tag the components with [0], [1], ...
+    for (size_t i = 0; i < t->components.size(); i++) {
+      component& c = t->components[i];
+
+      type* const tagged = create(type::kind::tagged);
+      if (tagged) {
+        tagged->tag_class = ber::tag_class::ContextSpecific;
+        tagged->tag_number = static_cast<uint32_t>(i);
+        tagged->tagging = tagging::implicit_tagging;
+        tagged->inner = c.type;
+        tagged->line = c.line;
+
+        c.type = tagged;
+      } else {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,249 @@
+#ifndef ASN1_COMPILER_MODULE_H
+#define ASN1_COMPILER_MODULE_H
+
+#include "asn1/compiler/lexer.h"
+#include "asn1/ber/schema/runtime.h"
+#include "string/buffer.h"
+
+namespace asn1 {
+  namespace compiler {
+    // Maximum length of a name.
+    static constexpr const size_t max_name = 255;
+
+    struct type;
+    struct assignment;
+
+    // Tagging.
+    enum class tagging {
+      none,
+      explicit_tagging,
+      implicit_tagging,
+      automatic_tagging
+    };
+
+    // Component of a SEQUENCE or SET, or alternative of a CHOICE.
+    struct component {
+      // Name.
+      char name[lexer::max_identifier + 1];
+
+      // Type.
+      struct type* type;
+
+      // Optional?
+      bool optional;
+
+      // Default value (INTEGER, BOOLEAN or ENUMERATED).
+      bool has_default;
+      int64_t default_value;
+      char default_name[lexer::max_identifier + 1];
+
+      // Line.
+      unsigned line;
+    };
+
+    // Enumerator of an ENUMERATED.
+    struct enumerator {
+      // Name.
+      char name[lexer::max_identifier + 1];
+
+      // Value.
+      int64_t value;
+    };
+
+    // Type.
+    struct type {
+      enum class kind {
+        boolean,
+        integer,
+        enumerated,
+        null,
+        octets,
+        oid,
+        utc_time,
+        generalized_time,
+        sequence,
+        set,
+        choice,
+        sequence_of,
+        set_of,
+        tagged,
+        reference
+      };
+
+      enum kind kind;
+
+      // Universal tag number (built-in types).
+      uint32_t universal = 0;
+
+      // Tag (tagged types).
+      ber::tag_class tag_class = ber::tag_class::ContextSpecific;
+      uint32_t tag_number = 0;
+      enum tagging tagging = tagging::none;
+
+      // Tagged type or type of the elements (SEQUENCE OF and SET OF).
+      struct type* inner = nullptr;
+
+      // Name of the referenced type (references).
+      char reference[lexer::max_identifier + 1];
+
+      // Referenced assignment (resolved references).
+      const struct assignment* target = nullptr;
+
+      // Components (SEQUENCE, SET and CHOICE).
+      ber::schema::array<component> components;
+
+      // Enumerators (ENUMERATED).
+      ber::schema::array<enumerator> enumerators;
+
+      // Extensible?
+      bool extensible = false;
+
+      // Name of the generated C++ type (SEQUENCE, SET, CHOICE and
+      // ENUMERATED).
+      char cname[max_name + 1];
+
+      // Line.
+      unsigned line = 0;
+
+      // Constructor.
+      type(enum kind k, uint32_t u = 0);
+    };
+
+    // Type assignment.
+    struct assignment {
+      // Name.
+      char name[lexer::max_identifier + 1];
+
+      // Type.
+      struct type* type;
+
+      // Line.
+      unsigned line;
+    };
+
+    // ASN.1 module.
+    class module {
+      public:
+        // Constructor.
+        module() = default;
+
+        // Destructor.
+        ~module();
+
+        // Get name.
+        const char* name() const;
+
+        // Set name.
+        void name(const char* n);
+
+        // Get default tagging.
+        enum tagging tagging() const;
+
+        // Set default tagging.
+        void tagging(enum tagging t);
+
+        // Is the module extensible by default?
+        bool extensible() const;
+
+        // Set whether the module is extensible by default.
+        void extensible(bool e);
+
+        // Create type.
+        type* create(enum type::kind k, uint32_t universal = 0);
+
+        // Add type assignment.
+        assignment* add(const char* name, type* t, unsigned line);
+
+        // Get number of type assignments.
+        size_t size() const;
+
+        // Get type assignment.
+        const assignment& get(size_t idx) const;
+
+        // Find type assignment by name.
+        const assignment* find(const char* name) const;
+
+        // Resolve references, apply the tagging rules and check the module
+        // (`error` receives the error message on failure).
+        bool resolve(string::buffer& error);
+
+        // Get the type referenced by a type (follows the references).
+        static const type* underlying(const type* t);
+
+        // Get the built-in type of a type (follows the references and the
+        // tagged types).
+        static const type* base(const type* t);
+
+      private:
+        // Name.
+        char _M_name[lexer::max_identifier + 1] = {0};
+
+        // Default tagging.
+        enum tagging _M_tagging = tagging::explicit_tagging;
+
+        // Extensibility implied?
+        bool _M_extensible = false;
+
+        // Types.
+        ber::schema::array<type*> _M_types;
+
+        // Type assignments.
+        ber::schema::array<assignment> _M_assignments;
+
+        // Check type.
+        bool check(type* t, string::buffer& error) const;
+
+        // Apply automatic tagging.
+        bool automatic(type* t);
+
+        // Disable copy constructor and assignment operator.
+        module(const module&) = delete;
+        module& operator=(const module&) = delete;
+    };
+
+    inline type::type(enum kind k, uint32_t u)
+      : kind(k),
+        universal(u)
+    {
+      reference[0] = 0;
+      cname[0] = 0;
+    }
+
+    inline const char* module::name() const
+    {
+      return _M_name;
+    }
+
+    inline enum tagging module::tagging() const
+    {
+      return _M_tagging;
+    }
+
+    inline void module::tagging(enum tagging t)
+    {
+      _M_tagging = t;
+    }
+
+    inline bool module::extensible() const
+    {
+      return _M_extensible;
+    }
+
+    inline void module::extensible(bool e)
+    {
+      _M_extensible = e;
+    }
+
+    inline size_t module::size() const
+    {
+      return _M_assignments.size();
+    }
+
+    inline const assignment& module::get(size_t idx) const
+    {
+      return _M_assignments[idx];
+    }
+  }
+}
+
+#endif // ASN1_COMPILER_MODULE_H
@@ -0,0 +1,766 @@
+#include <stdio.h>
+#include <string.h>
+#include "asn1/compiler/parser.h"
+
+#define IS_UPPER(x) (((x) >= 'A') && ((x) <= 'Z'))
+
+// Built-in types which are decoded as octets.
+struct string_type {
+  const char* name;
+  uint32_t universal;
+};
+
+static constexpr const string_type string_types[] = {
+  {"UTF8String",      12},
+  {"NumericString",   18},
+  {"PrintableString", 19},
+  {"TeletexString",   20},
+  {"T61String",       20},
+  {"VideotexString",  21},
+  {"IA5String",       22},
+  {"GraphicString",   25},
+  {"VisibleString",   26},
+  {"ISO646String",    26},
+  {"GeneralString",   27},
+  {"UniversalString", 28},
+  {"BMPString",       30}
+};
+
+bool asn1::compiler::parser::parse(module& m, string::buffer& error)
+{
+  _M_module = &m;
+  _M_error = &error;
+
+  // Read the first two tokens.
+  if ((advance()) && (advance())) {
+    // Parse module header.
+    if (parse_header()) {
+      // Parse assignments.
+      while (!is_identifier("END")) {
+        if (!parse_assignment()) {
+          return false;
+        }
+      }
+
+      if (advance()) {
+        if (_M_token.type == lexer::token::type::end) {
+          // Resolve references and apply the tagging rules.
+          return m.resolve(error);
+        }
+
+        return fail("unexpected data after END.");
+      }
+    }
+  }
+
+  return false;
+}
+
+bool asn1::compiler::parser::advance()
+{
+  _M_token = _M_next;
+
+  if (_M_lexer.next(_M_next)) {
+    return true;
+  }
+
+  _M_error->format("line %u: invalid token.", _M_lexer.line());
+
+  return false;
+}
+
+bool asn1::compiler::parser::expect_identifier(const char* s)
+{
+  if (is_identifier(s)) {
+    return advance();
+  }
+
+  _M_error->format("line %u: expected '%s'.", _M_token.line, s);
+
+  return false;
+}
+
+bool asn1::compiler::parser::expect_symbol(char c)
+{
+  if (is_symbol(c)) {
+    return advance();
+  }
+
+  _M_error->format("line %u: expected '%c'.", _M_token.line, c);
+
+  return false;
+}
+
+bool asn1::compiler::parser::expect_assignment()
+{
+  if (_M_token.type == lexer::token::type::assignment) {
+    return advance();
+  }
+
+  return fail("expected '::='.");
+}
+
+bool asn1::compiler::parser::parse_header()
+{
+  // Module reference.
+  if ((_M_token.type == lexer::token::type::identifier) &&
+      (IS_UPPER(_M_token.text[0]))) {
+    _M_module->name(_M_token.text);
+
+    if (!advance()) {
+      return false;
+    }
+
+    // Skip object identifier (if present).
+    if ((is_symbol('{')) && (!skip_block('{', '}'))) {
+      return false;
+    }
+
+    if (!expect_identifier("DEFINITIONS")) {
+      return false;
+    }
+
+    // Tag default.
+    if (_M_next.type == lexer::token::type::identifier) {
+      if (strcmp(_M_next.text, "TAGS") == 0) {
+        if (is_identifier("EXPLICIT")) {
+          _M_module->tagging(tagging::explicit_tagging);
+        } else if (is_identifier("IMPLICIT")) {
+          _M_module->tagging(tagging::implicit_tagging);
+        } else if (is_identifier("AUTOMATIC")) {
+          _M_module->tagging(tagging::automatic_tagging);
+        } else {
+          return fail("invalid tag default.");
+        }
+
+        if ((!advance()) || (!advance())) {
+          return false;
+        }
+      }
+    }
+
+    // Extension default.
+    if (is_identifier("EXTENSIBILITY")) {
+      if ((!advance()) || (!expect_identifier("IMPLIED"))) {
+        return false;
+      }
+
+      _M_module->extensible(true);
+    }
+
+    if ((!expect_assignment()) || (!expect_identifier("BEGIN"))) {
+      return false;
+    }
+
+    // Skip exports and imports (the imported types cannot be resolved).
+    for (unsigned i = 0; i < 2; i++) {
+      if ((is_identifier("EXPORTS")) || (is_identifier("IMPORTS"))) {
+        do {
+          if (!advance()) {
+            return false;
+          }
+
+          if (_M_token.type == lexer::token::type::end) {
+            return fail("unexpected end of file.");
+          }
+        } while (!is_symbol(';'));
+
+        if (!advance()) {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  return fail("expected module reference.");
+}
+
+bool asn1::compiler::parser::parse_assignment()
+{
+  if (_M_token.type == lexer::token::type::identifier) {
+    const lexer::token name = _M_token;
+
+    if (!advance()) {
+      return false;
+    }
+
+    // Type assignment?
+    if (IS_UPPER(name.text[0])) {
+      if (is_symbol('{')) {
+        return fail("parameterized types are not supported.");
+      }
+
+      if (expect_assignment()) {
+        type* const t = parse_type();
+        if (t) {
+          if (_M_module->add(name.text, t, name.line)) {
+            return true;
+          }
+
+          return fail("out of memory.");
+        }
+      }
+
+      return false;
+    } else {
+      // Value assignment (skipped).
+      return ((parse_type()) && (expect_assignment()) && (skip_value()));
+    }
+  } else if (_M_token.type == lexer::token::type::end) {
+    return fail("unexpected end of file (missing END).");
+  }
+
+  return fail("expected assignment.");
+}
+
+asn1::compiler::type* asn1::compiler::parser::parse_type()
+{
+  const unsigned line = _M_token.line;
+
+  type* t = nullptr;
+
+  if (is_symbol('[')) {
+    return parse_tagged_type();
+  } else if (_M_token.type == lexer::token::type::identifier) {
+    if (is_identifier("BOOLEAN")) {
+      t = _M_module->create(type::kind::boolean, 1);
+    } else if (is_identifier("INTEGER")) {
+      t = _M_module->create(type::kind::integer, 2);
+
+      if (!advance()) {
+        return nullptr;
+      }
+
+      // Skip named numbers.
+      if (is_symbol('{')) {
+        if (!skip_block('{', '}')) {
+          return nullptr;
+        }
+      }
+
+      if (t) {
+        t->line = line;
+
+        return skip_constraints() ? t : nullptr;
+      }
+
+      return fail_type("out of memory.");
+    } else if (is_identifier("ENUMERATED")) {
+      if ((t = _M_module->create(type::kind::enumerated, 10)) != nullptr) {
+        t->line = line;
+
+        if ((advance()) && (parse_enumerators(t)) && (skip_constraints())) {
+          return t;
+        }
+
+        return nullptr;
+      }
+
+      return fail_type("out of memory.");
+    } else if (is_identifier("NULL")) {
+      t = _M_module->create(type::kind::null, 5);
+    } else if (is_identifier("OCTET")) {
+      if (!advance()) {
+        return nullptr;
+      }
+
+      if (!is_identifier("STRING")) {
+        return fail_type("expected 'STRING'.");
+      }
+
+      t = _M_module->create(type::kind::octets, 4);
+    } else if (is_identifier("BIT")) {
+      if (!advance()) {
+        return nullptr;
+      }
+
+      if (!is_identifier("STRING")) {
+        return fail_type("expected 'STRING'.");
+      }
+
+      t = _M_module->create(type::kind::octets, 3);
+
+      if (!advance()) {
+        return nullptr;
+      }
+
+      // Skip named bits.
+      if (is_symbol('{')) {
+        if (!skip_block('{', '}')) {
+          return nullptr;
+        }
+      }
+
+      if (t) {
+        t->line = line;
+
+        return skip_constraints() ? t : nullptr;
+      }
+
+      return fail_type("out of memory.");
+    } else if (is_identifier("OBJECT")) {
+      if (!advance()) {
+        return nullptr;
+      }
+
+      if (!is_identifier("IDENTIFIER")) {
+        return fail_type("expected 'IDENTIFIER'.");
+      }
+
+      t = _M_module->create(type::kind::oid, 6);
+    } else if (is_identifier("UTCTime")) {
+      t = _M_module->create(type::kind::utc_time, 23);
+    } else if (is_identifier("GeneralizedTime")) {
+      t = _M_module->create(type::kind::generalized_time, 24);
+    } else if ((is_identifier("SEQUENCE")) || (is_identifier("SET"))) {
+      const bool sequence = is_identifier("SEQUENCE");
+
+      if (!advance()) {
+        return nullptr;
+      }
+
+      // SEQUENCE OF / SET OF?
+      if (!is_symbol('{')) {
+        return sequence ? parse_collection_of(type::kind::sequence_of, 16) :
+                          parse_collection_of(type::kind::set_of, 17);
+      }
+
+      t = sequence ? _M_module->create(type::kind::sequence, 16) :
+                     _M_module->create(type::kind::set, 17);
+
+      if (t) {
+        t->line = line;
+        t->extensible = _M_module->extensible();
+
+        if ((parse_components(t)) && (skip_constraints())) {
+          return t;
+        }
+
+        return nullptr;
+      }
+
+      return fail_type("out of memory.");
+    } else if (is_identifier("CHOICE")) {
+      if ((t = _M_module->create(type::kind::choice)) != nullptr) {
+        t->line = line;
+        t->extensible = _M_module->extensible();
+
+        if ((advance()) && (parse_components(t)) && (skip_constraints())) {
+          return t;
+        }
+
+        return nullptr;
+      }
+
+      return fail_type("out of memory.");
+    } else {
+      // Character string type?
+      for (size_t i = 0;
+           i < sizeof(string_types) / sizeof(string_types[0]);
+           i++) {
+        if (is_identifier(string_types[i].name)) {
+          if ((t = _M_module->create(type::kind::octets,
+                                     string_types[i].universal)) != nullptr) {
+            t->line = line;
+
+            return ((advance()) && (skip_constraints())) ? t : nullptr;
+          }
+
+          return fail_type("out of memory.");
+        }
+      }
+
+      // Unsupported built-in type?
+      if ((is_identifier("ANY")) ||
+          (is_identifier("REAL")) ||
+          (is_identifier("EXTERNAL")) ||
+          (is_identifier("EMBEDDED")) ||
+          (is_identifier("RELATIVE-OID")) ||
+          (is_identifier("ObjectDescriptor")) ||
+          (is_identifier("CHARACTER")) ||
+          (is_identifier("INSTANCE")) ||
+          (is_identifier("TIME")) ||
+          (is_identifier("DATE")) ||
+          (is_identifier("TIME-OF-DAY")) ||
+          (is_identifier("DATE-TIME")) ||
+          (is_identifier("DURATION"))) {
+        _M_error->format("line %u: type '%s' is not supported.",
+                         line,
+                         _M_token.text);
+
+        return nullptr;
+      }
+
+      // Type reference?
+      if (IS_UPPER(_M_token.text[0])) {
+        if (_M_next.type == lexer::token::type::symbol) {
+          if (_M_next.symbol == '.') {
+            return fail_type("external type references are not supported.");
+          } else if (_M_next.symbol == '{') {
+            return fail_type("parameterized types are not supported.");
+          }
+        }
+
+        if ((t = _M_module->create(type::kind::reference)) != nullptr) {
+          t->line = line;
+
+          snprintf(t->reference, sizeof(t->reference), "%s", _M_token.text);
+
+          return ((advance()) && (skip_constraints())) ? t : nullptr;
+        }
+
+        return fail_type("out of memory.");
+      }
+
+      return fail_type("expected type.");
+    }
+
+    if (t) {
+      t->line = line;
+
+      return ((advance()) && (skip_constraints())) ? t : nullptr;
+    }
+
+    return fail_type("out of memory.");
+  }
+
+  return fail_type("expected type.");
+}
+
+asn1::compiler::type* asn1::compiler::parser::parse_tagged_type()
+{
+  const unsigned line = _M_token.line;
+
+  // Skip '['.
+  if (!advance()) {
+    return nullptr;
+  }
+
+  // Tag class.
+  ber::tag_class tc = ber::tag_class::ContextSpecific;
+
+  if (_M_token.type == lexer::token::type::identifier) {
+    if (is_identifier("UNIVERSAL")) {
+      tc = ber::tag_class::Universal;
+    } else if (is_identifier("APPLICATION")) {
+      tc = ber::tag_class::Application;
+    } else if (is_identifier("PRIVATE")) {
+      tc = ber::tag_class::Private;
+    } else {
+      return fail_type("invalid tag class.");
+    }
+
+    if (!advance()) {
+      return nullptr;
+    }
+  }
+
+  // Tag number.
+  if ((_M_token.type != lexer::token::type::number) ||
+      (_M_token.number < 0) ||
+      (_M_token.number > UINT32_MAX)) {
+    return fail_type("invalid tag number.");
+  }
+
+  const uint32_t tn = static_cast<uint32_t>(_M_token.number);
+
+  if ((!advance()) || (!expect_symbol(']'))) {
+    return nullptr;
+  }
+
+  // Tagging.
+  enum tagging tagging = tagging::none;
+
+  if (is_identifier("IMPLICIT")) {
+    tagging = tagging::implicit_tagging;
+  } else if (is_identifier("EXPLICIT")) {
+    tagging = tagging::explicit_tagging;
+  }
+
+  if ((tagging != tagging::none) && (!advance())) {
+    return nullptr;
+  }
+
+  type* const t = _M_module->create(type::kind::tagged);
+  if (t) {
+    t->line = line;
+    t->tag_class = tc;
+    t->tag_number = tn;
+    t->tagging = tagging;
+
+    return ((t->inner = parse_type()) != nullptr) ? t : nullptr;
+  }
+
+  return fail_type("out of memory.");
+}
+
+asn1::compiler::type*
+asn1::compiler::parser::parse_collection_of(enum type::kind k,
+                                            uint32_t universal)
+{
+  const unsigned line = _M_token.line;
+
+  // Skip size constraint (if present).
+  if (is_symbol('(')) {
+    if (!skip_constraints()) {
+      return nullptr;
+    }
+  } else if (is_identifier("SIZE")) {
+    if ((!advance()) || (!skip_constraints())) {
+      return nullptr;
+    }
+  }
+
+  if (!expect_identifier("OF")) {
+    return nullptr;
+  }
+
+  // Skip the name of the elements (if present).
+  if ((_M_token.type == lexer::token::type::identifier) &&
+      (!IS_UPPER(_M_token.text[0]))) {
+    if (!advance()) {
+      return nullptr;
+    }
+  }
+
+  type* const t = _M_module->create(k, universal);
+  if (t) {
+    t->line = line;
+
+    return ((t->inner = parse_type()) != nullptr) ? t : nullptr;
+  }
+
+  return fail_type("out of memory.");
+}
+
+bool asn1::compiler::parser::parse_components(type* t)
+{
+  if (expect_symbol('{')) {
+    // Empty?
+    if (is_symbol('}')) {
+      return advance();
+    }
+
+    do {
+      // Extension marker?
+      if (_M_token.type == lexer::token::type::ellipsis) {
+        t->extensible = true;
+
+        if (!advance()) {
+          return false;
+        }
+
+        // Skip exception specification (if present).
+        if (is_symbol('!')) {
+          do {
+            if (!advance()) {
+              return false;
+            }
+          } while ((!is_symbol(',')) &&
+                   (!is_symbol('}')) &&
+                   (_M_token.type != lexer::token::type::end));
+        }
+      } else if (!parse_component(t)) {
+        return false;
+      }
+
+      if (is_symbol('}')) {
+        return advance();
+      }
+    } while (expect_symbol(','));
+  }
+
+  return false;
+}
+
+bool asn1::compiler::parser::parse_component(type* t)
+{
+  if ((is_symbol('[')) &&
+      (_M_next.type == lexer::token::type::symbol) &&
+      (_M_next.symbol == '[')) {
+    return fail("extension addition groups are not supported.");
+  }
+
+  if (is_identifier("COMPONENTS")) {
+    return fail("COMPONENTS OF is not supported.");
+  }
+
+  if ((_M_token.type == lexer::token::type::identifier) &&
+      (!IS_UPPER(_M_token.text[0]))) {
+    component* const c = t->components.add();
+    if (c) {
+      snprintf(c->name, sizeof(c->name), "%s", _M_token.text);
+      c->line = _M_token.line;
+
+      if ((advance()) && ((c->type = parse_type()) != nullptr)) {
+        // OPTIONAL and DEFAULT don't apply to the alternatives of a CHOICE.
+        if (t->kind != type::kind::choice) {
+          if (is_identifier("OPTIONAL")) {
+            c->optional = true;
+
+            return advance();
+          } else if (is_identifier("DEFAULT")) {
+            c->has_default = true;
+
+            if (!advance()) {
+              return false;
+            }
+
+            if (_M_token.type == lexer::token::type::number) {
+              c->default_value = _M_token.number;
+            } else if (_M_token.type == lexer::token::type::identifier) {
+              snprintf(c->default_name,
+                       sizeof(c->default_name),
+                       "%s",
+                       _M_token.text);
+            } else {
+              return fail("unsupported default value.");
+            }
+
+            return advance();
+          }
+        }
+
+        return true;
+      }
+
+      return false;
+    }
+
+    return fail("out of memory.");
+  }
+
+  return fail("expected component.");
+}
+
+bool asn1::compiler::parser::parse_enumerators(type* t)
+{
+  // Value of the enumerators without value (assigned afterwards).
+  static constexpr const int64_t unassigned = INT64_MIN;
+
+  t->extensible = _M_module->extensible();
+
+  if (expect_symbol('{')) {
+    do {
+      // Extension marker?
+      if (_M_token.type == lexer::token::type::ellipsis) {
+        t->extensible = true;
+
+        if (!advance()) {
+          return false;
+        }
+      } else if ((_M_token.type == lexer::token::type::identifier) &&
+                 (!IS_UPPER(_M_token.text[0]))) {
+        enumerator* const e = t->enumerators.add();
+        if (e) {
+          snprintf(e->name, sizeof(e->name), "%s", _M_token.text);
+
+          if (!advance()) {
+            return false;
+          }
+
+          // If the enumerator has a value...
+          if (is_symbol('(')) {
+            if (!advance()) {
+              return false;
+            }
+
+            if (_M_token.type != lexer::token::type::number) {
+              return fail("expected number.");
+            }
+
+            e->value = _M_token.number;
+
+            if ((!advance()) || (!expect_symbol(')'))) {
+              return false;
+            }
+          } else {
+            e->value = unassigned;
+          }
+        } else {
+          return fail("out of memory.");
+        }
+      } else {
+        return fail("expected enumerator.");
+      }
+
+      if (is_symbol('}')) {
+        // Assign the smallest unused non-negative values to the enumerators
+        // without value.
+        int64_t next = 0;
+
+        for (size_t i = 0; i < t->enumerators.size(); i++) {
+          if (t->enumerators[i].value == unassigned) {
+            size_t j = 0;
+            while (j < t->enumerators.size()) {
+              if (t->enumerators[j].value == next) {
+                next++;
+                j = 0;
+              } else {
+                j++;
+              }
+            }
+
+            t->enumerators[i].value = next++;
+          }
+        }
+
+        return advance();
+      }
+    } while (expect_symbol(','));
+  }
+
+  return false;
+}
+
+bool asn1::compiler::parser::skip_constraints()
+{
+  while (is_symbol('(')) {
+    if (!skip_block('(', ')')) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool asn1::compiler::parser::skip_block(char open, char close)
+{
+  size_t depth = 0;
+
+  do {
+    if (is_symbol(open)) {
+      depth++;
+    } else if (is_symbol(close)) {
+      depth--;
+    } else if (_M_token.type == lexer::token::type::end) {
+      return fail("unexpected end of file.");
+    }
+
+    if (!advance()) {
+      return false;
+    }
+  } while (depth > 0);
+
+  return true;
+}
+
+bool asn1::compiler::parser::skip_value()
+{
+  if (is_symbol('{')) {
+    return skip_block('{', '}');
+  } else if ((_M_token.type == lexer::token::type::number) ||
+             (_M_token.type == lexer::token::type::identifier)) {
+    return advance();
+  }
+
+  return fail("unsupported value.");
+}
+
+bool asn1::compiler::parser::fail(const char* msg)
+{
+  _M_error->format("line %u: %s", _M_token.line, msg);
+  return false;
+}
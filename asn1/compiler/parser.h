@@ -0,0 +1,130 @@
+#ifndef ASN1_COMPILER_PARSER_H
+#define ASN1_COMPILER_PARSER_H
+
+#include <string.h>
+#include "asn1/compiler/lexer.h"
+#include "asn1/compiler/module.h"
+#include "string/buffer.h"
+
+namespace asn1 {
+  namespace compiler {
+    // Parser of ASN.1 modules.
+    //
+    // Supports a subset of X.680: type assignments of BOOLEAN, INTEGER,
+    // ENUMERATED, NULL, OCTET STRING, BIT STRING, OBJECT IDENTIFIER, the
+    // character string types, UTCTime, GeneralizedTime, SEQUENCE, SET,
+    // CHOICE, SEQUENCE OF, SET OF, tagged types and type references.
+    // Constraints, named numbers and value assignments are skipped.
+    class parser {
+      public:
+        // Constructor.
+        parser(const char* data, size_t length);
+
+        // Destructor.
+        ~parser() = default;
+
+        // Parse module (`error` receives the error message on failure).
+        bool parse(module& m, string::buffer& error);
+
+      private:
+        // Lexer.
+        lexer _M_lexer;
+
+        // Current token.
+        lexer::token _M_token;
+
+        // Next token.
+        lexer::token _M_next;
+
+        // Module.
+        module* _M_module;
+
+        // Error message.
+        string::buffer* _M_error;
+
+        // Move to the next token.
+        bool advance();
+
+        // Is the current token the identifier `s`?
+        bool is_identifier(const char* s) const;
+
+        // Is the current token the symbol `c`?
+        bool is_symbol(char c) const;
+
+        // Expect identifier.
+        bool expect_identifier(const char* s);
+
+        // Expect symbol.
+        bool expect_symbol(char c);
+
+        // Expect assignment ("::=").
+        bool expect_assignment();
+
+        // Parse module header.
+        bool parse_header();
+
+        // Parse assignment.
+        bool parse_assignment();
+
+        // Parse type.
+        type* parse_type();
+
+        // Parse tagged type.
+        type* parse_tagged_type();
+
+        // Parse SEQUENCE OF or SET OF.
+        type* parse_collection_of(enum type::kind k, uint32_t universal);
+
+        // Parse components.
+        bool parse_components(type* t);
+
+        // Parse component.
+        bool parse_component(type* t);
+
+        // Parse enumerators.
+        bool parse_enumerators(type* t);
+
+        // Skip constraints.
+        bool skip_constraints();
+
+        // Skip the tokens up to the matching closing symbol.
+        bool skip_block(char open, char close);
+
+        // Skip value.
+        bool skip_value();
+
+        // Report error.
+        bool fail(const char* msg);
+        type* fail_type(const char* msg);
+
+        // Disable copy constructor and assignment operator.
+        parser(const parser&) = delete;
+        parser& operator=(const parser&) = delete;
+    };
+
+    inline parser::parser(const char* data, size_t length)
+      : _M_lexer(data, length)
+    {
+    }
+
+    inline bool parser::is_identifier(const char* s) const
+    {
+      return ((_M_token.type == lexer::token::type::identifier) &&
+              (strcmp(_M_token.text, s) == 0));
+    }
+
+    inline bool parser::is_symbol(char c) const
+    {
+      return ((_M_token.type == lexer::token::type::symbol) &&
+              (_M_token.symbol == c));
+    }
+
+    inline type* parser::fail_type(const char* msg)
+    {
+      fail(msg);
+      return nullptr;
+    }
+  }
+}
+
+#endif // ASN1_COMPILER_PARSER_H
@@ -0,0 +1,151 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "asn1/compiler/parser.h"
+#include "asn1/compiler/generator.h"
+
+static bool read_file(const char* filename, string::buffer& buf);
+static bool write_file(const char* filename, const string::buffer& buf);
+
+int main(int argc, const char* argv[])
+{
+  const char* ns = nullptr;
+  int i = 1;
+
+  // If the namespace has been specified...
+  if ((argc == 5) && (strcmp(argv[1], "-n") == 0)) {
+    ns = argv[2];
+    i = 3;
+  } else if (argc != 3) {
+    fprintf(stderr,
+            "Usage: %s [-n <namespace>] <module.asn1> <output-basename>\n",
+            argv[0]);
+
+    return EXIT_FAILURE;
+  }
+
+  const char* const input = argv[i];
+  const char* const basename = argv[i + 1];
+
+  // Compose the names of the output files.
+  string::buffer header;
+  string::buffer source;
+  if ((!header.format("%s.h", basename)) ||
+      (!source.format("%s.cpp", basename)) ||
+      (!header.push_back(0)) ||
+      (!source.push_back(0))) {
+    fprintf(stderr, "Out of memory.\n");
+    return EXIT_FAILURE;
+  }
+
+  const char* const hname = static_cast<const char*>(header.data());
+  const char* const cppname = static_cast<const char*>(source.data());
+
+  // Read module.
+  string::buffer data;
+  if (!read_file(input, data)) {
+    fprintf(stderr, "Error reading file '%s'.\n", input);
+    return EXIT_FAILURE;
+  }
+
+  // Parse module.
+  asn1::compiler::module module;
+  asn1::compiler::parser parser(static_cast<const char*>(data.data()),
+                                data.length());
+
+  string::buffer error;
+  if ((!parser.parse(module, error)) || (!module.resolve(error))) {
+    fprintf(stderr,
+            "%s: %.*s\n",
+            input,
+            static_cast<int>(error.length()),
+            static_cast<const char*>(error.data()));
+
+    return EXIT_FAILURE;
+  }
+
+  // The default namespace is the name of the module.
+  char name[asn1::compiler::max_name + 1];
+  if (!ns) {
+    size_t len = 0;
+    for (const char* p = module.name();
+         (*p) && (len + 1 < sizeof(name));
+         p++, len++) {
+      name[len] = (*p != '-') ? *p : '_';
+    }
+
+    name[len] = 0;
+
+    ns = name;
+  }
+
+  // Generate code.
+  asn1::compiler::generator generator(module, ns, hname);
+
+  string::buffer hcode;
+  string::buffer cppcode;
+  if (!generator.generate(hcode, cppcode, error)) {
+    fprintf(stderr,
+            "%s: %.*s\n",
+            input,
+            static_cast<int>(error.length()),
+            static_cast<const char*>(error.data()));
+
+    return EXIT_FAILURE;
+  }
+
+  // Write header and source.
+  if (!write_file(hname, hcode)) {
+    fprintf(stderr, "Error writing file '%s'.\n", hname);
+    return EXIT_FAILURE;
+  }
+
+  if (!write_file(cppname, cppcode)) {
+    fprintf(stderr, "Error writing file '%s'.\n", cppname);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+bool read_file(const char* filename, string::buffer& buf)
+{
+  // Open file for reading.
+  FILE* const file = fopen(filename, "rb");
+
+  // If the file could be opened...
+  if (file) {
+    char chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+      if (!buf.append(chunk, n)) {
+        fclose(file);
+        return false;
+      }
+    }
+
+    const bool ret = (ferror(file) == 0);
+
+    fclose(file);
+
+    return ret;
+  }
+
+  return false;
+}
+
+bool write_file(const char* filename, const string::buffer& buf)
+{
+  // Open file for writing.
+  FILE* const file = fopen(filename, "wb");
+
+  // If the file could be opened...
+  if (file) {
+    const bool ret = (fwrite(buf.data(), 1, buf.length(), file) ==
+                      buf.length());
+
+    return ((fclose(file) == 0) && (ret));
+  }
+
+  return false;
+}
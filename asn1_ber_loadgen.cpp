@@ -0,0 +1,953 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <atomic>
+#include <new>
+#include "asn1/ber/encoder.h"
+#include "asn1/ber/decoder.h"
+#include "asn1/ber/framer.h"
+#include "asn1/ber/record_batch.h"
+#include "net/socket/address.h"
+#include "util/clock.h"
+#include "util/counter.h"
+
+// Default mix of payload sizes.
+static constexpr const char* default_mix = "64:60,512:30,4096:10";
+
+// Maximum number of entries of the mix.
+static constexpr const size_t max_mix = 16;
+
+// Maximum number of capture files.
+static constexpr const size_t max_files = 16;
+
+// Maximum number of connections.
+static constexpr const size_t max_connections = 1024 * 1024;
+
+// Maximum number of threads.
+static constexpr const size_t max_threads = 256;
+
+// Maximum payload size.
+static constexpr const size_t max_payload = 1024 * 1024;
+
+// Number of templates per entry of the mix.
+static constexpr const size_t number_variants = 16;
+
+// Minimum size of the stream of generated records.
+static constexpr const size_t stream_size = 4 * 1024 * 1024;
+
+// Interval between rate ticks (microseconds).
+static constexpr const uint64_t tick = 1000;
+
+// Maximum number of records written at once to a connection when the rate
+// is limited.
+static constexpr const size_t max_records_per_write = 64;
+
+// Maximum number of events returned by epoll_wait().
+static constexpr const size_t max_events = 256;
+
+// Entry of the mix of payload sizes.
+struct mix_entry {
+  size_t size;
+  unsigned weight;
+};
+
+// Connection.
+struct connection {
+  int fd;
+
+  // Index of the next record to be sent.
+  size_t next;
+
+  // Data which couldn't be written yet (the rest of the last write).
+  size_t pending_offset;
+  size_t pending_length;
+
+  // Number of records of the last write (counted when completely written).
+  size_t pending_records;
+};
+
+// Sender thread.
+struct sender {
+  // Stream of records (shared by all the connections, sent in a loop).
+  const asn1::ber::record_batch* stream;
+
+  connection* connections;
+  size_t nconnections;
+
+  // Number of open connections.
+  size_t nopen;
+
+  // Target rate (records per second, 0: as fast as possible).
+  uint64_t rate;
+
+  // Counters.
+  util::counter records;
+  util::counter bytes;
+  util::counter errors;
+
+  // Epoll file descriptor.
+  int epollfd;
+
+  // Thread id.
+  pthread_t thread;
+};
+
+// Stop?
+static std::atomic<bool> stop_senders;
+
+static void usage(const char* program);
+
+static bool parse_number(const char* s,
+                         size_t len,
+                         uint64_t min,
+                         uint64_t max,
+                         uint64_t& n);
+
+static bool parse_mix(const char* s, mix_entry* mix, size_t& nmix);
+
+static bool generate(const mix_entry* mix,
+                     size_t nmix,
+                     unsigned indefinite,
+                     asn1::ber::record_batch& stream);
+
+static bool load(const char* const* filenames,
+                 size_t nfiles,
+                 asn1::ber::record_batch& stream);
+
+static bool connect(sender& sender,
+                    const net::socket::address& addr,
+                    const asn1::ber::record_batch& stream,
+                    size_t first);
+
+static void* run(void* arg);
+
+int main(int argc, const char* argv[])
+{
+  const char* address = nullptr;
+  uint64_t nconnections = 1;
+  uint64_t nthreads = 1;
+  uint64_t rate = 0;
+  uint64_t duration = 0;
+  uint64_t indefinite = 0;
+  const char* mixstr = default_mix;
+  const char* filenames[max_files];
+  size_t nfiles = 0;
+
+  // Parse arguments.
+  for (int i = 1; i < argc; i += 2) {
+    // If not the last argument...
+    if ((argv[i][0] == '-') &&
+        (argv[i][1] != 0) &&
+        (argv[i][2] == 0) &&
+        (i + 1 < argc)) {
+      const char* const arg = argv[i + 1];
+      const size_t len = strlen(arg);
+
+      bool valid = true;
+      switch (argv[i][1]) {
+        case 'a':
+          address = arg;
+          break;
+        case 'c':
+          valid = parse_number(arg, len, 1, max_connections, nconnections);
+          break;
+        case 't':
+          valid = parse_number(arg, len, 1, max_threads, nthreads);
+          break;
+        case 'r':
+          valid = parse_number(arg, len, 0, ULLONG_MAX, rate);
+          break;
+        case 'd':
+          valid = parse_number(arg, len, 0, ULLONG_MAX, duration);
+          break;
+        case 'i':
+          valid = parse_number(arg, len, 0, 100, indefinite);
+          break;
+        case 'm':
+          mixstr = arg;
+          break;
+        case 'f':
+          if (nfiles < max_files) {
+            filenames[nfiles++] = arg;
+          } else {
+            valid = false;
+          }
+
+          break;
+        default:
+          valid = false;
+      }
+
+      if (!valid) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+    } else {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  net::socket::address addr;
+  if ((!address) || (!addr.build(address))) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  // Prepare the stream of records.
+  asn1::ber::record_batch stream;
+  if (nfiles > 0) {
+    if (!load(filenames, nfiles, stream)) {
+      return EXIT_FAILURE;
+    }
+  } else {
+    mix_entry mix[max_mix];
+    size_t nmix;
+    if (!parse_mix(mixstr, mix, nmix)) {
+      fprintf(stderr, "Invalid mix of payload sizes '%s'.\n", mixstr);
+      return EXIT_FAILURE;
+    }
+
+    if (!generate(mix, nmix, static_cast<unsigned>(indefinite), stream)) {
+      fprintf(stderr, "Error generating records.\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (nthreads > nconnections) {
+    nthreads = nconnections;
+  }
+
+  // Block signals SIGINT, SIGTERM and SIGPIPE (inherited by the threads).
+  sigset_t set;
+  sigemptyset(&set);
+  sigaddset(&set, SIGINT);
+  sigaddset(&set, SIGTERM);
+  sigaddset(&set, SIGPIPE);
+  if (pthread_sigmask(SIG_BLOCK, &set, nullptr) != 0) {
+    fprintf(stderr, "Error blocking signals.\n");
+    return EXIT_FAILURE;
+  }
+
+  sender* const senders = new (std::nothrow) sender[nthreads];
+  if (!senders) {
+    fprintf(stderr, "Error allocating memory.\n");
+    return EXIT_FAILURE;
+  }
+
+  // Open connections.
+  size_t nsenders;
+  size_t first = 0;
+  for (nsenders = 0; nsenders < nthreads; nsenders++) {
+    sender& s = senders[nsenders];
+
+    s.stream = &stream;
+    s.nconnections = (nconnections / nthreads) +
+                     (nsenders < nconnections % nthreads);
+
+    s.rate = rate / nthreads;
+    if ((rate > 0) && (s.rate == 0)) {
+      s.rate = 1;
+    }
+
+    if (!connect(s, addr, stream, first)) {
+      fprintf(stderr,
+              "Error connecting to '%s' (%s).\n",
+              address,
+              strerror(errno));
+
+      break;
+    }
+
+    first += s.nconnections;
+  }
+
+  int ret = EXIT_FAILURE;
+
+  // If all the connections have been established...
+  if (nsenders == nthreads) {
+    printf("%llu connection(s), %zu record(s) (%zu bytes) per loop.\n",
+           static_cast<unsigned long long>(nconnections),
+           stream.count(),
+           stream.length());
+
+    stop_senders.store(false);
+
+    // Start threads.
+    size_t nstarted;
+    for (nstarted = 0; nstarted < nthreads; nstarted++) {
+      if (pthread_create(&senders[nstarted].thread,
+                         nullptr,
+                         run,
+                         &senders[nstarted]) != 0) {
+        fprintf(stderr, "Error creating thread.\n");
+        break;
+      }
+    }
+
+    // If all the threads have been started...
+    if (nstarted == nthreads) {
+      const uint64_t start = util::clock::monotonic();
+
+      uint64_t last = start;
+      uint64_t last_records = 0;
+      uint64_t last_bytes = 0;
+
+      // Print statistics every second until a signal arrives or the
+      // duration is reached.
+      do {
+        static const struct timespec timeout = {1, 0};
+        const int sig = sigtimedwait(&set, nullptr, &timeout);
+
+        const uint64_t now = util::clock::monotonic();
+
+        uint64_t records = 0;
+        uint64_t bytes = 0;
+        uint64_t errors = 0;
+        size_t open = 0;
+        for (size_t i = 0; i < nthreads; i++) {
+          records += senders[i].records.get();
+          bytes += senders[i].bytes.get();
+          errors += senders[i].errors.get();
+          open += __atomic_load_n(&senders[i].nopen, __ATOMIC_RELAXED);
+        }
+
+        const double seconds = static_cast<double>(now - last) / 1000000.0;
+
+        printf("%.1fs: %.0f records/s, %.2f MB/s, %zu connection(s), "
+               "%llu error(s).\n",
+               static_cast<double>(now - start) / 1000000.0,
+               static_cast<double>(records - last_records) / seconds,
+               (static_cast<double>(bytes - last_bytes) / seconds) / 1000000.0,
+               open,
+               static_cast<unsigned long long>(errors));
+
+        fflush(stdout);
+
+        last = now;
+        last_records = records;
+        last_bytes = bytes;
+
+        // Signal received (SIGPIPE is ignored)?
+        if ((sig == SIGINT) || (sig == SIGTERM)) {
+          break;
+        }
+
+        // If all the connections have been closed...
+        if (open == 0) {
+          break;
+        }
+      } while ((duration == 0) ||
+               (last - start < duration * 1000000ull));
+
+      const double seconds = static_cast<double>(last - start) / 1000000.0;
+
+      printf("Total: %llu records, %llu bytes in %.1fs (%.0f records/s, "
+             "%.2f MB/s).\n",
+             static_cast<unsigned long long>(last_records),
+             static_cast<unsigned long long>(last_bytes),
+             seconds,
+             static_cast<double>(last_records) / seconds,
+             (static_cast<double>(last_bytes) / seconds) / 1000000.0);
+
+      ret = EXIT_SUCCESS;
+    }
+
+    // Stop threads.
+    stop_senders.store(true);
+
+    for (size_t i = 0; i < nstarted; i++) {
+      pthread_join(senders[i].thread, nullptr);
+    }
+  }
+
+  // Close connections (also those of the sender which couldn't connect).
+  if (nsenders < nthreads) {
+    nsenders++;
+  }
+
+  for (size_t i = 0; i < nsenders; i++) {
+    if (senders[i].connections) {
+      for (size_t j = 0; j < senders[i].nconnections; j++) {
+        if (senders[i].connections[j].fd != -1) {
+          close(senders[i].connections[j].fd);
+        }
+      }
+
+      free(senders[i].connections);
+    }
+
+    if (senders[i].epollfd != -1) {
+      close(senders[i].epollfd);
+    }
+  }
+
+  delete [] senders;
+
+  return ret;
+}
+
+void usage(const char* program)
+{
+  fprintf(stderr,
+          "Usage: %s "
+          "-a <ip-port> "
+          "[-c <number-connections>] "
+          "[-t <number-threads>] "
+          "[-r <records-per-second>] "
+          "[-d <seconds>] "
+          "[-m <size>:<weight>[,<size>:<weight>]*] "
+          "[-i <percentage-indefinite-length>] "
+          "[-f <capture-file>]*\n",
+          program);
+
+  fprintf(stderr, "\n");
+  fprintf(stderr,
+          "Number of connections: 1 .. %zu, default: 1.\n",
+          max_connections);
+
+  fprintf(stderr,
+          "Number of threads: 1 .. %zu, default: 1.\n",
+          max_threads);
+
+  fprintf(stderr, "Records per second: default: 0 (as fast as possible).\n");
+  fprintf(stderr, "Seconds: default: 0 (until SIGINT or SIGTERM).\n");
+  fprintf(stderr,
+          "Mix of payload sizes: sizes 0 .. %zu, default: %s.\n",
+          max_payload,
+          default_mix);
+
+  fprintf(stderr,
+          "Percentage of records with indefinite-length encoding: 0 .. 100, "
+          "default: 0.\n");
+
+  fprintf(stderr,
+          "Capture files: the records of the files are sent instead of the "
+          "generated records.\n");
+}
+
+bool parse_number(const char* s,
+                  size_t len,
+                  uint64_t min,
+                  uint64_t max,
+                  uint64_t& n)
+{
+  if (len > 0) {
+    uint64_t res = 0;
+    for (size_t i = 0; i < len; i++) {
+      if ((s[i] >= '0') && (s[i] <= '9')) {
+        const uint64_t tmp = (res * 10) + (s[i] - '0');
+
+        // If the number is not too big...
+        if (tmp >= res) {
+          res = tmp;
+        } else {
+          return false;
+        }
+      } else {
+        return false;
+      }
+    }
+
+    if ((res >= min) && (res <= max)) {
+      n = res;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool parse_mix(const char* s, mix_entry* mix, size_t& nmix)
+{
+  nmix = 0;
+
+  do {
+    const char* const comma = strchr(s, ',');
+    const size_t len = comma ? comma - s : strlen(s);
+
+    const char* const colon = static_cast<const char*>(memchr(s, ':', len));
+
+    uint64_t size, weight;
+    if ((nmix < max_mix) &&
+        (colon) &&
+        (parse_number(s, colon - s, 0, max_payload, size)) &&
+        (parse_number(colon + 1, s + len - (colon + 1), 1, 1000000, weight))) {
+      mix[nmix].size = static_cast<size_t>(size);
+      mix[nmix].weight = static_cast<unsigned>(weight);
+
+      nmix++;
+
+      if (comma) {
+        s = comma + 1;
+      } else {
+        return true;
+      }
+    } else {
+      return false;
+    }
+  } while (true);
+}
+
+// Pseudo-random number generator (xorshift32).
+static uint32_t random_state = 2463534242u;
+
+static inline uint32_t random_number()
+{
+  random_state ^= random_state << 13;
+  random_state ^= random_state >> 17;
+  random_state ^= random_state << 5;
+
+  return random_state;
+}
+
+// Encode record with a payload of `size` bytes.
+//
+// SEQUENCE {
+//   [0] INTEGER,               -- Sequence number.
+//   [1] GeneralizedTime,       -- Time.
+//   [2] OCTET STRING,          -- Calling number.
+//   [3] OCTET STRING,          -- Called number.
+//   [4] SEQUENCE {
+//     [0] INTEGER,             -- Duration.
+//     [1] BOOLEAN,             -- Answered?
+//     [2] OCTET STRING         -- Payload.
+//   }
+// }
+static bool encode_record(uint64_t seqno,
+                          const uint8_t* payload,
+                          size_t size,
+                          string::buffer& buf)
+{
+  char calling[16], called[16];
+  snprintf(calling, sizeof(calling), "34%09u", random_number() % 1000000000);
+  snprintf(called, sizeof(called), "34%09u", random_number() % 1000000000);
+
+  const struct timeval tv = {
+    static_cast<time_t>(1500000000 + (random_number() % 100000000)),
+    static_cast<suseconds_t>(random_number() % 1000000)
+  };
+
+  asn1::ber::encoder encoder;
+  return ((encoder.start_constructed(asn1::ber::tag_class::Universal, 16)) &&
+          (encoder.add_integer(asn1::ber::tag_class::ContextSpecific,
+                               0,
+                               static_cast<int64_t>(seqno))) &&
+          (encoder.add_generalized_time(asn1::ber::tag_class::ContextSpecific,
+                                        1,
+                                        tv)) &&
+          (encoder.add_data(asn1::ber::tag_class::ContextSpecific,
+                            2,
+                            calling,
+                            strlen(calling))) &&
+          (encoder.add_data(asn1::ber::tag_class::ContextSpecific,
+                            3,
+                            called,
+                            strlen(called))) &&
+          (encoder.start_constructed(asn1::ber::tag_class::ContextSpecific,
+                                     4)) &&
+          (encoder.add_integer(asn1::ber::tag_class::ContextSpecific,
+                               0,
+                               random_number() % 7200)) &&
+          (encoder.add_boolean(asn1::ber::tag_class::ContextSpecific,
+                               1,
+                               (random_number() & 1) != 0)) &&
+          (encoder.add_data(asn1::ber::tag_class::ContextSpecific,
+                            2,
+                            payload,
+                            size,
+                            asn1::ber::encoder::copy::shallow)) &&
+          (encoder.end_constructed()) &&
+          (encoder.end_constructed()) &&
+          (encoder.serialize(buf)));
+}
+
+// Re-encode the data values with indefinite-length encoding for the
+// constructed values.
+static bool to_indefinite(asn1::ber::decoder& decoder, string::buffer& buf)
+{
+  asn1::ber::value val;
+  while (decoder.next(val) == asn1::ber::decoder::result::no_error) {
+    // Identifier and length octets.
+    const uint8_t* const hdr = static_cast<const uint8_t*>(val.data()) -
+                               (val.total_length() - val.length());
+
+    // Primitive?
+    if (val.primitive()) {
+      if (!buf.append(hdr, val.total_length())) {
+        return false;
+      }
+    } else {
+      // Length of the identifier octets.
+      size_t len = 1;
+      if ((hdr[0] & 0x1fu) == 0x1fu) {
+        while (hdr[len++] & 0x80u);
+      }
+
+      if ((!buf.append(hdr, len)) ||
+          (!buf.push_back(0x80)) ||
+          (!decoder.enter_constructed()) ||
+          (!to_indefinite(decoder, buf)) ||
+          (!decoder.leave_constructed()) ||
+          (!buf.append(2, 0))) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool generate(const mix_entry* mix,
+              size_t nmix,
+              unsigned indefinite,
+              asn1::ber::record_batch& stream)
+{
+  static uint8_t payload[max_payload];
+  for (size_t i = 0; i < sizeof(payload); i++) {
+    payload[i] = 'a' + (i % 26);
+  }
+
+  // Pre-encode templates (`number_variants` per entry of the mix).
+  string::buffer templates[max_mix][number_variants];
+
+  unsigned total_weight = 0;
+  uint64_t seqno = 0;
+
+  for (size_t i = 0; i < nmix; i++) {
+    for (size_t j = 0; j < number_variants; j++) {
+      if (!encode_record(seqno++, payload, mix[i].size, templates[i][j])) {
+        return false;
+      }
+
+      // Indefinite-length encoding?
+      if ((random_number() % 100) < indefinite) {
+        string::buffer buf;
+        asn1::ber::decoder decoder(templates[i][j].data(),
+                                   templates[i][j].length());
+
+        if (!to_indefinite(decoder, buf)) {
+          return false;
+        }
+
+        templates[i][j].swap(buf);
+      }
+    }
+
+    total_weight += mix[i].weight;
+  }
+
+  // Build the stream.
+  do {
+    // Choose template.
+    unsigned w = random_number() % total_weight;
+
+    size_t i;
+    for (i = 0; w >= mix[i].weight; i++) {
+      w -= mix[i].weight;
+    }
+
+    const string::buffer& templ = templates[i][random_number() %
+                                               number_variants];
+
+    if (!stream.add(templ.data(), templ.length())) {
+      return false;
+    }
+  } while (stream.length() < stream_size);
+
+  return true;
+}
+
+bool load(const char* const* filenames,
+          size_t nfiles,
+          asn1::ber::record_batch& stream)
+{
+  // Contents of the file.
+  string::buffer data;
+
+  for (size_t i = 0; i < nfiles; i++) {
+    // Open file for reading.
+    FILE* const file = fopen(filenames[i], "rb");
+
+    // If the file could be opened...
+    if (file) {
+      data.clear();
+
+      uint8_t buf[64 * 1024];
+      size_t n;
+      while ((n = fread(buf, 1, sizeof(buf), file)) > 0) {
+        if (!data.append(buf, n)) {
+          fprintf(stderr, "Error allocating memory.\n");
+
+          fclose(file);
+          return false;
+        }
+      }
+
+      const bool error = (ferror(file) != 0);
+
+      fclose(file);
+
+      if (error) {
+        fprintf(stderr, "Error reading file '%s'.\n", filenames[i]);
+        return false;
+      }
+
+      // Frame the records.
+      asn1::ber::framer framer(data.data(), data.length());
+
+      do {
+        const size_t offset = framer.offset();
+
+        size_t len;
+        const asn1::ber::decoder::result res = framer.next(len);
+
+        if (res == asn1::ber::decoder::result::no_error) {
+          if (!stream.add(static_cast<const uint8_t*>(data.data()) + offset,
+                          len)) {
+            fprintf(stderr, "Error allocating memory.\n");
+            return false;
+          }
+        } else {
+          if (res != asn1::ber::decoder::result::eof) {
+            // Only the records before the error are sent.
+            fprintf(stderr,
+                    "%s: %s at offset %zu (sending the previous records).\n",
+                    filenames[i],
+                    asn1::ber::to_string(res),
+                    offset);
+          }
+
+          break;
+        }
+      } while (true);
+    } else {
+      fprintf(stderr, "Error opening file '%s' for reading.\n", filenames[i]);
+      return false;
+    }
+  }
+
+  if (!stream.empty()) {
+    return true;
+  }
+
+  fprintf(stderr, "No records to send.\n");
+
+  return false;
+}
+
+bool connect(sender& sender,
+             const net::socket::address& addr,
+             const asn1::ber::record_batch& stream,
+             size_t first)
+{
+  sender.nopen = 0;
+
+  if ((sender.connections = static_cast<connection*>(
+                              malloc(sender.nconnections * sizeof(connection))
+                            )) == nullptr) {
+    sender.epollfd = -1;
+    return false;
+  }
+
+  for (size_t i = 0; i < sender.nconnections; i++) {
+    sender.connections[i].fd = -1;
+  }
+
+  if ((sender.epollfd = epoll_create1(0)) == -1) {
+    return false;
+  }
+
+  const struct sockaddr* const sa = addr;
+
+  for (size_t i = 0; i < sender.nconnections; i++) {
+    connection* const conn = &sender.connections[i];
+
+    // Each connection starts at a different record.
+    conn->next = (first + i) % stream.count();
+    conn->pending_offset = 0;
+    conn->pending_length = 0;
+    conn->pending_records = 0;
+
+    // Connect (blocking) and make the socket non-blocking.
+    if ((conn->fd = socket(sa->sa_family, SOCK_STREAM, 0)) != -1) {
+      if ((::connect(conn->fd, sa, addr.length()) == 0) &&
+          (fcntl(conn->fd, F_SETFL, O_NONBLOCK) == 0)) {
+        struct epoll_event ev;
+        ev.events = EPOLLOUT | EPOLLET;
+        ev.data.ptr = conn;
+
+        if (epoll_ctl(sender.epollfd, EPOLL_CTL_ADD, conn->fd, &ev) == 0) {
+          sender.nopen++;
+          continue;
+        }
+      }
+
+      close(conn->fd);
+      conn->fd = -1;
+    }
+
+    return false;
+  }
+
+  return true;
+}
+
+// Close connection.
+static void close_connection(sender& sender, connection* conn)
+{
+  close(conn->fd);
+  conn->fd = -1;
+
+  __atomic_store_n(&sender.nopen, sender.nopen - 1, __ATOMIC_RELAXED);
+
+  sender.errors.add();
+}
+
+// Write pending data (returns true if there is no pending data left).
+static bool flush(sender& sender,
+                  const asn1::ber::record_batch& stream,
+                  connection* conn)
+{
+  if (conn->pending_length > 0) {
+    const ssize_t ret = send(conn->fd,
+                             static_cast<const uint8_t*>(stream.data()) +
+                             conn->pending_offset,
+                             conn->pending_length,
+                             MSG_NOSIGNAL);
+
+    if (ret > 0) {
+      sender.bytes.add(ret);
+
+      conn->pending_offset += ret;
+
+      // If all the pending data has been written...
+      if ((conn->pending_length -= ret) == 0) {
+        sender.records.add(conn->pending_records);
+        return true;
+      }
+    } else if ((ret < 0) && (errno != EAGAIN) && (errno != EINTR)) {
+      close_connection(sender, conn);
+    }
+
+    return false;
+  }
+
+  return true;
+}
+
+// Write up to `n` records (returns the number of records written or queued).
+static size_t write_records(sender& sender,
+                            const asn1::ber::record_batch& stream,
+                            connection* conn,
+                            size_t n)
+{
+  // The records must be contiguous.
+  if (n > stream.count() - conn->next) {
+    n = stream.count() - conn->next;
+  }
+
+  conn->pending_offset = stream.offset(conn->next);
+  conn->pending_length = stream.offset(conn->next + n) -
+                         conn->pending_offset;
+
+  conn->pending_records = n;
+
+  if ((conn->next += n) == stream.count()) {
+    conn->next = 0;
+  }
+
+  flush(sender, stream, conn);
+
+  return n;
+}
+
+void* run(void* arg)
+{
+  sender& s = *static_cast<sender*>(arg);
+  const asn1::ber::record_batch& stream = *s.stream;
+
+  struct epoll_event events[max_events];
+
+  // Number of records which can be sent (rate limited).
+  double budget = 0.0;
+  uint64_t last = util::clock::monotonic();
+
+  size_t cursor = 0;
+
+  while ((!stop_senders.load(std::memory_order_relaxed)) && (s.nopen > 0)) {
+    const int nevents = epoll_wait(s.epollfd,
+                                   events,
+                                   max_events,
+                                   (s.rate > 0) ? tick / 1000 : 100);
+
+    for (int i = 0; i < nevents; i++) {
+      connection* const conn = static_cast<connection*>(events[i].data.ptr);
+
+      // If the connection has been closed...
+      if (conn->fd == -1) {
+        continue;
+      }
+
+      // If the connection failed...
+      if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+        close_connection(s, conn);
+        continue;
+      }
+
+      // Write pending data.
+      if (flush(s, stream, conn)) {
+        // As fast as possible?
+        if (s.rate == 0) {
+          // Write until the socket buffer is full.
+          do {
+            write_records(s, stream, conn, stream.count());
+          } while ((conn->fd != -1) && (conn->pending_length == 0));
+        }
+      }
+    }
+
+    // If the rate is limited...
+    if (s.rate > 0) {
+      const uint64_t now = util::clock::monotonic();
+
+      budget += (static_cast<double>(now - last) * s.rate) / 1000000.0;
+      last = now;
+
+      // Don't accumulate more than one second.
+      if (budget > s.rate) {
+        budget = static_cast<double>(s.rate);
+      }
+
+      // Distribute the budget among the connections (round robin).
+      for (size_t n = 0; (budget >= 1.0) && (n < s.nconnections); n++) {
+        connection* const conn = &s.connections[cursor];
+
+        if (++cursor == s.nconnections) {
+          cursor = 0;
+        }
+
+        // If the connection is open and has no pending data...
+        if ((conn->fd != -1) && (conn->pending_length == 0)) {
+          size_t nrecords = static_cast<size_t>(budget);
+          if (nrecords > max_records_per_write) {
+            nrecords = max_records_per_write;
+          }
+
+          budget -= write_records(s, stream, conn, nrecords);
+        }
+      }
+    }
+  }
+
+  return nullptr;
+}
@@ -4,7 +4,12 @@
 #include <signal.h>
 #include <limits.h>
 #include <inttypes.h>
+#include <new>
 #include "asn1/ber/server.h"
+#include "asn1/ber/sinks/file.h"
+#include "asn1/ber/sinks/null.h"
+#include "asn1/ber/sinks/tcp.h"
+#include "asn1/ber/sinks/shm.h"
 
 static void usage(const char* program);
 static bool parse_number_workers(int argc,
@@ -18,12 +23,18 @@ static bool parse_number(const char* s,
                          uint64_t min = 0,
                          uint64_t max = ULLONG_MAX);
 
+static bool parse_sink(const char* s,
+                       asn1::ber::server& server,
+                       bool& filesink);
+
 static bool parse_arguments(int argc,
                             const char* argv[],
+                            bool& filesink,
                             const char*& tempdir,
                             const char*& finaldir,
                             size_t& maxfilesize,
                             time_t& maxfileage,
+                            const char*& metrics,
                             asn1::ber::server& server);
 
 int main(int argc, const char* argv[])
@@ -33,18 +44,22 @@ int main(int argc, const char* argv[])
   if (parse_number_workers(argc, argv, nworkers)) {
     asn1::ber::server server(nworkers);
 
+    bool filesink;
     const char* tempdir;
     const char* finaldir;
     size_t maxfilesize;
     time_t maxfileage;
+    const char* metrics;
 
     // Parse arguments.
     if (parse_arguments(argc,
                         argv,
+                        filesink,
                         tempdir,
                         finaldir,
                         maxfilesize,
                         maxfileage,
+                        metrics,
                         server)) {
       // Block signals SIGINT and SIGTERM.
       sigset_t set;
@@ -52,8 +67,24 @@ int main(int argc, const char* argv[])
       sigaddset(&set, SIGINT);
       sigaddset(&set, SIGTERM);
       if (pthread_sigmask(SIG_BLOCK, &set, nullptr) == 0) {
-        // Start server.
-        if (server.start(tempdir, finaldir, maxfilesize, maxfileage)) {
+        // Add file sink (if needed) and start server.
+        if (((!filesink) ||
+             (server.add_sink(
+               new (std::nothrow) asn1::ber::sinks::file(tempdir,
+                                                         finaldir,
+                                                         maxfilesize,
+                                                         maxfileage)
+             ))) &&
+            (server.start())) {
+          // Serve metrics (if requested).
+          if ((metrics) && (!server.serve_metrics(metrics))) {
+            fprintf(stderr, "Error serving metrics on '%s'.\n", metrics);
+
+            server.stop();
+
+            return -1;
+          }
+
           printf("Waiting for signal to arrive.\n");
 
           // Wait for signal to arrive.
@@ -83,6 +114,8 @@ void usage(const char* program)
           "Usage: %s "
           "[--bind <ip-port>]+ "
           "[--number-workers <number-workers>] "
+          "[--sink <sink>]* "
+          "[--metrics <metrics-address>] "
           "--temp-dir <directory> "
           "--final-dir <directory> "
           "--max-file-size <size> "
@@ -91,6 +124,11 @@ void usage(const char* program)
 
   fprintf(stderr, "<ip-port> ::= <ip-address>:<port>\n");
   fprintf(stderr, "<ip-address> ::= <ipv4-address> | <ipv6-address>\n");
+  fprintf(stderr,
+          "<sink> ::= file | [lossy:]<lossy-sink>\n");
+  fprintf(stderr,
+          "<lossy-sink> ::= null | tcp:<ip-port> | shm:<name>:<size>\n");
+  fprintf(stderr, "<metrics-address> ::= unix:<path> | <ip-port>\n");
   fprintf(stderr, "\n");
   fprintf(stderr,
           "Number of workers: 1 .. %zu, default: %zu.\n",
@@ -99,13 +137,27 @@ void usage(const char* program)
 
   fprintf(stderr,
           "File size: %zu .. %zu.\n",
-          asn1::ber::server::min_file_size,
-          asn1::ber::server::max_file_size);
+          asn1::ber::sinks::file::min_file_size,
+          asn1::ber::sinks::file::max_file_size);
 
   fprintf(stderr,
           "File age: %ld .. %ld (seconds).\n",
-          asn1::ber::server::min_file_age,
-          asn1::ber::server::max_file_age);
+          asn1::ber::sinks::file::min_file_age,
+          asn1::ber::sinks::file::max_file_age);
+
+  fprintf(stderr,
+          "Shared memory ring size: %zu .. %zu.\n",
+          asn1::ber::sinks::shm::min_capacity,
+          asn1::ber::sinks::shm::max_capacity);
+
+  fprintf(stderr,
+          "Default sink: file (the temporary and final directories and the "
+          "maximum file size and age are only required by the file sink).\n");
+
+  fprintf(stderr,
+          "When the queue of a sink is full, the workers wait; the batches "
+          "of a \"lossy:\" sink are dropped instead (unless it is the only "
+          "sink).\n");
 
   fprintf(stderr, "\n");
 }
@@ -216,19 +268,106 @@ bool parse_number(const char* s,
   return false;
 }
 
+bool parse_sink(const char* s, asn1::ber::server& server, bool& filesink)
+{
+  // Lossy sink (its batches are dropped when its queue is full)?
+  bool lossy = false;
+  if (strncasecmp(s, "lossy:", 6) == 0) {
+    lossy = true;
+    s += 6;
+  }
+
+  if (strcasecmp(s, "file") == 0) {
+    if (!lossy) {
+      filesink = true;
+      return true;
+    }
+
+    fprintf(stderr, "The file sink cannot be lossy.\n");
+    return false;
+  } else if (strcasecmp(s, "null") == 0) {
+    if (server.add_sink(new (std::nothrow) asn1::ber::sinks::null(), lossy)) {
+      return true;
+    }
+  } else if (strncasecmp(s, "tcp:", 4) == 0) {
+    net::socket::address addr;
+    if (addr.build(s + 4)) {
+      if (server.add_sink(new (std::nothrow) asn1::ber::sinks::tcp(addr),
+                          lossy)) {
+        return true;
+      }
+    } else {
+      fprintf(stderr, "Invalid address '%s'.\n", s + 4);
+      return false;
+    }
+  } else if (strncasecmp(s, "shm:", 4) == 0) {
+    const char* const name = s + 4;
+
+    // Search last colon.
+    const char* const colon = strrchr(name, ':');
+
+    // If the colon was found...
+    if ((colon) && (colon > name)) {
+      // Parse size of the ring.
+      uint64_t n;
+      if (parse_number(colon + 1,
+                       strlen(colon + 1),
+                       "shared memory ring size",
+                       n,
+                       asn1::ber::sinks::shm::min_capacity,
+                       asn1::ber::sinks::shm::max_capacity)) {
+        char shmname[NAME_MAX];
+        if (snprintf(shmname,
+                     sizeof(shmname),
+                     "%.*s",
+                     static_cast<int>(colon - name),
+                     name) < static_cast<int>(sizeof(shmname))) {
+          if (server.add_sink(
+                new (std::nothrow) asn1::ber::sinks::shm(shmname,
+                                                         static_cast<size_t>(n)),
+                lossy
+              )) {
+            return true;
+          }
+        } else {
+          fprintf(stderr, "Shared memory name is too long.\n");
+          return false;
+        }
+      } else {
+        return false;
+      }
+    } else {
+      fprintf(stderr, "Expected shm:<name>:<size>.\n");
+      return false;
+    }
+  } else {
+    fprintf(stderr, "Invalid sink '%s'.\n", s);
+    return false;
+  }
+
+  fprintf(stderr, "Error adding sink '%s'.\n", s);
+
+  return false;
+}
+
 bool parse_arguments(int argc,
                      const char* argv[],
+                     bool& filesink,
                      const char*& tempdir,
                      const char*& finaldir,
                      size_t& maxfilesize,
                      time_t& maxfileage,
+                     const char*& metrics,
                      asn1::ber::server& server)
 {
+  filesink = false;
   tempdir = nullptr;
   finaldir = nullptr;
   maxfilesize = 0;
   maxfileage = 0;
+  metrics = nullptr;
   size_t nbind = 0;
+  size_t nsinks = 0;
 
   int i = 1;
   while (i < argc) {
@@ -249,6 +388,32 @@ bool parse_arguments(int argc,
         fprintf(stderr, "Expected IP address and port after \"--bind\".\n");
         return false;
       }
+    } else if (strcasecmp(argv[i], "--sink") == 0) {
+      // If not the last argument...
+      if (i + 1 < argc) {
+        // Parse sink.
+        if (parse_sink(argv[i + 1], server, filesink)) {
+          // Increment number of sinks.
+          nsinks++;
+
+          i += 2;
+        } else {
+          return false;
+        }
+      } else {
+        fprintf(stderr, "Expected sink after \"--sink\".\n");
+        return false;
+      }
+    } else if (strcasecmp(argv[i], "--metrics") == 0) {
+      // If not the last argument...
+      if (i + 1 < argc) {
+        metrics = argv[i + 1];
+
+        i += 2;
+      } else {
+        fprintf(stderr, "Expected address after \"--metrics\".\n");
+        return false;
+      }
     } else if (strcasecmp(argv[i], "--temp-dir") == 0) {
       // If not the last argument...
       if (i + 1 < argc) {
@@ -278,8 +443,8 @@ bool parse_arguments(int argc,
                          strlen(argv[i + 1]),
                          "maximum file size",
                          n,
-                         asn1::ber::server::min_file_size,
-                         asn1::ber::server::max_file_size)) {
+                         asn1::ber::sinks::file::min_file_size,
+                         asn1::ber::sinks::file::max_file_size)) {
           maxfilesize = static_cast<size_t>(n);
 
           i += 2;
@@ -301,8 +466,8 @@ bool parse_arguments(int argc,
                          strlen(argv[i + 1]),
                          "maximum file age",
                          n,
-                         asn1::ber::server::min_file_age,
-                         asn1::ber::server::max_file_age)) {
+                         asn1::ber::sinks::file::min_file_age,
+                         asn1::ber::sinks::file::max_file_age)) {
           maxfileage = static_cast<time_t>(n);
 
           i += 2;
@@ -324,11 +489,17 @@ bool parse_arguments(int argc,
   }
 
   if (argc > 1) {
+    // If no sink has been specified, use the file sink.
+    if (nsinks == 0) {
+      filesink = true;
+    }
+
     if ((nbind > 0) &&
-        (tempdir) &&
-        (finaldir) &&
-        (maxfilesize != 0) &&
-        (maxfileage != 0)) {
+        ((!filesink) ||
+         ((tempdir) &&
+          (finaldir) &&
+          (maxfilesize != 0) &&
+          (maxfileage != 0)))) {
       return true;
     } else if (nbind == 0) {
       fprintf(stderr, "At least one bind address has to be specified.\n");
@@ -0,0 +1,1029 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include "asn1/ber/decoder.h"
+#include "asn1/ber/framer.h"
+#include "asn1/ber/header.h"
+#include "asn1/ber/segmented_decoder.h"
+#include "asn1/ber/tape.h"
+#include "asn1/ber/printer.h"
+#include "asn1/ber/json_printer.h"
+#include "string/buffer.h"
+#include "util/clock.h"
+
+// Default size of the generated corpora.
+static constexpr const size_t default_corpus_size = 16 * 1024 * 1024;
+
+// Default minimum time per benchmark (milliseconds).
+static constexpr const uint64_t default_min_time = 500;
+
+// Depth of the nested records.
+static constexpr const unsigned nested_depth = 24;
+
+// Size of the segments (for the segmented decoder).
+static constexpr const size_t segment_size = 4 * 1024;
+
+// Sink of the checksums (prevents the compiler from discarding the work).
+static volatile uint64_t sink;
+
+// Corpus.
+struct corpus {
+  char name[PATH_MAX];
+
+  string::buffer data;
+
+  // Number of records.
+  size_t nrecords;
+
+  // Offsets of the contents octets of the indefinite-length records.
+  size_t* indefinite = nullptr;
+  size_t nindefinite = 0;
+
+  // INTEGER values (for the batch decoder).
+  asn1::ber::value* integers = nullptr;
+  size_t nintegers = 0;
+
+  // Segments of `segment_size` bytes (for the segmented decoder).
+  struct iovec* segments = nullptr;
+  size_t nsegments = 0;
+
+  // Destructor.
+  ~corpus()
+  {
+    free(indefinite);
+    free(integers);
+    free(segments);
+  }
+};
+
+// Benchmark (returns the number of records processed and their size in
+// bytes, 0 if the benchmark doesn't apply to the corpus).
+typedef size_t (*benchmark_t)(const corpus& corpus,
+                              uint64_t& checksum,
+                              size_t& bytes);
+
+static size_t bench_next(const corpus& corpus,
+                         uint64_t& checksum,
+                         size_t& bytes);
+static size_t bench_framer(const corpus& corpus,
+                           uint64_t& checksum,
+                           size_t& bytes);
+static size_t bench_find_eoc(const corpus& corpus,
+                             uint64_t& checksum,
+                             size_t& bytes);
+static size_t bench_walk(const corpus& corpus,
+                         uint64_t& checksum,
+                         size_t& bytes);
+static size_t bench_segmented(const corpus& corpus,
+                              uint64_t& checksum,
+                              size_t& bytes);
+static size_t bench_tape(const corpus& corpus,
+                         uint64_t& checksum,
+                         size_t& bytes);
+static size_t bench_decode(const corpus& corpus,
+                           uint64_t& checksum,
+                           size_t& bytes);
+static size_t bench_batch_integers(const corpus& corpus,
+                                   uint64_t& checksum,
+                                   size_t& bytes);
+static size_t bench_printer(const corpus& corpus,
+                            uint64_t& checksum,
+                            size_t& bytes);
+static size_t bench_json_printer(const corpus& corpus,
+                                 uint64_t& checksum,
+                                 size_t& bytes);
+
+static const struct {
+  const char* name;
+  benchmark_t fn;
+} benchmarks[] = {
+  {"next", bench_next},
+  {"framer", bench_framer},
+  {"find_eoc", bench_find_eoc},
+  {"walk", bench_walk},
+  {"segmented", bench_segmented},
+  {"tape", bench_tape},
+  {"decode", bench_decode},
+  {"batch_integers", bench_batch_integers},
+  {"printer", bench_printer},
+  {"json_printer", bench_json_printer}
+};
+
+// Shape of the generated records.
+enum class shape {
+  flat,
+  nested,
+  large
+};
+
+static void usage(const char* program);
+static bool parse_number(const char* s, uint64_t min, uint64_t& n);
+
+static bool generate(corpus& corpus,
+                     const char* name,
+                     enum shape shape,
+                     bool definite_length,
+                     size_t size);
+
+static bool load(corpus& corpus, const char* filename);
+static bool index(corpus& corpus);
+static bool split(corpus& corpus);
+
+static bool run(const corpus& corpus, uint64_t min_time);
+
+int main(int argc, const char* argv[])
+{
+  size_t size = default_corpus_size;
+  uint64_t min_time = default_min_time;
+
+  int i;
+  for (i = 1; (i < argc) && (argv[i][0] == '-'); i += 2) {
+    uint64_t n;
+    if ((i + 1 < argc) && (parse_number(argv[i + 1], 1, n))) {
+      if (strcmp(argv[i], "-s") == 0) {
+        size = n;
+      } else if (strcmp(argv[i], "-t") == 0) {
+        min_time = n;
+      } else {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+    } else {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Generated corpora.
+  static const struct {
+    const char* name;
+    enum shape shape;
+    bool definite_length;
+  } generated[] = {
+    {"flat-definite", shape::flat, true},
+    {"flat-indefinite", shape::flat, false},
+    {"nested-definite", shape::nested, true},
+    {"nested-indefinite", shape::nested, false},
+    {"large-definite", shape::large, true}
+  };
+
+  for (size_t j = 0; j < sizeof(generated) / sizeof(generated[0]); j++) {
+    corpus corpus;
+    if ((!generate(corpus,
+                   generated[j].name,
+                   generated[j].shape,
+                   generated[j].definite_length,
+                   size)) ||
+        (!run(corpus, min_time))) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Capture files.
+  for (; i < argc; i++) {
+    corpus corpus;
+    if ((!load(corpus, argv[i])) || (!run(corpus, min_time))) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+void usage(const char* program)
+{
+  fprintf(stderr,
+          "Usage: %s [-s <corpus-size>] [-t <milliseconds>] "
+          "[<capture-file>]*\n",
+          program);
+
+  fprintf(stderr,
+          "Corpus size: size of each generated corpus in bytes "
+          "(default: %zu).\n",
+          default_corpus_size);
+
+  fprintf(stderr,
+          "Milliseconds: minimum running time of each benchmark "
+          "(default: %llu).\n",
+          static_cast<unsigned long long>(default_min_time));
+}
+
+bool parse_number(const char* s, uint64_t min, uint64_t& n)
+{
+  uint64_t res = 0;
+  while (*s) {
+    if ((*s >= '0') && (*s <= '9')) {
+      const uint64_t tmp = (res * 10) + (*s - '0');
+
+      // If the number is not too big...
+      if (tmp >= res) {
+        res = tmp;
+        s++;
+      } else {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+
+  if (res >= min) {
+    n = res;
+    return true;
+  }
+
+  return false;
+}
+
+// Pseudo-random number generator (xorshift64).
+static uint64_t random_state = 88172645463325252ull;
+
+static inline uint32_t random_number()
+{
+  random_state ^= random_state << 13;
+  random_state ^= random_state >> 7;
+  random_state ^= random_state << 17;
+
+  return static_cast<uint32_t>(random_state >> 16);
+}
+
+// Append the identifier and length octets and the contents octets.
+static bool append_value(string::buffer& buf,
+                         uint8_t idoctet,
+                         const void* contents,
+                         size_t len,
+                         bool definite_length)
+{
+  if (!buf.push_back(idoctet)) {
+    return false;
+  }
+
+  // Definite length?
+  if (definite_length) {
+    if (len < 0x80) {
+      if (!buf.push_back(static_cast<uint8_t>(len))) {
+        return false;
+      }
+    } else {
+      uint8_t lenoctets[5];
+      size_t noctets = 0;
+      for (size_t l = len; l > 0; l >>= 8) {
+        lenoctets[4 - noctets++] = static_cast<uint8_t>(l);
+      }
+
+      lenoctets[4 - noctets] = static_cast<uint8_t>(0x80 | noctets);
+
+      if (!buf.append(lenoctets + 4 - noctets, noctets + 1)) {
+        return false;
+      }
+    }
+
+    return buf.append(contents, len);
+  } else {
+    return ((buf.push_back(0x80)) &&
+            (buf.append(contents, len)) &&
+            (buf.append(2, 0)));
+  }
+}
+
+// Append primitive values of the most common types.
+static bool append_primitives(string::buffer& buf, size_t n)
+{
+  uint8_t contents[64];
+
+  for (size_t i = 0; i < n; i++) {
+    size_t len;
+    uint8_t idoctet;
+
+    switch (i % 8) {
+      case 0: // INTEGER.
+      case 1:
+        idoctet = 0x02;
+        len = 1 + (random_number() % 8);
+
+        for (size_t j = 0; j < len; j++) {
+          contents[j] = static_cast<uint8_t>(random_number());
+        }
+
+        break;
+      case 2: // BOOLEAN.
+        idoctet = 0x01;
+        len = 1;
+        contents[0] = (random_number() & 1) ? 0xff : 0x00;
+
+        break;
+      case 3: // OCTET STRING.
+      case 4:
+        idoctet = 0x04;
+        len = 8 + (random_number() % 24);
+
+        for (size_t j = 0; j < len; j++) {
+          contents[j] = 'a' + (random_number() % 26);
+        }
+
+        break;
+      case 5: // OBJECT IDENTIFIER (1.3.6.1.4.1.x.y...).
+        idoctet = 0x06;
+        contents[0] = 0x2b;
+        contents[1] = 6;
+        contents[2] = 1;
+        contents[3] = 4;
+        contents[4] = 1;
+        contents[5] = 0x80 | (random_number() % 0x7f);
+        contents[6] = random_number() % 0x80;
+        len = 7;
+
+        for (size_t j = random_number() % 4; j > 0; j--) {
+          contents[len++] = random_number() % 0x80;
+        }
+
+        break;
+      case 6: // UTCTime.
+        idoctet = 0x17;
+        len = snprintf(reinterpret_cast<char*>(contents),
+                       sizeof(contents),
+                       "%02u%02u%02u%02u%02u%02uZ",
+                       random_number() % 100,
+                       1 + (random_number() % 12),
+                       1 + (random_number() % 28),
+                       random_number() % 24,
+                       random_number() % 60,
+                       random_number() % 60);
+
+        break;
+      default: // GeneralizedTime.
+        idoctet = 0x18;
+        len = snprintf(reinterpret_cast<char*>(contents),
+                       sizeof(contents),
+                       "%04u%02u%02u%02u%02u%02u.%03uZ",
+                       1970 + (random_number() % 100),
+                       1 + (random_number() % 12),
+                       1 + (random_number() % 28),
+                       random_number() % 24,
+                       random_number() % 60,
+                       random_number() % 60,
+                       random_number() % 1000);
+    }
+
+    if (!append_value(buf, idoctet, contents, len, true)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Append record.
+static bool append_record(string::buffer& buf,
+                          enum shape shape,
+                          bool definite_length)
+{
+  string::buffer contents;
+
+  switch (shape) {
+    case shape::flat:
+      if (!append_primitives(contents, 16)) {
+        return false;
+      }
+
+      break;
+    case shape::nested:
+      // Innermost value.
+      if (!append_primitives(contents, 2)) {
+        return false;
+      }
+
+      for (unsigned i = 0; i < nested_depth; i++) {
+        string::buffer tmp;
+        if ((!append_primitives(tmp, 2)) ||
+            (!append_value(tmp,
+                           0xa0 | (i % 31),
+                           contents.data(),
+                           contents.length(),
+                           definite_length))) {
+          return false;
+        }
+
+        contents.swap(tmp);
+      }
+
+      break;
+    case shape::large:
+      {
+        static uint8_t large[4096];
+        for (size_t i = 0; i < sizeof(large); i++) {
+          large[i] = static_cast<uint8_t>(random_number());
+        }
+
+        if ((!append_primitives(contents, 2)) ||
+            (!append_value(contents, 0x04, large, sizeof(large), true)) ||
+            (!append_value(contents, 0x04, large, sizeof(large) / 4, true))) {
+          return false;
+        }
+      }
+
+      break;
+  }
+
+  // SEQUENCE.
+  return append_value(buf,
+                      0x30,
+                      contents.data(),
+                      contents.length(),
+                      definite_length);
+}
+
+bool generate(corpus& corpus,
+              const char* name,
+              enum shape shape,
+              bool definite_length,
+              size_t size)
+{
+  snprintf(corpus.name, sizeof(corpus.name), "%s", name);
+
+  while (corpus.data.length() < size) {
+    if (!append_record(corpus.data, shape, definite_length)) {
+      fprintf(stderr, "Error generating corpus '%s'.\n", name);
+      return false;
+    }
+  }
+
+  return index(corpus);
+}
+
+bool load(corpus& corpus, const char* filename)
+{
+  snprintf(corpus.name, sizeof(corpus.name), "%s", filename);
+
+  // Open file for reading.
+  const int fd = open(filename, O_RDONLY);
+
+  // If the file could be opened...
+  if (fd != -1) {
+    uint8_t buf[64 * 1024];
+    ssize_t ret;
+    while ((ret = read(fd, buf, sizeof(buf))) > 0) {
+      if (!corpus.data.append(buf, ret)) {
+        fprintf(stderr, "Error allocating memory.\n");
+
+        close(fd);
+        return false;
+      }
+    }
+
+    close(fd);
+
+    if (ret == 0) {
+      return index(corpus);
+    }
+
+    fprintf(stderr, "Error reading file '%s'.\n", filename);
+  } else {
+    fprintf(stderr, "Error opening file '%s' for reading.\n", filename);
+  }
+
+  return false;
+}
+
+// Collect the INTEGER values.
+static bool collect_integers(asn1::ber::decoder& decoder,
+                             corpus& corpus,
+                             size_t& size)
+{
+  asn1::ber::value val;
+  while (decoder.next(val) == asn1::ber::decoder::result::no_error) {
+    // Constructed?
+    if (val.constructed()) {
+      decoder.enter_constructed();
+
+      if (!collect_integers(decoder, corpus, size)) {
+        return false;
+      }
+
+      decoder.leave_constructed();
+    } else if ((val.tag_class() == asn1::ber::tag_class::Universal) &&
+               (val.tag_number() == 2)) {
+      // If the array is full...
+      if (corpus.nintegers == size) {
+        size = (size == 0) ? 1024 : size * 2;
+
+        asn1::ber::value* const integers = static_cast<asn1::ber::value*>(
+                                             realloc(corpus.integers,
+                                                     size *
+                                                     sizeof(asn1::ber::value))
+                                           );
+
+        if (!integers) {
+          return false;
+        }
+
+        corpus.integers = integers;
+      }
+
+      corpus.integers[corpus.nintegers++] = val;
+    }
+  }
+
+  return true;
+}
+
+bool index(corpus& corpus)
+{
+  const uint8_t* const data = static_cast<const uint8_t*>(corpus.data.data());
+  const size_t len = corpus.data.length();
+
+  corpus.nrecords = 0;
+  corpus.nindefinite = 0;
+
+  size_t size = 0;
+
+  asn1::ber::framer framer(data, len);
+
+  do {
+    const size_t offset = framer.offset();
+
+    size_t reclen;
+    const asn1::ber::decoder::result res = framer.next(reclen);
+
+    if (res == asn1::ber::decoder::result::no_error) {
+      corpus.nrecords++;
+
+      // Decode identifier and length octets.
+      size_t off = offset;
+      asn1::ber::header hdr;
+      hdr.decode(data, len, off);
+
+      // Indefinite length?
+      if (!hdr.definite_length) {
+        // If the array is full...
+        if (corpus.nindefinite == size) {
+          size = (size == 0) ? 1024 : size * 2;
+
+          size_t* const indefinite = static_cast<size_t*>(
+                                       realloc(corpus.indefinite,
+                                               size * sizeof(size_t))
+                                     );
+
+          if (!indefinite) {
+            fprintf(stderr, "Error allocating memory.\n");
+            return false;
+          }
+
+          corpus.indefinite = indefinite;
+        }
+
+        corpus.indefinite[corpus.nindefinite++] = off;
+      }
+    } else if (res == asn1::ber::decoder::result::eof) {
+      break;
+    } else {
+      // Only the records before the error are used.
+      fprintf(stderr,
+              "%s: %s at offset %zu (using the first %zu records).\n",
+              corpus.name,
+              asn1::ber::to_string(res),
+              offset,
+              corpus.nrecords);
+
+      corpus.data.resize(offset);
+
+      break;
+    }
+  } while (true);
+
+  if (corpus.nrecords > 0) {
+    asn1::ber::decoder decoder(corpus.data.data(), corpus.data.length());
+
+    size = 0;
+    if ((collect_integers(decoder, corpus, size)) && (split(corpus))) {
+      return true;
+    }
+
+    fprintf(stderr, "Error allocating memory.\n");
+    return false;
+  }
+
+  fprintf(stderr, "%s: no records.\n", corpus.name);
+
+  return false;
+}
+
+bool split(corpus& corpus)
+{
+  const size_t len = corpus.data.length();
+  const size_t nsegments = (len + segment_size - 1) / segment_size;
+
+  struct iovec* const
+    segments = static_cast<struct iovec*>(
+                 realloc(corpus.segments, nsegments * sizeof(struct iovec))
+               );
+
+  if (!segments) {
+    return false;
+  }
+
+  uint8_t* const data = static_cast<uint8_t*>(
+                          const_cast<void*>(corpus.data.data())
+                        );
+
+  for (size_t i = 0; i < nsegments; i++) {
+    const size_t offset = i * segment_size;
+
+    segments[i].iov_base = data + offset;
+    segments[i].iov_len = ((len - offset) < segment_size) ? len - offset :
+                                                            segment_size;
+  }
+
+  corpus.segments = segments;
+  corpus.nsegments = nsegments;
+
+  return true;
+}
+
+bool run(const corpus& corpus, uint64_t min_time)
+{
+  const uint64_t min_time_us = min_time * 1000;
+
+  uint64_t checksum = 0;
+
+  for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++) {
+    // Warm up (and skip the benchmarks which don't apply to the corpus).
+    size_t bytes;
+    const size_t nrecords = benchmarks[i].fn(corpus, checksum, bytes);
+    if (nrecords == 0) {
+      continue;
+    }
+
+    // Run the benchmark for at least `min_time` milliseconds.
+    size_t passes = 0;
+    uint64_t elapsed;
+
+    const uint64_t start = util::clock::monotonic();
+
+    do {
+      benchmarks[i].fn(corpus, checksum, bytes);
+      passes++;
+    } while ((elapsed = util::clock::monotonic() - start) < min_time_us);
+
+    const double ns = static_cast<double>(elapsed) * 1000.0;
+
+    printf("{\"benchmark\":\"%s\",\"corpus\":\"%s\",\"records\":%zu,"
+           "\"bytes\":%zu,\"passes\":%zu,\"ns_per_record\":%.2f,"
+           "\"gb_per_s\":%.3f}\n",
+           benchmarks[i].name,
+           corpus.name,
+           nrecords,
+           bytes,
+           passes,
+           ns / (static_cast<double>(nrecords) * passes),
+           (static_cast<double>(bytes) * passes) / ns);
+
+    fflush(stdout);
+  }
+
+  // Make sure the results are used.
+  sink = checksum;
+
+  return true;
+}
+
+size_t bench_next(const corpus& corpus,
+                  uint64_t& checksum,
+                  size_t& bytes)
+{
+  asn1::ber::decoder decoder(corpus.data.data(), corpus.data.length());
+
+  size_t nrecords = 0;
+
+  asn1::ber::value val;
+  while (decoder.next(val) == asn1::ber::decoder::result::no_error) {
+    checksum += val.total_length();
+    nrecords++;
+  }
+
+  bytes = corpus.data.length();
+
+  return nrecords;
+}
+
+size_t bench_framer(const corpus& corpus,
+                    uint64_t& checksum,
+                    size_t& bytes)
+{
+  asn1::ber::framer framer(corpus.data.data(), corpus.data.length());
+
+  size_t nrecords = 0;
+
+  size_t len;
+  while (framer.next(len) == asn1::ber::decoder::result::no_error) {
+    checksum += len;
+    nrecords++;
+  }
+
+  bytes = corpus.data.length();
+
+  return nrecords;
+}
+
+size_t bench_find_eoc(const corpus& corpus,
+                      uint64_t& checksum,
+                      size_t& bytes)
+{
+  const uint8_t* const data = static_cast<const uint8_t*>(corpus.data.data());
+  const size_t len = corpus.data.length();
+
+  bytes = 0;
+
+  for (size_t i = 0; i < corpus.nindefinite; i++) {
+    size_t offset = corpus.indefinite[i];
+    if (asn1::ber::framer::find_eoc(data, len, offset) !=
+        asn1::ber::decoder::result::no_error) {
+      return 0;
+    }
+
+    // Contents octets and end-of-contents.
+    bytes += (offset - corpus.indefinite[i]) + 2;
+
+    checksum += offset;
+  }
+
+  return corpus.nindefinite;
+}
+
+// Walk the data values (depth-first).
+template<typename Decoder>
+static void walk(Decoder& decoder, uint64_t& checksum)
+{
+  asn1::ber::value val;
+  while (decoder.next(val) == asn1::ber::decoder::result::no_error) {
+    checksum += val.tag_number();
+
+    // Constructed?
+    if (val.constructed()) {
+      decoder.enter_constructed();
+      walk(decoder, checksum);
+      decoder.leave_constructed();
+    }
+  }
+}
+
+size_t bench_walk(const corpus& corpus,
+                  uint64_t& checksum,
+                  size_t& bytes)
+{
+  asn1::ber::decoder decoder(corpus.data.data(), corpus.data.length());
+
+  walk(decoder, checksum);
+
+  bytes = corpus.data.length();
+
+  return corpus.nrecords;
+}
+
+size_t bench_segmented(const corpus& corpus,
+                       uint64_t& checksum,
+                       size_t& bytes)
+{
+  asn1::ber::segmented_decoder decoder(corpus.segments, corpus.nsegments);
+
+  walk(decoder, checksum);
+
+  bytes = corpus.data.length();
+
+  return corpus.nrecords;
+}
+
+size_t bench_tape(const corpus& corpus,
+                  uint64_t& checksum,
+                  size_t& bytes)
+{
+  static asn1::ber::tape tape;
+
+  const uint8_t* const data = static_cast<const uint8_t*>(corpus.data.data());
+  const size_t len = corpus.data.length();
+
+  size_t nrecords = 0;
+
+  for (size_t offset = 0; offset < len; offset += tape.total_length()) {
+    if (!tape.decode(data + offset, len - offset)) {
+      return 0;
+    }
+
+    checksum += tape.size();
+    nrecords++;
+  }
+
+  bytes = len;
+
+  return nrecords;
+}
+
+// Decode the primitive values of the universal types.
+static void decode(asn1::ber::decoder& decoder, uint64_t& checksum)
+{
+  asn1::ber::value val;
+  while (decoder.next(val) == asn1::ber::decoder::result::no_error) {
+    // Constructed?
+    if (val.constructed()) {
+      decoder.enter_constructed();
+      decode(decoder, checksum);
+      decoder.leave_constructed();
+    } else if (val.tag_class() == asn1::ber::tag_class::Universal) {
+      switch (val.tag_number()) {
+        case 1: // BOOLEAN.
+          {
+            bool b;
+            if (val.decode_boolean(b)) {
+              checksum += b;
+            }
+          }
+
+          break;
+        case 2:  // INTEGER.
+        case 10: // ENUMERATED.
+          {
+            int64_t n;
+            if (val.decode_integer(n)) {
+              checksum += static_cast<uint64_t>(n);
+            }
+          }
+
+          break;
+        case 6: // OBJECT IDENTIFIER.
+          {
+            uint32_t components[asn1::ber::value::max_oid_components];
+            size_t ncomponents;
+            if (val.decode_oid(components, ncomponents)) {
+              checksum += components[ncomponents - 1];
+            }
+          }
+
+          break;
+        case 23: // UTCTime.
+          {
+            time_t t;
+            if (val.decode_utc_time(t)) {
+              checksum += t;
+            }
+          }
+
+          break;
+        case 24: // GeneralizedTime.
+          {
+            struct timeval tv;
+            if (val.decode_generalized_time(tv)) {
+              checksum += tv.tv_sec + tv.tv_usec;
+            }
+          }
+
+          break;
+      }
+    }
+  }
+}
+
+size_t bench_decode(const corpus& corpus,
+                    uint64_t& checksum,
+                    size_t& bytes)
+{
+  asn1::ber::decoder decoder(corpus.data.data(), corpus.data.length());
+
+  decode(decoder, checksum);
+
+  bytes = corpus.data.length();
+
+  return corpus.nrecords;
+}
+
+size_t bench_batch_integers(const corpus& corpus,
+                            uint64_t& checksum,
+                            size_t& bytes)
+{
+  static constexpr const size_t batch_size = 256;
+
+  int64_t out[batch_size];
+  bool valid[batch_size];
+
+  bytes = 0;
+
+  for (size_t i = 0; i < corpus.nintegers; i += batch_size) {
+    const size_t n = (corpus.nintegers - i < batch_size) ?
+                       corpus.nintegers - i :
+                       batch_size;
+
+    asn1::ber::value::decode_integers(corpus.integers + i, n, out, valid);
+
+    for (size_t j = 0; j < n; j++) {
+      checksum += valid[j] ? static_cast<uint64_t>(out[j]) : 0;
+      bytes += corpus.integers[i + j].total_length();
+    }
+  }
+
+  return corpus.nintegers;
+}
+
+size_t bench_printer(const corpus& corpus,
+                     uint64_t& checksum,
+                     size_t& bytes)
+{
+  const uint8_t* const data = static_cast<const uint8_t*>(corpus.data.data());
+  const size_t len = corpus.data.length();
+
+  // Redirect the standard output to /dev/null.
+  fflush(stdout);
+
+  const int out = dup(STDOUT_FILENO);
+  if (out == -1) {
+    return 0;
+  }
+
+  const int null = open("/dev/null", O_WRONLY);
+  if (null == -1) {
+    close(out);
+    return 0;
+  }
+
+  dup2(null, STDOUT_FILENO);
+  close(null);
+
+  asn1::ber::printer printer;
+
+  size_t nrecords = 0;
+
+  for (size_t offset = 0; offset < len; nrecords++) {
+    size_t reclen = len - offset;
+    if (!printer.print(offset, data + offset, reclen)) {
+      break;
+    }
+
+    offset += reclen;
+  }
+
+  checksum += nrecords;
+
+  // Restore the standard output.
+  printer.flush();
+  fflush(stdout);
+
+  dup2(out, STDOUT_FILENO);
+  close(out);
+
+  bytes = len;
+
+  return nrecords;
+}
+
+size_t bench_json_printer(const corpus& corpus,
+                          uint64_t& checksum,
+                          size_t& bytes)
+{
+  const uint8_t* const data = static_cast<const uint8_t*>(corpus.data.data());
+  const size_t len = corpus.data.length();
+
+  // Redirect the standard output to /dev/null.
+  fflush(stdout);
+
+  const int out = dup(STDOUT_FILENO);
+  if (out == -1) {
+    return 0;
+  }
+
+  const int null = open("/dev/null", O_WRONLY);
+  if (null == -1) {
+    close(out);
+    return 0;
+  }
+
+  dup2(null, STDOUT_FILENO);
+  close(null);
+
+  asn1::ber::json_printer printer;
+
+  size_t nrecords = 0;
+
+  for (size_t offset = 0; offset < len; nrecords++) {
+    size_t reclen = len - offset;
+    if (!printer.print(offset, data + offset, reclen)) {
+      break;
+    }
+
+    offset += reclen;
+  }
+
+  checksum += nrecords;
+
+  // Restore the standard output.
+  printer.flush();
+  fflush(stdout);
+
+  dup2(out, STDOUT_FILENO);
+  close(out);
+
+  bytes = len;
+
+  return nrecords;
+}
@@ -0,0 +1,1134 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <atomic>
+#include <new>
+#include "asn1/ber/server.h"
+#include "asn1/ber/encoder.h"
+#include "asn1/ber/header.h"
+#include "asn1/ber/sinks/file.h"
+#include "asn1/ber/sinks/null.h"
+#include "asn1/ber/sinks/tcp.h"
+#include "asn1/ber/sinks/shm.h"
+#include "util/histogram.h"
+
+// Default address of the server.
+static constexpr const char* default_address = "127.0.0.1:24680";
+
+// Default duration of each run (seconds).
+static constexpr const uint64_t default_duration = 5;
+
+// Default mix of payload sizes.
+static constexpr const char* default_mix = "64:60,512:30,4096:10";
+
+// Maximum number of values of a list (workers, connections, ...).
+static constexpr const size_t max_list = 16;
+
+// Maximum number of connections.
+static constexpr const size_t max_connections = 64 * 1024;
+
+// Maximum number of client threads.
+static constexpr const size_t max_threads = 256;
+
+// Maximum payload size.
+static constexpr const size_t max_payload = 1024 * 1024;
+
+// Size of the chunk of records of a client thread.
+static constexpr const size_t chunk_size = 64 * 1024;
+
+// Maximum age of the files of the file sink (seconds).
+static constexpr const time_t file_age = 60;
+
+// Time without progress after which the records still in flight are
+// considered lost (microseconds).
+static constexpr const uint64_t drain_timeout = 500 * 1000;
+
+// Record template.
+//
+// SEQUENCE {
+//   [0] IMPLICIT OCTET STRING (SIZE (8)), -- Send time (microseconds, big
+//                                         -- endian).
+//   [1] IMPLICIT OCTET STRING             -- Payload.
+// }
+struct record_template {
+  string::buffer data;
+
+  // Offset of the send time.
+  size_t timestamp;
+
+  // Weight.
+  unsigned weight;
+};
+
+// Record of a chunk.
+struct record {
+  // Offset of the record in the chunk.
+  size_t offset;
+
+  // Offset of the send time in the chunk.
+  size_t timestamp;
+};
+
+// Probe sink.
+//
+// Counts the records and measures the latency between the write() of the
+// client and the delivery of the record to the sinks.
+class probe : public asn1::ber::sinks::sink {
+  public:
+    // Constructor.
+    probe() = default;
+
+    // Destructor.
+    ~probe() = default;
+
+    // Get name.
+    const char* name() const;
+
+    // Open.
+    bool open(size_t nworkers);
+
+    // Begin batch.
+    bool begin(size_t nworker, time_t now);
+
+    // Append record.
+    bool append(size_t nworker, const void* buf, size_t len);
+
+    // Flush.
+    bool flush(size_t nworker);
+
+    // Rotate.
+    bool rotate(size_t nworker, time_t now);
+
+    // Close.
+    void close();
+
+    // Get number of records.
+    uint64_t records() const;
+
+    // Get number of bytes.
+    uint64_t bytes() const;
+
+    // Get latencies (microseconds).
+    const util::histogram& latencies() const;
+
+  private:
+    // Number of records.
+    util::counter _M_records;
+
+    // Number of bytes.
+    util::counter _M_bytes;
+
+    // Latencies.
+    util::histogram _M_latencies;
+
+    // Time of the delivery of the current batch.
+    uint64_t _M_now = 0;
+
+    // Disable copy constructor and assignment operator.
+    probe(const probe&) = delete;
+    probe& operator=(const probe&) = delete;
+};
+
+inline const char* probe::name() const
+{
+  return "probe";
+}
+
+inline bool probe::open(size_t nworkers)
+{
+  return true;
+}
+
+inline bool probe::begin(size_t nworker, time_t now)
+{
+  _M_now = util::clock::monotonic();
+  return true;
+}
+
+bool probe::append(size_t nworker, const void* buf, size_t len)
+{
+  const uint8_t* const data = static_cast<const uint8_t*>(buf);
+
+  // Decode the header of the record and the header of the send time.
+  size_t offset = 0;
+  asn1::ber::header hdr;
+  if ((hdr.decode(data, len, offset) ==
+       asn1::ber::decoder::result::no_error) &&
+      (hdr.decode(data, len, offset) ==
+       asn1::ber::decoder::result::no_error) &&
+      (hdr.tag_class == asn1::ber::tag_class::ContextSpecific) &&
+      (hdr.tag_number == 0) &&
+      (hdr.length == 8) &&
+      (offset + 8 <= len)) {
+    uint64_t sent = 0;
+    for (size_t i = 0; i < 8; i++) {
+      sent = (sent << 8) | data[offset + i];
+    }
+
+    _M_latencies.record((_M_now > sent) ? _M_now - sent : 0);
+  }
+
+  _M_records.add();
+  _M_bytes.add(len);
+
+  return true;
+}
+
+inline bool probe::flush(size_t nworker)
+{
+  return true;
+}
+
+inline bool probe::rotate(size_t nworker, time_t now)
+{
+  return true;
+}
+
+inline void probe::close()
+{
+}
+
+inline uint64_t probe::records() const
+{
+  return _M_records.get();
+}
+
+inline uint64_t probe::bytes() const
+{
+  return _M_bytes.get();
+}
+
+inline const util::histogram& probe::latencies() const
+{
+  return _M_latencies;
+}
+
+// Client thread.
+struct client {
+  // Number of connections.
+  size_t nconnections;
+
+  // Socket descriptors.
+  int* fds;
+
+  // Target rate (records per second, 0: as fast as possible).
+  uint64_t rate;
+
+  // Chunk of records (sent in a loop).
+  string::buffer chunk;
+
+  record* records;
+  size_t nrecords;
+
+  // Number of records and bytes sent.
+  uint64_t sent_records;
+  uint64_t sent_bytes;
+
+  // CPU time (microseconds).
+  uint64_t cpu;
+
+  // Error?
+  bool error;
+
+  // Thread id.
+  pthread_t thread;
+};
+
+// Options.
+struct options {
+  net::socket::address addr;
+  const char* address = default_address;
+
+  size_t workers[max_list];
+  size_t nworkers = 0;
+
+  size_t connections[max_list];
+  size_t nconnections = 0;
+
+  size_t nthreads = 1;
+
+  const char* sinks[max_list];
+  size_t nsinks = 0;
+
+  record_template templates[max_list];
+  size_t ntemplates = 0;
+
+  unsigned total_weight = 0;
+
+  uint64_t rate = 0;
+
+  uint64_t duration = default_duration;
+};
+
+// Synchronization of the client threads.
+static std::atomic<bool> start_clients;
+static std::atomic<bool> stop_clients;
+
+static void usage(const char* program);
+static bool parse_arguments(int argc, const char* argv[], options& opts);
+static bool parse_number(const char* s,
+                         size_t len,
+                         uint64_t min,
+                         uint64_t max,
+                         uint64_t& n);
+
+static bool parse_list(const char* s,
+                       uint64_t min,
+                       uint64_t max,
+                       size_t* list,
+                       size_t& n);
+
+static bool parse_mix(const char* s, options& opts);
+
+static bool add_sinks(const char* s, asn1::ber::server& server);
+
+static bool run(const options& opts,
+                size_t nworkers,
+                size_t nconnections,
+                const char* sinks);
+
+int main(int argc, const char* argv[])
+{
+  options opts;
+  if (parse_arguments(argc, argv, opts)) {
+    for (size_t s = 0; s < opts.nsinks; s++) {
+      for (size_t w = 0; w < opts.nworkers; w++) {
+        for (size_t c = 0; c < opts.nconnections; c++) {
+          if (!run(opts, opts.workers[w], opts.connections[c], opts.sinks[s])) {
+            return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+    return EXIT_SUCCESS;
+  }
+
+  usage(argv[0]);
+
+  return EXIT_FAILURE;
+}
+
+void usage(const char* program)
+{
+  fprintf(stderr,
+          "Usage: %s "
+          "[-a <ip-port>] "
+          "[-w <number-workers>[,<number-workers>]*] "
+          "[-c <number-connections>[,<number-connections>]*] "
+          "[-t <number-client-threads>] "
+          "[-k <sinks>]* "
+          "[-m <size>:<weight>[,<size>:<weight>]*] "
+          "[-r <records-per-second>] "
+          "[-d <seconds>]\n",
+          program);
+
+  fprintf(stderr, "<sinks> ::= <sink>[+<sink>]*\n");
+  fprintf(stderr,
+          "<sink> ::= file:<temp-dir>:<final-dir> | [lossy:]<lossy-sink>\n");
+  fprintf(stderr,
+          "<lossy-sink> ::= null | tcp:<ip-port> | shm:<name>:<size>\n");
+
+  fprintf(stderr, "\n");
+  fprintf(stderr, "Address: default: %s.\n", default_address);
+  fprintf(stderr,
+          "Number of workers: 1 .. %zu, default: %zu.\n",
+          net::tcp::receiver::max_workers,
+          net::tcp::receiver::default_workers);
+
+  fprintf(stderr,
+          "Number of connections: 1 .. %zu, default: 1.\n",
+          max_connections);
+
+  fprintf(stderr,
+          "Number of client threads: 1 .. %zu, default: 1.\n",
+          max_threads);
+
+  fprintf(stderr, "Sinks: default: null.\n");
+  fprintf(stderr,
+          "Mix of payload sizes: sizes 0 .. %zu, default: %s.\n",
+          max_payload,
+          default_mix);
+
+  fprintf(stderr,
+          "Records per second: 0 (as fast as possible) .. , default: 0.\n");
+
+  fprintf(stderr,
+          "Duration of each run: default: %llu seconds.\n",
+          static_cast<unsigned long long>(default_duration));
+
+  fprintf(stderr,
+          "\nOne run per combination of sinks, number of workers and number "
+          "of connections.\n");
+}
+
+bool parse_arguments(int argc, const char* argv[], options& opts)
+{
+  const char* mix = default_mix;
+
+  for (int i = 1; i < argc; i += 2) {
+    // If not the last argument...
+    if ((argv[i][0] == '-') &&
+        (argv[i][1] != 0) &&
+        (argv[i][2] == 0) &&
+        (i + 1 < argc)) {
+      const char* const arg = argv[i + 1];
+
+      uint64_t n;
+      switch (argv[i][1]) {
+        case 'a':
+          opts.address = arg;
+          break;
+        case 'w':
+          if (!parse_list(arg,
+                          1,
+                          net::tcp::receiver::max_workers,
+                          opts.workers,
+                          opts.nworkers)) {
+            fprintf(stderr, "Invalid number of workers '%s'.\n", arg);
+            return false;
+          }
+
+          break;
+        case 'c':
+          if (!parse_list(arg,
+                          1,
+                          max_connections,
+                          opts.connections,
+                          opts.nconnections)) {
+            fprintf(stderr, "Invalid number of connections '%s'.\n", arg);
+            return false;
+          }
+
+          break;
+        case 't':
+          if (parse_number(arg, strlen(arg), 1, max_threads, n)) {
+            opts.nthreads = static_cast<size_t>(n);
+          } else {
+            fprintf(stderr, "Invalid number of client threads '%s'.\n", arg);
+            return false;
+          }
+
+          break;
+        case 'k':
+          if (opts.nsinks < max_list) {
+            opts.sinks[opts.nsinks++] = arg;
+          } else {
+            fprintf(stderr, "Too many sinks.\n");
+            return false;
+          }
+
+          break;
+        case 'm':
+          mix = arg;
+          break;
+        case 'r':
+          if (parse_number(arg, strlen(arg), 0, ULLONG_MAX, n)) {
+            opts.rate = n;
+          } else {
+            fprintf(stderr, "Invalid number of records per second '%s'.\n", arg);
+            return false;
+          }
+
+          break;
+        case 'd':
+          if (parse_number(arg, strlen(arg), 1, 24 * 3600, n)) {
+            opts.duration = n;
+          } else {
+            fprintf(stderr, "Invalid duration '%s'.\n", arg);
+            return false;
+          }
+
+          break;
+        default:
+          return false;
+      }
+    } else {
+      return false;
+    }
+  }
+
+  // Set default values.
+  if (opts.nworkers == 0) {
+    opts.workers[opts.nworkers++] = net::tcp::receiver::default_workers;
+  }
+
+  if (opts.nconnections == 0) {
+    opts.connections[opts.nconnections++] = 1;
+  }
+
+  if (opts.nsinks == 0) {
+    opts.sinks[opts.nsinks++] = "null";
+  }
+
+  if (!opts.addr.build(opts.address)) {
+    fprintf(stderr, "Invalid address '%s'.\n", opts.address);
+    return false;
+  }
+
+  return parse_mix(mix, opts);
+}
+
+bool parse_number(const char* s,
+                  size_t len,
+                  uint64_t min,
+                  uint64_t max,
+                  uint64_t& n)
+{
+  if (len > 0) {
+    uint64_t res = 0;
+    for (size_t i = 0; i < len; i++) {
+      if ((s[i] >= '0') && (s[i] <= '9')) {
+        const uint64_t tmp = (res * 10) + (s[i] - '0');
+
+        // If the number is not too big...
+        if (tmp >= res) {
+          res = tmp;
+        } else {
+          return false;
+        }
+      } else {
+        return false;
+      }
+    }
+
+    if ((res >= min) && (res <= max)) {
+      n = res;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool parse_list(const char* s,
+                uint64_t min,
+                uint64_t max,
+                size_t* list,
+                size_t& n)
+{
+  n = 0;
+
+  do {
+    const char* const comma = strchr(s, ',');
+    const size_t len = comma ? comma - s : strlen(s);
+
+    uint64_t val;
+    if ((n < max_list) && (parse_number(s, len, min, max, val))) {
+      list[n++] = static_cast<size_t>(val);
+
+      if (comma) {
+        s = comma + 1;
+      } else {
+        return true;
+      }
+    } else {
+      return false;
+    }
+  } while (true);
+}
+
+bool parse_mix(const char* s, options& opts)
+{
+  static uint8_t payload[max_payload];
+  memset(payload, 'x', sizeof(payload));
+
+  do {
+    const char* const comma = strchr(s, ',');
+    const size_t len = comma ? comma - s : strlen(s);
+
+    const char* const colon = static_cast<const char*>(memchr(s, ':', len));
+
+    uint64_t size, weight;
+    if ((opts.ntemplates < max_list) &&
+        (colon) &&
+        (parse_number(s, colon - s, 0, max_payload, size)) &&
+        (parse_number(colon + 1, s + len - (colon + 1), 1, 1000000, weight))) {
+      record_template& templ = opts.templates[opts.ntemplates];
+
+      // Encode record.
+      static const uint8_t timestamp[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+      asn1::ber::encoder encoder;
+      if ((!encoder.start_constructed(asn1::ber::tag_class::Universal, 16)) ||
+          (!encoder.add_data(asn1::ber::tag_class::ContextSpecific,
+                             0,
+                             timestamp,
+                             sizeof(timestamp),
+                             asn1::ber::encoder::copy::shallow)) ||
+          (!encoder.add_data(asn1::ber::tag_class::ContextSpecific,
+                             1,
+                             payload,
+                             size,
+                             asn1::ber::encoder::copy::shallow)) ||
+          (!encoder.end_constructed()) ||
+          (!encoder.serialize(templ.data))) {
+        fprintf(stderr, "Error encoding record.\n");
+        return false;
+      }
+
+      // Find the send time.
+      const uint8_t* const data = static_cast<const uint8_t*>(templ.data.data());
+
+      size_t offset = 0;
+      asn1::ber::header hdr;
+      hdr.decode(data, templ.data.length(), offset);
+      hdr.decode(data, templ.data.length(), offset);
+
+      templ.timestamp = offset;
+      templ.weight = static_cast<unsigned>(weight);
+
+      opts.total_weight += templ.weight;
+      opts.ntemplates++;
+
+      if (comma) {
+        s = comma + 1;
+      } else {
+        return true;
+      }
+    } else {
+      fprintf(stderr, "Invalid mix of payload sizes.\n");
+      return false;
+    }
+  } while (true);
+}
+
+bool add_sinks(const char* s, asn1::ber::server& server)
+{
+  do {
+    const char* const plus = strchr(s, '+');
+    const size_t len = plus ? plus - s : strlen(s);
+
+    char sink[PATH_MAX];
+    if (len >= sizeof(sink)) {
+      fprintf(stderr, "Sink is too long.\n");
+      return false;
+    }
+
+    memcpy(sink, s, len);
+    sink[len] = 0;
+
+    asn1::ber::sinks::sink* snk = nullptr;
+
+    // Lossy sink (its batches are dropped when its queue is full)?
+    bool lossy = false;
+    if (strncasecmp(sink, "lossy:", 6) == 0) {
+      lossy = true;
+      memmove(sink, sink + 6, len - 6 + 1);
+    }
+
+    if (strcasecmp(sink, "null") == 0) {
+      snk = new (std::nothrow) asn1::ber::sinks::null();
+    } else if (strncasecmp(sink, "file:", 5) == 0) {
+      if (lossy) {
+        fprintf(stderr, "The file sink cannot be lossy.\n");
+        return false;
+      }
+
+      char* const tempdir = sink + 5;
+
+      // Search separator of the temporary and final directories.
+      char* const colon = strchr(tempdir, ':');
+
+      // If the colon was found...
+      if ((colon) && (colon > tempdir) && (colon[1])) {
+        *colon = 0;
+
+        snk = new (std::nothrow)
+              asn1::ber::sinks::file(tempdir,
+                                     colon + 1,
+                                     asn1::ber::sinks::file::max_file_size,
+                                     file_age);
+      } else {
+        fprintf(stderr, "Expected file:<temp-dir>:<final-dir>.\n");
+        return false;
+      }
+    } else if (strncasecmp(sink, "tcp:", 4) == 0) {
+      net::socket::address addr;
+      if (addr.build(sink + 4)) {
+        snk = new (std::nothrow) asn1::ber::sinks::tcp(addr);
+      } else {
+        fprintf(stderr, "Invalid address '%s'.\n", sink + 4);
+        return false;
+      }
+    } else if (strncasecmp(sink, "shm:", 4) == 0) {
+      char* const name = sink + 4;
+
+      // Search last colon.
+      char* const colon = strrchr(name, ':');
+
+      // If the colon was found...
+      uint64_t n;
+      if ((colon) &&
+          (colon > name) &&
+          (parse_number(colon + 1,
+                        strlen(colon + 1),
+                        asn1::ber::sinks::shm::min_capacity,
+                        asn1::ber::sinks::shm::max_capacity,
+                        n))) {
+        *colon = 0;
+
+        snk = new (std::nothrow) asn1::ber::sinks::shm(name,
+                                                       static_cast<size_t>(n));
+      } else {
+        fprintf(stderr, "Expected shm:<name>:<size>.\n");
+        return false;
+      }
+    } else {
+      fprintf(stderr, "Invalid sink '%s'.\n", sink);
+      return false;
+    }
+
+    if (!server.add_sink(snk, lossy)) {
+      fprintf(stderr, "Error adding sink '%s'.\n", sink);
+      return false;
+    }
+
+    if (plus) {
+      s = plus + 1;
+    } else {
+      return true;
+    }
+  } while (true);
+}
+
+// Pseudo-random number generator (xorshift32).
+static inline uint32_t random_number(uint32_t& state)
+{
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+
+  return state;
+}
+
+// Build the chunk of records of a client.
+static bool build_chunk(client& client, const options& opts, uint32_t seed)
+{
+  size_t size = 0;
+
+  do {
+    // Choose record template.
+    unsigned w = random_number(seed) % opts.total_weight;
+
+    size_t i;
+    for (i = 0; w >= opts.templates[i].weight; i++) {
+      w -= opts.templates[i].weight;
+    }
+
+    const record_template& templ = opts.templates[i];
+
+    // If the array of records is full...
+    if (client.nrecords == size) {
+      size = (size == 0) ? 256 : size * 2;
+
+      record* const records = static_cast<record*>(
+                                realloc(client.records, size * sizeof(record))
+                              );
+
+      if (!records) {
+        return false;
+      }
+
+      client.records = records;
+    }
+
+    record* const rec = &client.records[client.nrecords++];
+
+    rec->offset = client.chunk.length();
+    rec->timestamp = rec->offset + templ.timestamp;
+
+    if (!client.chunk.append(templ.data)) {
+      return false;
+    }
+  } while (client.chunk.length() < chunk_size);
+
+  return true;
+}
+
+// Write all the data.
+static bool write_all(int fd, const uint8_t* data, size_t len)
+{
+  while (len > 0) {
+    const ssize_t ret = send(fd, data, len, MSG_NOSIGNAL);
+    if (ret > 0) {
+      data += ret;
+      len -= ret;
+    } else if ((ret < 0) && (errno != EINTR)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Get CPU time of the calling thread (microseconds).
+static uint64_t thread_cpu_time()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+
+  return (static_cast<uint64_t>(ts.tv_sec) * 1000000ull) + (ts.tv_nsec / 1000);
+}
+
+// Get CPU time of the process (microseconds).
+static uint64_t process_cpu_time()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  return (static_cast<uint64_t>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) *
+          1000000ull) +
+         usage.ru_utime.tv_usec +
+         usage.ru_stime.tv_usec;
+}
+
+static void* send_records(void* arg)
+{
+  client* const cl = static_cast<client*>(arg);
+
+  uint8_t* const data = static_cast<uint8_t*>(
+                          const_cast<void*>(cl->chunk.data())
+                        );
+
+  const size_t chunklen = cl->chunk.length();
+
+  // Number of records per write (about one write per millisecond if the rate
+  // is limited).
+  size_t batch = cl->nrecords;
+  if (cl->rate > 0) {
+    batch = static_cast<size_t>(cl->rate / 1000);
+    if (batch == 0) {
+      batch = 1;
+    } else if (batch > cl->nrecords) {
+      batch = cl->nrecords;
+    }
+  }
+
+  // Wait for the other clients.
+  while (!start_clients.load()) {
+    sched_yield();
+  }
+
+  const uint64_t start = util::clock::monotonic();
+
+  size_t conn = 0;
+  size_t idx = 0;
+
+  while ((!cl->error) && (!stop_clients.load(std::memory_order_relaxed))) {
+    // Records [idx, end).
+    const size_t end = (idx + batch < cl->nrecords) ? idx + batch :
+                                                      cl->nrecords;
+
+    const size_t from = cl->records[idx].offset;
+    const size_t to = (end < cl->nrecords) ? cl->records[end].offset :
+                                             chunklen;
+
+    // Set send time.
+    const uint64_t now = util::clock::monotonic();
+    for (size_t i = idx; i < end; i++) {
+      uint8_t* const ts = data + cl->records[i].timestamp;
+
+      ts[0] = static_cast<uint8_t>(now >> 56);
+      ts[1] = static_cast<uint8_t>(now >> 48);
+      ts[2] = static_cast<uint8_t>(now >> 40);
+      ts[3] = static_cast<uint8_t>(now >> 32);
+      ts[4] = static_cast<uint8_t>(now >> 24);
+      ts[5] = static_cast<uint8_t>(now >> 16);
+      ts[6] = static_cast<uint8_t>(now >> 8);
+      ts[7] = static_cast<uint8_t>(now);
+    }
+
+    if (write_all(cl->fds[conn], data + from, to - from)) {
+      cl->sent_records += (end - idx);
+      cl->sent_bytes += (to - from);
+
+      if (++conn == cl->nconnections) {
+        conn = 0;
+      }
+
+      idx = (end < cl->nrecords) ? end : 0;
+
+      // If the rate is limited...
+      if (cl->rate > 0) {
+        // Time when the next batch is due.
+        const uint64_t due = start + ((cl->sent_records * 1000000ull) /
+                                      cl->rate);
+
+        const uint64_t t = util::clock::monotonic();
+        if (due > t) {
+          const struct timespec req = {
+            static_cast<time_t>((due - t) / 1000000),
+            static_cast<long>(((due - t) % 1000000) * 1000)
+          };
+
+          nanosleep(&req, nullptr);
+        }
+      }
+    } else {
+      fprintf(stderr, "Error sending data (%s).\n", strerror(errno));
+      cl->error = true;
+    }
+  }
+
+  // Close connections.
+  for (size_t i = 0; i < cl->nconnections; i++) {
+    close(cl->fds[i]);
+  }
+
+  cl->cpu = thread_cpu_time();
+
+  return nullptr;
+}
+
+// Connect.
+static int connect_to(const net::socket::address& addr)
+{
+  const struct sockaddr* const sa = addr;
+
+  const int fd = socket(sa->sa_family, SOCK_STREAM, 0);
+  if (fd != -1) {
+    if (connect(fd, sa, addr.length()) == 0) {
+      return fd;
+    }
+
+    close(fd);
+  }
+
+  return -1;
+}
+
+bool run(const options& opts,
+         size_t nworkers,
+         size_t nconnections,
+         const char* sinks)
+{
+  asn1::ber::server server(nworkers);
+
+  // Add probe sink (the server takes ownership of the sink).
+  probe* const prb = new (std::nothrow) probe();
+  if ((!server.add_sink(prb)) || (!add_sinks(sinks, server))) {
+    return false;
+  }
+
+  if ((!server.listen(opts.address)) || (!server.start())) {
+    fprintf(stderr, "Error starting server on '%s'.\n", opts.address);
+    return false;
+  }
+
+  const size_t nthreads = (opts.nthreads < nconnections) ? opts.nthreads :
+                                                           nconnections;
+
+  client* const clients = new (std::nothrow) client[nthreads];
+  if (!clients) {
+    fprintf(stderr, "Error allocating memory.\n");
+    return false;
+  }
+
+  // Prepare clients.
+  bool ret = true;
+  size_t nclients;
+  for (nclients = 0; nclients < nthreads; nclients++) {
+    client& cl = clients[nclients];
+
+    cl.nconnections = (nconnections / nthreads) +
+                      (nclients < nconnections % nthreads);
+
+    cl.rate = opts.rate / nthreads;
+    if ((opts.rate > 0) && (cl.rate == 0)) {
+      cl.rate = 1;
+    }
+
+    cl.records = nullptr;
+    cl.nrecords = 0;
+    cl.sent_records = 0;
+    cl.sent_bytes = 0;
+    cl.cpu = 0;
+    cl.error = false;
+
+    if (((cl.fds = static_cast<int*>(
+                     malloc(cl.nconnections * sizeof(int))
+                   )) == nullptr) ||
+        (!build_chunk(cl, opts, 2463534242u + nclients))) {
+      free(cl.fds);
+      free(cl.records);
+
+      fprintf(stderr, "Error allocating memory.\n");
+
+      ret = false;
+      break;
+    }
+
+    // Connect.
+    size_t i;
+    for (i = 0; i < cl.nconnections; i++) {
+      if ((cl.fds[i] = connect_to(opts.addr)) == -1) {
+        fprintf(stderr,
+                "Error connecting to '%s' (%s).\n",
+                opts.address,
+                strerror(errno));
+
+        break;
+      }
+    }
+
+    // If not all the connections could be established...
+    if (i < cl.nconnections) {
+      while (i > 0) {
+        close(cl.fds[--i]);
+      }
+
+      free(cl.fds);
+      free(cl.records);
+
+      ret = false;
+      break;
+    }
+  }
+
+  // If the clients are ready...
+  if (ret) {
+    start_clients.store(false);
+    stop_clients.store(false);
+
+    size_t nstarted;
+    for (nstarted = 0; nstarted < nthreads; nstarted++) {
+      if (pthread_create(&clients[nstarted].thread,
+                         nullptr,
+                         send_records,
+                         &clients[nstarted]) != 0) {
+        break;
+      }
+    }
+
+    // If all the threads have been started...
+    if (nstarted == nthreads) {
+      const uint64_t cpu = process_cpu_time();
+
+      start_clients.store(true);
+
+      const uint64_t start = util::clock::monotonic();
+
+      // Let the clients send.
+      const struct timespec req = {static_cast<time_t>(opts.duration), 0};
+      nanosleep(&req, nullptr);
+
+      stop_clients.store(true);
+
+      uint64_t sent_records = 0;
+      uint64_t sent_bytes = 0;
+      uint64_t client_cpu = 0;
+
+      for (size_t i = 0; i < nthreads; i++) {
+        pthread_join(clients[i].thread, nullptr);
+
+        sent_records += clients[i].sent_records;
+        sent_bytes += clients[i].sent_bytes;
+        client_cpu += clients[i].cpu;
+
+        if (clients[i].error) {
+          ret = false;
+        }
+      }
+
+      // Wait for the records in flight.
+      uint64_t end = util::clock::monotonic();
+      uint64_t records = prb->records();
+      while (records < sent_records) {
+        const struct timespec tick = {0, 10 * 1000 * 1000};
+        nanosleep(&tick, nullptr);
+
+        const uint64_t now = util::clock::monotonic();
+        const uint64_t n = prb->records();
+        if (n > records) {
+          records = n;
+          end = now;
+        } else if (now - end >= drain_timeout) {
+          break;
+        }
+      }
+
+      // Stop server (the pending records are processed).
+      server.stop();
+
+      // CPU time of the server.
+      const uint64_t server_cpu = process_cpu_time() - cpu - client_cpu;
+
+      records = prb->records();
+
+      const uint64_t bytes = prb->bytes();
+      const double seconds = static_cast<double>(end - start) / 1000000.0;
+
+      const util::histogram& latencies = prb->latencies();
+
+      printf("{\"workers\":%zu,\"connections\":%zu,\"client_threads\":%zu,"
+             "\"sinks\":\"%s\",\"seconds\":%.3f,\"records_sent\":%llu,"
+             "\"bytes_sent\":%llu,\"records\":%llu,\"bytes\":%llu,"
+             "\"records_per_s\":%.0f,\"mb_per_s\":%.2f,"
+             "\"cpu_us_per_record\":%.3f,\"latency_p50_us\":%llu,"
+             "\"latency_p99_us\":%llu,\"latency_p999_us\":%llu,"
+             "\"latency_max_us\":%llu}\n",
+             nworkers,
+             nconnections,
+             nthreads,
+             sinks,
+             seconds,
+             static_cast<unsigned long long>(sent_records),
+             static_cast<unsigned long long>(sent_bytes),
+             static_cast<unsigned long long>(records),
+             static_cast<unsigned long long>(bytes),
+             static_cast<double>(records) / seconds,
+             (static_cast<double>(bytes) / seconds) / 1000000.0,
+             (records > 0) ?
+               static_cast<double>(server_cpu) / static_cast<double>(records) :
+               0.0,
+             static_cast<unsigned long long>(latencies.quantile(0.5)),
+             static_cast<unsigned long long>(latencies.quantile(0.99)),
+             static_cast<unsigned long long>(latencies.quantile(0.999)),
+             static_cast<unsigned long long>(latencies.max()));
+
+      fflush(stdout);
+    } else {
+      fprintf(stderr, "Error creating client thread.\n");
+
+      // Stop the started threads (they close their connections).
+      stop_clients.store(true);
+      start_clients.store(true);
+
+      for (size_t i = 0; i < nstarted; i++) {
+        pthread_join(clients[i].thread, nullptr);
+      }
+
+      for (size_t i = nstarted; i < nthreads; i++) {
+        for (size_t j = 0; j < clients[i].nconnections; j++) {
+          close(clients[i].fds[j]);
+        }
+      }
+
+      ret = false;
+    }
+  } else {
+    // Close the connections of the prepared clients.
+    for (size_t i = 0; i < nclients; i++) {
+      for (size_t j = 0; j < clients[i].nconnections; j++) {
+        close(clients[i].fds[j]);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < nclients; i++) {
+    free(clients[i].fds);
+    free(clients[i].records);
+  }
+
+  delete [] clients;
+
+  return ret;
+}
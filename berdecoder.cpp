@@ -1,34 +1,218 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <fcntl.h>
 #include <sys/stat.h>
 
 #if !defined(_WIN32)
   #include <unistd.h>
+  #include <pthread.h>
   #include <sys/mman.h>
+  #include <new>
 #else
   #include <windows.h>
 #endif
 
 #include "asn1/ber/printer.h"
+#include "asn1/ber/json_printer.h"
+#include "asn1/ber/framer.h"
+#include "asn1/ber/query.h"
 
-static int process_file(const char* filename);
-static int process_data(const uint8_t* data, size_t len);
+// Output format.
+enum class output_format {
+  text,
+  json,
+  ndjson
+};
+
+static int process_file(const char* filename,
+                        const asn1::ber::query* query,
+                        output_format format,
+                        unsigned nthreads);
+
+static int process_data(const uint8_t* data,
+                        size_t len,
+                        const asn1::ber::query* query,
+                        output_format format,
+                        unsigned nthreads);
+
+// Print the records (`last`: do the records end the data?).
+static bool print_records(const uint8_t* data,
+                          size_t len,
+                          size_t offset,
+                          bool last,
+                          output_format format,
+                          string::buffer* out,
+                          size_t& error_offset);
+
+template<typename Printer>
+static bool print_records(Printer& printer,
+                          const uint8_t* data,
+                          size_t len,
+                          size_t offset,
+                          size_t& error_offset);
+
+// Context of the query matches.
+struct match_context {
+  const uint8_t* data;
+
+  // Printer for the text format.
+  asn1::ber::printer* printer;
+
+  // Printer for the JSON formats (nullptr for the text format).
+  asn1::ber::json_printer* json_printer;
+
+  bool error;
+};
+
+static int run_query(const uint8_t* data,
+                     size_t len,
+                     const asn1::ber::query& query,
+                     output_format format);
+
+static bool print_match(const asn1::ber::value& val,
+                        size_t offset,
+                        void* user);
+
+#if !defined(_WIN32)
+// Maximum number of threads.
+static constexpr const unsigned max_threads = 256;
+
+// Minimum size of the chunks of records printed by each thread.
+static constexpr const size_t chunk_size = 256 * 1024;
+
+// Number of chunks per thread whose output can be pending.
+static constexpr const size_t slots_per_thread = 2;
+
+// Chunk of records.
+struct chunk {
+  size_t offset;
+  size_t length;
+};
+
+// Output of a chunk.
+struct slot {
+  string::buffer out;
+
+  // Has the chunk been printed?
+  bool done;
+
+  // Error?
+  bool error;
+  size_t error_offset;
+};
+
+// Context of the threads.
+struct parallel_context {
+  const uint8_t* data;
+
+  const chunk* chunks;
+  size_t nchunks;
+
+  output_format format;
+
+  slot* slots;
+  size_t nslots;
+
+  // Index of the next chunk to be printed.
+  size_t next;
+
+  // Number of chunks whose output has been written.
+  size_t written;
+
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+};
+
+static int process_data_parallel(const uint8_t* data,
+                                 size_t len,
+                                 output_format format,
+                                 unsigned nthreads);
+
+static bool split(const uint8_t* data,
+                  size_t len,
+                  chunk*& chunks,
+                  size_t& nchunks);
+
+static void* run(void* arg);
+#endif // !defined(_WIN32)
 
 int main(int argc, const char* argv[])
 {
-  if (argc == 2) {
-    // Process file.
-    return process_file(argv[1]);
+  const char* path = nullptr;
+  output_format format = output_format::text;
+  unsigned nthreads = 1;
+
+  // Parse options.
+  int i = 1;
+  while (i + 2 < argc) {
+    if (strcmp(argv[i], "-q") == 0) {
+      path = argv[i + 1];
+    } else if (strcmp(argv[i], "-f") == 0) {
+      if (strcmp(argv[i + 1], "text") == 0) {
+        format = output_format::text;
+      } else if (strcmp(argv[i + 1], "json") == 0) {
+        format = output_format::json;
+      } else if (strcmp(argv[i + 1], "ndjson") == 0) {
+        format = output_format::ndjson;
+      } else {
+        fprintf(stderr, "Invalid output format '%s'.\n", argv[i + 1]);
+        return EXIT_FAILURE;
+      }
+#if !defined(_WIN32)
+    } else if (strcmp(argv[i], "-j") == 0) {
+      char* end;
+      const unsigned long n = strtoul(argv[i + 1], &end, 10);
+      if ((*end) || (n < 1) || (n > max_threads)) {
+        fprintf(stderr, "Invalid number of threads '%s'.\n", argv[i + 1]);
+        return EXIT_FAILURE;
+      }
+
+      nthreads = static_cast<unsigned>(n);
+#endif // !defined(_WIN32)
+    } else {
+      break;
+    }
+
+    i += 2;
+  }
+
+  if (i == argc - 1) {
+    // If a query has been given...
+    if (path) {
+      // Compile query.
+      asn1::ber::query query;
+      if (query.compile(path)) {
+        // Process file.
+        return process_file(argv[i], &query, format, nthreads);
+      } else {
+        fprintf(stderr, "Invalid query '%s'.\n", path);
+      }
+    } else {
+      // Process file.
+      return process_file(argv[i], nullptr, format, nthreads);
+    }
   } else {
-    fprintf(stderr, "Usage: %s <filename>\n", argv[0]);
+#if !defined(_WIN32)
+    fprintf(stderr,
+            "Usage: %s [-f text|json|ndjson] [-j <number-threads>] "
+            "[-q <path>] <filename>\n",
+            argv[0]);
+#else
+    fprintf(stderr,
+            "Usage: %s [-f text|json|ndjson] [-q <path>] <filename>\n",
+            argv[0]);
+#endif
   }
 
   return EXIT_FAILURE;
 }
 
 #if !defined(_WIN32)
-int process_file(const char* filename)
+int process_file(const char* filename,
+                 const asn1::ber::query* query,
+                 output_format format,
+                 unsigned nthreads)
 {
   // If the file exists and is a regular file...
   struct stat sbuf;
@@ -50,7 +234,10 @@ int process_file(const char* filename)
       if (base != MAP_FAILED) {
         // Process data.
         const int ret = process_data(static_cast<const uint8_t*>(base),
-                                     static_cast<size_t>(sbuf.st_size));
+                                     static_cast<size_t>(sbuf.st_size),
+                                     query,
+                                     format,
+                                     nthreads);
 
         munmap(base, sbuf.st_size);
 
@@ -74,7 +261,10 @@ int process_file(const char* filename)
   return EXIT_FAILURE;
 }
 #else
-int process_file(const char* filename)
+int process_file(const char* filename,
+                 const asn1::ber::query* query,
+                 output_format format,
+                 unsigned nthreads)
 {
   // If the file exists and is a regular file...
   struct _stat64 sbuf;
@@ -112,7 +302,10 @@ int process_file(const char* filename)
         if (base) {
           // Process data.
           const int ret = process_data(static_cast<const uint8_t*>(base),
-                                       static_cast<size_t>(sbuf.st_size));
+                                       static_cast<size_t>(sbuf.st_size),
+                                       query,
+                                       format,
+                                       nthreads);
 
           UnmapViewOfFile(base);
           CloseHandle(hMapFile);
@@ -144,13 +337,81 @@ int process_file(const char* filename)
 }
 #endif
 
-int process_data(const uint8_t* data, size_t len)
+int process_data(const uint8_t* data,
+                 size_t len,
+                 const asn1::ber::query* query,
+                 output_format format,
+                 unsigned nthreads)
 {
-  size_t offset = 0;
+  // If a query has been given...
+  if (query) {
+    return run_query(data, len, *query, format);
+  }
+
+#if !defined(_WIN32)
+  // If the data values have to be printed by several threads...
+  if (nthreads > 1) {
+    return process_data_parallel(data, len, format, nthreads);
+  }
+#endif
+
+  // Print data values.
+  size_t error_offset;
+  if (print_records(data, len, 0, true, format, nullptr, error_offset)) {
+    return EXIT_SUCCESS;
+  }
+
+  fprintf(stderr, "Error decoding ASN.1 data (offset: %zu).\n", error_offset);
+
+  return EXIT_FAILURE;
+}
+
+bool print_records(const uint8_t* data,
+                   size_t len,
+                   size_t offset,
+                   bool last,
+                   output_format format,
+                   string::buffer* out,
+                   size_t& error_offset)
+{
+  // Text?
+  if (format == output_format::text) {
+    asn1::ber::printer printer;
+    printer.output(out);
+
+    return print_records(printer, data, len, offset, error_offset);
+  }
+
+  asn1::ber::json_printer printer(format == output_format::json);
+  printer.output(out);
+
+  // If the records are the first records of the data...
+  if (offset == 0) {
+    printer.begin();
+  } else {
+    // The records continue the output of the previous records.
+    printer.separator(true);
+  }
+
+  const bool ret = print_records(printer, data, len, offset, error_offset);
+
+  // If the records end the output (last records of the data or error)...
+  if ((last) || (!ret)) {
+    printer.end();
+  }
+
+  return ret;
+}
 
+template<typename Printer>
+bool print_records(Printer& printer,
+                   const uint8_t* data,
+                   size_t len,
+                   size_t offset,
+                   size_t& error_offset)
+{
   do {
     // Print data value.
-    asn1::ber::printer printer;
     size_t l = len;
     if (printer.print(offset, data, l)) {
       data += l;
@@ -158,16 +419,288 @@ int process_data(const uint8_t* data, size_t len)
 
       offset += l;
     } else {
-      // End of the file?
+      // End of the data?
       if (printer.eof()) {
-        return EXIT_SUCCESS;
+        return true;
       } else {
+        error_offset = offset;
+        return false;
+      }
+    }
+  } while (true);
+}
+
+#if !defined(_WIN32)
+int process_data_parallel(const uint8_t* data,
+                          size_t len,
+                          output_format format,
+                          unsigned nthreads)
+{
+  // Split the data in chunks of records.
+  chunk* chunks;
+  size_t nchunks;
+  if (!split(data, len, chunks, nchunks)) {
+    fprintf(stderr, "Error allocating memory.\n");
+    return EXIT_FAILURE;
+  }
+
+  if (nthreads > nchunks) {
+    nthreads = static_cast<unsigned>(nchunks);
+  }
+
+  parallel_context ctx;
+  ctx.data = data;
+  ctx.chunks = chunks;
+  ctx.nchunks = nchunks;
+  ctx.format = format;
+  ctx.nslots = nthreads * slots_per_thread;
+  ctx.next = 0;
+  ctx.written = 0;
+
+  if ((ctx.slots = new (std::nothrow) slot[ctx.nslots]) == nullptr) {
+    fprintf(stderr, "Error allocating memory.\n");
+
+    free(chunks);
+    return EXIT_FAILURE;
+  }
+
+  for (size_t i = 0; i < ctx.nslots; i++) {
+    ctx.slots[i].done = false;
+  }
+
+  pthread_mutex_init(&ctx.mutex, nullptr);
+  pthread_cond_init(&ctx.cond, nullptr);
+
+  // Start threads.
+  pthread_t threads[max_threads];
+  unsigned nstarted;
+  for (nstarted = 0; nstarted < nthreads; nstarted++) {
+    if (pthread_create(&threads[nstarted], nullptr, run, &ctx) != 0) {
+      break;
+    }
+  }
+
+  int ret = EXIT_SUCCESS;
+
+  // If at least one thread could be started...
+  if (nstarted > 0) {
+    // Write the output of the chunks in the original order.
+    for (size_t i = 0; i < nchunks; i++) {
+      slot& s = ctx.slots[i % ctx.nslots];
+
+      // Wait for the chunk to be printed.
+      pthread_mutex_lock(&ctx.mutex);
+
+      while (!s.done) {
+        pthread_cond_wait(&ctx.cond, &ctx.mutex);
+      }
+
+      pthread_mutex_unlock(&ctx.mutex);
+
+      fwrite(s.out.data(), 1, s.out.length(), stdout);
+
+      const bool error = s.error;
+
+      pthread_mutex_lock(&ctx.mutex);
+
+      // If the chunk couldn't be printed, the next chunks are not printed.
+      if (error) {
+        ctx.next = nchunks;
+      }
+
+      // Free the slot.
+      s.done = false;
+      ctx.written++;
+
+      pthread_cond_broadcast(&ctx.cond);
+      pthread_mutex_unlock(&ctx.mutex);
+
+      if (error) {
+        fflush(stdout);
+
         fprintf(stderr,
                 "Error decoding ASN.1 data (offset: %zu).\n",
-                offset);
+                s.error_offset);
 
-        return EXIT_FAILURE;
+        ret = EXIT_FAILURE;
+        break;
+      }
+    }
+  } else {
+    fprintf(stderr, "Error creating threads.\n");
+    ret = EXIT_FAILURE;
+  }
+
+  // Wait for the threads to finish.
+  for (unsigned i = 0; i < nstarted; i++) {
+    pthread_join(threads[i], nullptr);
+  }
+
+  pthread_cond_destroy(&ctx.cond);
+  pthread_mutex_destroy(&ctx.mutex);
+
+  delete [] ctx.slots;
+  free(chunks);
+
+  return ret;
+}
+
+bool split(const uint8_t* data, size_t len, chunk*& chunks, size_t& nchunks)
+{
+  chunks = nullptr;
+  nchunks = 0;
+
+  size_t size = 0;
+
+  // Frame the records.
+  asn1::ber::framer framer(data, len);
+
+  size_t start = 0;
+  bool last = false;
+
+  do {
+    size_t l;
+    if (framer.next(l) == asn1::ber::decoder::result::no_error) {
+      // If the chunk is not big enough yet...
+      if (framer.offset() - start < chunk_size) {
+        continue;
       }
+    } else {
+      // The last chunk contains the rest of the data (the records after the
+      // previous chunk and the data which couldn't be framed, if any).
+      last = true;
     }
+
+    // If the array of chunks is full...
+    if (nchunks == size) {
+      size = (size == 0) ? 64 : size * 2;
+
+      chunk* const c = static_cast<chunk*>(
+                         realloc(chunks, size * sizeof(chunk))
+                       );
+
+      if (!c) {
+        free(chunks);
+        return false;
+      }
+
+      chunks = c;
+    }
+
+    chunks[nchunks].offset = start;
+    chunks[nchunks].length = last ? len - start : framer.offset() - start;
+
+    nchunks++;
+
+    start = framer.offset();
+  } while (!last);
+
+  return true;
+}
+
+void* run(void* arg)
+{
+  parallel_context& ctx = *static_cast<parallel_context*>(arg);
+
+  pthread_mutex_lock(&ctx.mutex);
+
+  do {
+    // Wait until the slot of the next chunk is free.
+    while ((ctx.next < ctx.nchunks) &&
+           (ctx.next >= ctx.written + ctx.nslots)) {
+      pthread_cond_wait(&ctx.cond, &ctx.mutex);
+    }
+
+    // If there are no chunks left...
+    if (ctx.next == ctx.nchunks) {
+      break;
+    }
+
+    const chunk& c = ctx.chunks[ctx.next];
+    slot& s = ctx.slots[ctx.next % ctx.nslots];
+
+    const bool last = (ctx.next == ctx.nchunks - 1);
+
+    ctx.next++;
+
+    pthread_mutex_unlock(&ctx.mutex);
+
+    // Print the records of the chunk into the slot.
+    s.out.clear();
+    s.error = !print_records(ctx.data + c.offset,
+                             c.length,
+                             c.offset,
+                             last,
+                             ctx.format,
+                             &s.out,
+                             s.error_offset);
+
+    pthread_mutex_lock(&ctx.mutex);
+
+    s.done = true;
+
+    pthread_cond_broadcast(&ctx.cond);
   } while (true);
+
+  pthread_mutex_unlock(&ctx.mutex);
+
+  return nullptr;
+}
+#endif // !defined(_WIN32)
+
+int run_query(const uint8_t* data,
+              size_t len,
+              const asn1::ber::query& query,
+              output_format format)
+{
+  asn1::ber::printer printer;
+  asn1::ber::json_printer json_printer(format == output_format::json);
+
+  match_context ctx;
+  ctx.data = data;
+  ctx.printer = &printer;
+  ctx.json_printer = (format != output_format::text) ? &json_printer : nullptr;
+  ctx.error = false;
+
+  if (ctx.json_printer) {
+    json_printer.begin();
+  }
+
+  // Run query.
+  const bool ret = ((query.run(data, len, print_match, &ctx)) && (!ctx.error));
+
+  if (ctx.json_printer) {
+    json_printer.end();
+  }
+
+  if (ret) {
+    return EXIT_SUCCESS;
+  } else {
+    if (!ctx.error) {
+      fprintf(stderr, "Error decoding ASN.1 data.\n");
+    }
+
+    return EXIT_FAILURE;
+  }
+}
+
+bool print_match(const asn1::ber::value& val, size_t offset, void* user)
+{
+  match_context* const ctx = static_cast<match_context*>(user);
+
+  // Print data value.
+  size_t l = val.total_length();
+  if (ctx->json_printer) {
+    if (ctx->json_printer->print(offset, ctx->data + offset, l)) {
+      return true;
+    }
+  } else if (ctx->printer->print(offset, ctx->data + offset, l)) {
+    return true;
+  }
+
+  fprintf(stderr, "Error decoding ASN.1 data (offset: %zu).\n", offset);
+
+  ctx->error = true;
+
+  return false;
 }
@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include "net/http/endpoint.h"
+#include "net/socket/address.h"
+
+net::http::endpoint::~endpoint()
+{
+  // Stop endpoint (if running).
+  stop();
+}
+
+bool net::http::endpoint::start(const char* address,
+                                handler_t handler,
+                                void* user)
+{
+  // Listen.
+  if (listen(address)) {
+    // Save handler.
+    _M_handler = handler;
+
+    // Save pointer to user data.
+    _M_user = user;
+
+    _M_running = true;
+
+    // Start thread.
+    if (pthread_create(&_M_thread, nullptr, run, this) == 0) {
+      return true;
+    }
+
+    _M_running = false;
+  }
+
+  return false;
+}
+
+void net::http::endpoint::stop()
+{
+  // If the thread is running...
+  if (_M_running) {
+    _M_running = false;
+    pthread_join(_M_thread, nullptr);
+  }
+
+  if (_M_fd != -1) {
+    close(_M_fd);
+    _M_fd = -1;
+
+    // Remove Unix socket (if any).
+    if (*_M_path) {
+      unlink(_M_path);
+    }
+  }
+}
+
+bool net::http::endpoint::listen(const char* address)
+{
+  *_M_path = 0;
+
+  // Unix socket?
+  if (strncmp(address, "unix:", 5) == 0) {
+    struct sockaddr_un addr;
+    const size_t len = strlen(address + 5);
+
+    // If the path is not too long...
+    if ((len > 0) && (len < sizeof(addr.sun_path)) && (len < sizeof(_M_path))) {
+      addr.sun_family = AF_UNIX;
+      memcpy(addr.sun_path, address + 5, len + 1);
+
+      // Create socket.
+      if ((_M_fd = ::socket(AF_UNIX, SOCK_STREAM, 0)) != -1) {
+        // Remove stale socket (if any).
+        unlink(addr.sun_path);
+
+        // Bind and listen.
+        if ((bind(_M_fd,
+                  reinterpret_cast<const struct sockaddr*>(&addr),
+                  sizeof(struct sockaddr_un)) == 0) &&
+            (::listen(_M_fd, SOMAXCONN) == 0)) {
+          memcpy(_M_path, addr.sun_path, len + 1);
+          return true;
+        }
+
+        close(_M_fd);
+        _M_fd = -1;
+      }
+    }
+  } else {
+    socket::address addr;
+    if (addr.build(address)) {
+      const struct sockaddr& sa = addr;
+
+      // Create socket.
+      if ((_M_fd = ::socket(sa.sa_family, SOCK_STREAM, 0)) != -1) {
+        // Reuse address, bind and listen.
+        const int optval = 1;
+        if ((setsockopt(_M_fd,
+                        SOL_SOCKET,
+                        SO_REUSEADDR,
+                        &optval,
+                        sizeof(int)) == 0) &&
+            (bind(_M_fd, &sa, addr.length()) == 0) &&
+            (::listen(_M_fd, SOMAXCONN) == 0)) {
+          return true;
+        }
+
+        close(_M_fd);
+        _M_fd = -1;
+      }
+    }
+  }
+
+  return false;
+}
+
+void* net::http::endpoint::run(void* arg)
+{
+  static_cast<endpoint*>(arg)->run();
+  return nullptr;
+}
+
+void net::http::endpoint::run()
+{
+  static constexpr const int timeout = 250; // Milliseconds.
+
+  do {
+    struct pollfd pfd;
+    pfd.fd = _M_fd;
+    pfd.events = POLLIN;
+
+    // Wait for connections.
+    if (poll(&pfd, 1, timeout) == 1) {
+      // Accept connection.
+      const int fd = accept(_M_fd, nullptr, nullptr);
+
+      // If the connection could be accepted...
+      if (fd != -1) {
+        // Serve connection.
+        serve(fd);
+
+        close(fd);
+      }
+    }
+  } while (_M_running);
+}
+
+void net::http::endpoint::serve(int fd)
+{
+  // Don't wait forever for slow clients.
+  struct timeval tv;
+  tv.tv_sec = 1;
+  tv.tv_usec = 0;
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(struct timeval));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(struct timeval));
+
+  // Receive request header.
+  char req[max_request_size + 1];
+  size_t len = 0;
+
+  do {
+    const ssize_t ret = recv(fd, req + len, max_request_size - len, 0);
+
+    if (ret > 0) {
+      len += ret;
+      req[len] = 0;
+
+      // If the end of the header has been received...
+      if (strstr(req, "\r\n\r\n")) {
+        break;
+      }
+
+      // If the request is too big...
+      if (len == max_request_size) {
+        return;
+      }
+    } else if ((ret == 0) || (errno != EINTR)) {
+      return;
+    }
+  } while (true);
+
+  static constexpr const char* const not_found =
+    "HTTP/1.0 404 Not Found\r\n"
+    "Content-Type: text/plain\r\n"
+    "Content-Length: 10\r\n"
+    "Connection: close\r\n"
+    "\r\n"
+    "Not found\n";
+
+  // Only GET is supported.
+  if (strncmp(req, "GET ", 4) == 0) {
+    // Extract path (without the query string).
+    const char* const path = req + 4;
+    const size_t pathlen = strcspn(path, " ?\r\n");
+
+    string::buffer body;
+    if (_M_handler(path, pathlen, body, _M_user)) {
+      // Compose header.
+      char header[128];
+      const int headerlen = snprintf(header,
+                                     sizeof(header),
+                                     "HTTP/1.0 200 OK\r\n"
+                                     "Content-Type: text/plain; "
+                                     "version=0.0.4\r\n"
+                                     "Content-Length: %zu\r\n"
+                                     "Connection: close\r\n"
+                                     "\r\n",
+                                     body.length());
+
+      // Send response.
+      if (send(fd, header, headerlen)) {
+        send(fd, body.data(), body.length());
+      }
+
+      return;
+    }
+  }
+
+  send(fd, not_found, strlen(not_found));
+}
+
+bool net::http::endpoint::send(int fd, const void* buf, size_t len)
+{
+  const uint8_t* data = static_cast<const uint8_t*>(buf);
+
+  // While there is data to be sent...
+  while (len > 0) {
+    // Send.
+    const ssize_t ret = ::send(fd, data, len, MSG_NOSIGNAL);
+
+    // If we have sent some data...
+    if (ret > 0) {
+      data += ret;
+      len -= ret;
+    } else if ((ret < 0) && (errno != EINTR)) {
+      return false;
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,77 @@
+#ifndef NET_HTTP_ENDPOINT_H
+#define NET_HTTP_ENDPOINT_H
+
+#include <pthread.h>
+#include "string/buffer.h"
+
+namespace net {
+  namespace http {
+    // Minimal HTTP endpoint.
+    //
+    // Serves GET requests from its own thread, one connection at a time, by
+    // invoking a handler which renders the body of the response. Intended for
+    // local monitoring (metrics, statistics), not for general use.
+    class endpoint {
+      public:
+        // Handler (returns false if the path was not found).
+        typedef bool (*handler_t)(const char* path,
+                                  size_t pathlen,
+                                  string::buffer& body,
+                                  void* user);
+
+        // Constructor.
+        endpoint() = default;
+
+        // Destructor.
+        ~endpoint();
+
+        // Start.
+        // <address> ::= unix:<path> | <ip-address>:<port>
+        bool start(const char* address, handler_t handler, void* user);
+
+        // Stop.
+        void stop();
+
+      private:
+        // Maximum size of a request.
+        static constexpr const size_t max_request_size = 8 * 1024;
+
+        // Socket descriptor.
+        int _M_fd = -1;
+
+        // Path of the Unix socket (if any).
+        char _M_path[108];
+
+        // Handler.
+        handler_t _M_handler;
+
+        // Pointer to user data.
+        void* _M_user;
+
+        // Thread id.
+        pthread_t _M_thread;
+
+        // Running?
+        bool _M_running = false;
+
+        // Listen.
+        bool listen(const char* address);
+
+        // Run.
+        static void* run(void* arg);
+        void run();
+
+        // Serve connection.
+        void serve(int fd);
+
+        // Send.
+        static bool send(int fd, const void* buf, size_t len);
+
+        // Disable copy constructor and assignment operator.
+        endpoint(const endpoint&) = delete;
+        endpoint& operator=(const endpoint&) = delete;
+    };
+  }
+}
+
+#endif // NET_HTTP_ENDPOINT_H
@@ -3,6 +3,7 @@
 #include <arpa/inet.h>
 #include <errno.h>
 #include "net/tcp/connection.h"
+#include "util/clock.h"
 
 net::tcp::connection::~connection()
 {
@@ -66,6 +67,13 @@ bool net::tcp::connection::read()
 
       switch (ret) {
         default:
+          _M_last_read = util::clock::monotonic();
+
+          // If the buffer was empty, the received data is the oldest.
+          if (_M_buf.empty()) {
+            _M_timestamp = _M_last_read;
+          }
+
           // Resize buffer.
           if (_M_buf.resize(_M_buf.length() + ret)) {
             // If we have exhausted the read I/O space...
@@ -59,6 +59,15 @@ namespace net {
         const string::buffer& buffer() const;
         string::buffer& buffer();
 
+        // Get time when the oldest data in the buffer was received
+        // (monotonic time in microseconds, see `util::clock::monotonic()`).
+        uint64_t timestamp() const;
+
+        // Remove the first `len` bytes of the buffer (the data which has been
+        // processed); the data left, if any, is timestamped with the time of
+        // the last read.
+        bool consume(size_t len);
+
       private:
         // Socket descriptor.
         int _M_fd = -1;
@@ -75,6 +84,12 @@ namespace net {
         // Buffer.
         string::buffer _M_buf;
 
+        // Time when the oldest data in the buffer was received.
+        uint64_t _M_timestamp = 0;
+
+        // Time of the last read.
+        uint64_t _M_last_read = 0;
+
         // Previous connection.
         connection* _M_prev;
 
@@ -128,6 +143,23 @@ namespace net {
     {
       return _M_buf;
     }
+
+    inline uint64_t connection::timestamp() const
+    {
+      return _M_timestamp;
+    }
+
+    inline bool connection::consume(size_t len)
+    {
+      if (_M_buf.erase(0, len)) {
+        // The data left is (at least partly) the data of the last read.
+        _M_timestamp = _M_last_read;
+
+        return true;
+      }
+
+      return false;
+    }
   }
 }
 
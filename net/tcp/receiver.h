@@ -7,6 +7,7 @@
 #include "net/tcp/listeners.h"
 #include "net/tcp/connections.h"
 #include "net/tcp/connection.h"
+#include "util/clock.h"
 
 namespace net {
   namespace tcp {
@@ -46,6 +47,10 @@ namespace net {
         // Get number of worker threads.
         size_t number_workers() const;
 
+        // Get clock of a worker thread (only to be used from the worker
+        // thread itself, e.g. from the callbacks).
+        const util::clock& clock(size_t nworker) const;
+
       private:
         // Worker thread.
         class worker {
@@ -72,10 +77,16 @@ namespace net {
             // Stop.
             void stop();
 
+            // Get clock.
+            const util::clock& clock() const;
+
           private:
             // Worker number.
             size_t _M_nworker;
 
+            // Clock (updated every time epoll_wait() returns).
+            util::clock _M_clock;
+
             // Epoll file descriptor.
             int _M_epollfd = -1;
 
@@ -134,6 +145,16 @@ namespace net {
     {
       return _M_nworkers;
     }
+
+    inline const util::clock& receiver::clock(size_t nworker) const
+    {
+      return _M_workers[nworker].clock();
+    }
+
+    inline const util::clock& receiver::worker::clock() const
+    {
+      return _M_clock;
+    }
   }
 }
 
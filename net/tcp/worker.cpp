@@ -116,6 +116,9 @@ void net::tcp::receiver::worker::run()
     // Wait for event.
     const int ret = epoll_wait(_M_epollfd, events, maxevents, timeout);
 
+    // Update clock.
+    _M_clock.update();
+
     switch (ret) {
       default: // At least one event was returned.
         // Process events.
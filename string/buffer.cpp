@@ -1,3 +1,5 @@
+#include <stdio.h>
+#include <stdarg.h>
 #include "string/buffer.h"
 
 bool string::buffer::reserve(size_t n)
@@ -85,6 +87,55 @@ bool string::buffer::append(const buffer& buf, size_t pos, size_t n)
   return true;
 }
 
+bool string::buffer::format(const char* format, ...)
+{
+  va_list ap;
+  va_start(ap, format);
+
+  const bool ret = vformat(format, ap);
+
+  va_end(ap);
+
+  return ret;
+}
+
+bool string::buffer::vformat(const char* format, va_list ap)
+{
+  static constexpr const size_t min_size = 128;
+
+  size_t size = min_size;
+
+  do {
+    // Reserve memory.
+    if (!reserve(size)) {
+      return false;
+    }
+
+    // `ap` might be needed again.
+    va_list aq;
+    va_copy(aq, ap);
+
+    const int n = vsnprintf(reinterpret_cast<char*>(_M_data + _M_used),
+                            _M_size - _M_used,
+                            format,
+                            aq);
+
+    va_end(aq);
+
+    if (n >= 0) {
+      // If the formatted string fit in the buffer...
+      if (static_cast<size_t>(n) < _M_size - _M_used) {
+        _M_used += n;
+        return true;
+      }
+
+      size = static_cast<size_t>(n) + 1;
+    } else {
+      return false;
+    }
+  } while (true);
+}
+
 bool string::buffer::insert(size_t pos, const void* buf, size_t n)
 {
   if (pos < _M_used) {
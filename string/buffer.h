@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdarg.h>
 #include <limits.h>
 
 namespace string {
@@ -57,6 +58,11 @@ namespace string {
       // Append a single character.
       bool push_back(uint8_t c);
 
+      // Append formatted string.
+      bool format(const char* format, ...)
+        __attribute__((format(printf, 2, 3)));
+      bool vformat(const char* format, va_list ap);
+
       // Insert.
       bool insert(size_t pos, const buffer& buf);
       bool insert(size_t pos1, const buffer& buf, size_t pos2, size_t n);
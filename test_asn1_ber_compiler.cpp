@@ -0,0 +1,303 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "test_asn1_ber_compiler_sample.h"
+#include "asn1/ber/decoder.h"
+
+// Serialize the data values encoded by `enc` into `buf` and decode the first
+// one.
+static bool decode(const asn1::ber::encoder& enc,
+                   string::buffer& buf,
+                   asn1::ber::value& val);
+
+// Round trip of a record (SEQUENCE with OPTIONAL and DEFAULT components,
+// SEQUENCE OF, SET OF, CHOICE, ENUMERATED and extension marker).
+static bool test_record();
+
+// Components with default values which are not encoded.
+static bool test_defaults();
+
+// SET whose components are encoded in a different order and SET with a
+// duplicate component.
+static bool test_set();
+
+// Tagged types and SEQUENCE OF a string type.
+static bool test_tagged();
+
+// Unknown enumerated values (allowed only with an extension marker).
+static bool test_enumerated();
+
+// Check.
+static bool check(bool cond, const char* test);
+
+int main()
+{
+  if ((test_record()) &&
+      (test_defaults()) &&
+      (test_set()) &&
+      (test_tagged()) &&
+      (test_enumerated())) {
+    printf("Success.\n");
+    return 0;
+  }
+
+  fprintf(stderr, "Error.\n");
+
+  return -1;
+}
+
+bool decode(const asn1::ber::encoder& enc,
+            string::buffer& buf,
+            asn1::ber::value& val)
+{
+  buf.clear();
+  if (enc.serialize(buf)) {
+    asn1::ber::decoder decoder(buf.data(), buf.length());
+    return (decoder.next(val) == asn1::ber::decoder::result::no_error);
+  }
+
+  return false;
+}
+
+bool test_record()
+{
+  sample::Record in;
+  in.id = 4000000000ll;
+  in.name.data = "hello";
+  in.name.length = 5;
+  in.active = false;
+  in.kind = sample::Kind::gamma;
+  in.has_when = true;
+  in.when = 1700000000;
+  in.has_stamp = true;
+  in.stamp.tv_sec = 1700000001;
+  in.stamp.tv_usec = 250000;
+  in.has_oid = true;
+  in.oid.ncomponents = 4;
+  in.oid.components[0] = 1;
+  in.oid.components[1] = 3;
+  in.oid.components[2] = 6;
+  in.oid.components[3] = 300000;
+
+  in.payload.present = sample::Payload::alternative::nested;
+
+  sample::Record* const nested = in.payload.nested.add();
+  if (!nested) {
+    return check(false, "record");
+  }
+
+  nested->id = -5;
+  nested->name.data = "x";
+  nested->name.length = 1;
+  nested->payload.present = sample::Payload::alternative::text;
+  nested->payload.text.data = "abc";
+  nested->payload.text.length = 3;
+
+  for (int64_t i = 0; i < 2; i++) {
+    sample::Item* const item = in.items.add();
+    if (!item) {
+      return check(false, "record");
+    }
+
+    item->count = 7 - (i * 8);
+    item->class_ = (i == 0) ? sample::Strict::two : sample::Strict::one;
+  }
+
+  sample::Record_attrs_element* const attr = in.attrs.add();
+  if (!attr) {
+    return check(false, "record");
+  }
+
+  attr->key.data = "k";
+  attr->key.length = 1;
+  attr->val = 42;
+
+  in.has_nothing = true;
+
+  asn1::ber::encoder enc;
+  string::buffer buf;
+  asn1::ber::value val;
+  sample::Record out;
+  if ((!sample::encode_Record(enc, in)) ||
+      (!decode(enc, buf, val)) ||
+      (!sample::decode_Record(val, out))) {
+    return check(false, "record");
+  }
+
+  return check((out.id == in.id) &&
+               (out.name.length == 5) &&
+               (memcmp(out.name.data, "hello", 5) == 0) &&
+               (!out.active) &&
+               (out.kind == sample::Kind::gamma) &&
+               (out.has_when) &&
+               (out.when == in.when) &&
+               (out.has_stamp) &&
+               (out.stamp.tv_sec == in.stamp.tv_sec) &&
+               (out.stamp.tv_usec == in.stamp.tv_usec) &&
+               (out.has_oid) &&
+               (out.oid.ncomponents == 4) &&
+               (out.oid.components[3] == 300000) &&
+               (out.payload.present == sample::Payload::alternative::nested) &&
+               (out.payload.nested.size() == 1) &&
+               (out.payload.nested[0].id == -5) &&
+               (out.payload.nested[0].payload.present ==
+                sample::Payload::alternative::text) &&
+               (out.payload.nested[0].payload.text.length == 3) &&
+               (memcmp(out.payload.nested[0].payload.text.data, "abc", 3) ==
+                0) &&
+               (out.items.size() == 2) &&
+               (out.items[0].count == 7) &&
+               (out.items[0].class_ == sample::Strict::two) &&
+               (out.items[1].count == -1) &&
+               (out.items[1].class_ == sample::Strict::one) &&
+               (out.attrs.size() == 1) &&
+               (out.attrs[0].key.length == 1) &&
+               (out.attrs[0].val == 42) &&
+               (out.has_nothing),
+               "record");
+}
+
+bool test_defaults()
+{
+  sample::Record in;
+  in.id = 1;
+  in.payload.present = sample::Payload::alternative::number;
+  in.payload.number = 12;
+
+  asn1::ber::encoder enc;
+  string::buffer buf;
+  asn1::ber::value val;
+  sample::Record out;
+  if ((!sample::encode_Record(enc, in)) ||
+      (!decode(enc, buf, val)) ||
+      (!sample::decode_Record(val, out))) {
+    return check(false, "defaults");
+  }
+
+  return check((out.id == 1) &&
+               (out.active) &&
+               (out.kind == sample::Kind::beta) &&
+               (!out.has_when) &&
+               (!out.has_stamp) &&
+               (!out.has_oid) &&
+               (!out.has_nothing) &&
+               (out.payload.present == sample::Payload::alternative::number) &&
+               (out.payload.number == 12) &&
+               (out.items.empty()) &&
+               (out.attrs.empty()),
+               "defaults");
+}
+
+bool test_set()
+{
+  // Components in reverse order.
+  asn1::ber::encoder enc;
+  if ((!enc.start_constructed(asn1::ber::tag_class::Universal, 17)) ||
+      (!enc.add_boolean(asn1::ber::tag_class::ContextSpecific, 1, true)) ||
+      (!enc.add_integer(asn1::ber::tag_class::ContextSpecific, 0, 99)) ||
+      (!enc.end_constructed())) {
+    return check(false, "set");
+  }
+
+  string::buffer buf;
+  asn1::ber::value val;
+  sample::Config config;
+  if ((!decode(enc, buf, val)) ||
+      (!sample::decode_Config(val, config)) ||
+      (config.a != 99) ||
+      (!config.has_b) ||
+      (!config.b) ||
+      (config.c != -7)) {
+    return check(false, "set");
+  }
+
+  // Duplicate component.
+  enc.reset();
+  if ((!enc.start_constructed(asn1::ber::tag_class::Universal, 17)) ||
+      (!enc.add_integer(asn1::ber::tag_class::ContextSpecific, 0, 1)) ||
+      (!enc.add_integer(asn1::ber::tag_class::ContextSpecific, 0, 2)) ||
+      (!enc.end_constructed())) {
+    return check(false, "set");
+  }
+
+  return check((decode(enc, buf, val)) &&
+               (!sample::decode_Config(val, config)),
+               "set");
+}
+
+bool test_tagged()
+{
+  sample::Tagged tagged;
+  tagged.present = sample::Payload::alternative::number;
+  tagged.number = 12;
+
+  const sample::Counter counter = 77;
+
+  sample::Names names;
+  asn1::ber::schema::octets* const name = names.add();
+  if (!name) {
+    return check(false, "tagged");
+  }
+
+  name->data = "zz";
+  name->length = 2;
+
+  asn1::ber::encoder enc;
+  string::buffer buf;
+  if ((!sample::encode_Tagged(enc, tagged)) ||
+      (!sample::encode_Counter(enc, counter)) ||
+      (!sample::encode_Names(enc, names)) ||
+      (!enc.serialize(buf))) {
+    return check(false, "tagged");
+  }
+
+  asn1::ber::decoder decoder(buf.data(), buf.length());
+  asn1::ber::value val;
+
+  sample::Tagged t;
+  sample::Counter c;
+  sample::Names n;
+
+  return check((decoder.next(val) == asn1::ber::decoder::result::no_error) &&
+               (sample::decode_Tagged(val, t)) &&
+               (t.present == sample::Payload::alternative::number) &&
+               (t.number == 12) &&
+               (decoder.next(val) == asn1::ber::decoder::result::no_error) &&
+               (sample::decode_Counter(val, c)) &&
+               (c == 77) &&
+               (!sample::decode_Tagged(val, t)) &&
+               (decoder.next(val) == asn1::ber::decoder::result::no_error) &&
+               (sample::decode_Names(val, n)) &&
+               (n.size() == 1) &&
+               (n[0].length == 2) &&
+               (memcmp(n[0].data, "zz", 2) == 0),
+               "tagged");
+}
+
+bool test_enumerated()
+{
+  asn1::ber::encoder enc;
+  string::buffer buf;
+  asn1::ber::value val;
+  if ((!enc.add_integer(asn1::ber::tag_class::Universal, 10, 9)) ||
+      (!decode(enc, buf, val))) {
+    return check(false, "enumerated");
+  }
+
+  sample::Strict strict;
+  sample::Kind kind;
+
+  return check((!sample::decode_Strict(val, strict)) &&
+               (sample::decode_Kind(val, kind)) &&
+               (static_cast<int64_t>(kind) == 9),
+               "enumerated");
+}
+
+bool check(bool cond, const char* test)
+{
+  if (!cond) {
+    fprintf(stderr, "Test '%s' failed.\n", test);
+  }
+
+  return cond;
+}
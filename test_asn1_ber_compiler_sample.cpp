@@ -0,0 +1,1111 @@
+// Generated by asn1_ber_compiler from the ASN.1 module Sample.
+// Do not edit.
+
+#include "test_asn1_ber_compiler_sample.h"
+
+namespace sample {
+  static constexpr const asn1::ber::schema::tag tags_Record_id[] = {
+    {asn1::ber::tag_class::ContextSpecific, 0}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Record_name[] = {
+    {asn1::ber::tag_class::ContextSpecific, 1}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Record_active[] = {
+    {asn1::ber::tag_class::ContextSpecific, 2}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Record_kind[] = {
+    {asn1::ber::tag_class::ContextSpecific, 3}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Record_when[] = {
+    {asn1::ber::tag_class::ContextSpecific, 4}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Record_stamp[] = {
+    {asn1::ber::tag_class::ContextSpecific, 5}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Record_oid[] = {
+    {asn1::ber::tag_class::ContextSpecific, 6}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Record_payload[] = {
+    {asn1::ber::tag_class::ContextSpecific, 7}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Record_items[] = {
+    {asn1::ber::tag_class::ContextSpecific, 8}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Record_items_element[] = {
+    {asn1::ber::tag_class::Application, 3}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Record_attrs[] = {
+    {asn1::ber::tag_class::ContextSpecific, 9}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Record_attrs_element[] = {
+    {asn1::ber::tag_class::Universal, 16}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Record_nothing[] = {
+    {asn1::ber::tag_class::ContextSpecific, 10}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Record_attrs_element_key[] = {
+    {asn1::ber::tag_class::ContextSpecific, 0}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Record_attrs_element_val[] = {
+    {asn1::ber::tag_class::ContextSpecific, 1}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Payload_number[] = {
+    {asn1::ber::tag_class::ContextSpecific, 0}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Payload_text[] = {
+    {asn1::ber::tag_class::ContextSpecific, 1}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Payload_nested[] = {
+    {asn1::ber::tag_class::ContextSpecific, 2}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Payload_nested_element[] = {
+    {asn1::ber::tag_class::Universal, 16}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Item_count[] = {
+    {asn1::ber::tag_class::ContextSpecific, 0}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Item_class_[] = {
+    {asn1::ber::tag_class::ContextSpecific, 1}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Config_a[] = {
+    {asn1::ber::tag_class::ContextSpecific, 0}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Config_b[] = {
+    {asn1::ber::tag_class::ContextSpecific, 1}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Config_c[] = {
+    {asn1::ber::tag_class::ContextSpecific, 2}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Record[] = {
+    {asn1::ber::tag_class::Universal, 16}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Kind[] = {
+    {asn1::ber::tag_class::Universal, 10}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Strict[] = {
+    {asn1::ber::tag_class::Universal, 10}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Payload[] = {
+    {asn1::ber::tag_class::ContextSpecific, 0},
+    {asn1::ber::tag_class::ContextSpecific, 1},
+    {asn1::ber::tag_class::ContextSpecific, 2}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Item[] = {
+    {asn1::ber::tag_class::Application, 3}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Names[] = {
+    {asn1::ber::tag_class::Universal, 16}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Names_element[] = {
+    {asn1::ber::tag_class::Universal, 22}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Tagged[] = {
+    {asn1::ber::tag_class::ContextSpecific, 5}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Counter[] = {
+    {asn1::ber::tag_class::Application, 7}
+  };
+
+  static constexpr const asn1::ber::schema::tag tags_Config[] = {
+    {asn1::ber::tag_class::Universal, 17}
+  };
+
+  static bool decode_Record_value(const asn1::ber::value& val, Record& v);
+  static bool encode_Record_value(asn1::ber::encoder& enc,
+                                  asn1::ber::tag_class tc,
+                                  uint32_t tn,
+                                  const Record& v);
+
+  static bool decode_Record_attrs_element_value(const asn1::ber::value& val, Record_attrs_element& v);
+  static bool encode_Record_attrs_element_value(asn1::ber::encoder& enc,
+                                                asn1::ber::tag_class tc,
+                                                uint32_t tn,
+                                                const Record_attrs_element& v);
+
+  static bool decode_Kind_value(const asn1::ber::value& val, Kind& v);
+
+  static bool decode_Strict_value(const asn1::ber::value& val, Strict& v);
+
+  static bool decode_Payload_value(const asn1::ber::value& val, Payload& v);
+  static bool encode_Payload_value(asn1::ber::encoder& enc, const Payload& v);
+
+  static bool decode_Item_value(const asn1::ber::value& val, Item& v);
+  static bool encode_Item_value(asn1::ber::encoder& enc,
+                                asn1::ber::tag_class tc,
+                                uint32_t tn,
+                                const Item& v);
+
+  static bool decode_Config_value(const asn1::ber::value& val, Config& v);
+  static bool encode_Config_value(asn1::ber::encoder& enc,
+                                  asn1::ber::tag_class tc,
+                                  uint32_t tn,
+                                  const Config& v);
+
+  static bool decode_Record_value(const asn1::ber::value& val, Record& v)
+  {
+    if (!val.constructed()) {
+      return false;
+    }
+
+    asn1::ber::schema::reader r(val);
+
+    // id.
+    if ((!r.end()) && (asn1::ber::schema::match(r.get(), tags_Record_id))) {
+      if (!asn1::ber::schema::decode_integer(r.get(), v.id)) {
+        return false;
+      }
+
+      if (!r.next()) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+
+    // name.
+    if ((!r.end()) && (asn1::ber::schema::match(r.get(), tags_Record_name))) {
+      if (!asn1::ber::schema::decode_octets(r.get(), v.name)) {
+        return false;
+      }
+
+      if (!r.next()) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+
+    // active.
+    if ((!r.end()) && (asn1::ber::schema::match(r.get(), tags_Record_active))) {
+      if (!asn1::ber::schema::decode_boolean(r.get(), v.active)) {
+        return false;
+      }
+
+      if (!r.next()) {
+        return false;
+      }
+    } else {
+      v.active = true;
+    }
+
+    // kind.
+    if ((!r.end()) && (asn1::ber::schema::match(r.get(), tags_Record_kind))) {
+      if (!decode_Kind_value(r.get(), v.kind)) {
+        return false;
+      }
+
+      if (!r.next()) {
+        return false;
+      }
+    } else {
+      v.kind = static_cast<Kind>(5ll);
+    }
+
+    // when.
+    if ((!r.end()) && (asn1::ber::schema::match(r.get(), tags_Record_when))) {
+      if (!asn1::ber::schema::decode_utc_time(r.get(), v.when)) {
+        return false;
+      }
+      v.has_when = true;
+
+      if (!r.next()) {
+        return false;
+      }
+    } else {
+      v.has_when = false;
+    }
+
+    // stamp.
+    if ((!r.end()) && (asn1::ber::schema::match(r.get(), tags_Record_stamp))) {
+      if (!asn1::ber::schema::decode_generalized_time(r.get(), v.stamp)) {
+        return false;
+      }
+      v.has_stamp = true;
+
+      if (!r.next()) {
+        return false;
+      }
+    } else {
+      v.has_stamp = false;
+    }
+
+    // oid.
+    if ((!r.end()) && (asn1::ber::schema::match(r.get(), tags_Record_oid))) {
+      if (!asn1::ber::schema::decode_oid(r.get(), v.oid)) {
+        return false;
+      }
+      v.has_oid = true;
+
+      if (!r.next()) {
+        return false;
+      }
+    } else {
+      v.has_oid = false;
+    }
+
+    // payload.
+    if ((!r.end()) && (asn1::ber::schema::match(r.get(), tags_Record_payload))) {
+      asn1::ber::value v0;
+      if (!asn1::ber::schema::unwrap(r.get(), v0)) {
+        return false;
+      }
+
+      if (!decode_Payload_value(v0, v.payload)) {
+        return false;
+      }
+
+      if (!r.next()) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+
+    // items.
+    if ((!r.end()) && (asn1::ber::schema::match(r.get(), tags_Record_items))) {
+      if (!r.get().constructed()) {
+        return false;
+      }
+
+      v.items.clear();
+
+      asn1::ber::schema::reader r1(r.get());
+      while (!r1.end()) {
+        if (!asn1::ber::schema::match(r1.get(), tags_Record_items_element)) {
+          return false;
+        }
+
+        Item* const p1 = v.items.add();
+        if (!p1) {
+          return false;
+        }
+
+        Item& e1 = *p1;
+
+        if (!decode_Item_value(r1.get(), e1)) {
+          return false;
+        }
+
+        if (!r1.next()) {
+          return false;
+        }
+      }
+
+      if (r1.error()) {
+        return false;
+      }
+
+      if (!r.next()) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+
+    // attrs.
+    if ((!r.end()) && (asn1::ber::schema::match(r.get(), tags_Record_attrs))) {
+      if (!r.get().constructed()) {
+        return false;
+      }
+
+      v.attrs.clear();
+
+      asn1::ber::schema::reader r2(r.get());
+      while (!r2.end()) {
+        if (!asn1::ber::schema::match(r2.get(), tags_Record_attrs_element)) {
+          return false;
+        }
+
+        Record_attrs_element* const p2 = v.attrs.add();
+        if (!p2) {
+          return false;
+        }
+
+        Record_attrs_element& e2 = *p2;
+
+        if (!decode_Record_attrs_element_value(r2.get(), e2)) {
+          return false;
+        }
+
+        if (!r2.next()) {
+          return false;
+        }
+      }
+
+      if (r2.error()) {
+        return false;
+      }
+
+      if (!r.next()) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+
+    // nothing.
+    if ((!r.end()) && (asn1::ber::schema::match(r.get(), tags_Record_nothing))) {
+      if (!asn1::ber::schema::decode_null(r.get(), v.nothing)) {
+        return false;
+      }
+      v.has_nothing = true;
+
+      if (!r.next()) {
+        return false;
+      }
+    } else {
+      v.has_nothing = false;
+    }
+
+    // Skip extensions.
+    while (!r.end()) {
+      if (!r.next()) {
+        return false;
+      }
+    }
+
+    return ((r.end()) && (!r.error()));
+  }
+
+  static bool encode_Record_value(asn1::ber::encoder& enc,
+                                  asn1::ber::tag_class tc,
+                                  uint32_t tn,
+                                  const Record& v)
+  {
+    if (!enc.start_constructed(tc, tn)) {
+      return false;
+    }
+
+    // id.
+    if (!asn1::ber::schema::encode_integer<asn1::ber::tag_class::ContextSpecific, 0>(enc, v.id)) {
+      return false;
+    }
+
+    // name.
+    if (!asn1::ber::schema::encode_octets<asn1::ber::tag_class::ContextSpecific, 1>(enc, v.name)) {
+      return false;
+    }
+
+    // active.
+    if (!asn1::ber::schema::encode_boolean<asn1::ber::tag_class::ContextSpecific, 2>(enc, v.active)) {
+      return false;
+    }
+
+    // kind.
+    if (!asn1::ber::schema::encode_integer<asn1::ber::tag_class::ContextSpecific, 3>(
+          enc,
+          static_cast<int64_t>(v.kind))) {
+      return false;
+    }
+
+    // when.
+    if (v.has_when) {
+      if (!asn1::ber::schema::encode_utc_time(enc, asn1::ber::tag_class::ContextSpecific, 4, v.when)) {
+        return false;
+      }
+    }
+
+    // stamp.
+    if (v.has_stamp) {
+      if (!asn1::ber::schema::encode_generalized_time<asn1::ber::tag_class::ContextSpecific, 5>(enc, v.stamp)) {
+        return false;
+      }
+    }
+
+    // oid.
+    if (v.has_oid) {
+      if (!asn1::ber::schema::encode_oid(enc, asn1::ber::tag_class::ContextSpecific, 6, v.oid)) {
+        return false;
+      }
+    }
+
+    // payload.
+    if (!enc.start_constructed<asn1::ber::tag_class::ContextSpecific, 7>()) {
+      return false;
+    }
+
+    if (!encode_Payload_value(enc, v.payload)) {
+      return false;
+    }
+
+    if (!enc.end_constructed()) {
+      return false;
+    }
+
+    // items.
+    if (!enc.start_constructed<asn1::ber::tag_class::ContextSpecific, 8>()) {
+      return false;
+    }
+
+    for (size_t i3 = 0; i3 < v.items.size(); i3++) {
+      if (!encode_Item_value(enc, asn1::ber::tag_class::Application, 3, v.items[i3])) {
+        return false;
+      }
+    }
+
+    if (!enc.end_constructed()) {
+      return false;
+    }
+
+    // attrs.
+    if (!enc.start_constructed<asn1::ber::tag_class::ContextSpecific, 9>()) {
+      return false;
+    }
+
+    for (size_t i4 = 0; i4 < v.attrs.size(); i4++) {
+      if (!encode_Record_attrs_element_value(enc, asn1::ber::tag_class::Universal, 16, v.attrs[i4])) {
+        return false;
+      }
+    }
+
+    if (!enc.end_constructed()) {
+      return false;
+    }
+
+    // nothing.
+    if (v.has_nothing) {
+      if (!asn1::ber::schema::encode_null<asn1::ber::tag_class::ContextSpecific, 10>(enc, v.nothing)) {
+        return false;
+      }
+    }
+
+    return enc.end_constructed();
+  }
+
+  static bool decode_Record_attrs_element_value(const asn1::ber::value& val, Record_attrs_element& v)
+  {
+    if (!val.constructed()) {
+      return false;
+    }
+
+    asn1::ber::schema::reader r(val);
+
+    // key.
+    if ((!r.end()) && (asn1::ber::schema::match(r.get(), tags_Record_attrs_element_key))) {
+      if (!asn1::ber::schema::decode_octets(r.get(), v.key)) {
+        return false;
+      }
+
+      if (!r.next()) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+
+    // val.
+    if ((!r.end()) && (asn1::ber::schema::match(r.get(), tags_Record_attrs_element_val))) {
+      if (!asn1::ber::schema::decode_integer(r.get(), v.val)) {
+        return false;
+      }
+
+      if (!r.next()) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+
+    return ((r.end()) && (!r.error()));
+  }
+
+  static bool encode_Record_attrs_element_value(asn1::ber::encoder& enc,
+                                                asn1::ber::tag_class tc,
+                                                uint32_t tn,
+                                                const Record_attrs_element& v)
+  {
+    if (!enc.start_constructed(tc, tn)) {
+      return false;
+    }
+
+    // key.
+    if (!asn1::ber::schema::encode_octets<asn1::ber::tag_class::ContextSpecific, 0>(enc, v.key)) {
+      return false;
+    }
+
+    // val.
+    if (!asn1::ber::schema::encode_integer<asn1::ber::tag_class::ContextSpecific, 1>(enc, v.val)) {
+      return false;
+    }
+
+    return enc.end_constructed();
+  }
+
+  static bool decode_Kind_value(const asn1::ber::value& val, Kind& v)
+  {
+    int64_t n;
+    if (!asn1::ber::schema::decode_integer(val, n)) {
+      return false;
+    }
+
+    // Unknown values are allowed (extensions).
+    v = static_cast<Kind>(n);
+
+    return true;
+  }
+
+  static bool decode_Strict_value(const asn1::ber::value& val, Strict& v)
+  {
+    int64_t n;
+    if (!asn1::ber::schema::decode_integer(val, n)) {
+      return false;
+    }
+
+    switch (n) {
+      case 1ll:
+      case 2ll:
+        v = static_cast<Strict>(n);
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  static bool decode_Payload_value(const asn1::ber::value& val, Payload& v)
+  {
+    // number.
+    if (asn1::ber::schema::match(val, tags_Payload_number)) {
+      v.present = Payload::alternative::number;
+
+      if (!asn1::ber::schema::decode_integer(val, v.number)) {
+        return false;
+      }
+
+      return true;
+    }
+
+    // text.
+    if (asn1::ber::schema::match(val, tags_Payload_text)) {
+      v.present = Payload::alternative::text;
+
+      if (!asn1::ber::schema::decode_octets(val, v.text)) {
+        return false;
+      }
+
+      return true;
+    }
+
+    // nested.
+    if (asn1::ber::schema::match(val, tags_Payload_nested)) {
+      v.present = Payload::alternative::nested;
+
+      if (!val.constructed()) {
+        return false;
+      }
+
+      v.nested.clear();
+
+      asn1::ber::schema::reader r5(val);
+      while (!r5.end()) {
+        if (!asn1::ber::schema::match(r5.get(), tags_Payload_nested_element)) {
+          return false;
+        }
+
+        Record* const p5 = v.nested.add();
+        if (!p5) {
+          return false;
+        }
+
+        Record& e5 = *p5;
+
+        if (!decode_Record_value(r5.get(), e5)) {
+          return false;
+        }
+
+        if (!r5.next()) {
+          return false;
+        }
+      }
+
+      if (r5.error()) {
+        return false;
+      }
+
+      return true;
+    }
+
+    return false;
+  }
+
+  static bool encode_Payload_value(asn1::ber::encoder& enc, const Payload& v)
+  {
+    switch (v.present) {
+      case Payload::alternative::number:
+        if (!asn1::ber::schema::encode_integer<asn1::ber::tag_class::ContextSpecific, 0>(enc, v.number)) {
+          return false;
+        }
+
+        return true;
+      case Payload::alternative::text:
+        if (!asn1::ber::schema::encode_octets<asn1::ber::tag_class::ContextSpecific, 1>(enc, v.text)) {
+          return false;
+        }
+
+        return true;
+      case Payload::alternative::nested:
+        if (!enc.start_constructed<asn1::ber::tag_class::ContextSpecific, 2>()) {
+          return false;
+        }
+
+        for (size_t i6 = 0; i6 < v.nested.size(); i6++) {
+          if (!encode_Record_value(enc, asn1::ber::tag_class::Universal, 16, v.nested[i6])) {
+            return false;
+          }
+        }
+
+        if (!enc.end_constructed()) {
+          return false;
+        }
+
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  static bool decode_Item_value(const asn1::ber::value& val, Item& v)
+  {
+    if (!val.constructed()) {
+      return false;
+    }
+
+    asn1::ber::schema::reader r(val);
+
+    // count.
+    if ((!r.end()) && (asn1::ber::schema::match(r.get(), tags_Item_count))) {
+      if (!asn1::ber::schema::decode_integer(r.get(), v.count)) {
+        return false;
+      }
+
+      if (!r.next()) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+
+    // class.
+    if ((!r.end()) && (asn1::ber::schema::match(r.get(), tags_Item_class_))) {
+      if (!decode_Strict_value(r.get(), v.class_)) {
+        return false;
+      }
+
+      if (!r.next()) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+
+    return ((r.end()) && (!r.error()));
+  }
+
+  static bool encode_Item_value(asn1::ber::encoder& enc,
+                                asn1::ber::tag_class tc,
+                                uint32_t tn,
+                                const Item& v)
+  {
+    if (!enc.start_constructed(tc, tn)) {
+      return false;
+    }
+
+    // count.
+    if (!asn1::ber::schema::encode_integer<asn1::ber::tag_class::ContextSpecific, 0>(enc, v.count)) {
+      return false;
+    }
+
+    // class.
+    if (!asn1::ber::schema::encode_integer<asn1::ber::tag_class::ContextSpecific, 1>(
+          enc,
+          static_cast<int64_t>(v.class_))) {
+      return false;
+    }
+
+    return enc.end_constructed();
+  }
+
+  static bool decode_Config_value(const asn1::ber::value& val, Config& v)
+  {
+    if (!val.constructed()) {
+      return false;
+    }
+
+    asn1::ber::schema::reader r(val);
+
+    // Components present.
+    bool present[3] = {};
+
+    while (!r.end()) {
+      // a.
+      if (asn1::ber::schema::match(r.get(), tags_Config_a)) {
+        if (present[0]) {
+          return false;
+        }
+
+        if (!asn1::ber::schema::decode_integer(r.get(), v.a)) {
+          return false;
+        }
+
+        present[0] = true;
+      // b.
+      } else if (asn1::ber::schema::match(r.get(), tags_Config_b)) {
+        if (present[1]) {
+          return false;
+        }
+
+        if (!asn1::ber::schema::decode_boolean(r.get(), v.b)) {
+          return false;
+        }
+
+        present[1] = true;
+      // c.
+      } else if (asn1::ber::schema::match(r.get(), tags_Config_c)) {
+        if (present[2]) {
+          return false;
+        }
+
+        if (!asn1::ber::schema::decode_integer(r.get(), v.c)) {
+          return false;
+        }
+
+        present[2] = true;
+      } else {
+        return false;
+      }
+
+      if (!r.next()) {
+        return false;
+      }
+    }
+
+    if (r.error()) {
+      return false;
+    }
+
+    if (!present[0]) {
+      return false;
+    }
+
+    v.has_b = present[1];
+
+    if (!present[2]) {
+      v.c = -7ll;
+    }
+
+    return true;
+  }
+
+  static bool encode_Config_value(asn1::ber::encoder& enc,
+                                  asn1::ber::tag_class tc,
+                                  uint32_t tn,
+                                  const Config& v)
+  {
+    if (!enc.start_constructed(tc, tn)) {
+      return false;
+    }
+
+    // a.
+    if (!asn1::ber::schema::encode_integer<asn1::ber::tag_class::ContextSpecific, 0>(enc, v.a)) {
+      return false;
+    }
+
+    // b.
+    if (v.has_b) {
+      if (!asn1::ber::schema::encode_boolean<asn1::ber::tag_class::ContextSpecific, 1>(enc, v.b)) {
+        return false;
+      }
+    }
+
+    // c.
+    if (!asn1::ber::schema::encode_integer<asn1::ber::tag_class::ContextSpecific, 2>(enc, v.c)) {
+      return false;
+    }
+
+    return enc.end_constructed();
+  }
+
+  bool decode_Record(const asn1::ber::value& val, Record& v)
+  {
+    if (!asn1::ber::schema::match(val, tags_Record)) {
+      return false;
+    }
+
+    if (!decode_Record_value(val, v)) {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool encode_Record(asn1::ber::encoder& enc, const Record& v)
+  {
+    if (!encode_Record_value(enc, asn1::ber::tag_class::Universal, 16, v)) {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool decode_Kind(const asn1::ber::value& val, Kind& v)
+  {
+    if (!asn1::ber::schema::match(val, tags_Kind)) {
+      return false;
+    }
+
+    if (!decode_Kind_value(val, v)) {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool encode_Kind(asn1::ber::encoder& enc, const Kind& v)
+  {
+    if (!asn1::ber::schema::encode_integer<asn1::ber::tag_class::Universal, 10>(
+          enc,
+          static_cast<int64_t>(v))) {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool decode_Strict(const asn1::ber::value& val, Strict& v)
+  {
+    if (!asn1::ber::schema::match(val, tags_Strict)) {
+      return false;
+    }
+
+    if (!decode_Strict_value(val, v)) {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool encode_Strict(asn1::ber::encoder& enc, const Strict& v)
+  {
+    if (!asn1::ber::schema::encode_integer<asn1::ber::tag_class::Universal, 10>(
+          enc,
+          static_cast<int64_t>(v))) {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool decode_Payload(const asn1::ber::value& val, Payload& v)
+  {
+    if (!asn1::ber::schema::match(val, tags_Payload)) {
+      return false;
+    }
+
+    if (!decode_Payload_value(val, v)) {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool encode_Payload(asn1::ber::encoder& enc, const Payload& v)
+  {
+    if (!encode_Payload_value(enc, v)) {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool decode_Item(const asn1::ber::value& val, Item& v)
+  {
+    if (!asn1::ber::schema::match(val, tags_Item)) {
+      return false;
+    }
+
+    if (!decode_Item_value(val, v)) {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool encode_Item(asn1::ber::encoder& enc, const Item& v)
+  {
+    if (!encode_Item_value(enc, asn1::ber::tag_class::Application, 3, v)) {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool decode_Names(const asn1::ber::value& val, Names& v)
+  {
+    if (!asn1::ber::schema::match(val, tags_Names)) {
+      return false;
+    }
+
+    if (!val.constructed()) {
+      return false;
+    }
+
+    v.clear();
+
+    asn1::ber::schema::reader r7(val);
+    while (!r7.end()) {
+      if (!asn1::ber::schema::match(r7.get(), tags_Names_element)) {
+        return false;
+      }
+
+      asn1::ber::schema::octets* const p7 = v.add();
+      if (!p7) {
+        return false;
+      }
+
+      asn1::ber::schema::octets& e7 = *p7;
+
+      if (!asn1::ber::schema::decode_octets(r7.get(), e7)) {
+        return false;
+      }
+
+      if (!r7.next()) {
+        return false;
+      }
+    }
+
+    if (r7.error()) {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool encode_Names(asn1::ber::encoder& enc, const Names& v)
+  {
+    if (!enc.start_constructed<asn1::ber::tag_class::Universal, 16>()) {
+      return false;
+    }
+
+    for (size_t i8 = 0; i8 < v.size(); i8++) {
+      if (!asn1::ber::schema::encode_octets<asn1::ber::tag_class::Universal, 22>(enc, v[i8])) {
+        return false;
+      }
+    }
+
+    if (!enc.end_constructed()) {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool decode_Tagged(const asn1::ber::value& val, Tagged& v)
+  {
+    if (!asn1::ber::schema::match(val, tags_Tagged)) {
+      return false;
+    }
+
+    asn1::ber::value v9;
+    if (!asn1::ber::schema::unwrap(val, v9)) {
+      return false;
+    }
+
+    if (!decode_Payload_value(v9, v)) {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool encode_Tagged(asn1::ber::encoder& enc, const Tagged& v)
+  {
+    if (!enc.start_constructed<asn1::ber::tag_class::ContextSpecific, 5>()) {
+      return false;
+    }
+
+    if (!encode_Payload_value(enc, v)) {
+      return false;
+    }
+
+    if (!enc.end_constructed()) {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool decode_Counter(const asn1::ber::value& val, Counter& v)
+  {
+    if (!asn1::ber::schema::match(val, tags_Counter)) {
+      return false;
+    }
+
+    if (!asn1::ber::schema::decode_integer(val, v)) {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool encode_Counter(asn1::ber::encoder& enc, const Counter& v)
+  {
+    if (!asn1::ber::schema::encode_integer<asn1::ber::tag_class::Application, 7>(enc, v)) {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool decode_Config(const asn1::ber::value& val, Config& v)
+  {
+    if (!asn1::ber::schema::match(val, tags_Config)) {
+      return false;
+    }
+
+    if (!decode_Config_value(val, v)) {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool encode_Config(asn1::ber::encoder& enc, const Config& v)
+  {
+    if (!encode_Config_value(enc, asn1::ber::tag_class::Universal, 17, v)) {
+      return false;
+    }
+
+    return true;
+  }
+}
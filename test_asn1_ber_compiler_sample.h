@@ -0,0 +1,188 @@
+// Generated by asn1_ber_compiler from the ASN.1 module Sample.
+// Do not edit.
+
+#ifndef TEST_ASN1_BER_COMPILER_SAMPLE_H
+#define TEST_ASN1_BER_COMPILER_SAMPLE_H
+
+#include "asn1/ber/schema/runtime.h"
+
+namespace sample {
+  // Forward declarations.
+  struct Record;
+  struct Record_attrs_element;
+  struct Payload;
+  struct Item;
+  struct Config;
+
+  // Kind.
+  enum class Kind : int64_t {
+    alpha = 0ll,
+    beta = 5ll,
+    gamma = 1ll
+  };
+
+  // Strict.
+  enum class Strict : int64_t {
+    one = 1ll,
+    two = 2ll
+  };
+
+  // Names.
+  typedef asn1::ber::schema::array<asn1::ber::schema::octets> Names;
+
+  // Tagged.
+  typedef Payload Tagged;
+
+  // Counter.
+  typedef int64_t Counter;
+
+  // Payload.
+  struct Payload {
+    // Alternatives.
+    enum class alternative {
+      none,
+      number,
+      text,
+      nested
+    };
+
+    // Present alternative.
+    alternative present = alternative::none;
+
+    // number.
+    int64_t number = 0ll;
+
+    // text.
+    asn1::ber::schema::octets text;
+
+    // nested.
+    asn1::ber::schema::array<Record> nested;
+  };
+
+  // Record.
+  struct Record {
+    // id.
+    int64_t id = 0ll;
+
+    // name.
+    asn1::ber::schema::octets name;
+
+    // active (default: true).
+    bool active = true;
+
+    // kind (default: static_cast<Kind>(5ll)).
+    Kind kind = static_cast<Kind>(5ll);
+
+    // when (optional).
+    bool has_when = false;
+    time_t when = 0;
+
+    // stamp (optional).
+    bool has_stamp = false;
+    struct timeval stamp = {0, 0};
+
+    // oid (optional).
+    bool has_oid = false;
+    asn1::ber::schema::oid oid;
+
+    // payload.
+    Payload payload;
+
+    // items.
+    asn1::ber::schema::array<Item> items;
+
+    // attrs.
+    asn1::ber::schema::array<Record_attrs_element> attrs;
+
+    // nothing (optional).
+    bool has_nothing = false;
+    asn1::ber::schema::null nothing;
+  };
+
+  // Record_attrs_element.
+  struct Record_attrs_element {
+    // key.
+    asn1::ber::schema::octets key;
+
+    // val.
+    int64_t val = 0ll;
+  };
+
+  // Item.
+  struct Item {
+    // count.
+    int64_t count = 0ll;
+
+    // class.
+    Strict class_ = static_cast<Strict>(1ll);
+  };
+
+  // Config.
+  struct Config {
+    // a.
+    int64_t a = 0ll;
+
+    // b (optional).
+    bool has_b = false;
+    bool b = false;
+
+    // c (default: -7ll).
+    int64_t c = -7ll;
+  };
+
+  // Decode Record.
+  bool decode_Record(const asn1::ber::value& val, Record& v);
+
+  // Encode Record.
+  bool encode_Record(asn1::ber::encoder& enc, const Record& v);
+
+  // Decode Kind.
+  bool decode_Kind(const asn1::ber::value& val, Kind& v);
+
+  // Encode Kind.
+  bool encode_Kind(asn1::ber::encoder& enc, const Kind& v);
+
+  // Decode Strict.
+  bool decode_Strict(const asn1::ber::value& val, Strict& v);
+
+  // Encode Strict.
+  bool encode_Strict(asn1::ber::encoder& enc, const Strict& v);
+
+  // Decode Payload.
+  bool decode_Payload(const asn1::ber::value& val, Payload& v);
+
+  // Encode Payload.
+  bool encode_Payload(asn1::ber::encoder& enc, const Payload& v);
+
+  // Decode Item.
+  bool decode_Item(const asn1::ber::value& val, Item& v);
+
+  // Encode Item.
+  bool encode_Item(asn1::ber::encoder& enc, const Item& v);
+
+  // Decode Names.
+  bool decode_Names(const asn1::ber::value& val, Names& v);
+
+  // Encode Names.
+  bool encode_Names(asn1::ber::encoder& enc, const Names& v);
+
+  // Decode Tagged.
+  bool decode_Tagged(const asn1::ber::value& val, Tagged& v);
+
+  // Encode Tagged.
+  bool encode_Tagged(asn1::ber::encoder& enc, const Tagged& v);
+
+  // Decode Counter.
+  bool decode_Counter(const asn1::ber::value& val, Counter& v);
+
+  // Encode Counter.
+  bool encode_Counter(asn1::ber::encoder& enc, const Counter& v);
+
+  // Decode Config.
+  bool decode_Config(const asn1::ber::value& val, Config& v);
+
+  // Encode Config.
+  bool encode_Config(asn1::ber::encoder& enc, const Config& v);
+}
+
+#endif // TEST_ASN1_BER_COMPILER_SAMPLE_H
@@ -1,6 +1,60 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "asn1/ber/encoder.h"
+#include "asn1/ber/stream_encoder.h"
+
+#if !defined(_WIN32)
+  #define O_BINARY 0
+#endif
+
+// Encode the same record with indefinite lengths.
+static bool stream(const char* filename)
+{
+  // Open file for writing.
+  const int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+
+  // If the file could be opened...
+  if (fd != -1) {
+    asn1::ber::stream_encoder encoder(fd);
+
+    if ((encoder.start_constructed(asn1::ber::tag_class::ContextSpecific,
+                                   0)) &&
+        (encoder.add_integer(asn1::ber::tag_class::ContextSpecific, 1, 314)) &&
+        (encoder.add_integer(asn1::ber::tag_class::ContextSpecific, 2, 315)) &&
+        (encoder.start_constructed(asn1::ber::tag_class::ContextSpecific,
+                                   3)) &&
+        (encoder.add_integer(asn1::ber::tag_class::ContextSpecific, 4, 316)) &&
+        (encoder.end_constructed()) &&
+        (encoder.start_constructed(asn1::ber::tag_class::ContextSpecific,
+                                   5)) &&
+        (encoder.add_integer(asn1::ber::tag_class::ContextSpecific, 6, 316)) &&
+        (encoder.add_data(asn1::ber::tag_class::ContextSpecific,
+                          7,
+                          "Testtest",
+                          8)) &&
+        (encoder.start_constructed(asn1::ber::tag_class::ContextSpecific,
+                                   8)) &&
+        (encoder.add_data(asn1::ber::tag_class::ContextSpecific,
+                          9,
+                          "AAAA",
+                          4)) &&
+        (encoder.add_generalized_time(asn1::ber::tag_class::ContextSpecific,
+                                      10)) &&
+        (encoder.end_constructed()) &&
+        (encoder.end_constructed()) &&
+        (encoder.end_constructed()) &&
+        (encoder.flush())) {
+      return (close(fd) == 0);
+    }
+
+    close(fd);
+    unlink(filename);
+  }
+
+  return false;
+}
 
 int main()
 {
@@ -30,7 +84,8 @@ int main()
       (encoder.end_constructed()) &&
       (encoder.end_constructed()) &&
       (encoder.end_constructed()) &&
-      (encoder.serialize("test.asn1"))) {
+      (encoder.serialize("test.asn1")) &&
+      (stream("test_stream.asn1"))) {
     printf("Success.\n");
     return 0;
   }
@@ -0,0 +1,599 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include "asn1/ber/json_printer.h"
+#include "asn1/ber/encoder.h"
+#include "string/buffer.h"
+
+#if !defined(_WIN32)
+  #include <unistd.h>
+  #include <sys/wait.h>
+#endif
+
+// Fixture file.
+static const char* const fixture = "test_json_printer.ber";
+
+// Maximum depth of the JSON values.
+static constexpr const unsigned max_json_depth = 64;
+
+// Print the UTF8String whose contents are `contents` and check that the
+// string is printed as `expected`.
+static bool test_utf8(const char* contents, const char* expected);
+
+// Well-formed and ill-formed UTF-8 sequences.
+static bool test_utf8();
+
+#if !defined(_WIN32)
+// Write the records of the fixture followed by the `len` octets of `trailer`
+// (a record which cannot be printed) to the fixture file.
+static bool write_fixture(const void* trailer, size_t len);
+
+// Run berdecoder with the arguments `args` on the fixture file and check
+// that it succeeds or fails (`success`) and that both formats print valid
+// JSON with `nrecords` records (JSON: array of `nrecords` objects, NDJSON:
+// `nrecords` lines, each with an object; -1: don't check the number of
+// records).
+static bool test_berdecoder(const char* args, bool success, int nrecords);
+
+// Output of berdecoder on valid data, after a record which cannot be decoded
+// and after a truncated record.
+static bool test_berdecoder();
+
+// Check that `s` is a JSON value (and skip it).
+static bool json_value(const char*& s, const char* end, unsigned depth);
+static bool json_string(const char*& s, const char* end);
+static bool json_number(const char*& s, const char* end);
+static bool json_literal(const char*& s, const char* end, const char* literal);
+static void json_whitespace(const char*& s, const char* end);
+#endif // !defined(_WIN32)
+
+int main()
+{
+  if ((test_utf8())
+#if !defined(_WIN32)
+      && (test_berdecoder())
+#endif
+     ) {
+    printf("Success.\n");
+    return 0;
+  }
+
+  fprintf(stderr, "Error.\n");
+
+  return -1;
+}
+
+bool test_utf8(const char* contents, const char* expected)
+{
+  const size_t len = strlen(contents);
+
+  // UTF8String.
+  string::buffer in;
+  if ((!in.push_back(0x0c)) ||
+      (!in.push_back(static_cast<uint8_t>(len))) ||
+      (!in.append(contents, len))) {
+    fprintf(stderr, "Error allocating memory.\n");
+    return false;
+  }
+
+  string::buffer out;
+
+  asn1::ber::json_printer printer;
+  printer.output(&out);
+
+  size_t l = in.length();
+  if (!printer.print(0, in.data(), l)) {
+    fprintf(stderr, "Error printing UTF8String.\n");
+    return false;
+  }
+
+  string::buffer buf;
+  if ((!buf.format("{\"offset\":0,\"[UNIVERSAL 12]\":\"%s\"}\n", expected)) ||
+      (!buf.push_back(0))) {
+    fprintf(stderr, "Error allocating memory.\n");
+    return false;
+  }
+
+  if ((out.length() + 1 != buf.length()) ||
+      (memcmp(out.data(), buf.data(), out.length()) != 0)) {
+    fprintf(stderr,
+            "Expected: %s"
+            "Got:      %.*s",
+            static_cast<const char*>(buf.data()),
+            static_cast<int>(out.length()),
+            static_cast<const char*>(out.data()));
+
+    return false;
+  }
+
+  return true;
+}
+
+bool test_utf8()
+{
+  return (
+    // ASCII and escaped characters.
+    (test_utf8("a\"b\\c\nd\te\x01", "a\\\"b\\\\c\\nd\\te\\u0001")) &&
+
+    // Well-formed sequences (2, 3 and 4 octets, first and last code points).
+    (test_utf8("h\xc3\xa9", "h\xc3\xa9")) &&
+    (test_utf8("\xc2\x80\xdf\xbf", "\xc2\x80\xdf\xbf")) &&
+    (test_utf8("\xe2\x82\xac", "\xe2\x82\xac")) &&
+    (test_utf8("\xe0\xa0\x80\xed\x9f\xbf\xee\x80\x80",
+               "\xe0\xa0\x80\xed\x9f\xbf\xee\x80\x80")) &&
+    (test_utf8("\xf0\x9f\x98\x80", "\xf0\x9f\x98\x80")) &&
+    (test_utf8("\xf0\x90\x80\x80\xf4\x8f\xbf\xbf",
+               "\xf0\x90\x80\x80\xf4\x8f\xbf\xbf")) &&
+
+    // Overlong forms.
+    (test_utf8("\xc0\xaf", "\\u00c0\\u00af")) &&
+    (test_utf8("\xc1\xbf", "\\u00c1\\u00bf")) &&
+    (test_utf8("\xe0\x80\xaf", "\\u00e0\\u0080\\u00af")) &&
+    (test_utf8("\xf0\x80\x80\xaf", "\\u00f0\\u0080\\u0080\\u00af")) &&
+
+    // Surrogates.
+    (test_utf8("\xed\xa0\x80", "\\u00ed\\u00a0\\u0080")) &&
+    (test_utf8("\xed\xbf\xbf", "\\u00ed\\u00bf\\u00bf")) &&
+
+    // Values above U+10FFFF.
+    (test_utf8("\xf4\x90\x80\x80", "\\u00f4\\u0090\\u0080\\u0080")) &&
+    (test_utf8("\xf5\x80\x80\x80", "\\u00f5\\u0080\\u0080\\u0080")) &&
+    (test_utf8("\xff", "\\u00ff")) &&
+
+    // Unexpected continuation octets.
+    (test_utf8("\x80", "\\u0080")) &&
+    (test_utf8("a\xbf" "b", "a\\u00bfb")) &&
+
+    // Missing continuation octets.
+    (test_utf8("\xc3(", "\\u00c3(")) &&
+    (test_utf8("\xe2\x82(", "\\u00e2\\u0082(")) &&
+
+    // Truncated sequences.
+    (test_utf8("\xc3", "\\u00c3")) &&
+    (test_utf8("a\xe2\x82", "a\\u00e2\\u0082")) &&
+    (test_utf8("\xf0\x9f\x98", "\\u00f0\\u009f\\u0098")) &&
+
+    // Well-formed sequence after an ill-formed one.
+    (test_utf8("\xe2\xc3\xa9", "\\u00e2\xc3\xa9"))
+  );
+}
+
+#if !defined(_WIN32)
+bool write_fixture(const void* trailer, size_t len)
+{
+  // Records: a SEQUENCE with values of several types (among them, repeated
+  // tags and strings which have to be escaped), a SEQUENCE with a nested
+  // constructed value and an empty constructed value.
+  asn1::ber::encoder encoder;
+
+  struct timeval tv;
+  tv.tv_sec = 1700000000;
+  tv.tv_usec = 250000;
+
+  string::buffer buf;
+  if ((encoder.start_constructed(asn1::ber::tag_class::Universal, 16)) &&
+      (encoder.add_integer(asn1::ber::tag_class::Universal, 2, -5)) &&
+      (encoder.add_boolean(asn1::ber::tag_class::Universal, 1, true)) &&
+      (encoder.add_null(asn1::ber::tag_class::Universal, 5)) &&
+      (encoder.add_data(asn1::ber::tag_class::Universal,
+                        6,
+                        "\x2a\x86\x48\x86\xf7\x0d",
+                        6)) &&
+      (encoder.add_data(asn1::ber::tag_class::Universal,
+                        12,
+                        "\"q\"\n\\\xc3\xa9\xc0\xaf\xed\xa0\x80",
+                        12)) &&
+      (encoder.add_data(asn1::ber::tag_class::Universal, 22, "a\x01\xe9", 3)) &&
+      (encoder.add_data(asn1::ber::tag_class::ContextSpecific, 0, "\xff", 1)) &&
+      (encoder.add_data(asn1::ber::tag_class::ContextSpecific, 0, "", 0)) &&
+      (encoder.add_generalized_time(asn1::ber::tag_class::Universal, 24, tv)) &&
+      (encoder.end_constructed()) &&
+      (encoder.start_constructed(asn1::ber::tag_class::Universal, 16)) &&
+      (encoder.start_constructed(asn1::ber::tag_class::Application, 1)) &&
+      (encoder.add_integer(asn1::ber::tag_class::ContextSpecific, 0, 1)) &&
+      (encoder.add_integer(asn1::ber::tag_class::ContextSpecific, 0, 2)) &&
+      (encoder.end_constructed()) &&
+      (encoder.end_constructed()) &&
+      (encoder.start_constructed(asn1::ber::tag_class::Private, 2)) &&
+      (encoder.end_constructed()) &&
+      (encoder.serialize(buf)) &&
+      (buf.append(trailer, len))) {
+    FILE* const file = fopen(fixture, "wb");
+    if (file) {
+      const bool ret = (fwrite(buf.data(), 1, buf.length(), file) ==
+                        buf.length());
+
+      if ((fclose(file) == 0) && (ret)) {
+        return true;
+      }
+
+      unlink(fixture);
+    }
+  }
+
+  fprintf(stderr, "Error writing fixture.\n");
+
+  return false;
+}
+
+bool test_berdecoder(const char* args, bool success, int nrecords)
+{
+  static const char* const formats[] = {"json", "ndjson"};
+
+  for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++) {
+    string::buffer cmd;
+    if (!cmd.format("./berdecoder -f %s %s %s 2>/dev/null",
+                    formats[i],
+                    args,
+                    fixture)) {
+      fprintf(stderr, "Error allocating memory.\n");
+      return false;
+    }
+
+    // Run berdecoder.
+    FILE* const pipe = popen(static_cast<const char*>(cmd.data()), "r");
+    if (!pipe) {
+      fprintf(stderr, "Error running '%s'.\n", cmd.data());
+      return false;
+    }
+
+    string::buffer out;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), pipe)) > 0) {
+      if (!out.append(buf, n)) {
+        pclose(pipe);
+
+        fprintf(stderr, "Error allocating memory.\n");
+        return false;
+      }
+    }
+
+    const int status = pclose(pipe);
+
+    // If berdecoder didn't succeed or fail as expected...
+    if ((!WIFEXITED(status)) || ((WEXITSTATUS(status) == 0) != success)) {
+      fprintf(stderr, "'%s': unexpected exit status.\n", cmd.data());
+      return false;
+    }
+
+    const char* s = static_cast<const char*>(out.data());
+    const char* const end = s + out.length();
+
+    int count = 0;
+
+    // JSON?
+    if (i == 0) {
+      json_whitespace(s, end);
+
+      // Count the elements of the array.
+      if ((s < end) && (*s == '[')) {
+        json_whitespace(++s, end);
+
+        bool closed = false;
+
+        if ((s < end) && (*s == ']')) {
+          s++;
+          closed = true;
+        } else {
+          while ((s < end) && (*s == '{') && (json_value(s, end, 1))) {
+            count++;
+
+            json_whitespace(s, end);
+
+            if ((s < end) && (*s == ',')) {
+              json_whitespace(++s, end);
+            } else {
+              if ((s < end) && (*s == ']')) {
+                s++;
+                closed = true;
+              }
+
+              break;
+            }
+          }
+        }
+
+        if (closed) {
+          json_whitespace(s, end);
+        } else {
+          s = nullptr;
+        }
+      } else {
+        s = nullptr;
+      }
+    } else {
+      // One object per line.
+      while (s < end) {
+        const char* const
+          eol = static_cast<const char*>(memchr(s, '\n', end - s));
+
+        if ((!eol) || (*s != '{') || (!json_value(s, eol, 0))) {
+          break;
+        }
+
+        json_whitespace(s, eol);
+
+        if (s != eol) {
+          break;
+        }
+
+        s = eol + 1;
+        count++;
+      }
+    }
+
+    // If the output is not valid JSON...
+    if (s != end) {
+      fprintf(stderr,
+              "'%s': invalid output:\n%.*s\n",
+              cmd.data(),
+              static_cast<int>(out.length()),
+              static_cast<const char*>(out.data()));
+
+      return false;
+    }
+
+    if ((nrecords >= 0) && (count != nrecords)) {
+      fprintf(stderr,
+              "'%s': %d records (expected: %d).\n",
+              cmd.data(),
+              count,
+              nrecords);
+
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool test_berdecoder()
+{
+  // BOOLEAN with two contents octets (can be framed, but not decoded).
+  static const uint8_t invalid_boolean[] = {0x01, 0x02, 0xff, 0xff};
+
+  // Truncated SEQUENCE.
+  static const uint8_t truncated[] = {0x30, 0x05, 0x02, 0x01};
+
+  const bool ret = (
+    // Valid data.
+    (write_fixture(nullptr, 0)) &&
+    (test_berdecoder("", true, 3)) &&
+    (test_berdecoder("-j 2", true, 3)) &&
+    (test_berdecoder("-q '[UNIVERSAL 16]'", true, 2)) &&
+    (test_berdecoder("-q '**'", true, -1)) &&
+
+    // Record which cannot be decoded.
+    (write_fixture(invalid_boolean, sizeof(invalid_boolean))) &&
+    (test_berdecoder("", false, 3)) &&
+    (test_berdecoder("-j 2", false, 3)) &&
+    (test_berdecoder("-q '**'", false, -1)) &&
+
+    // Truncated record.
+    (write_fixture(truncated, sizeof(truncated))) &&
+    (test_berdecoder("", false, 3)) &&
+    (test_berdecoder("-j 2", false, 3))
+  );
+
+  unlink(fixture);
+
+  return ret;
+}
+
+bool json_value(const char*& s, const char* end, unsigned depth)
+{
+  json_whitespace(s, end);
+
+  if ((s == end) || (depth > max_json_depth)) {
+    return false;
+  }
+
+  switch (*s) {
+    case '{':
+    case '[':
+      {
+        const char close = (*s == '{') ? '}' : ']';
+
+        json_whitespace(++s, end);
+
+        if ((s < end) && (*s == close)) {
+          s++;
+          return true;
+        }
+
+        do {
+          // Member name.
+          if (close == '}') {
+            if (!json_string(s, end)) {
+              return false;
+            }
+
+            json_whitespace(s, end);
+
+            if ((s == end) || (*s++ != ':')) {
+              return false;
+            }
+          }
+
+          if (!json_value(s, end, depth + 1)) {
+            return false;
+          }
+
+          json_whitespace(s, end);
+
+          if (s == end) {
+            return false;
+          }
+
+          if (*s == close) {
+            s++;
+            return true;
+          }
+
+          if (*s++ != ',') {
+            return false;
+          }
+
+          json_whitespace(s, end);
+        } while (true);
+      }
+    case '"':
+      return json_string(s, end);
+    case 't':
+      return json_literal(s, end, "true");
+    case 'f':
+      return json_literal(s, end, "false");
+    case 'n':
+      return json_literal(s, end, "null");
+    default:
+      return json_number(s, end);
+  }
+}
+
+bool json_string(const char*& s, const char* end)
+{
+  if ((s == end) || (*s++ != '"')) {
+    return false;
+  }
+
+  while (s < end) {
+    const uint8_t c = static_cast<uint8_t>(*s++);
+
+    if (c == '"') {
+      return true;
+    } else if (c == '\\') {
+      if (s == end) {
+        return false;
+      }
+
+      switch (*s++) {
+        case '"':
+        case '\\':
+        case '/':
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+          break;
+        case 'u':
+          for (size_t i = 0; i < 4; i++) {
+            if ((s == end) || (!isxdigit(static_cast<uint8_t>(*s++)))) {
+              return false;
+            }
+          }
+
+          break;
+        default:
+          return false;
+      }
+    } else if (c < 0x20) {
+      // Control characters have to be escaped.
+      return false;
+    } else if (c >= 0x80) {
+      // Well-formed UTF-8 sequence.
+      size_t n;
+      uint8_t min = 0x80;
+      uint8_t max = 0xbf;
+
+      if ((c >= 0xc2) && (c <= 0xdf)) {
+        n = 1;
+      } else if ((c >= 0xe0) && (c <= 0xef)) {
+        n = 2;
+        min = (c == 0xe0) ? 0xa0 : 0x80;
+        max = (c == 0xed) ? 0x9f : 0xbf;
+      } else if ((c >= 0xf0) && (c <= 0xf4)) {
+        n = 3;
+        min = (c == 0xf0) ? 0x90 : 0x80;
+        max = (c == 0xf4) ? 0x8f : 0xbf;
+      } else {
+        return false;
+      }
+
+      if ((static_cast<size_t>(end - s) < n) ||
+          (static_cast<uint8_t>(s[0]) < min) ||
+          (static_cast<uint8_t>(s[0]) > max)) {
+        return false;
+      }
+
+      for (size_t i = 1; i < n; i++) {
+        if ((static_cast<uint8_t>(s[i]) & 0xc0) != 0x80) {
+          return false;
+        }
+      }
+
+      s += n;
+    }
+  }
+
+  return false;
+}
+
+bool json_number(const char*& s, const char* end)
+{
+  if ((s < end) && (*s == '-')) {
+    s++;
+  }
+
+  // Integer part.
+  if ((s < end) && (*s == '0')) {
+    s++;
+  } else if ((s < end) && (*s >= '1') && (*s <= '9')) {
+    do {
+      s++;
+    } while ((s < end) && (*s >= '0') && (*s <= '9'));
+  } else {
+    return false;
+  }
+
+  // Fraction.
+  if ((s < end) && (*s == '.')) {
+    if ((++s == end) || (*s < '0') || (*s > '9')) {
+      return false;
+    }
+
+    do {
+      s++;
+    } while ((s < end) && (*s >= '0') && (*s <= '9'));
+  }
+
+  // Exponent.
+  if ((s < end) && ((*s == 'e') || (*s == 'E'))) {
+    if ((++s < end) && ((*s == '+') || (*s == '-'))) {
+      s++;
+    }
+
+    if ((s == end) || (*s < '0') || (*s > '9')) {
+      return false;
+    }
+
+    do {
+      s++;
+    } while ((s < end) && (*s >= '0') && (*s <= '9'));
+  }
+
+  return true;
+}
+
+bool json_literal(const char*& s, const char* end, const char* literal)
+{
+  const size_t len = strlen(literal);
+
+  if ((static_cast<size_t>(end - s) >= len) && (memcmp(s, literal, len) == 0)) {
+    s += len;
+    return true;
+  }
+
+  return false;
+}
+
+void json_whitespace(const char*& s, const char* end)
+{
+  while ((s < end) &&
+         ((*s == ' ') || (*s == '\t') || (*s == '\r') || (*s == '\n'))) {
+    s++;
+  }
+}
+#endif // !defined(_WIN32)
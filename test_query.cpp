@@ -0,0 +1,362 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "asn1/ber/query.h"
+#include "string/buffer.h"
+
+// Records (offset: value):
+//  0: [APPLICATION 1] {
+//       2: [0] 01
+//       5: [1] {
+//            7: [0] 02
+//           10: [0] 03
+//           13: [UNIVERSAL 16] {
+//                 15: [0] 04
+//                 18: [UNIVERSAL 12] "a"
+//               }
+//          }
+//      21: [0] 05
+//      24: [UNIVERSAL 2] 6
+//     }
+// 27: [APPLICATION 2] {
+//      29: [0] 07
+//     }
+static const uint8_t records[] = {
+  0x61, 0x19,
+        0x80, 0x01, 0x01,
+        0xa1, 0x0e,
+              0x80, 0x01, 0x02,
+              0x80, 0x01, 0x03,
+              0x30, 0x06,
+                    0x80, 0x01, 0x04,
+                    0x0c, 0x01, 0x61,
+        0x80, 0x01, 0x05,
+        0x02, 0x01, 0x06,
+  0x62, 0x03,
+        0x80, 0x01, 0x07
+};
+
+// [APPLICATION 1] { [0] { [0] { [1] 05 } } } (a value which matches the path
+// "**/[0]/**/[1]" in two ways).
+static const uint8_t nested_records[] = {
+  0x61, 0x07, 0xa0, 0x05, 0xa0, 0x03, 0x81, 0x01, 0x05
+};
+
+// Matches.
+struct matches {
+  // Offsets (separated by commas).
+  string::buffer offsets;
+
+  // Number of matches.
+  size_t count;
+
+  // Maximum number of matches (0: no maximum).
+  size_t max;
+};
+
+// Build `depth` nested definite-length SEQUENCEs around the primitive
+// context-specific value [0] (`30 84 <length> ... 80 00`).
+static bool nested(size_t depth, string::buffer& buf);
+
+// Count matches.
+static bool count(const asn1::ber::value& val, size_t offset, void* user);
+
+// Save offset of the match.
+static bool save(const asn1::ber::value& val, size_t offset, void* user);
+
+// Run `path` on `data` and check that the values at the offsets `offsets`
+// (separated by commas, in this order) match; the query is stopped after
+// `max` matches (0: not stopped).
+static bool test_offsets(const char* path,
+                         const void* data,
+                         size_t len,
+                         const char* offsets,
+                         size_t max = 0);
+
+// Check that the path `path` is valid or not.
+static bool test_compile(const char* path, bool valid);
+
+// Run `path` on `depth` nested SEQUENCEs and check the result.
+static bool test(const char* path,
+                 size_t depth,
+                 bool success,
+                 asn1::ber::decoder::result error,
+                 size_t nmatches);
+
+int main()
+{
+  if (
+      // Values at the maximum depth are found.
+      (test("**/[0]", 128, true, asn1::ber::decoder::result::no_error, 1)) &&
+      (test("**", 128, true, asn1::ber::decoder::result::no_error, 129)) &&
+
+      // Deeper values make the query fail (instead of overflowing the stack).
+      (test("**/[0]",
+            129,
+            false,
+            asn1::ber::decoder::result::max_depth_exceeded,
+            0)) &&
+      (test("**/[0]",
+            200000,
+            false,
+            asn1::ber::decoder::result::max_depth_exceeded,
+            0)) &&
+      (test("[UNIVERSAL 16]/**/[0]",
+            200000,
+            false,
+            asn1::ber::decoder::result::max_depth_exceeded,
+            0)) &&
+
+      // The values which are not visited are skipped using their lengths.
+      (test("[UNIVERSAL 16]/[UNIVERSAL 16]",
+            200000,
+            true,
+            asn1::ber::decoder::result::no_error,
+            1)) &&
+
+      // Tags ([CLASS n], context-specific by default).
+      (test_offsets("[APPLICATION 1]", records, sizeof(records), "0")) &&
+      (test_offsets("[APPLICATION 1]/[0]",
+                    records,
+                    sizeof(records),
+                    "2,21")) &&
+      (test_offsets("[APPLICATION 1]/[CONTEXT 0]",
+                    records,
+                    sizeof(records),
+                    "2,21")) &&
+      (test_offsets("[APPLICATION 1]/[UNIVERSAL 2]",
+                    records,
+                    sizeof(records),
+                    "24")) &&
+      (test_offsets("[APPLICATION 1]/[1]/[UNIVERSAL 16]/[UNIVERSAL 12]",
+                    records,
+                    sizeof(records),
+                    "18")) &&
+      (test_offsets("[PRIVATE 1]", records, sizeof(records), "")) &&
+
+      // Any value.
+      (test_offsets("*", records, sizeof(records), "0,27")) &&
+      (test_offsets("*/*", records, sizeof(records), "2,5,21,24,29")) &&
+
+      // Occurrences among the siblings.
+      (test_offsets("[APPLICATION 1]/[0]#1",
+                    records,
+                    sizeof(records),
+                    "21")) &&
+      (test_offsets("[APPLICATION 1]/[1]/[0]#1",
+                    records,
+                    sizeof(records),
+                    "10")) &&
+      (test_offsets("[APPLICATION 1]/[0]#2", records, sizeof(records), "")) &&
+      (test_offsets("*/*#1", records, sizeof(records), "5")) &&
+      (test_offsets("**/[0]#1", records, sizeof(records), "10,21")) &&
+
+      // Any number of levels (including none).
+      (test_offsets("**",
+                    records,
+                    sizeof(records),
+                    "0,2,5,7,10,13,15,18,21,24,27,29")) &&
+      (test_offsets("**/[0]", records, sizeof(records), "2,7,10,15,21,29")) &&
+      (test_offsets("[APPLICATION 1]/**/[0]",
+                    records,
+                    sizeof(records),
+                    "2,7,10,15,21")) &&
+      (test_offsets("**/[UNIVERSAL 16]/**",
+                    records,
+                    sizeof(records),
+                    "15,18")) &&
+      (test_offsets("[APPLICATION 2]/**", records, sizeof(records), "29")) &&
+
+      // Values matching the path in several ways are reported once.
+      (test_offsets("**/*/**",
+                    records,
+                    sizeof(records),
+                    "2,5,7,10,13,15,18,21,24,29")) &&
+      (test_offsets("**/[0]/**/[1]",
+                    nested_records,
+                    sizeof(nested_records),
+                    "6")) &&
+      (test_offsets("**/[0]/**/[0]",
+                    nested_records,
+                    sizeof(nested_records),
+                    "4")) &&
+
+      // The callback stops the query.
+      (test_offsets("**", records, sizeof(records), "0,2,5", 3)) &&
+      (test_offsets("**/[0]", records, sizeof(records), "2", 1)) &&
+
+      // Valid and invalid paths.
+      (test_compile("[PRIVATE 4294967295]#0", true)) &&
+      (test_compile("*/**/*#3/[UNIVERSAL 16]", true)) &&
+      (test_compile("", false)) &&
+      (test_compile("/**/**/", false)) &&
+      (test_compile("**/**", false)) &&
+      (test_compile("[1]/", false)) &&
+      (test_compile("[1]//[2]", false)) &&
+      (test_compile("[APPLICATION]", false)) &&
+      (test_compile("[application 1]", false)) &&
+      (test_compile("[1", false)) &&
+      (test_compile("1", false)) &&
+      (test_compile("[1]#", false)) &&
+      (test_compile("[1]x", false)) &&
+      (test_compile("***", false)) &&
+      (test_compile("**#1", false)) &&
+      (test_compile("[PRIVATE 4294967296]", false)) &&
+      (test_compile("*/*/*/*/*/*/*/*/*/*/*/*/*/*/*/*/"
+                    "*/*/*/*/*/*/*/*/*/*/*/*/*/*/*/*",
+                    true)) &&
+      (test_compile("*/*/*/*/*/*/*/*/*/*/*/*/*/*/*/*/"
+                    "*/*/*/*/*/*/*/*/*/*/*/*/*/*/*/*/*",
+                    false))) {
+    printf("Success.\n");
+    return 0;
+  }
+
+  fprintf(stderr, "Error.\n");
+
+  return -1;
+}
+
+bool nested(size_t depth, string::buffer& buf)
+{
+  static constexpr const size_t header_length = 6;
+
+  buf.clear();
+
+  // Reserve memory for the SEQUENCEs and the primitive value.
+  const size_t len = (depth * header_length) + 2;
+  if (!buf.resize(len)) {
+    return false;
+  }
+
+  uint8_t* const data = static_cast<uint8_t*>(const_cast<void*>(buf.data()));
+
+  // Primitive value.
+  data[len - 2] = 0x80;
+  data[len - 1] = 0x00;
+
+  // SEQUENCEs (from the innermost one).
+  for (size_t i = depth; i > 0; i--) {
+    uint8_t* const hdr = data + ((i - 1) * header_length);
+    const size_t contents_length = len - (i * header_length);
+
+    hdr[0] = 0x30;
+    hdr[1] = 0x84;
+    hdr[2] = static_cast<uint8_t>(contents_length >> 24);
+    hdr[3] = static_cast<uint8_t>(contents_length >> 16);
+    hdr[4] = static_cast<uint8_t>(contents_length >> 8);
+    hdr[5] = static_cast<uint8_t>(contents_length);
+  }
+
+  return true;
+}
+
+bool count(const asn1::ber::value& val, size_t offset, void* user)
+{
+  (*static_cast<size_t*>(user))++;
+  return true;
+}
+
+bool test(const char* path,
+          size_t depth,
+          bool success,
+          asn1::ber::decoder::result error,
+          size_t nmatches)
+{
+  asn1::ber::query query;
+  if (!query.compile(path)) {
+    fprintf(stderr, "Error compiling query '%s'.\n", path);
+    return false;
+  }
+
+  string::buffer buf;
+  if (!nested(depth, buf)) {
+    fprintf(stderr, "Error allocating memory.\n");
+    return false;
+  }
+
+  size_t n = 0;
+  asn1::ber::decoder::result res;
+  const bool ret = query.run(buf.data(), buf.length(), count, &n, &res);
+
+  if ((ret != success) || (res != error) || (n != nmatches)) {
+    fprintf(stderr,
+            "Query '%s' on %zu nested values: %s (%s), %zu matches "
+            "(expected: %s (%s), %zu matches).\n",
+            path,
+            depth,
+            ret ? "success" : "failure",
+            asn1::ber::to_string(res),
+            n,
+            success ? "success" : "failure",
+            asn1::ber::to_string(error),
+            nmatches);
+
+    return false;
+  }
+
+  return true;
+}
+
+bool save(const asn1::ber::value& val, size_t offset, void* user)
+{
+  matches* const m = static_cast<matches*>(user);
+
+  if (!m->offsets.format((m->count > 0) ? ",%zu" : "%zu", offset)) {
+    return false;
+  }
+
+  m->count++;
+
+  // Stop the query after `max` matches.
+  return ((m->max == 0) || (m->count < m->max));
+}
+
+bool test_offsets(const char* path,
+                  const void* data,
+                  size_t len,
+                  const char* offsets,
+                  size_t max)
+{
+  asn1::ber::query query;
+  if (!query.compile(path)) {
+    fprintf(stderr, "Error compiling query '%s'.\n", path);
+    return false;
+  }
+
+  matches m;
+  m.count = 0;
+  m.max = max;
+
+  if ((!query.run(data, len, save, &m)) || (!m.offsets.push_back(0))) {
+    fprintf(stderr, "Error running query '%s'.\n", path);
+    return false;
+  }
+
+  if (strcmp(static_cast<const char*>(m.offsets.data()), offsets) != 0) {
+    fprintf(stderr,
+            "Query '%s': offsets %s (expected: %s).\n",
+            path,
+            static_cast<const char*>(m.offsets.data()),
+            offsets);
+
+    return false;
+  }
+
+  return true;
+}
+
+bool test_compile(const char* path, bool valid)
+{
+  asn1::ber::query query;
+  if (query.compile(path) != valid) {
+    fprintf(stderr,
+            "Path '%s' should be %s.\n",
+            path,
+            valid ? "valid" : "invalid");
+
+    return false;
+  }
+
+  return true;
+}
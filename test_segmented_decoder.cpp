@@ -0,0 +1,339 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "asn1/ber/decoder.h"
+#include "asn1/ber/segmented_decoder.h"
+#include "string/buffer.h"
+
+// Number of inputs.
+static constexpr const size_t number_inputs = 20000;
+
+// Maximum number of records per input.
+static constexpr const unsigned max_records = 4;
+
+// Maximum depth of the generated values.
+static constexpr const unsigned max_depth = 5;
+
+// Maximum length of the contents of the generated primitive values.
+static constexpr const unsigned max_primitive_length = 40;
+
+// Maximum length of the segments.
+static constexpr const unsigned max_segment_length = 7;
+
+// Pseudo-random number generator (xorshift64*).
+static uint64_t state = 0x9e3779b97f4a7c15ull;
+
+static uint32_t next_random(uint32_t n);
+
+// Generate a data value.
+static bool generate(string::buffer& buf, unsigned depth);
+
+// Append identifier octets.
+static bool append_identifier(string::buffer& buf, bool constructed);
+
+// Append length octets.
+static bool append_length(string::buffer& buf, size_t len);
+
+// Corrupt the input (truncate it, change octets or leave it unchanged).
+static void corrupt(string::buffer& buf);
+
+// Split the input into segments of 0 .. `max_segment_length` octets (array of
+// `struct iovec` stored in `segments`).
+static bool split(const string::buffer& buf, string::buffer& segments);
+
+// Walk the data values (depth-first) and record the results, the values and
+// the contents of the primitive values in `out` (returns false on error).
+template<typename Decoder>
+static bool walk(Decoder& decoder, string::buffer& out);
+
+int main()
+{
+  string::buffer in;
+  string::buffer expected;
+  string::buffer out;
+  string::buffer segments;
+
+  for (size_t i = 0; i < number_inputs; i++) {
+    // Generate input.
+    in.clear();
+
+    for (unsigned n = 1 + next_random(max_records); n > 0; n--) {
+      if (!generate(in, 0)) {
+        fprintf(stderr, "Error generating input.\n");
+        return -1;
+      }
+    }
+
+    corrupt(in);
+
+    if (!split(in, segments)) {
+      fprintf(stderr, "Error allocating memory.\n");
+      return -1;
+    }
+
+    // Walk the input with the decoder...
+    asn1::ber::decoder decoder(in.data(), in.length());
+
+    expected.clear();
+    walk(decoder, expected);
+
+    // ... and with the segmented decoder.
+    asn1::ber::segmented_decoder
+      segmented_decoder(static_cast<const struct iovec*>(segments.data()),
+                        segments.length() / sizeof(struct iovec));
+
+    out.clear();
+    walk(segmented_decoder, out);
+
+    // If the walks differ...
+    if ((out.length() != expected.length()) ||
+        (memcmp(out.data(), expected.data(), out.length()) != 0)) {
+      fprintf(stderr, "Walks differ for the input %zu:", i);
+
+      const uint8_t* const data = static_cast<const uint8_t*>(in.data());
+      for (size_t j = 0; j < in.length(); j++) {
+        fprintf(stderr, " %02x", data[j]);
+      }
+
+      fprintf(stderr, "\n");
+
+      return -1;
+    }
+  }
+
+  printf("Success.\n");
+
+  return 0;
+}
+
+uint32_t next_random(uint32_t n)
+{
+  state ^= state >> 12;
+  state ^= state << 25;
+  state ^= state >> 27;
+
+  return static_cast<uint32_t>((state * 0x2545f4914f6cdd1dull) >> 32) % n;
+}
+
+bool generate(string::buffer& buf, unsigned depth)
+{
+  // Primitive?
+  if ((depth == max_depth) || (next_random(3) != 0)) {
+    const size_t len = next_random(max_primitive_length + 1);
+
+    if ((!append_identifier(buf, false)) || (!append_length(buf, len))) {
+      return false;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+      if (!buf.push_back(static_cast<uint8_t>(next_random(256)))) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  if (!append_identifier(buf, true)) {
+    return false;
+  }
+
+  const unsigned nchildren = next_random(4);
+
+  // Indefinite length?
+  if (next_random(2) == 0) {
+    if (!buf.push_back(0x80)) {
+      return false;
+    }
+
+    for (unsigned i = 0; i < nchildren; i++) {
+      if (!generate(buf, depth + 1)) {
+        return false;
+      }
+    }
+
+    // End-of-contents.
+    return buf.append(2, 0);
+  }
+
+  // Generate the children and insert the length octets before them.
+  string::buffer contents;
+  for (unsigned i = 0; i < nchildren; i++) {
+    if (!generate(contents, depth + 1)) {
+      return false;
+    }
+  }
+
+  return ((append_length(buf, contents.length())) && (buf.append(contents)));
+}
+
+bool append_identifier(string::buffer& buf, bool constructed)
+{
+  const uint8_t tag_class = static_cast<uint8_t>(next_random(4) << 6);
+  const uint8_t pc = constructed ? 0x20 : 0x00;
+
+  // Low tag number (not end-of-contents)?
+  if (next_random(4) != 0) {
+    return buf.push_back(tag_class | pc | static_cast<uint8_t>(1 + next_random(30)));
+  }
+
+  // High tag number.
+  uint32_t tag_number = next_random(0x200000);
+
+  uint8_t octets[3];
+  size_t n = 0;
+
+  do {
+    octets[n++] = tag_number & 0x7f;
+    tag_number >>= 7;
+  } while (tag_number > 0);
+
+  if (!buf.push_back(tag_class | pc | 0x1f)) {
+    return false;
+  }
+
+  while (n > 1) {
+    if (!buf.push_back(octets[--n] | 0x80)) {
+      return false;
+    }
+  }
+
+  return buf.push_back(octets[0]);
+}
+
+bool append_length(string::buffer& buf, size_t len)
+{
+  // Short form?
+  if ((len < 0x80) && (next_random(4) != 0)) {
+    return buf.push_back(static_cast<uint8_t>(len));
+  }
+
+  // Long form (with leading zeros, sometimes).
+  const unsigned n = 1 + next_random(4);
+
+  if (!buf.push_back(static_cast<uint8_t>(0x80 | n))) {
+    return false;
+  }
+
+  for (unsigned i = n; i > 0; i--) {
+    const size_t shift = (i - 1) * 8;
+    if (!buf.push_back((shift < 32) ? static_cast<uint8_t>(len >> shift) : 0)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void corrupt(string::buffer& buf)
+{
+  if (buf.empty()) {
+    return;
+  }
+
+  switch (next_random(3)) {
+    case 0:
+      // Truncate.
+      buf.resize(next_random(static_cast<uint32_t>(buf.length())));
+      break;
+    case 1:
+      {
+        // Change octets.
+        uint8_t* const
+          data = static_cast<uint8_t*>(const_cast<void*>(buf.data()));
+
+        for (unsigned n = 1 + next_random(3); n > 0; n--) {
+          data[next_random(static_cast<uint32_t>(buf.length()))] =
+            static_cast<uint8_t>(next_random(256));
+        }
+      }
+
+      break;
+    default:
+      break;
+  }
+}
+
+bool split(const string::buffer& buf, string::buffer& segments)
+{
+  const uint8_t* const data = static_cast<const uint8_t*>(buf.data());
+
+  segments.clear();
+
+  for (size_t offset = 0; offset < buf.length(); ) {
+    size_t len = next_random(max_segment_length + 1);
+    if (len > buf.length() - offset) {
+      len = buf.length() - offset;
+    }
+
+    struct iovec iov;
+    iov.iov_base = const_cast<uint8_t*>(data + offset);
+    iov.iov_len = len;
+
+    if (!segments.append(&iov, sizeof(struct iovec))) {
+      return false;
+    }
+
+    offset += len;
+  }
+
+  return true;
+}
+
+template<typename Decoder>
+bool walk(Decoder& decoder, string::buffer& out)
+{
+  do {
+    asn1::ber::value val;
+    const asn1::ber::decoder::result res = decoder.next(val);
+
+    const uint8_t r = static_cast<uint8_t>(res);
+    if (!out.push_back(r)) {
+      return false;
+    }
+
+    switch (res) {
+      case asn1::ber::decoder::result::no_error:
+        {
+          struct {
+            uint8_t tag_class;
+            uint8_t primitive;
+            uint32_t tag_number;
+            size_t length;
+            size_t total_length;
+          } v;
+
+          memset(&v, 0, sizeof(v));
+
+          v.tag_class = static_cast<uint8_t>(val.tag_class());
+          v.primitive = val.primitive();
+          v.tag_number = val.tag_number();
+          v.length = val.length();
+          v.total_length = val.total_length();
+
+          if (!out.append(&v, sizeof(v))) {
+            return false;
+          }
+        }
+
+        // Primitive?
+        if (val.primitive()) {
+          if ((val.length() > 0) && (!out.append(val.data(), val.length()))) {
+            return false;
+          }
+        } else {
+          if ((!decoder.enter_constructed()) || (!walk(decoder, out))) {
+            return false;
+          }
+
+          decoder.leave_constructed();
+        }
+
+        break;
+      case asn1::ber::decoder::result::eof:
+        return true;
+      default:
+        return false;
+    }
+  } while (true);
+}
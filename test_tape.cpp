@@ -0,0 +1,576 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "asn1/ber/decoder.h"
+#include "asn1/ber/header.h"
+#include "asn1/ber/tape.h"
+#include "string/buffer.h"
+
+// Number of inputs.
+static constexpr const size_t number_inputs = 20000;
+
+// Maximum number of records per input.
+static constexpr const unsigned max_records = 4;
+
+// Maximum depth of the generated values.
+static constexpr const unsigned max_depth = 5;
+
+// Maximum length of the contents of the generated primitive values.
+static constexpr const unsigned max_primitive_length = 40;
+
+// Minimum and maximum number of levels of the deeply nested records (around
+// the maximum depth of the decoder and of the tape).
+static constexpr const unsigned min_nested_levels = 120;
+static constexpr const unsigned max_nested_levels = 136;
+
+// Result of the decoder when it couldn't find the end-of-contents of an
+// indefinite-length value. The decoder scans the contents of such a value
+// (without entering the definite-length values) before returning it, whereas
+// the tape decodes them in a single pass, so, if the contents have several
+// errors, the tape might report a different one.
+static const asn1::ber::decoder::result
+  eoc_not_found =
+    static_cast<asn1::ber::decoder::result>(
+      asn1::ber::decoder::number_results
+    );
+
+// Data value (as reported by the decoder or by the tape) or result which
+// ended the walk.
+struct node {
+  uint32_t offset;
+  uint32_t contents_offset;
+  uint32_t tag_number;
+  uint32_t length;
+  uint32_t total_length;
+  uint8_t tag_class;
+  uint8_t constructed;
+  uint8_t depth;
+  uint8_t result;
+};
+
+// Pseudo-random number generator (xorshift64*).
+static uint64_t state = 0x9e3779b97f4a7c15ull;
+
+static uint32_t next_random(uint32_t n);
+
+// Generate a data value.
+static bool generate(string::buffer& buf, unsigned depth);
+
+// Generate `levels` nested constructed values.
+static bool generate_nested(string::buffer& buf, unsigned levels);
+
+// Append identifier octets.
+static bool append_identifier(string::buffer& buf, bool constructed);
+
+// Append length octets.
+static bool append_length(string::buffer& buf, size_t len);
+
+// Corrupt the input (truncate it, change octets or leave it unchanged).
+static void corrupt(string::buffer& buf);
+
+// Walk the records with the decoder and record their data values
+// (depth-first) and the result which ended the walk in `out` (the data values
+// of a record which couldn't be decoded are not recorded). Returns false if
+// memory couldn't be allocated.
+static bool walk_decoder(const string::buffer& in, string::buffer& out);
+
+// Walk the data values of the constructed value the decoder has entered
+// (`offset` and `end` are the offsets of the beginning and of the end of its
+// contents octets). Returns the result which ended the walk (`no_error` if
+// memory couldn't be allocated).
+static asn1::ber::decoder::result walk(asn1::ber::decoder& decoder,
+                                       const uint8_t* begin,
+                                       size_t offset,
+                                       size_t end,
+                                       size_t depth,
+                                       string::buffer& out);
+
+// Get the error of the decoder for the value at `offset` (`eoc_not_found` if
+// it is an indefinite-length value).
+static asn1::ber::decoder::result error(const uint8_t* begin,
+                                        size_t offset,
+                                        size_t end,
+                                        asn1::ber::decoder::result res);
+
+// Decode the records with the tape and record the same in `out`.
+static bool walk_tape(const string::buffer& in, string::buffer& out);
+
+// Append data value.
+static bool append_node(string::buffer& out,
+                        const uint8_t* begin,
+                        size_t offset,
+                        const asn1::ber::value& val,
+                        size_t depth);
+
+// Append result.
+static bool append_result(string::buffer& out, asn1::ber::decoder::result res);
+
+// Compare the walks.
+static bool compare(const string::buffer& expected, const string::buffer& out);
+
+int main()
+{
+  string::buffer in;
+  string::buffer expected;
+  string::buffer out;
+
+  for (size_t i = 0; i < number_inputs; i++) {
+    // Generate input.
+    in.clear();
+
+    for (unsigned n = 1 + next_random(max_records); n > 0; n--) {
+      // Deeply nested record?
+      if (next_random(16) == 0) {
+        const unsigned levels = min_nested_levels +
+                                next_random(max_nested_levels -
+                                            min_nested_levels +
+                                            1);
+
+        if (!generate_nested(in, levels)) {
+          fprintf(stderr, "Error generating input.\n");
+          return -1;
+        }
+      } else if (!generate(in, 0)) {
+        fprintf(stderr, "Error generating input.\n");
+        return -1;
+      }
+    }
+
+    corrupt(in);
+
+    // Walk the input with the decoder and with the tape.
+    expected.clear();
+    out.clear();
+
+    if ((!walk_decoder(in, expected)) || (!walk_tape(in, out))) {
+      fprintf(stderr, "Error allocating memory.\n");
+      return -1;
+    }
+
+    // If the walks differ...
+    if (!compare(expected, out)) {
+      fprintf(stderr, "Walks differ for the input %zu:", i);
+
+      const uint8_t* const data = static_cast<const uint8_t*>(in.data());
+      for (size_t j = 0; j < in.length(); j++) {
+        fprintf(stderr, " %02x", data[j]);
+      }
+
+      fprintf(stderr, "\n");
+
+      return -1;
+    }
+  }
+
+  printf("Success.\n");
+
+  return 0;
+}
+
+uint32_t next_random(uint32_t n)
+{
+  state ^= state >> 12;
+  state ^= state << 25;
+  state ^= state >> 27;
+
+  return static_cast<uint32_t>((state * 0x2545f4914f6cdd1dull) >> 32) % n;
+}
+
+bool generate(string::buffer& buf, unsigned depth)
+{
+  // Primitive?
+  if ((depth == max_depth) || (next_random(3) != 0)) {
+    const size_t len = next_random(max_primitive_length + 1);
+
+    if ((!append_identifier(buf, false)) || (!append_length(buf, len))) {
+      return false;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+      if (!buf.push_back(static_cast<uint8_t>(next_random(256)))) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  if (!append_identifier(buf, true)) {
+    return false;
+  }
+
+  const unsigned nchildren = next_random(4);
+
+  // Indefinite length?
+  if (next_random(2) == 0) {
+    if (!buf.push_back(0x80)) {
+      return false;
+    }
+
+    for (unsigned i = 0; i < nchildren; i++) {
+      if (!generate(buf, depth + 1)) {
+        return false;
+      }
+    }
+
+    // End-of-contents.
+    return buf.append(2, 0);
+  }
+
+  // Generate the children and insert the length octets before them.
+  string::buffer contents;
+  for (unsigned i = 0; i < nchildren; i++) {
+    if (!generate(contents, depth + 1)) {
+      return false;
+    }
+  }
+
+  return ((append_length(buf, contents.length())) && (buf.append(contents)));
+}
+
+bool generate_nested(string::buffer& buf, unsigned levels)
+{
+  // Innermost value?
+  if (levels == 0) {
+    return generate(buf, max_depth);
+  }
+
+  if (!append_identifier(buf, true)) {
+    return false;
+  }
+
+  // Indefinite length?
+  if (next_random(2) == 0) {
+    return ((buf.push_back(0x80)) &&
+            (generate_nested(buf, levels - 1)) &&
+            (buf.append(2, 0)));
+  }
+
+  // Generate the child and insert the length octets before it.
+  string::buffer contents;
+  return ((generate_nested(contents, levels - 1)) &&
+          (append_length(buf, contents.length())) &&
+          (buf.append(contents)));
+}
+
+bool append_identifier(string::buffer& buf, bool constructed)
+{
+  const uint8_t tag_class = static_cast<uint8_t>(next_random(4) << 6);
+  const uint8_t pc = constructed ? 0x20 : 0x00;
+
+  // Low tag number (not end-of-contents)?
+  if (next_random(4) != 0) {
+    return buf.push_back(tag_class | pc | static_cast<uint8_t>(1 + next_random(30)));
+  }
+
+  // High tag number.
+  uint32_t tag_number = next_random(0x200000);
+
+  uint8_t octets[3];
+  size_t n = 0;
+
+  do {
+    octets[n++] = tag_number & 0x7f;
+    tag_number >>= 7;
+  } while (tag_number > 0);
+
+  if (!buf.push_back(tag_class | pc | 0x1f)) {
+    return false;
+  }
+
+  while (n > 1) {
+    if (!buf.push_back(octets[--n] | 0x80)) {
+      return false;
+    }
+  }
+
+  return buf.push_back(octets[0]);
+}
+
+bool append_length(string::buffer& buf, size_t len)
+{
+  // Short form?
+  if ((len < 0x80) && (next_random(4) != 0)) {
+    return buf.push_back(static_cast<uint8_t>(len));
+  }
+
+  // Number of octets needed.
+  unsigned needed = 1;
+  while ((needed < 4) && ((len >> (needed * 8)) != 0)) {
+    needed++;
+  }
+
+  // Long form (with leading zeros, sometimes).
+  const unsigned n = needed + next_random(5 - needed);
+
+  if (!buf.push_back(static_cast<uint8_t>(0x80 | n))) {
+    return false;
+  }
+
+  for (unsigned i = n; i > 0; i--) {
+    const size_t shift = (i - 1) * 8;
+    if (!buf.push_back((shift < 32) ? static_cast<uint8_t>(len >> shift) : 0)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void corrupt(string::buffer& buf)
+{
+  if (buf.empty()) {
+    return;
+  }
+
+  switch (next_random(3)) {
+    case 0:
+      // Truncate.
+      buf.resize(next_random(static_cast<uint32_t>(buf.length())));
+      break;
+    case 1:
+      {
+        // Change octets.
+        uint8_t* const
+          data = static_cast<uint8_t*>(const_cast<void*>(buf.data()));
+
+        for (unsigned n = 1 + next_random(3); n > 0; n--) {
+          data[next_random(static_cast<uint32_t>(buf.length()))] =
+            static_cast<uint8_t>(next_random(256));
+        }
+      }
+
+      break;
+    default:
+      break;
+  }
+}
+
+bool walk_decoder(const string::buffer& in, string::buffer& out)
+{
+  const uint8_t* const begin = static_cast<const uint8_t*>(in.data());
+  asn1::ber::decoder decoder(begin, in.length());
+
+  string::buffer record;
+  size_t offset = 0;
+
+  do {
+    asn1::ber::value val;
+    asn1::ber::decoder::result res = decoder.next(val);
+
+    // If the record could be decoded...
+    if (res == asn1::ber::decoder::result::no_error) {
+      record.clear();
+
+      if (!append_node(record, begin, offset, val, 0)) {
+        return false;
+      }
+
+      // Constructed?
+      if (val.constructed()) {
+        decoder.enter_constructed();
+
+        const size_t
+          contents_offset = static_cast<const uint8_t*>(val.data()) - begin;
+
+        res = walk(decoder,
+                   begin,
+                   contents_offset,
+                   contents_offset + val.length(),
+                   1,
+                   record);
+
+        decoder.leave_constructed();
+
+        // If memory couldn't be allocated...
+        if (res == asn1::ber::decoder::result::no_error) {
+          return false;
+        }
+      } else {
+        res = asn1::ber::decoder::result::eof;
+      }
+
+      // If the whole record could be decoded...
+      if (res == asn1::ber::decoder::result::eof) {
+        if (!out.append(record)) {
+          return false;
+        }
+
+        offset += val.total_length();
+
+        continue;
+      }
+    } else {
+      res = error(begin, offset, in.length(), res);
+    }
+
+    return append_result(out, res);
+  } while (true);
+}
+
+asn1::ber::decoder::result walk(asn1::ber::decoder& decoder,
+                                const uint8_t* begin,
+                                size_t offset,
+                                size_t end,
+                                size_t depth,
+                                string::buffer& out)
+{
+  do {
+    asn1::ber::value val;
+    asn1::ber::decoder::result res = decoder.next(val);
+
+    // If the value couldn't be decoded or at the end of the contents...
+    if (res != asn1::ber::decoder::result::no_error) {
+      return error(begin, offset, end, res);
+    }
+
+    if (!append_node(out, begin, offset, val, depth)) {
+      return asn1::ber::decoder::result::no_error;
+    }
+
+    // Constructed?
+    if (val.constructed()) {
+      decoder.enter_constructed();
+
+      const size_t
+        contents_offset = static_cast<const uint8_t*>(val.data()) - begin;
+
+      res = walk(decoder,
+                 begin,
+                 contents_offset,
+                 contents_offset + val.length(),
+                 depth + 1,
+                 out);
+
+      decoder.leave_constructed();
+
+      // If the contents couldn't be walked...
+      if (res != asn1::ber::decoder::result::eof) {
+        return res;
+      }
+    }
+
+    offset += val.total_length();
+  } while (true);
+}
+
+asn1::ber::decoder::result error(const uint8_t* begin,
+                                 size_t offset,
+                                 size_t end,
+                                 asn1::ber::decoder::result res)
+{
+  // If not at the end of the contents and the maximum depth has not been
+  // exceeded (checked before the end-of-contents is searched for)...
+  if ((res != asn1::ber::decoder::result::eof) &&
+      (res != asn1::ber::decoder::result::max_depth_exceeded)) {
+    asn1::ber::header hdr;
+
+    // If the header can be decoded and the length is indefinite...
+    if ((hdr.decode(begin, end, offset) ==
+         asn1::ber::decoder::result::no_error) &&
+        (!hdr.definite_length)) {
+      return eoc_not_found;
+    }
+  }
+
+  return res;
+}
+
+bool walk_tape(const string::buffer& in, string::buffer& out)
+{
+  const uint8_t* const begin = static_cast<const uint8_t*>(in.data());
+
+  asn1::ber::tape tape;
+
+  for (size_t offset = 0; ; offset += tape.total_length()) {
+    // If the record couldn't be decoded...
+    if (!tape.decode(begin + offset, in.length() - offset)) {
+      // If memory couldn't be allocated...
+      if (tape.error() == asn1::ber::decoder::result::no_error) {
+        return false;
+      }
+
+      return append_result(out, tape.error());
+    }
+
+    for (size_t idx = 0; idx < tape.size(); idx++) {
+      asn1::ber::value val;
+      tape.get(idx, val);
+
+      if (!append_node(out,
+                       begin,
+                       offset + tape.offset(idx),
+                       val,
+                       tape.depth(idx))) {
+        return false;
+      }
+    }
+  }
+}
+
+bool append_node(string::buffer& out,
+                 const uint8_t* begin,
+                 size_t offset,
+                 const asn1::ber::value& val,
+                 size_t depth)
+{
+  struct node n;
+  memset(&n, 0, sizeof(struct node));
+
+  n.offset = static_cast<uint32_t>(offset);
+  n.contents_offset =
+    static_cast<uint32_t>(static_cast<const uint8_t*>(val.data()) - begin);
+
+  n.tag_number = val.tag_number();
+  n.length = static_cast<uint32_t>(val.length());
+  n.total_length = static_cast<uint32_t>(val.total_length());
+  n.tag_class = static_cast<uint8_t>(val.tag_class());
+  n.constructed = val.constructed();
+  n.depth = static_cast<uint8_t>(depth);
+  n.result = static_cast<uint8_t>(asn1::ber::decoder::result::no_error);
+
+  return out.append(&n, sizeof(struct node));
+}
+
+bool append_result(string::buffer& out, asn1::ber::decoder::result res)
+{
+  struct node n;
+  memset(&n, 0, sizeof(struct node));
+
+  n.result = static_cast<uint8_t>(res);
+
+  return out.append(&n, sizeof(struct node));
+}
+
+bool compare(const string::buffer& expected, const string::buffer& out)
+{
+  // If the walks have a different number of data values...
+  if (out.length() != expected.length()) {
+    return false;
+  }
+
+  // Both walks end with a result.
+  const size_t len = out.length() - sizeof(struct node);
+
+  // If the data values differ...
+  if (memcmp(out.data(), expected.data(), len) != 0) {
+    return false;
+  }
+
+  struct node e;
+  memcpy(&e, static_cast<const uint8_t*>(expected.data()) + len, sizeof(e));
+
+  struct node o;
+  memcpy(&o, static_cast<const uint8_t*>(out.data()) + len, sizeof(o));
+
+  // If the decoder couldn't find the end-of-contents of an indefinite-length
+  // value, any decoding error will do.
+  if (e.result == static_cast<uint8_t>(eoc_not_found)) {
+    return ((o.result !=
+             static_cast<uint8_t>(asn1::ber::decoder::result::no_error)) &&
+            (o.result !=
+             static_cast<uint8_t>(asn1::ber::decoder::result::eof)));
+  }
+
+  return (o.result == e.result);
+}
@@ -0,0 +1,44 @@
+#include "util/clock.h"
+
+void util::clock::format() const
+{
+  const time_t t = _M_now.tv_sec;
+
+  // If the time is not in the local hour of the cached prefix...
+  if ((t < _M_hour_start) || (t >= _M_hour_start + 3600)) {
+    // Convert to local time (once per hour: the offset to UTC can only change
+    // at the start of a local hour).
+    struct tm tm;
+    localtime_r(&t, &tm);
+
+    _M_hour_start = t - (tm.tm_min * 60) - tm.tm_sec;
+
+    const unsigned year = 1900 + tm.tm_year;
+    const unsigned month = 1 + tm.tm_mon;
+
+    _M_prefix[0] = '0' + ((year / 1000) % 10);
+    _M_prefix[1] = '0' + ((year / 100) % 10);
+    _M_prefix[2] = '0' + ((year / 10) % 10);
+    _M_prefix[3] = '0' + (year % 10);
+    _M_prefix[4] = '0' + (month / 10);
+    _M_prefix[5] = '0' + (month % 10);
+    _M_prefix[6] = '0' + (tm.tm_mday / 10);
+    _M_prefix[7] = '0' + (tm.tm_mday % 10);
+    _M_prefix[8] = '-';
+    _M_prefix[9] = '0' + (tm.tm_hour / 10);
+    _M_prefix[10] = '0' + (tm.tm_hour % 10);
+    _M_prefix[prefix_length] = 0;
+  }
+
+  // Minutes and seconds.
+  const unsigned secs = static_cast<unsigned>(t - _M_hour_start);
+  const unsigned minute = secs / 60;
+  const unsigned second = secs % 60;
+
+  _M_prefix[11] = '0' + (minute / 10);
+  _M_prefix[12] = '0' + (minute % 10);
+  _M_prefix[13] = '0' + (second / 10);
+  _M_prefix[14] = '0' + (second % 10);
+
+  _M_prefix_second = t;
+}
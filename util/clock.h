@@ -0,0 +1,110 @@
+#ifndef UTIL_CLOCK_H
+#define UTIL_CLOCK_H
+
+#include <stdint.h>
+#include <time.h>
+
+namespace util {
+  // Coarse wall clock.
+  //
+  // Keeps the current time (updated by the owner thread, typically once per
+  // iteration of its event loop) and caches the local time of the current
+  // second formatted as "YYYYMMDD-HHMMSS", so the hot path doesn't have to
+  // call time(), localtime_r() or snprintf().
+  class clock {
+    public:
+      // Length of the prefix ("YYYYMMDD-HHMMSS").
+      static constexpr const size_t prefix_length = 15;
+
+      // Constructor.
+      clock();
+
+      // Destructor.
+      ~clock() = default;
+
+      // Update (reads the coarse real-time clock).
+      void update();
+
+      // Set current time.
+      void set(time_t t);
+
+      // Get current time (seconds).
+      time_t now() const;
+
+      // Get current time.
+      const struct timespec& timestamp() const;
+
+      // Get local time of the current second ("YYYYMMDD-HHMMSS").
+      const char* prefix() const;
+
+      // Get monotonic time (microseconds; for measuring latencies).
+      static uint64_t monotonic();
+
+    private:
+      // Current time.
+      struct timespec _M_now;
+
+      // Second of the cached prefix.
+      mutable time_t _M_prefix_second = -1;
+
+      // Start of the local hour of the cached prefix.
+      mutable time_t _M_hour_start = 0;
+
+      // Prefix.
+      mutable char _M_prefix[prefix_length + 1];
+
+      // Format prefix.
+      void format() const;
+  };
+
+  inline clock::clock()
+  {
+    update();
+  }
+
+  inline void clock::update()
+  {
+#if defined(CLOCK_REALTIME_COARSE)
+    clock_gettime(CLOCK_REALTIME_COARSE, &_M_now);
+#else
+    clock_gettime(CLOCK_REALTIME, &_M_now);
+#endif
+  }
+
+  inline void clock::set(time_t t)
+  {
+    _M_now.tv_sec = t;
+    _M_now.tv_nsec = 0;
+  }
+
+  inline time_t clock::now() const
+  {
+    return _M_now.tv_sec;
+  }
+
+  inline const struct timespec& clock::timestamp() const
+  {
+    return _M_now;
+  }
+
+  inline const char* clock::prefix() const
+  {
+    // If the second has changed...
+    if (_M_now.tv_sec != _M_prefix_second) {
+      format();
+    }
+
+    return _M_prefix;
+  }
+
+  inline uint64_t clock::monotonic()
+  {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (static_cast<uint64_t>(ts.tv_sec) * 1000000ull) +
+           (static_cast<uint64_t>(ts.tv_nsec) / 1000);
+  }
+}
+
+#endif // UTIL_CLOCK_H
@@ -0,0 +1,56 @@
+#ifndef UTIL_COUNTER_H
+#define UTIL_COUNTER_H
+
+#include <stdint.h>
+#include <atomic>
+
+namespace util {
+  // Single-writer counter.
+  //
+  // Only one thread updates the counter, so the updates are plain loads and
+  // stores (no locked instructions); any thread can read it.
+  class counter {
+    public:
+      // Constructor.
+      counter() = default;
+
+      // Destructor.
+      ~counter() = default;
+
+      // Add.
+      void add(uint64_t n = 1);
+
+      // Update maximum.
+      void max(uint64_t n);
+
+      // Get value.
+      uint64_t get() const;
+
+    private:
+      std::atomic<uint64_t> _M_value{0};
+
+      // Disable copy constructor and assignment operator.
+      counter(const counter&) = delete;
+      counter& operator=(const counter&) = delete;
+  };
+
+  inline void counter::add(uint64_t n)
+  {
+    _M_value.store(_M_value.load(std::memory_order_relaxed) + n,
+                   std::memory_order_relaxed);
+  }
+
+  inline void counter::max(uint64_t n)
+  {
+    if (n > _M_value.load(std::memory_order_relaxed)) {
+      _M_value.store(n, std::memory_order_relaxed);
+    }
+  }
+
+  inline uint64_t counter::get() const
+  {
+    return _M_value.load(std::memory_order_relaxed);
+  }
+}
+
+#endif // UTIL_COUNTER_H
@@ -0,0 +1,68 @@
+#include "util/histogram.h"
+
+void util::histogram::add(const histogram& other)
+{
+  for (size_t i = 0; i < number_buckets; i++) {
+    _M_buckets[i].add(other._M_buckets[i].get());
+  }
+
+  _M_sum.add(other._M_sum.get());
+  _M_max.max(other._M_max.get());
+}
+
+uint64_t util::histogram::count() const
+{
+  uint64_t n = 0;
+  for (size_t i = 0; i < number_buckets; i++) {
+    n += _M_buckets[i].get();
+  }
+
+  return n;
+}
+
+uint64_t util::histogram::quantile(double q) const
+{
+  const uint64_t n = count();
+
+  // If the histogram is not empty...
+  if (n > 0) {
+    // Rank of the value.
+    uint64_t rank = (q <= 0.0) ? 1 :
+                    (q >= 1.0) ? n :
+                                 static_cast<uint64_t>(q * n + 0.5);
+
+    if (rank == 0) {
+      rank = 1;
+    }
+
+    uint64_t accumulated = 0;
+    for (size_t i = 0; i < number_buckets; i++) {
+      accumulated += _M_buckets[i].get();
+
+      // If the bucket contains the value...
+      if (accumulated >= rank) {
+        const uint64_t value = upper_bound(i);
+        const uint64_t max = _M_max.get();
+
+        return (value < max) ? value : max;
+      }
+    }
+
+    return _M_max.get();
+  }
+
+  return 0;
+}
+
+uint64_t util::histogram::upper_bound(size_t idx)
+{
+  // If the bucket holds a single value...
+  if (idx < sub_buckets) {
+    return idx;
+  }
+
+  const unsigned shift = (idx / sub_buckets) - 1;
+  const uint64_t sub = sub_buckets + (idx % sub_buckets);
+
+  return ((sub + 1) << shift) - 1;
+}
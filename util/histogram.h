@@ -0,0 +1,116 @@
+#ifndef UTIL_HISTOGRAM_H
+#define UTIL_HISTOGRAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "util/counter.h"
+
+namespace util {
+  // Latency histogram.
+  //
+  // HDR-style log-linear buckets: the values below `sub_buckets` have their
+  // own bucket, every power of two above is split in `sub_buckets` buckets
+  // (relative error < 1 / `sub_buckets`). Values of 2^`max_bits` and above
+  // are counted in the last bucket.
+  //
+  // Only one thread records values (single-writer counters); any thread can
+  // merge the histogram into its own copy to compute quantiles.
+  class histogram {
+    public:
+      // Number of bits of the sub-bucket index.
+      static constexpr const unsigned sub_bucket_bits = 4;
+
+      // Number of sub-buckets per power of two.
+      static constexpr const size_t sub_buckets = 1u << sub_bucket_bits;
+
+      // Number of bits of the largest value.
+      static constexpr const unsigned max_bits = 36;
+
+      // Number of buckets.
+      static constexpr const size_t number_buckets =
+        (max_bits - sub_bucket_bits + 1) * sub_buckets;
+
+      // Constructor.
+      histogram() = default;
+
+      // Destructor.
+      ~histogram() = default;
+
+      // Record value.
+      void record(uint64_t value, uint64_t count = 1);
+
+      // Add the counts of another histogram.
+      void add(const histogram& other);
+
+      // Get number of values.
+      uint64_t count() const;
+
+      // Get sum of the values.
+      uint64_t sum() const;
+
+      // Get maximum value.
+      uint64_t max() const;
+
+      // Get value at quantile `q` (0.0 .. 1.0); the value returned is the
+      // upper bound of the bucket.
+      uint64_t quantile(double q) const;
+
+    private:
+      // Buckets.
+      counter _M_buckets[number_buckets];
+
+      // Sum of the values.
+      counter _M_sum;
+
+      // Maximum value.
+      counter _M_max;
+
+      // Get bucket index.
+      static size_t index(uint64_t value);
+
+      // Get highest value of the bucket.
+      static uint64_t upper_bound(size_t idx);
+
+      // Disable copy constructor and assignment operator.
+      histogram(const histogram&) = delete;
+      histogram& operator=(const histogram&) = delete;
+  };
+
+  inline void histogram::record(uint64_t value, uint64_t count)
+  {
+    _M_buckets[index(value)].add(count);
+    _M_sum.add(value * count);
+    _M_max.max(value);
+  }
+
+  inline uint64_t histogram::sum() const
+  {
+    return _M_sum.get();
+  }
+
+  inline uint64_t histogram::max() const
+  {
+    return _M_max.get();
+  }
+
+  inline size_t histogram::index(uint64_t value)
+  {
+    // If the value has its own bucket...
+    if (value < sub_buckets) {
+      return static_cast<size_t>(value);
+    }
+
+    // Position of the most significant bit.
+    const unsigned msb = 63 - __builtin_clzll(value);
+
+    // If the value is too big...
+    if (msb >= max_bits) {
+      return number_buckets - 1;
+    }
+
+    return ((msb - sub_bucket_bits + 1) * sub_buckets) +
+           ((value >> (msb - sub_bucket_bits)) & (sub_buckets - 1));
+  }
+}
+
+#endif // UTIL_HISTOGRAM_H